@@ -0,0 +1,567 @@
+#include "analysis.h"
+#include "decompress.h"
+#include "iou_matrix.h"
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace analyze
+{
+    namespace
+    {
+        /// The number of characters read from a stream at a time.
+        constexpr std::size_t text_chunk = 1 << 16;
+
+        /// Bounding box text being parsed a chunk at a time.
+        struct box_text final
+        {
+            std::string text;                 ///< The characters read but not yet parsed.
+            std::size_t position    = 0;      ///< The first character in \a text not yet parsed.
+            bool        exhausted   = false;  ///< True if the stream has no more characters.
+            parse_status status;              ///< The validation policy, and the lines parsed.
+            box_parser  parser      = nullptr; ///< The parser of the text's dialect.
+        };
+
+        /**
+         * \brief           Read the next chunk of a stream.
+         * \param[in,out]   stream  The stream to read.
+         * \param[in,out]   text    The parsed characters are dropped, and the chunk is appended.
+         * \throws          std::runtime_error  This is thrown if the stream is compressed and
+         *                                      corrupt.
+         * \throws          std::bad_alloc      This is thrown if the text cannot grow.
+         */
+        void read_chunk(std::istream& stream, box_text& text)
+        {
+            text.text.erase(0, text.position);
+            text.position = 0;
+            const auto size = text.text.size();
+            text.text.resize(size + text_chunk);
+            stream.read(&text.text[size], static_cast<std::streamsize>(text_chunk));
+            const auto read = static_cast<std::size_t>(stream.gcount());
+            text.text.resize(size + read);
+            text.exhausted = read < text_chunk;
+        }
+
+        /**
+         * \brief           Start parsing a stream.
+         * \param[in,out]   stream  The stream to read.
+         * \param[out]      text    The first chunk of the stream, and its parser.
+         * \param[in]       format  The stream's dialect. If this is null, it is detected from the
+         *                          first chunk.
+         * \param[in]       convention  The convention to detect with, if \a format is null.
+         * \param[in]       policy  What to do with invalid lines.
+         * \throws          std::runtime_error  This is thrown if the stream is compressed and
+         *                                      corrupt.
+         * \throws          std::bad_alloc      This is thrown if memory for the chunk cannot be
+         *                                      allocated.
+         */
+        void start_text(std::istream& stream,
+                        box_text& text,
+                        const box_format* format,
+                        const box_convention convention,
+                        const validation_policy policy)
+        {
+            read_chunk(stream, text);
+            text.status.policy = policy;
+            text.parser = select_box_parser(format != nullptr ? *format
+                                                              : detect_box_format(text.text.c_str(), text.text.size(), convention),
+                                            policy);
+        }
+
+        /**
+         * \brief           Parse the next boxes of a stream.
+         * \param[in,out]   stream  The stream to read.
+         * \param[in,out]   text    The text read so far, from start_text().
+         * \param[in,out]   boxes   The boxes are appended to this list.
+         * \param[in]       count   The most boxes to read.
+         * \return          The number of boxes appended. This is less than \a count only at the
+         *                  end of the data.
+         * \throws          std::runtime_error  This is thrown if the stream is compressed and
+         *                                      corrupt, or if a line is invalid under the text's
+         *                                      validation policy.
+         * \throws          std::bad_alloc      This is thrown if memory for the boxes cannot be
+         *                                      allocated.
+         * \details         Only whole lines are parsed until the stream is exhausted, so a line
+         *                  split across chunks is parsed once the rest of it is read.
+         */
+        std::size_t read_boxes(std::istream& stream, box_text& text, box_list& boxes, const std::size_t count)
+        {
+            std::size_t read = 0;
+            while (read < count && !text.status.stopped)
+            {
+                const auto last_line = text.exhausted ? text.text.size() : text.text.rfind('\n') + 1;
+                if (last_line > text.position)
+                {
+                    const char* p = text.text.c_str() + text.position;
+                    read += text.parser(p, text.text.c_str() + last_line, boxes, count - read, text.status);
+                    text.position = static_cast<std::size_t>(p - text.text.c_str());
+                }
+                if (read == count || text.exhausted)
+                    break;
+                read_chunk(stream, text);
+            }
+            return read;
+        }
+
+        /**
+         * \brief           Read all the bounding box data from a stream.
+         * \param[in,out]   stream  The stream to read.
+         * \param[in]       policy  What to do with invalid lines.
+         * \param[in]       convention  The convention of four value lines.
+         * \return          The bounding boxes.
+         * \throws          std::runtime_error  This is thrown if the stream is compressed and
+         *                                      corrupt, or if a line is invalid under \a policy.
+         * \throws          std::bad_alloc      This is thrown if memory for the boxes cannot be
+         *                                      allocated.
+         */
+        box_list read_boxes(std::istream& stream, const validation_policy policy, const box_convention convention)
+        {
+            box_text text;
+            start_text(stream, text, nullptr, convention, policy);
+            box_list boxes;
+            read_boxes(stream, text, boxes, std::numeric_limits<std::size_t>::max());
+            return boxes;
+        }
+    }
+
+    box_list load_results(const std::string& file_name, const validation_policy policy, const box_convention convention)
+    {
+        box_reader reader(file_name, policy, convention);
+        box_list boxes;
+        reader.read(boxes, std::numeric_limits<std::size_t>::max());
+        return boxes;
+    }
+
+    box_list parse_results(const std::string& text, const validation_policy policy, const box_convention convention)
+    {
+        const auto format = detect_compression(text.data(), text.size());
+        if (format == compression::none)
+        {
+            // the text is already in memory, so it is parsed in place
+            const char* p = text.c_str();
+            const auto  parser = select_box_parser(detect_box_format(p, text.size(), convention), policy);
+            box_list boxes;
+            parse_status status;
+            status.policy = policy;
+            parser(p, text.c_str() + text.size(), boxes, std::numeric_limits<std::size_t>::max(), status);
+            return boxes;
+        }
+
+        decompressing_buffer buffer(text.data(), text.size(), format);
+        std::istream stream(&buffer);
+        stream.exceptions(std::ios::badbit);
+        return read_boxes(stream, policy, convention);
+    }
+
+    //-------------------------------------------------------
+    //                              box_reader class methods
+    //-------------------------------------------------------
+    /// The open file and its decoder.
+    class box_reader::state final
+    {
+    public:
+        std::string                           file_name;       ///< The path to the file.
+        std::ifstream                         file;            ///< The open file.
+        std::unique_ptr<decompressing_buffer> buffer;          ///< The decoder, if the file is compressed.
+        std::istream                          stream {nullptr}; ///< Reads the file or the decoder.
+        box_text                              text;            ///< The text read but not yet parsed.
+
+        /**
+         * \brief       Open a file.
+         * \param[in]   name    The path to the file.
+         * \param[in]   format  The file's dialect, or null to detect it.
+         * \param[in]   convention  The convention to detect with, if \a format is null.
+         * \param[in]   policy  What to do with invalid lines.
+         * \throws      std::runtime_error  This is thrown if the file cannot be opened, or if it is
+         *                                  compressed in a format this build cannot read.
+         */
+        void open(const std::string& name, const box_format* format, box_convention convention, validation_policy policy);
+    };
+
+    void box_reader::state::open(const std::string& name,
+                                 const box_format* const format,
+                                 const box_convention convention,
+                                 const validation_policy policy)
+    {
+        file_name = name;
+        file.open(file_name.c_str(), std::ios::binary);
+        if (!file)
+            throw std::runtime_error("could not open results file " + file_name);
+
+        char magic[4] = {};
+        file.read(magic, sizeof(magic));
+        const auto compressed = detect_compression(magic, static_cast<std::size_t>(file.gcount()));
+        file.clear();
+        file.seekg(0);
+        if (compressed == compression::none)
+            stream.rdbuf(file.rdbuf());
+        else
+        {
+            try
+            {
+                buffer.reset(new decompressing_buffer(file, compressed));
+            }
+            catch (std::runtime_error& e)
+            {
+                throw std::runtime_error("could not read results file " + file_name + ": " + e.what());
+            }
+            stream.rdbuf(buffer.get());
+            stream.exceptions(std::ios::badbit);
+        }
+
+        try
+        {
+            start_text(stream, text, format, convention, policy);
+        }
+        catch (std::runtime_error& e)
+        {
+            throw std::runtime_error("could not read results file " + file_name + ": " + e.what());
+        }
+    }
+
+    box_reader::box_reader(const std::string& file_name, const validation_policy policy, const box_convention convention)
+        : m_state(new state)
+    {
+        m_state->open(file_name, nullptr, convention, policy);
+    }
+
+    box_reader::box_reader(const std::string& file_name, const box_format& format, const validation_policy policy)
+        : m_state(new state)
+    {
+        m_state->open(file_name, &format, format.convention, policy);
+    }
+
+    box_reader::box_reader(box_reader&& reader) noexcept = default;
+
+    box_reader::~box_reader() noexcept = default;
+
+    box_reader& box_reader::operator=(box_reader&& reader) noexcept = default;
+
+    std::size_t box_reader::read(box_list& boxes, const std::size_t count)
+    {
+        try
+        {
+            return read_boxes(m_state->stream, m_state->text, boxes, count);
+        }
+        catch (std::runtime_error& e)
+        {
+            throw std::runtime_error("could not read results file " + m_state->file_name + ": " + e.what());
+        }
+    }
+
+    const parse_status& box_reader::status() const noexcept
+    {
+        return m_state->text.status;
+    }
+
+    namespace
+    {
+        /// With an automatic thread count, shorter lists are handled on one thread.
+        constexpr std::size_t parallel_threshold = 1 << 16;
+
+        /**
+         * \brief       Decide how many ranges to split some work into.
+         * \param[in]   count           The number of items.
+         * \param[in]   grain           Ranges hold whole multiples of this many items.
+         * \param[in]   thread_count    The requested thread count; 0 is automatic.
+         * \return      The number of ranges, which is at least 1.
+         * \throws      None
+         */
+        std::size_t range_count(const std::size_t count, const std::size_t grain, const unsigned thread_count) noexcept
+        {
+            std::size_t threads = thread_count;
+            if (threads == 0)
+                threads = count < parallel_threshold ? 1 : std::max(std::thread::hardware_concurrency(), 1u);
+            return std::max(std::min(threads, (count + grain - 1) / grain), std::size_t(1));
+        }
+
+        /**
+         * \brief       Run some work on contiguous ranges of items, one thread for each range.
+         * \param[in]   count   The number of items.
+         * \param[in]   grain   Every range but the last starts and ends on a multiple of this.
+         * \param[in]   ranges  The number of ranges, from range_count().
+         * \param[in]   work    Called with the range index and the range's first and end items.
+         *                      It must not throw.
+         * \throws      None
+         * \details     The calling thread runs the first range, and any range whose thread cannot
+         *              be started, so the work is always done.
+         */
+        template <typename function>
+        void run_ranges(const std::size_t count, const std::size_t grain, const std::size_t ranges, const function& work) noexcept
+        {
+            const auto size  = ((count + grain - 1) / grain + ranges - 1) / ranges * grain;
+            const auto range = [&work, count, size](const std::size_t r) {
+                work(r, std::min(count, r * size), std::min(count, (r + 1) * size));
+            };
+
+            std::vector<std::thread> threads;
+            try
+            {
+                threads.reserve(ranges - 1);
+                for (std::size_t r = 1; r < ranges; ++r)
+                    threads.emplace_back(range, r);
+            }
+            catch (...)
+            {
+            }
+            range(0);
+            for (auto r = threads.size() + 1; r < ranges; ++r)
+                range(r);
+            for (auto& t : threads)
+                t.join();
+        }
+
+        /// The smallest and largest values of part of a series, ignoring NaN.
+        struct extremes final
+        {
+            iou::value_type minimum = std::numeric_limits<iou::value_type>::infinity();  ///< The smallest value.
+            iou::value_type maximum = -std::numeric_limits<iou::value_type>::infinity(); ///< The largest value.
+
+            /**
+             * \brief       Include a value.
+             * \param[in]   v   The value. NaN is ignored, since it fails both comparisons.
+             * \throws      None
+             */
+            void add(const iou::value_type v) noexcept
+            {
+                if (v < minimum)
+                    minimum = v;
+                if (v > maximum)
+                    maximum = v;
+            }
+
+            /**
+             * \brief       Include the extremes of another part of the series.
+             * \param[in]   part    The other part's extremes. It may be empty.
+             * \throws      None
+             */
+            void merge(const extremes& part) noexcept
+            {
+                minimum = std::min(minimum, part.minimum);
+                maximum = std::max(maximum, part.maximum);
+            }
+        };
+
+        /**
+         * \brief       Total one block of a series, in order.
+         * \param[in]   values  The first value of the block.
+         * \param[in]   count   The number of values in the block.
+         * \return      The total.
+         * \throws      None
+         */
+        iou::value_type block_total(const iou* values, const std::size_t count) noexcept
+        {
+            iou::value_type total = 0.0f;
+            for (std::size_t i = 0; i < count; ++i)
+                total += values[i].value();
+            return total;
+        }
+
+        /**
+         * \brief       Assemble a summary.
+         * \param[in]   first   The first value of the series.
+         * \param[in]   range   The extremes of the whole series.
+         * \param[in]   total   The pairwise total of the series.
+         * \param[in]   count   The number of values.
+         * \return      The summary.
+         * \throws      None
+         */
+        iou_summary make_summary(const iou::value_type first, const extremes& range, const iou::value_type total, const std::size_t count) noexcept
+        {
+            iou_summary summary;
+            if (count == 0)
+                return summary;
+
+            // a NaN first value wins every std::min() and std::max() after it
+            const bool nan = first != first;
+            summary.minimum = nan ? first : range.minimum;
+            summary.maximum = nan ? first : range.maximum;
+            summary.count   = count;
+            summary.average = total / static_cast<iou::value_type>(count);
+            return summary;
+        }
+    }
+
+    std::size_t calculate_ious(const box_span results,
+                               const box_span ground_truth,
+                               const span<iou> ious,
+                               const std::size_t stride,
+                               const unsigned thread_count) noexcept
+    {
+        constexpr std::size_t grain = 4096;
+        const auto length = std::min(results.size(), ground_truth.size());
+        const auto step   = std::max(stride, std::size_t(1));
+        const auto count  = length == 0 ? 0 : std::min((length - 1) / step + 1, ious.size());
+        run_ranges(count, grain, range_count(count, grain, thread_count), [&](std::size_t, const std::size_t begin, const std::size_t end) {
+            for (auto i = begin; i < end; ++i)
+                ious[i] = make_iou(results[i * step], ground_truth[i * step]);
+        });
+        return count;
+    }
+
+    iou_list calculate_ious(const box_list& results, const box_list& ground_truth)
+    {
+        iou_list ious((std::min(results.size(), ground_truth.size()) + iou_stride - 1) / iou_stride);
+        calculate_ious(results, ground_truth, ious, iou_stride, 0);
+        return ious;
+    }
+
+    iou_summary summarize(const span<const iou> ious, const unsigned thread_count) noexcept
+    {
+        constexpr auto block = iou_accumulator::block_size;
+        const auto blocked = ious.size() / block * block;
+        const auto ranges  = range_count(blocked, block, thread_count);
+        if (ranges > 1)
+        {
+            try
+            {
+                std::vector<iou::value_type> totals(blocked / block);
+                std::vector<extremes> parts(ranges);
+                run_ranges(blocked, block, ranges, [&](const std::size_t r, const std::size_t begin, const std::size_t end) {
+                    for (auto b = begin; b < end; b += block)
+                        totals[b / block] = block_total(ious.data() + b, block);
+                    for (auto i = begin; i < end; ++i)
+                        parts[r].add(ious[i].value());
+                });
+
+                // combine in a fixed order, exactly as iou_accumulator does
+                pairwise_sum total;
+                for (const auto t : totals)
+                    total.add(t);
+                if (blocked < ious.size())
+                    total.add(block_total(ious.data() + blocked, ious.size() - blocked));
+                extremes range;
+                for (const auto& p : parts)
+                    range.merge(p);
+                for (auto i = blocked; i < ious.size(); ++i)
+                    range.add(ious[i].value());
+                return make_summary(ious[0].value(), range, total.total(), ious.size());
+            }
+            catch (std::bad_alloc&)
+            {
+            }
+        }
+
+        iou_accumulator accumulator;
+        accumulator.add(ious);
+        return accumulator.summary();
+    }
+
+    //-------------------------------------------------------
+    //                            pairwise_sum class methods
+    //-------------------------------------------------------
+    void pairwise_sum::add(const iou::value_type value) noexcept
+    {
+        m_sums[m_depth]  = value;
+        m_sizes[m_depth] = 1;
+        ++m_depth;
+        // two trees of the same size make one twice the size, like carrying in binary
+        while (m_depth > 1 && m_sizes[m_depth - 1] == m_sizes[m_depth - 2])
+        {
+            m_sums[m_depth - 2] = m_sums[m_depth - 2] + m_sums[m_depth - 1];
+            m_sizes[m_depth - 2] *= 2;
+            --m_depth;
+        }
+    }
+
+    iou::value_type pairwise_sum::total() const noexcept
+    {
+        if (m_depth == 0)
+            return 0.0f;
+        auto total = m_sums[m_depth - 1];
+        for (auto t = m_depth - 1; t > 0; --t)
+            total = m_sums[t - 1] + total;
+        return total;
+    }
+
+    //-------------------------------------------------------
+    //                         iou_accumulator class methods
+    //-------------------------------------------------------
+    void iou_accumulator::add(const span<const iou> ious) noexcept
+    {
+        extremes range {m_minimum, m_maximum};
+        for (const auto i : ious)
+        {
+            const auto v = i.value();
+            if (m_count++ == 0)
+                m_first = v;
+            range.add(v);
+            m_block += v;
+            if (++m_block_count == block_size)
+            {
+                m_blocks.add(m_block);
+                m_block       = 0.0f;
+                m_block_count = 0;
+            }
+        }
+        m_minimum = range.minimum;
+        m_maximum = range.maximum;
+    }
+
+    iou_summary iou_accumulator::summary() const noexcept
+    {
+        auto total = m_blocks;
+        if (m_block_count > 0)
+            total.add(m_block);
+        return make_summary(m_first, extremes {m_minimum, m_maximum}, total.total(), m_count);
+    }
+
+    void accumulate(iou_summary& summary, const iou value) noexcept
+    {
+        const auto v = value.value();
+        summary.minimum = summary.count == 0 ? v : std::min(summary.minimum, v);
+        summary.maximum = summary.count == 0 ? v : std::max(summary.maximum, v);
+        ++summary.count;
+        summary.average += (v - summary.average) / static_cast<iou::value_type>(summary.count);
+    }
+
+    void write_ious(const span<const iou> ious, const std::string& file_name) noexcept
+    {
+        std::ofstream file(file_name.c_str());
+        if (!file)
+        {
+            std::cerr << "error: could not open " << file_name << " for writing IoU data.\n";
+            return;
+        }
+
+        for (const auto i : ious)
+            file << i.value() << std::endl;
+
+        // write the minimum, average, and maximum
+        if (ious.empty())
+            return;
+        const auto summary = summarize(ious);
+        file << "minimum: "   << summary.minimum
+             << "\nmaximum: " << summary.maximum
+             << "\naverage: " << summary.average;
+    }
+
+    iou_list calculate_coverage(const mot_sequence& results, const mot_sequence& ground_truth)
+    {
+        iou_list ious;
+        std::vector<iou::value_type> matrix;
+        for (mot_sequence::size_type f = 0; f < ground_truth.frame_count(); ++f)
+        {
+            const auto truth = ground_truth.frame(f);
+            if (truth.size == 0)
+                continue;
+
+            const auto boxes = results.frame(f);
+            matrix.resize(boxes.size * truth.size);
+            calculate_iou_matrix(boxes.boxes, boxes.size, truth.boxes, truth.size, matrix.data());
+
+            iou::value_type total = 0.0f;
+            for (std::size_t c = 0; c < truth.size; ++c)
+            {
+                iou::value_type best = 0.0f;
+                for (std::size_t r = 0; r < boxes.size; ++r)
+                    best = std::max(best, matrix[r * truth.size + c]);
+                total += best;
+            }
+            ious.emplace_back(total / truth.size);
+        }
+        return ious;
+    }
+}
@@ -0,0 +1,328 @@
+#ifndef ANALYZE_ANALYSIS_H
+#define ANALYZE_ANALYSIS_H
+
+#include "bounding_box.h"
+#include "box_format.h"
+#include "iou.h"
+#include "mot.h"
+#include "span.h"
+#include <limits>
+#include <memory>
+#include <string>
+
+namespace analyze
+{
+    /// Alias the type of a read only view of bounding boxes.
+    using box_span = span<const bounding_box<float>>;
+
+    /**
+     * \brief       Read bounding box data from a file.
+     * \param[in]   file_name   The path to the file containing the bounding box data.
+     * \param[in]   policy      What to do with lines which are not valid.
+     * \param[in]   convention  The meaning of the values of a four value line. The dataset
+     *                          decides this; see dataset_manifest. It is never guessed, so the
+     *                          results and ground truth of a sequence are read alike.
+     * \return      A list of bounding box data from the file.
+     * \throws      std::runtime_error  This is thrown if the file cannot be opened, if it is
+     *                                  compressed and corrupt, or if a line is not valid and
+     *                                  \a policy is validation_policy::fail. The message gives the
+     *                                  line number.
+     * \details     Bounding box data in the file must adhere to these restrictions:
+     *              \li The file must be plain text, or plain text compressed with gzip or zstd.
+     *              Compression is recognized by the file's magic number, whatever its name, and
+     *              the file is decompressed as it is parsed.
+     *              \li Each line must correspond to one frame of imagery or video.
+     *              \li Each line must have values separated by commas, tabs, or spaces. The
+     *              delimiter is detected from the first line; see detect_box_format(). Four
+     *              values are read as \a convention says, and eight as the corners of a polygon.
+     *              \li Fractional pixels are allowed, but not required.
+     *              \li Blank lines are skipped.
+     *              \li Each other line must have exactly the values its dialect needs, every value
+     *              must be finite, and no width or height may be negative.
+     *              Lines which break the last rule are handled as \a policy says. The checks are
+     *              made as the values are parsed, so they cost little; validation_policy::none
+     *              leaves them out and ends the data at the first line without enough values.
+     */
+    box_list load_results(const std::string& file_name,
+                          validation_policy policy  = validation_policy::fail,
+                          box_convention convention = box_convention::left_width_top_height);
+
+    /**
+     * \brief       Parse bounding box data which has already been read.
+     * \param[in]   text    The contents of a bounding box file.
+     * \param[in]   policy  What to do with lines which are not valid.
+     * \param[in]   convention  The meaning of the values of a four value line.
+     * \return      The bounding boxes, exactly as load_results() reads them from a file with these
+     *              contents.
+     * \throws      std::runtime_error  This is thrown if \a text is compressed and corrupt, or if a
+     *                                  line is not valid and \a policy is validation_policy::fail.
+     * \throws      std::bad_alloc      This is thrown if memory for the boxes cannot be allocated.
+     * \details     This is for files read by a batch_reader. Compressed contents are decompressed
+     *              in chunks as they are parsed.
+     */
+    box_list parse_results(const std::string& text,
+                           validation_policy policy  = validation_policy::fail,
+                           box_convention convention = box_convention::left_width_top_height);
+
+    /**
+     * \brief       Reads a bounding box file a piece at a time.
+     * \details     The file is read exactly as load_results() reads it, including compressed files,
+     *              but only as many boxes as are asked for are parsed and held at once. This is for
+     *              sequences too long to hold in memory.
+     */
+    class box_reader final
+    {
+    public:
+        /**
+         * \brief       Open a bounding box file.
+         * \param[in]   file_name   The path to the file.
+         * \param[in]   policy      What to do with lines which are not valid.
+         * \param[in]   convention  The meaning of the values of a four value line.
+         * \throws      std::runtime_error  This is thrown if the file cannot be opened, or if it is
+         *                                  compressed in a format this build cannot read.
+         */
+        explicit box_reader(const std::string& file_name,
+                            validation_policy policy  = validation_policy::fail,
+                            box_convention convention = box_convention::left_width_top_height);
+
+        /**
+         * \brief       Open a bounding box file in a known dialect.
+         * \param[in]   file_name   The path to the file.
+         * \param[in]   format      The file's dialect. It is used instead of detecting one.
+         * \param[in]   policy      What to do with lines which are not valid.
+         * \throws      std::runtime_error  This is thrown if the file cannot be opened, or if it is
+         *                                  compressed in a format this build cannot read.
+         */
+        box_reader(const std::string& file_name,
+                   const box_format& format,
+                   validation_policy policy = validation_policy::fail);
+
+        /// A reader owns an open file, so it cannot be copied.
+        box_reader(const box_reader&) = delete;
+
+        /**
+         * \brief       Move a reader.
+         * \param[in]   reader  The reader to move. It cannot be used afterwards.
+         * \throws      None
+         */
+        box_reader(box_reader&& reader) noexcept;
+
+        /**
+         * \brief   Close the file.
+         * \throws  None
+         */
+        ~box_reader() noexcept;
+
+        /// A reader owns an open file, so it cannot be copied.
+        box_reader& operator=(const box_reader&) = delete;
+
+        /**
+         * \brief       Move a reader.
+         * \param[in]   reader  The reader to move. It cannot be used afterwards.
+         * \return      A reference to this reader.
+         * \throws      None
+         */
+        box_reader& operator=(box_reader&& reader) noexcept;
+
+        /**
+         * \brief           Read the next boxes from the file.
+         * \param[in,out]   boxes   The boxes are appended to this list.
+         * \param[in]       count   The most boxes to read.
+         * \return          The number of boxes appended. This is less than \a count only at the
+         *                  end of the data.
+         * \throws          std::runtime_error  This is thrown if the file is compressed and corrupt,
+         *                                      or if a line is not valid and the policy is
+         *                                      validation_policy::fail.
+         * \throws          std::bad_alloc      This is thrown if memory for the boxes cannot be
+         *                                      allocated.
+         */
+        std::size_t read(box_list& boxes, const std::size_t count);
+
+        /**
+         * \brief   Get the progress through the file.
+         * \return  The lines read so far, and how many were skipped or clamped.
+         * \throws  None
+         */
+        const parse_status& status() const noexcept;
+
+        /// The open file and its decoder.
+        class state;
+
+    private:
+        std::unique_ptr<state> m_state; ///< The open file and its decoder.
+    };
+
+    /// The frames between the IoU values of a sequence's series; see calculate_ious().
+    constexpr std::size_t iou_stride = 5;
+
+    /**
+     * \brief       Calculate IoU values for two lists of bounding boxes, into caller storage.
+     * \param[in]   results         The bounding boxes representing algorithm results.
+     * \param[in]   ground_truth    The bounding boxes representing ground truth.
+     * \param[out]  ious            The storage for the IoU values.
+     * \param[in]   stride          Only every \a stride frame is compared. A stride of 0 is treated
+     *                              as 1.
+     * \param[in]   thread_count    The number of threads to compare frames on. 0 chooses one
+     *                              thread per core for long lists, and one thread for short ones.
+     * \return      The number of IoU values written to \a ious.
+     * \throws      None
+     * \details     Frame \f$ s \cdot i \f$ of \a results and \a ground_truth is written to
+     *              \a ious[i]. Frames past the end of the shorter list are not compared, and no
+     *              more than \a ious.size() values are written. With one thread, nothing is
+     *              allocated or copied, so a tracker can call this every frame on its own storage.
+     *              With more, each thread writes its own contiguous range of \a ious, so the
+     *              values are the same whatever the thread count. If a thread cannot be started,
+     *              its range is compared on the calling thread.
+     */
+    std::size_t calculate_ious(box_span results,
+                               box_span ground_truth,
+                               span<iou> ious,
+                               std::size_t stride = 1,
+                               unsigned thread_count = 1) noexcept;
+
+    /**
+     * \brief       Calculate IoU values for two lists of bounding boxes.
+     * \param[in]   results         The list of bounding boxes representing algorithm results.
+     * \param[in]   ground_truth    The list of bounding boxes representing ground truth.
+     * \return      A list of intersection-over-union (IoU) values, for every iou_stride frame.
+     * \throws      std::bad_alloc  This is thrown if memory for the IoU list cannot be allocated.
+     * \details     Each entry in the IoU list is the IoU for the corresponding entries in the
+     *              \a results and \a ground_truth lists. The IoU formula is:
+     *              \f$ IoU(B,G) = \frac{B \cap G}{B \cup G} \f$
+     *
+     *              Long lists are compared on every core.
+     */
+    iou_list calculate_ious(const box_list& results, const box_list& ground_truth);
+
+    /// The summary statistics of a list of IoU values.
+    struct iou_summary final
+    {
+        iou::value_type minimum = 0.0f; ///< The smallest IoU.
+        iou::value_type maximum = 0.0f; ///< The largest IoU.
+        iou::value_type average = 0.0f; ///< The mean IoU.
+        std::size_t     count   = 0;    ///< The number of IoU values summarized.
+    };
+
+    /**
+     * \brief       Adds numbers in a fixed pairwise order.
+     * \details     The numbers are the leaves of a tree whose shape depends only on how many there
+     *              are: the leaves are split into perfect binary trees of decreasing size, from the
+     *              left, and those are added from the right. Each leaf is added as it arrives, and
+     *              only one partial sum is kept for each tree, so any number of leaves takes
+     *              constant memory. However the leaves were produced, the same leaves in the same
+     *              order give the same total, bit for bit.
+     */
+    class pairwise_sum final
+    {
+    public:
+        /**
+         * \brief       Add the next leaf.
+         * \param[in]   value   The leaf.
+         * \throws      None
+         */
+        void add(const iou::value_type value) noexcept;
+
+        /**
+         * \brief   Add up the leaves so far.
+         * \return  The total; 0 if there are no leaves.
+         * \throws  None
+         */
+        iou::value_type total() const noexcept;
+
+    private:
+        iou::value_type m_sums[64] = {};  ///< The sum of each complete tree, largest first.
+        std::size_t     m_sizes[64] = {}; ///< The number of leaves in each tree.
+        std::size_t     m_depth = 0;      ///< The number of trees.
+    };
+
+    /**
+     * \brief       Summarizes an IoU series a piece at a time.
+     * \details     The series is split into blocks of block_size values, counted from its first
+     *              value. Each block is added in order, and the block totals are added with a
+     *              pairwise_sum, the last partial block included. The minimum and maximum ignore
+     *              NaN, unless the first value is NaN, in which case they are that value; this is
+     *              what comparing each value in turn with std::min() and std::max() gives. Every
+     *              statistic therefore depends only on the values, not on how they were split up
+     *              or how many threads summarized them.
+     */
+    class iou_accumulator final
+    {
+    public:
+        /// The number of values in each block.
+        static constexpr std::size_t block_size = 1024;
+
+        /**
+         * \brief       Add the next values of the series.
+         * \param[in]   ious    The values.
+         * \throws      None
+         */
+        void add(const span<const iou> ious) noexcept;
+
+        /**
+         * \brief   Summarize the values so far.
+         * \return  The minimum, maximum, and average of the values. If there are none, every
+         *          field is 0.
+         * \throws  None
+         */
+        iou_summary summary() const noexcept;
+
+    private:
+        pairwise_sum    m_blocks;            ///< The totals of the complete blocks.
+        iou::value_type m_block = 0.0f;      ///< The total of the current block.
+        std::size_t     m_block_count = 0;   ///< The number of values in the current block.
+        iou::value_type m_first = 0.0f;      ///< The first value.
+        iou::value_type m_minimum = std::numeric_limits<iou::value_type>::infinity();  ///< The smallest value which is not NaN.
+        iou::value_type m_maximum = -std::numeric_limits<iou::value_type>::infinity(); ///< The largest value which is not NaN.
+        std::size_t     m_count = 0;         ///< The number of values.
+    };
+
+    /**
+     * \brief       Summarize a list of IoU values.
+     * \param[in]   ious            The IoU values to summarize.
+     * \param[in]   thread_count    The number of threads to use. 0 chooses one thread per core for
+     *                              long lists, and one thread for short ones.
+     * \return      The minimum, maximum, and average of \a ious. If \a ious is empty, every field
+     *              is 0.
+     * \throws      None
+     * \details     The statistics are those of an iou_accumulator given all of \a ious, whatever
+     *              the thread count. Each thread totals whole blocks, and the block totals are
+     *              added in order afterwards. If the threads cannot be started, the calling thread
+     *              does all the work.
+     */
+    iou_summary summarize(span<const iou> ious, unsigned thread_count = 0) noexcept;
+
+    /**
+     * \brief           Add one IoU value to a running summary.
+     * \param[in,out]   summary The summary to update.
+     * \param[in]       value   The IoU value to add.
+     * \throws          None
+     * \details         This keeps a running mean, so a summary can be updated one frame at a time
+     *                  without storing the IoU values.
+     */
+    void accumulate(iou_summary& summary, const iou value) noexcept;
+
+    /**
+     * \brief       Write a list of IoU values to a file.
+     * \param[in]   ious        The list of IoU values to write.
+     * \param[in]   file_name   The path to the file to write.
+     * \throws      None
+     * \details     This writes one IoU for each line, followed by the summarize() statistics. The
+     *              statistics are omitted for an empty list.
+     */
+    void write_ious(span<const iou> ious, const std::string& file_name) noexcept;
+
+    /**
+     * \brief       Calculate the per frame coverage of multi-object ground truth.
+     * \param[in]   results         The multi-object algorithm results.
+     * \param[in]   ground_truth    The multi-object ground truth.
+     * \return      One IoU for each frame that has ground truth.
+     * \throws      std::bad_alloc  This is thrown if memory for the IoU matrices cannot be
+     *                              allocated.
+     * \details     For each frame, the IoU matrix between the results and ground truth is
+     *              calculated. Each ground truth object is credited with its best IoU from any
+     *              result, and the frame's IoU is the average of those credits.
+     */
+    iou_list calculate_coverage(const mot_sequence& results, const mot_sequence& ground_truth);
+}
+
+#endif
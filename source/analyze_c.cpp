@@ -0,0 +1,170 @@
+#include "analyze_c.h"
+#include "analysis.h"
+#include "iou_file.h"
+#include "live_ring.h"
+#include <algorithm>
+#include <type_traits>
+
+/// The C handle is the C++ ring.
+struct analyze_live_ring
+{
+    analyze::live_ring ring; ///< The opened ring.
+};
+
+/// The C handle is the C++ file.
+struct analyze_iou_file
+{
+    analyze::iou_file file; ///< The mapped file.
+};
+
+namespace
+{
+    using box_type = analyze::bounding_box<float>;
+    static_assert(sizeof(analyze_box) == sizeof(box_type) && alignof(analyze_box) == alignof(box_type),
+                  "analyze_box must have the same layout as bounding_box<float>");
+    static_assert(std::is_standard_layout<box_type>::value, "bounding_box<float> must be standard layout");
+    static_assert(sizeof(analyze::iou) == sizeof(float), "iou must have the same layout as float");
+
+    /**
+     * \brief       View a C box array as C++ boxes.
+     * \param[in]   boxes   The C boxes. Their sides must be in order; see is_ordered().
+     * \param[in]   count   The number of boxes.
+     * \return      A span over the same memory.
+     * \throws      None
+     */
+    analyze::box_span as_boxes(const analyze_box* boxes, const size_t count) noexcept
+    {
+        return analyze::box_span(reinterpret_cast<const box_type*>(boxes), count);
+    }
+
+    /**
+     * \brief       Convert a C box to a C++ box.
+     * \param[in]   box     The C box. Its sides may be in either order.
+     * \return      The box, with left not greater than right and top not greater than bottom,
+     *              which the C++ box guarantees to everything that uses it.
+     * \throws      None
+     */
+    box_type to_box(const analyze_box& box) noexcept
+    {
+        return box_type(box.left, box.right, box.top, box.bottom);
+    }
+
+    /**
+     * \brief       Check whether C boxes can be used as C++ boxes without converting them.
+     * \param[in]   boxes   The C boxes.
+     * \param[in]   count   The number of boxes.
+     * \retval      true    Every box's left is not greater than its right, and its top is not
+     *                      greater than its bottom.
+     * \retval      false   A box has a pair of sides swapped.
+     * \throws      None
+     */
+    bool is_ordered(const analyze_box* boxes, const size_t count) noexcept
+    {
+        return std::none_of(boxes, boxes + count, [](const analyze_box& b) {
+            return b.left > b.right || b.top > b.bottom;
+        });
+    }
+}
+
+extern "C" float analyze_iou(const analyze_box* a, const analyze_box* b)
+{
+    return analyze::make_iou(to_box(*a), to_box(*b)).value();
+}
+
+extern "C" size_t analyze_calculate_ious(const analyze_box* results,
+                                         const analyze_box* ground_truth,
+                                         const size_t       count,
+                                         float*             ious)
+{
+    auto* const values = reinterpret_cast<analyze::iou*>(ious);
+    if (is_ordered(results, count) && is_ordered(ground_truth, count))
+    {
+        return analyze::calculate_ious(as_boxes(results, count),
+                                       as_boxes(ground_truth, count),
+                                       analyze::span<analyze::iou>(values, count));
+    }
+
+    // order the sides a block at a time on the stack, so nothing is allocated
+    constexpr size_t block = 256;
+    box_type ordered_results[block], ordered_truth[block];
+    for (size_t first = 0; first < count; first += block)
+    {
+        const auto size = std::min(block, count - first);
+        for (size_t i = 0; i < size; ++i)
+        {
+            ordered_results[i] = to_box(results[first + i]);
+            ordered_truth[i]   = to_box(ground_truth[first + i]);
+        }
+        analyze::calculate_ious(analyze::box_span(ordered_results, size),
+                                analyze::box_span(ordered_truth, size),
+                                analyze::span<analyze::iou>(values + first, size));
+    }
+    return count;
+}
+
+extern "C" analyze_summary analyze_summarize(const float* ious, const size_t count)
+{
+    const auto s = analyze::summarize(
+        analyze::span<const analyze::iou>(reinterpret_cast<const analyze::iou*>(ious), count));
+    return analyze_summary {s.minimum, s.maximum, s.average, s.count};
+}
+
+extern "C" analyze_live_ring* analyze_live_open(const char* name)
+{
+    try
+    {
+        return new analyze_live_ring {analyze::live_ring(name)};
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+extern "C" int analyze_live_push(analyze_live_ring* ring, const uint64_t frame, const analyze_box* box)
+{
+    return ring->ring.try_push(analyze::live_record {frame, to_box(*box)}) ? 1 : 0;
+}
+
+extern "C" void analyze_live_finish(analyze_live_ring* ring)
+{
+    if (ring == nullptr)
+        return;
+    ring->ring.close();
+    delete ring;
+}
+
+extern "C" analyze_iou_file* analyze_iou_file_open(const char* file_name)
+{
+    try
+    {
+        return new analyze_iou_file {analyze::iou_file(file_name)};
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+extern "C" const float* analyze_iou_file_values(const analyze_iou_file* file, size_t* count)
+{
+    const auto ious = file->file.ious();
+    *count = ious.size();
+    return reinterpret_cast<const float*>(ious.data());
+}
+
+extern "C" analyze_summary analyze_iou_file_summary(const analyze_iou_file* file)
+{
+    const auto s = file->file.summary();
+    return analyze_summary {s.minimum, s.maximum, s.average, s.count};
+}
+
+extern "C" uint64_t analyze_iou_file_frame(const analyze_iou_file* file, const size_t index)
+{
+    return file->file.frame(index);
+}
+
+extern "C" void analyze_iou_file_close(analyze_iou_file* file)
+{
+    delete file;
+}
@@ -0,0 +1,136 @@
+#ifndef ANALYZE_ANALYZE_C_H
+#define ANALYZE_ANALYZE_C_H
+
+/**
+ * \file
+ * \brief   A C interface to the analysis library, for trackers which are not written in C++.
+ * \details The box type has the same layout as analyze::bounding_box<float>, so arrays of boxes
+ *          are passed straight through to the C++ functions without being copied.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief   A bounding box. Image coordinates increase left to right, and top to bottom.
+ * \details The functions which take boxes put each pair of sides in order first, so a box whose
+ *          left and right, or top and bottom, are swapped describes the same box.
+ */
+typedef struct analyze_box
+{
+    float left;   ///< The coordinate for the box's left side.
+    float right;  ///< The coordinate for the box's right side.
+    float top;    ///< The coordinate for the box's top.
+    float bottom; ///< The coordinate for the box's bottom.
+} analyze_box;
+
+/// The summary statistics of a list of IoU values.
+typedef struct analyze_summary
+{
+    float  minimum; ///< The smallest IoU.
+    float  maximum; ///< The largest IoU.
+    float  average; ///< The mean IoU.
+    size_t count;   ///< The number of IoU values summarized.
+} analyze_summary;
+
+/**
+ * \brief       Calculate the IoU of two bounding boxes.
+ * \param[in]   a,b The boxes to compare. Neither may be null.
+ * \return      The IoU of \a a and \a b.
+ */
+float analyze_iou(const analyze_box* a, const analyze_box* b);
+
+/**
+ * \brief       Calculate the IoU of corresponding boxes in two arrays.
+ * \param[in]   results         The algorithm result boxes.
+ * \param[in]   ground_truth    The ground truth boxes.
+ * \param[in]   count           The number of boxes in \a results, \a ground_truth, and \a ious.
+ * \param[out]  ious            The IoU of each pair of boxes.
+ * \return      The number of IoU values written to \a ious.
+ */
+size_t analyze_calculate_ious(const analyze_box* results,
+                              const analyze_box* ground_truth,
+                              size_t             count,
+                              float*             ious);
+
+/**
+ * \brief       Summarize a list of IoU values.
+ * \param[in]   ious    The IoU values to summarize.
+ * \param[in]   count   The number of IoU values.
+ * \return      The minimum, maximum, and average IoU. If \a count is 0, every field is 0.
+ */
+analyze_summary analyze_summarize(const float* ious, size_t count);
+
+/// A handle to a live result ring, opened by a tracker; see analyze::live_ring.
+typedef struct analyze_live_ring analyze_live_ring;
+
+/**
+ * \brief       Open a live result ring created by <tt>analyze --live</tt>.
+ * \param[in]   name    The shared memory name of the ring.
+ * \return      A handle to the ring, or null if it cannot be opened.
+ */
+analyze_live_ring* analyze_live_open(const char* name);
+
+/**
+ * \brief       Push one tracker result to a live ring. This never blocks or calls the kernel.
+ * \param[in]   ring    The ring, from analyze_live_open().
+ * \param[in]   frame   The frame number, counting from 0.
+ * \param[in]   box     The tracker's box for the frame.
+ * \return      1 if the result was pushed, or 0 if the ring is full.
+ */
+int analyze_live_push(analyze_live_ring* ring, uint64_t frame, const analyze_box* box);
+
+/**
+ * \brief       Tell the consumer that no more results will be pushed, and release the ring.
+ * \param[in]   ring    The ring, from analyze_live_open(). It must not be used again.
+ */
+void analyze_live_finish(analyze_live_ring* ring);
+
+/// A handle to a mapped binary IoU file; see analyze::iou_file.
+typedef struct analyze_iou_file analyze_iou_file;
+
+/**
+ * \brief       Map a binary IoU file, as written by <tt>analyze --binary</tt>.
+ * \param[in]   file_name   The file to open.
+ * \return      A handle to the file, or null if it cannot be mapped or is not a binary IoU file.
+ */
+analyze_iou_file* analyze_iou_file_open(const char* file_name);
+
+/**
+ * \brief       Get the IoU values of a binary IoU file, without copying them.
+ * \param[in]   file    The file, from analyze_iou_file_open().
+ * \param[out]  count   The number of values.
+ * \return      The values. They are valid until the file is closed.
+ */
+const float* analyze_iou_file_values(const analyze_iou_file* file, size_t* count);
+
+/**
+ * \brief       Get the statistics stored in a binary IoU file.
+ * \param[in]   file    The file, from analyze_iou_file_open().
+ * \return      The minimum, maximum, and average IoU, and the number of values.
+ */
+analyze_summary analyze_iou_file_summary(const analyze_iou_file* file);
+
+/**
+ * \brief       Find the frame an IoU value of a binary IoU file is for.
+ * \param[in]   file    The file, from analyze_iou_file_open().
+ * \param[in]   index   The position of the value.
+ * \return      The frame number.
+ */
+uint64_t analyze_iou_file_frame(const analyze_iou_file* file, size_t index);
+
+/**
+ * \brief       Unmap a binary IoU file.
+ * \param[in]   file    The file, from analyze_iou_file_open(). It must not be used again.
+ */
+void analyze_iou_file_close(analyze_iou_file* file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,312 @@
+#include "archive.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+
+namespace analyze
+{
+    /// One index record, as stored in the archive.
+    struct dataset_archive::index_entry final
+    {
+        std::uint64_t name_offset;    ///< The offset of the name in the name table.
+        std::uint64_t name_size;      ///< The length of the name.
+        std::uint64_t truth_offset;   ///< The file offset of the ground truth block.
+        std::uint64_t truth_count;    ///< The number of ground truth boxes.
+        std::uint64_t results_offset; ///< The file offset of the results block; 0 if there is none.
+        std::uint64_t results_count;  ///< The number of result boxes.
+    };
+
+    namespace
+    {
+        /// Identifies an archive: "ANPK".
+        constexpr std::uint32_t archive_magic = 0x4b504e41;
+
+        /// The version of the archive format.
+        constexpr std::uint32_t archive_version = 1;
+
+        /// The alignment of each box block.
+        constexpr std::size_t block_alignment = 64;
+
+        /// The start of an archive.
+        struct archive_header final
+        {
+            std::uint32_t magic;       ///< archive_magic.
+            std::uint32_t version;     ///< archive_version.
+            std::uint64_t count;       ///< The number of sequences.
+            std::uint64_t names;       ///< The file offset of the name table.
+            std::uint64_t names_size;  ///< The size of the name table.
+        };
+
+        static_assert(sizeof(bounding_box<float>) == 4 * sizeof(float) && std::is_standard_layout<bounding_box<float>>::value,
+                      "archived boxes are used in place, so they must be four packed floats");
+
+        /**
+         * \brief           Pad a buffer to the block alignment.
+         * \param[in,out]   bytes   The buffer.
+         * \throws          std::bad_alloc  This is thrown if the buffer cannot grow.
+         */
+        void align(std::string& bytes)
+        {
+            bytes.resize((bytes.size() + block_alignment - 1) / block_alignment * block_alignment, '\0');
+        }
+
+        /**
+         * \brief           Append a block of boxes to a buffer.
+         * \param[in,out]   bytes   The buffer.
+         * \param[in]       boxes   The boxes to append.
+         * \return          The offset of the block.
+         * \throws          std::bad_alloc  This is thrown if the buffer cannot grow.
+         */
+        std::uint64_t put_boxes(std::string& bytes, const box_list& boxes)
+        {
+            align(bytes);
+            const auto offset = bytes.size();
+            bytes.append(reinterpret_cast<const char*>(boxes.data()), boxes.size() * sizeof(bounding_box<float>));
+            return offset;
+        }
+
+        /**
+         * \brief       Order two names the way std::string does.
+         * \param[in]   a,a_size    The first name and its length.
+         * \param[in]   b,b_size    The second name and its length.
+         * \return      A negative number, 0, or a positive number, as \a a sorts before, with, or
+         *              after \a b.
+         * \throws      None
+         */
+        int compare_names(const char* a, const std::size_t a_size, const char* b, const std::size_t b_size) noexcept
+        {
+            const auto order = std::memcmp(a, b, std::min(a_size, b_size));
+            return order != 0 ? order : (a_size < b_size ? -1 : (a_size > b_size ? 1 : 0));
+        }
+
+        /**
+         * \brief       Check that a block lies within a file.
+         * \param[in]   offset  The start of the block.
+         * \param[in]   count   The number of items in the block.
+         * \param[in]   item    The size of one item.
+         * \param[in]   size    The size of the file.
+         * \retval      true    The block is inside the file.
+         * \retval      false   The block runs past the end of the file.
+         * \throws      None
+         */
+        bool inside(const std::uint64_t offset, const std::uint64_t count, const std::uint64_t item, const std::uint64_t size) noexcept
+        {
+            return offset <= size && count <= (size - offset) / item;
+        }
+    }
+
+    void write_archive(const std::string& file_name, std::vector<packed_sequence> sequences)
+    {
+        std::sort(sequences.begin(), sequences.end(), [](const packed_sequence& a, const packed_sequence& b) {
+            return a.name < b.name;
+        });
+        const auto duplicate = std::adjacent_find(sequences.begin(), sequences.end(), [](const packed_sequence& a, const packed_sequence& b) {
+            return a.name == b.name;
+        });
+        if (duplicate != sequences.end())
+            throw std::invalid_argument("the archive has two sequences named " + duplicate->name);
+
+        std::string names;
+        std::vector<dataset_archive::index_entry> index(sequences.size());
+        for (std::size_t s = 0; s < sequences.size(); ++s)
+        {
+            index[s].name_offset = names.size();
+            index[s].name_size   = sequences[s].name.size();
+            names += sequences[s].name;
+        }
+
+        archive_header header;
+        std::memset(&header, 0, sizeof(header));
+        header.magic      = archive_magic;
+        header.version    = archive_version;
+        header.count      = sequences.size();
+        header.names      = sizeof(header) + index.size() * sizeof(dataset_archive::index_entry);
+        header.names_size = names.size();
+
+        // lay out the blocks first, then fill in the index in front of them
+        std::string bytes(header.names + names.size(), '\0');
+        for (std::size_t s = 0; s < sequences.size(); ++s)
+        {
+            index[s].truth_count  = sequences[s].ground_truth.size();
+            index[s].truth_offset = put_boxes(bytes, sequences[s].ground_truth);
+            if (sequences[s].has_results)
+            {
+                index[s].results_count  = sequences[s].results.size();
+                index[s].results_offset = put_boxes(bytes, sequences[s].results);
+            }
+            else
+                index[s].results_offset = index[s].results_count = 0;
+        }
+        align(bytes);
+        std::memcpy(&bytes[0], &header, sizeof(header));
+        if (!index.empty())
+            std::memcpy(&bytes[sizeof(header)], index.data(), index.size() * sizeof(dataset_archive::index_entry));
+        std::memcpy(&bytes[header.names], names.data(), names.size());
+
+        const auto temporary = file_name + ".tmp." + std::to_string(getpid());
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+            if (!file)
+            {
+                std::remove(temporary.c_str());
+                throw std::runtime_error("could not write " + file_name);
+            }
+        }
+        if (std::rename(temporary.c_str(), file_name.c_str()) != 0)
+        {
+            std::remove(temporary.c_str());
+            throw std::runtime_error("could not replace " + file_name);
+        }
+    }
+
+    //-------------------------------------------------------
+    //                         dataset_archive class methods
+    //-------------------------------------------------------
+    dataset_archive::dataset_archive(const std::string& file_name)
+    {
+        const int descriptor = open(file_name.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat status;
+        if (descriptor < 0 || fstat(descriptor, &status) != 0)
+        {
+            const auto message = "could not open archive " + file_name + ": " + std::strerror(errno);
+            if (descriptor >= 0)
+                ::close(descriptor);
+            throw std::runtime_error(message);
+        }
+        m_size = static_cast<std::size_t>(status.st_size);
+        if (m_size < sizeof(archive_header))
+        {
+            ::close(descriptor);
+            throw std::runtime_error(file_name + " is not an archive");
+        }
+
+        void* const data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        ::close(descriptor);
+        if (data == MAP_FAILED)
+            throw std::runtime_error("could not map archive " + file_name + ": " + std::strerror(errno));
+        m_data = static_cast<const char*>(data);
+
+        // check everything now, so lookups can trust the archive
+        archive_header header;
+        std::memcpy(&header, m_data, sizeof(header));
+        bool valid = header.magic == archive_magic && header.version == archive_version &&
+                     inside(sizeof(header), header.count, sizeof(index_entry), m_size) &&
+                     header.names == sizeof(header) + header.count * sizeof(index_entry) &&
+                     inside(header.names, header.names_size, 1, m_size);
+        if (valid)
+        {
+            m_count = static_cast<std::size_t>(header.count);
+            m_index = reinterpret_cast<const index_entry*>(m_data + sizeof(header));
+            m_names = m_data + header.names;
+        }
+        for (std::size_t s = 0; valid && s < m_count; ++s)
+        {
+            const auto& e = m_index[s];
+            valid = inside(e.name_offset, e.name_size, 1, header.names_size) &&
+                    e.truth_offset % block_alignment == 0 &&
+                    inside(e.truth_offset, e.truth_count, sizeof(bounding_box<float>), m_size) &&
+                    e.results_offset % block_alignment == 0 &&
+                    inside(e.results_offset, e.results_count, sizeof(bounding_box<float>), m_size);
+            if (valid && s > 0)
+            {
+                // the index must be sorted for the binary search
+                std::size_t a_size = 0, b_size = 0;
+                const char* const a = name(s - 1, a_size);
+                const char* const b = name(s, b_size);
+                valid = compare_names(a, a_size, b, b_size) < 0;
+            }
+        }
+        if (!valid)
+        {
+            munmap(const_cast<char*>(m_data), m_size);
+            throw std::runtime_error(file_name + " is not a valid archive");
+        }
+
+        // the blocks are read in order by evaluation, and the index is searched at random
+        madvise(const_cast<char*>(m_data), m_size, MADV_WILLNEED);
+    }
+
+    dataset_archive::dataset_archive(dataset_archive&& archive) noexcept
+        : m_data(archive.m_data),
+          m_size(archive.m_size),
+          m_count(archive.m_count),
+          m_index(archive.m_index),
+          m_names(archive.m_names)
+    {
+        archive.m_data  = nullptr;
+        archive.m_size  = 0;
+        archive.m_count = 0;
+        archive.m_index = nullptr;
+        archive.m_names = nullptr;
+    }
+
+    dataset_archive::~dataset_archive() noexcept
+    {
+        if (m_data != nullptr)
+            munmap(const_cast<char*>(m_data), m_size);
+    }
+
+    dataset_archive& dataset_archive::operator=(dataset_archive&& archive) noexcept
+    {
+        std::swap(m_data, archive.m_data);
+        std::swap(m_size, archive.m_size);
+        std::swap(m_count, archive.m_count);
+        std::swap(m_index, archive.m_index);
+        std::swap(m_names, archive.m_names);
+        return *this;
+    }
+
+    archived_sequence dataset_archive::at(const std::size_t index) const
+    {
+        const auto& e = m_index[index];
+        const auto* const boxes = reinterpret_cast<const bounding_box<float>*>(m_data);
+        std::size_t size = 0;
+        const char* const n = name(index, size);
+
+        archived_sequence sequence;
+        sequence.name.assign(n, size);
+        sequence.ground_truth = box_span(boxes + e.truth_offset / sizeof(bounding_box<float>), e.truth_count);
+        sequence.has_results  = e.results_offset != 0;
+        if (sequence.has_results)
+            sequence.results = box_span(boxes + e.results_offset / sizeof(bounding_box<float>), e.results_count);
+        return sequence;
+    }
+
+    bool dataset_archive::find(const std::string& name, archived_sequence& sequence) const
+    {
+        std::size_t low = 0, high = m_count;
+        while (low < high)
+        {
+            const auto middle = low + (high - low) / 2;
+            std::size_t size = 0;
+            const char* const n = this->name(middle, size);
+            const auto order = compare_names(n, size, name.data(), name.size());
+            if (order == 0)
+            {
+                sequence = at(middle);
+                return true;
+            }
+            if (order < 0)
+                low = middle + 1;
+            else
+                high = middle;
+        }
+        return false;
+    }
+
+    const char* dataset_archive::name(const std::size_t index, std::size_t& size) const noexcept
+    {
+        size = static_cast<std::size_t>(m_index[index].name_size);
+        return m_names + m_index[index].name_offset;
+    }
+}
@@ -0,0 +1,142 @@
+#ifndef ANALYZE_ARCHIVE_H
+#define ANALYZE_ARCHIVE_H
+
+#include "analysis.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace analyze
+{
+    /// One sequence to write to a dataset archive.
+    struct packed_sequence final
+    {
+        std::string name;         ///< The sequence name.
+        box_list    ground_truth; ///< The ground truth boxes.
+        box_list    results;      ///< The tracker results, if has_results is true.
+        bool        has_results = false; ///< True if the archive should hold the results too.
+    };
+
+    /**
+     * \brief       Write a dataset archive.
+     * \param[in]   file_name   The archive to write. An existing archive is replaced.
+     * \param[in]   sequences   The sequences to pack, in any order.
+     * \throws      std::invalid_argument   This is thrown if two sequences have the same name.
+     * \throws      std::runtime_error      This is thrown if the archive cannot be written.
+     * \details     See dataset_archive for the format. The archive is written to a temporary file
+     *              and renamed, so a reader never sees a partial archive.
+     */
+    void write_archive(const std::string& file_name, std::vector<packed_sequence> sequences);
+
+    /// A sequence in a dataset_archive. The boxes point into the archive's mapping.
+    struct archived_sequence final
+    {
+        std::string name;         ///< The sequence name.
+        box_span    ground_truth; ///< The ground truth boxes.
+        box_span    results;      ///< The tracker results; empty if the archive has none.
+        bool        has_results = false; ///< True if the archive holds the results.
+    };
+
+    /**
+     * \brief       A read only view of a dataset archive, mapped into memory.
+     * \details     An archive packs a whole dataset's boxes into one file, so evaluating it opens
+     *              one file instead of tens of thousands. It holds, in order:
+     *              \li A header: the magic number, version, sequence count, and the offset and
+     *              size of the name table.
+     *              \li The index: one record per sequence, sorted by name, giving the location of
+     *              its name and of its ground truth and results blocks.
+     *              \li The name table.
+     *              \li The box blocks, each aligned to 64 bytes. A box is four floats, left, right,
+     *              top, and bottom, the same layout as bounding_box<float>, so the blocks are used
+     *              in place.
+     *
+     *              Numbers are in the host's byte order. The whole archive is checked when it is
+     *              opened, so lookups cannot read outside the mapping. After that, a lookup is a
+     *              binary search of the index, without any system calls.
+     */
+    class dataset_archive final
+    {
+    public:
+        /**
+         * \brief       Map an archive.
+         * \param[in]   file_name   The archive to open.
+         * \throws      std::runtime_error  This is thrown if the file cannot be mapped or is not a
+         *                                  valid archive.
+         */
+        explicit dataset_archive(const std::string& file_name);
+
+        /// An archive owns its mapping, so it cannot be copied.
+        dataset_archive(const dataset_archive&) = delete;
+
+        /**
+         * \brief       Move an archive.
+         * \param[in]   archive The archive to move. It is empty afterwards.
+         * \throws      None
+         */
+        dataset_archive(dataset_archive&& archive) noexcept;
+
+        /**
+         * \brief   Unmap the archive.
+         * \throws  None
+         */
+        ~dataset_archive() noexcept;
+
+        /// An archive owns its mapping, so it cannot be copied.
+        dataset_archive& operator=(const dataset_archive&) = delete;
+
+        /**
+         * \brief       Move an archive.
+         * \param[in]   archive The archive to move. It holds this archive's mapping afterwards.
+         * \return      A reference to this archive.
+         * \throws      None
+         */
+        dataset_archive& operator=(dataset_archive&& archive) noexcept;
+
+        /**
+         * \brief   Query the number of sequences.
+         * \return  The number of sequences in the archive.
+         * \throws  None
+         */
+        std::size_t size() const noexcept { return m_count; }
+
+        /**
+         * \brief       Get a sequence by position.
+         * \param[in]   index   The position of the sequence, in name order. This must be less than
+         *                      size().
+         * \return      The sequence.
+         * \throws      std::bad_alloc  This is thrown if memory for the name cannot be allocated.
+         */
+        archived_sequence at(const std::size_t index) const;
+
+        /**
+         * \brief       Look up a sequence by name.
+         * \param[in]   name        The sequence name.
+         * \param[out]  sequence    The sequence, if it was found.
+         * \retval      true        The sequence was found.
+         * \retval      false       The archive has no sequence named \a name.
+         * \throws      std::bad_alloc  This is thrown if memory for the name cannot be allocated.
+         */
+        bool find(const std::string& name, archived_sequence& sequence) const;
+
+        /// One index record, as stored in the archive.
+        struct index_entry;
+
+    private:
+        /**
+         * \brief       Get the name of a sequence, without copying it.
+         * \param[in]   index   The position of the sequence.
+         * \param[out]  size    The length of the name.
+         * \return      The first character of the name.
+         * \throws      None
+         */
+        const char* name(const std::size_t index, std::size_t& size) const noexcept;
+
+        const char*        m_data  = nullptr; ///< The mapping.
+        std::size_t        m_size  = 0;       ///< The size of the mapping.
+        std::size_t        m_count = 0;       ///< The number of sequences.
+        const index_entry* m_index = nullptr; ///< The index.
+        const char*        m_names = nullptr; ///< The name table.
+    };
+}
+
+#endif
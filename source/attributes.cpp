@@ -0,0 +1,165 @@
+#include "attributes.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace analyze
+{
+    namespace
+    {
+        /**
+         * \brief       Read a file whose items are separated by commas or white space.
+         * \param[in]   file_name   The file to read.
+         * \param[out]  words       The items in the file.
+         * \retval      true        The file was read.
+         * \retval      false       The file does not exist or cannot be opened.
+         * \throws      std::bad_alloc  This is thrown if memory for the items cannot be allocated.
+         */
+        bool read_words(const std::string& file_name, std::vector<std::string>& words)
+        {
+            std::ifstream file(file_name.c_str());
+            if (!file)
+                return false;
+            std::ostringstream contents;
+            contents << file.rdbuf();
+            auto text = contents.str();
+            std::replace(text.begin(), text.end(), ',', ' ');
+            std::istringstream stream(text);
+            std::string word;
+            while (stream >> word)
+                words.push_back(word);
+            return true;
+        }
+
+        /**
+         * \brief       Read a frame attribute file into a table, if it exists.
+         * \param[in]   file_name   The file.
+         * \param[in]   name        The attribute's name.
+         * \param[out]  table       The table to tag.
+         * \throws      std::runtime_error  This is thrown if the file cannot be parsed.
+         */
+        void tag_frames_from(const std::string& file_name, const std::string& name, attribute_table& table)
+        {
+            std::ifstream probe(file_name.c_str());
+            if (probe)
+                table.tag_frames(name, load_frame_flags(file_name));
+        }
+    }
+
+    //-------------------------------------------------------
+    //                         attribute_table class methods
+    //-------------------------------------------------------
+    std::size_t attribute_table::add_attribute(const std::string& name)
+    {
+        const auto found = std::find(m_names.begin(), m_names.end(), name);
+        if (found != m_names.end())
+            return static_cast<std::size_t>(found - m_names.begin());
+        if (m_names.size() == max_attributes)
+            throw std::length_error("a sequence can have at most " + std::to_string(max_attributes) + " attributes");
+        m_names.push_back(name);
+        return m_names.size() - 1;
+    }
+
+    void attribute_table::tag_sequence(const std::string& name)
+    {
+        m_sequence |= attribute_mask(1) << add_attribute(name);
+    }
+
+    void attribute_table::tag_frames(const std::string& name, const std::vector<std::uint8_t>& flags)
+    {
+        const auto bit = attribute_mask(1) << add_attribute(name);
+        if (m_frames.size() < flags.size())
+            m_frames.resize(flags.size(), 0);
+        for (std::size_t f = 0; f < flags.size(); ++f)
+            m_frames[f] |= flags[f] != 0 ? bit : attribute_mask(0);
+    }
+
+    std::vector<std::uint8_t> load_frame_flags(const std::string& file_name)
+    {
+        std::vector<std::string> words;
+        if (!read_words(file_name, words))
+            throw std::runtime_error("could not open " + file_name + " for reading attributes");
+
+        std::vector<std::uint8_t> flags;
+        flags.reserve(words.size());
+        for (const auto& word : words)
+        {
+            if (word.find_first_not_of("0123456789") != std::string::npos)
+                throw std::runtime_error(file_name + ": " + word + " is not a frame flag");
+            flags.push_back(word.find_first_not_of('0') == std::string::npos ? 0 : 1);
+        }
+        return flags;
+    }
+
+    attribute_table load_attributes(const std::string& directory)
+    {
+        attribute_table table;
+        std::vector<std::string> names;
+        if (read_words(directory + "/attributes.txt", names))
+        {
+            for (const auto& name : names)
+                table.tag_sequence(name);
+        }
+        tag_frames_from(directory + "/full_occlusion.txt", "full occlusion", table);
+        tag_frames_from(directory + "/out_of_view.txt", "out of view", table);
+        tag_frames_from(directory + "/absence.label", "absent", table);
+        return table;
+    }
+
+    std::vector<attribute_statistics> summarize_attributes(const span<const iou> ious,
+                                                           const std::size_t stride,
+                                                           const attribute_table& table,
+                                                           const iou::value_type success_threshold)
+    {
+        // fixed size accumulators let the attribute loop unroll and vectorize
+        const auto count = table.names().size();
+        std::size_t frames[max_attributes]    = {};
+        std::size_t successes[max_attributes] = {};
+        double      totals[max_attributes]    = {};
+        for (std::size_t i = 0; i < ious.size(); ++i)
+        {
+            const auto v       = ious[i].value();
+            const auto defined = !std::isnan(v);
+            const auto mask    = table.mask(i * stride) & (attribute_mask(0) - attribute_mask(defined));
+            const auto success = static_cast<std::size_t>(v > success_threshold);
+            const auto value   = defined ? static_cast<double>(v) : 0.0;
+            for (std::size_t a = 0; a < max_attributes; ++a)
+            {
+                const auto bit = static_cast<std::size_t>((mask >> a) & 1);
+                frames[a]    += bit;
+                successes[a] += bit & success;
+                totals[a]    += static_cast<double>(bit) * value;
+            }
+        }
+
+        std::vector<attribute_statistics> statistics(count);
+        for (std::size_t a = 0; a < count; ++a)
+        {
+            statistics[a].name      = table.names()[a];
+            statistics[a].frames    = frames[a];
+            statistics[a].successes = successes[a];
+            statistics[a].total     = totals[a];
+        }
+        return statistics;
+    }
+
+    void merge_attributes(std::vector<attribute_statistics>& totals, const std::vector<attribute_statistics>& statistics)
+    {
+        for (const auto& s : statistics)
+        {
+            auto found = std::find_if(totals.begin(), totals.end(), [&s](const attribute_statistics& t) {
+                return t.name == s.name;
+            });
+            if (found == totals.end())
+            {
+                totals.push_back(s);
+                continue;
+            }
+            found->frames    += s.frames;
+            found->successes += s.successes;
+            found->total     += s.total;
+        }
+    }
+}
@@ -0,0 +1,143 @@
+#ifndef ANALYZE_ATTRIBUTES_H
+#define ANALYZE_ATTRIBUTES_H
+
+#include "analysis.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace analyze
+{
+    /// One bit for each attribute of an attribute_table.
+    using attribute_mask = std::uint32_t;
+
+    /// The most attributes an attribute_table can hold.
+    constexpr std::size_t max_attributes = 32;
+
+    /**
+     * \brief       The attribute labels of one sequence, stored as a bit mask for each frame.
+     * \details     Sequence attributes, such as OTB's illumination variation, apply to every frame
+     *              and are kept in one mask. Frame attributes, such as LaSOT's full occlusion, are
+     *              kept in a mask for each frame. Attribute \a a is bit \a a of both.
+     */
+    class attribute_table final
+    {
+    public:
+        /**
+         * \brief       Find an attribute, adding it if it is new.
+         * \param[in]   name    The attribute's name.
+         * \return      The attribute's bit.
+         * \throws      std::length_error   This is thrown if the table already has max_attributes
+         *                                  attributes.
+         */
+        std::size_t add_attribute(const std::string& name);
+
+        /**
+         * \brief       Label every frame with an attribute.
+         * \param[in]   name    The attribute's name.
+         * \throws      std::length_error   This is thrown if the attribute is new and the table is
+         *                                  full.
+         */
+        void tag_sequence(const std::string& name);
+
+        /**
+         * \brief       Label some frames with an attribute.
+         * \param[in]   name    The attribute's name.
+         * \param[in]   flags   One flag for each frame, starting with the first; frames whose flag
+         *                      is not 0 are labelled. Frames past the last flag are not.
+         * \throws      std::length_error   This is thrown if the attribute is new and the table is
+         *                                  full.
+         * \throws      std::bad_alloc      This is thrown if memory for the masks cannot be
+         *                                  allocated.
+         */
+        void tag_frames(const std::string& name, const std::vector<std::uint8_t>& flags);
+
+        /**
+         * \brief       Get the attributes of a frame.
+         * \param[in]   frame   The frame's index.
+         * \return      The frame's mask.
+         * \throws      None
+         */
+        attribute_mask mask(const std::size_t frame) const noexcept
+        {
+            return m_sequence | (frame < m_frames.size() ? m_frames[frame] : attribute_mask(0));
+        }
+
+        /**
+         * \brief   Get the attribute names.
+         * \return  The names, in bit order.
+         * \throws  None
+         */
+        const std::vector<std::string>& names() const noexcept { return m_names; }
+
+    private:
+        std::vector<std::string>    m_names;        ///< The name of each attribute.
+        attribute_mask              m_sequence = 0; ///< The attributes of every frame.
+        std::vector<attribute_mask> m_frames;       ///< The attributes of each frame.
+    };
+
+    /**
+     * \brief       Read per-frame attribute flags.
+     * \param[in]   file_name   The file to read.
+     * \return      One flag for each frame.
+     * \throws      std::runtime_error  This is thrown if the file cannot be read, or if it holds
+     *                                  something other than whole numbers.
+     * \details     The numbers may be separated by commas or white space, so both LaSOT's one line
+     *              files and GOT-10k's one number per line files can be read.
+     */
+    std::vector<std::uint8_t> load_frame_flags(const std::string& file_name);
+
+    /**
+     * \brief       Read the attributes of a sequence.
+     * \param[in]   directory   The directory holding the sequence's ground truth.
+     * \return      The sequence's attributes. If there are no attribute files, the table is empty.
+     * \throws      std::runtime_error  This is thrown if an attribute file cannot be parsed.
+     * \throws      std::length_error   This is thrown if there are more than max_attributes
+     *                                  attributes.
+     * \details     These files are read if they exist:
+     *              \li <tt>attributes.txt</tt> lists sequence attributes, separated by commas or
+     *              white space, such as the OTB labels <tt>IV,SV,OCC</tt>.
+     *              \li <tt>full_occlusion.txt</tt> and <tt>out_of_view.txt</tt> are LaSOT's frame
+     *              attributes.
+     *              \li <tt>absence.label</tt> is GOT-10k's frame attribute.
+     */
+    attribute_table load_attributes(const std::string& directory);
+
+    /// The pooled IoU statistics of the frames with one attribute.
+    struct attribute_statistics final
+    {
+        std::string name;          ///< The attribute's name.
+        std::size_t frames    = 0; ///< The number of compared frames with the attribute.
+        std::size_t successes = 0; ///< The frames whose IoU is above the success threshold.
+        double      total     = 0; ///< The sum of the frames' IoUs; the mean is total / frames.
+    };
+
+    /**
+     * \brief       Find the IoU statistics of every attribute of a sequence in one pass.
+     * \param[in]   ious                The sequence's IoU series.
+     * \param[in]   stride              IoU \a i is for frame \a i * \a stride; calculate_ious()
+     *                                  uses iou_stride.
+     * \param[in]   table               The sequence's attributes.
+     * \param[in]   success_threshold   A frame succeeds if its IoU is above this.
+     * \return      One entry for each attribute, in the table's bit order.
+     * \throws      std::bad_alloc  This is thrown if memory for the statistics cannot be allocated.
+     * \details     Each frame is added to every attribute at once: its mask selects, without a
+     *              branch, whether each attribute's counts grow. Frames whose IoU is NaN have their
+     *              mask cleared, so they count for no attribute.
+     */
+    std::vector<attribute_statistics> summarize_attributes(span<const iou> ious,
+                                                           const std::size_t stride,
+                                                           const attribute_table& table,
+                                                           const iou::value_type success_threshold = 0.5f);
+
+    /**
+     * \brief       Pool the attribute statistics of another sequence.
+     * \param[in,out]   totals      The pooled statistics. Attributes are matched by name, and new
+     *                              attributes are appended.
+     * \param[in]       statistics  The statistics to add.
+     * \throws          std::bad_alloc  This is thrown if \a totals cannot grow.
+     */
+    void merge_attributes(std::vector<attribute_statistics>& totals, const std::vector<attribute_statistics>& statistics);
+}
+
+#endif
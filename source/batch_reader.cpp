@@ -0,0 +1,641 @@
+#include "batch_reader.h"
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <mutex>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+
+namespace analyze
+{
+    /// The interface of the io_uring and thread pool implementations.
+    class batch_reader::engine
+    {
+    public:
+        /**
+         * \brief   Destroy the implementation.
+         * \throws  None
+         */
+        virtual ~engine() noexcept = default;
+
+        /// \copydoc batch_reader::method()
+        virtual read_method method() const noexcept = 0;
+
+        /// \copydoc batch_reader::start()
+        virtual void start(std::vector<std::string> paths) = 0;
+
+        /// \copydoc batch_reader::next()
+        virtual bool next(file_read& read) = 0;
+    };
+
+    namespace
+    {
+        /// The size of the first read of each file. Short sequences' annotations fit in one read,
+        /// and longer files double the buffer for each further read.
+        constexpr std::size_t first_read_size = 8 * 1024;
+
+        /**
+         * \brief       Make an error message which includes the system error.
+         * \param[in]   what    The operation which failed.
+         * \return      The error message.
+         * \throws      std::bad_alloc  This is thrown if memory for the message cannot be
+         *                              allocated.
+         */
+        std::string system_error(const std::string& what)
+        {
+            return "could not " + what + ": " + std::strerror(errno);
+        }
+
+        /**
+         * \brief       Reads files through an io_uring.
+         * \details     Each file in flight is a small state machine: open, then read until the end
+         *              of the file, then close. Each step is one submission, so a file has at most
+         *              one operation in the ring, and the completion queue cannot overflow.
+         */
+        class uring_engine final: public batch_reader::engine
+        {
+        public:
+            /**
+             * \brief       Set up an io_uring.
+             * \param[in]   queue_depth The most files in flight at once.
+             * \throws      std::runtime_error  This is thrown if the kernel does not support
+             *                                  io_uring, or the operations this needs.
+             */
+            explicit uring_engine(const std::size_t queue_depth) : m_slots(queue_depth)
+            {
+                io_uring_params parameters;
+                std::memset(&parameters, 0, sizeof(parameters));
+                m_ring = static_cast<int>(syscall(__NR_io_uring_setup, static_cast<unsigned>(queue_depth), &parameters));
+                if (m_ring < 0)
+                    throw std::runtime_error(system_error("set up an io_uring"));
+
+                try
+                {
+                    probe();
+                    map(parameters);
+                }
+                catch (...)
+                {
+                    release();
+                    throw;
+                }
+                for (std::size_t s = 0; s < m_slots.size(); ++s)
+                    m_free.push_back(s);
+            }
+
+            /**
+             * \brief   Wait for any operations in flight, and release the io_uring.
+             * \throws  None
+             */
+            ~uring_engine() noexcept override
+            {
+                try
+                {
+                    // the kernel may still write to the buffers of operations in flight
+                    while (m_in_flight > 0)
+                        reap(1);
+                }
+                catch (...)
+                {
+                }
+                for (auto& s : m_slots)
+                {
+                    if (s.fd >= 0)
+                        ::close(s.fd);
+                }
+                release();
+            }
+
+            read_method method() const noexcept override { return read_method::io_uring; }
+
+            void start(std::vector<std::string> paths) override
+            {
+                while (m_in_flight > 0)
+                    reap(1);
+                for (std::size_t s = 0; s < m_slots.size(); ++s)
+                {
+                    if (m_slots[s].fd >= 0)
+                        ::close(m_slots[s].fd);
+                    m_slots[s] = slot();
+                }
+                m_free.clear();
+                for (std::size_t s = 0; s < m_slots.size(); ++s)
+                    m_free.push_back(s);
+                m_done.clear();
+                m_paths    = std::move(paths);
+                m_next     = 0;
+                m_returned = 0;
+            }
+
+            bool next(file_read& read) override
+            {
+                while (m_done.empty())
+                {
+                    if (m_returned == m_paths.size())
+                        return false;
+                    while (m_next < m_paths.size() && !m_free.empty())
+                    {
+                        const auto s = m_free.back();
+                        m_free.pop_back();
+                        m_slots[s]       = slot();
+                        m_slots[s].index = m_next++;
+                        m_slots[s].data.resize(first_read_size);
+                        push_open(s);
+                    }
+                    reap(1);
+                }
+                read = std::move(m_done.front());
+                m_done.pop_front();
+                ++m_returned;
+                return true;
+            }
+
+        private:
+            /// The steps of reading one file.
+            enum class step
+            {
+                open,  ///< The file is being opened.
+                read,  ///< The file is being read.
+                close  ///< The file is being closed.
+            };
+
+            /// One file in flight.
+            struct slot final
+            {
+                std::size_t index  = 0;          ///< The index of the file in the batch.
+                step        state  = step::open; ///< The operation in flight.
+                int         fd     = -1;         ///< The open file.
+                std::string data;                ///< The file's contents, and space for more.
+                std::size_t filled = 0;          ///< The number of bytes read.
+                int         error  = 0;          ///< The errno value of a failed step.
+            };
+
+            /**
+             * \brief   Check that the kernel supports the operations this needs.
+             * \throws  std::runtime_error  This is thrown if an operation is not supported.
+             */
+            void probe()
+            {
+                constexpr unsigned op_count = 256;
+                std::vector<char> buffer(sizeof(io_uring_probe) + op_count * sizeof(io_uring_probe_op), 0);
+                auto* p = reinterpret_cast<io_uring_probe*>(buffer.data());
+                if (syscall(__NR_io_uring_register, m_ring, IORING_REGISTER_PROBE, p, op_count) < 0)
+                    throw std::runtime_error(system_error("probe the io_uring"));
+                for (const unsigned op : {IORING_OP_OPENAT, IORING_OP_READ, IORING_OP_CLOSE})
+                {
+                    if (op > p->last_op || (p->ops[op].flags & IO_URING_OP_SUPPORTED) == 0)
+                        throw std::runtime_error("the io_uring does not support opening, reading, and closing files");
+                }
+            }
+
+            /**
+             * \brief       Map the submission and completion queues.
+             * \param[in]   parameters  The parameters filled in when the ring was set up.
+             * \throws      std::runtime_error  This is thrown if the queues cannot be mapped.
+             */
+            void map(const io_uring_params& parameters)
+            {
+                m_sq_size = parameters.sq_off.array + parameters.sq_entries * sizeof(unsigned);
+                m_cq_size = parameters.cq_off.cqes + parameters.cq_entries * sizeof(io_uring_cqe);
+                if ((parameters.features & IORING_FEAT_SINGLE_MMAP) != 0)
+                    m_sq_size = m_cq_size = std::max(m_sq_size, m_cq_size);
+
+                m_sq = mmap(nullptr, m_sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring, IORING_OFF_SQ_RING);
+                if (m_sq == MAP_FAILED)
+                    throw std::runtime_error(system_error("map the io_uring submission queue"));
+                if ((parameters.features & IORING_FEAT_SINGLE_MMAP) != 0)
+                    m_cq = m_sq;
+                else
+                {
+                    m_cq = mmap(nullptr, m_cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring, IORING_OFF_CQ_RING);
+                    if (m_cq == MAP_FAILED)
+                        throw std::runtime_error(system_error("map the io_uring completion queue"));
+                }
+                m_sqe_size = parameters.sq_entries * sizeof(io_uring_sqe);
+                m_sqes = static_cast<io_uring_sqe*>(
+                    mmap(nullptr, m_sqe_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring, IORING_OFF_SQES));
+                if (m_sqes == MAP_FAILED)
+                {
+                    m_sqes = nullptr;
+                    throw std::runtime_error(system_error("map the io_uring submission entries"));
+                }
+
+                auto* const sq = static_cast<char*>(m_sq);
+                auto* const cq = static_cast<char*>(m_cq);
+                m_sq_tail  = reinterpret_cast<unsigned*>(sq + parameters.sq_off.tail);
+                m_sq_mask  = *reinterpret_cast<unsigned*>(sq + parameters.sq_off.ring_mask);
+                m_sq_array = reinterpret_cast<unsigned*>(sq + parameters.sq_off.array);
+                m_cq_head  = reinterpret_cast<unsigned*>(cq + parameters.cq_off.head);
+                m_cq_tail  = reinterpret_cast<unsigned*>(cq + parameters.cq_off.tail);
+                m_cq_mask  = *reinterpret_cast<unsigned*>(cq + parameters.cq_off.ring_mask);
+                m_cqes     = reinterpret_cast<io_uring_cqe*>(cq + parameters.cq_off.cqes);
+            }
+
+            /**
+             * \brief   Unmap the queues and close the ring.
+             * \throws  None
+             */
+            void release() noexcept
+            {
+                if (m_sqes != nullptr)
+                    munmap(m_sqes, m_sqe_size);
+                if (m_cq != MAP_FAILED && m_cq != m_sq)
+                    munmap(m_cq, m_cq_size);
+                if (m_sq != MAP_FAILED)
+                    munmap(m_sq, m_sq_size);
+                ::close(m_ring);
+            }
+
+            /**
+             * \brief       Get a cleared submission entry for one slot.
+             * \param[in]   s   The slot the operation is for.
+             * \return      The entry. It is submitted by the next reap().
+             * \throws      None
+             */
+            io_uring_sqe& push(const std::size_t s) noexcept
+            {
+                const auto tail  = *m_sq_tail;
+                const auto entry = tail & m_sq_mask;
+                auto& sqe = m_sqes[entry];
+                std::memset(&sqe, 0, sizeof(sqe));
+                sqe.user_data    = s;
+                m_sq_array[entry] = entry;
+                __atomic_store_n(m_sq_tail, tail + 1, __ATOMIC_RELEASE);
+                ++m_pending;
+                ++m_in_flight;
+                return sqe;
+            }
+
+            /**
+             * \brief       Queue the open of a slot's file.
+             * \param[in]   s   The slot.
+             * \throws      None
+             */
+            void push_open(const std::size_t s) noexcept
+            {
+                auto& sqe = push(s);
+                sqe.opcode     = IORING_OP_OPENAT;
+                sqe.fd         = AT_FDCWD;
+                sqe.addr       = reinterpret_cast<std::uintptr_t>(m_paths[m_slots[s].index].c_str());
+                sqe.open_flags = O_RDONLY | O_CLOEXEC;
+                m_slots[s].state = step::open;
+            }
+
+            /**
+             * \brief       Queue a read of the rest of a slot's buffer.
+             * \param[in]   s   The slot.
+             * \throws      None
+             */
+            void push_read(const std::size_t s) noexcept
+            {
+                auto& f   = m_slots[s];
+                auto& sqe = push(s);
+                sqe.opcode = IORING_OP_READ;
+                sqe.fd     = f.fd;
+                sqe.addr   = reinterpret_cast<std::uintptr_t>(&f.data[f.filled]);
+                sqe.len    = static_cast<unsigned>(f.data.size() - f.filled);
+                sqe.off    = f.filled;
+                f.state    = step::read;
+            }
+
+            /**
+             * \brief       Queue the close of a slot's file.
+             * \param[in]   s   The slot.
+             * \throws      None
+             */
+            void push_close(const std::size_t s) noexcept
+            {
+                auto& sqe = push(s);
+                sqe.opcode = IORING_OP_CLOSE;
+                sqe.fd     = m_slots[s].fd;
+                m_slots[s].state = step::close;
+            }
+
+            /**
+             * \brief       Submit the queued operations, and handle completions.
+             * \param[in]   wait    The number of completions to wait for.
+             * \throws      std::runtime_error  This is thrown if the io_uring fails.
+             * \throws      std::bad_alloc      This is thrown if a buffer cannot grow.
+             */
+            void reap(const unsigned wait)
+            {
+                const auto result = syscall(__NR_io_uring_enter, m_ring, m_pending, wait, IORING_ENTER_GETEVENTS, nullptr, 0);
+                if (result < 0 && errno != EINTR)
+                    throw std::runtime_error(system_error("wait for the io_uring"));
+                if (result > 0)
+                    m_pending -= static_cast<unsigned>(result);
+
+                auto head = *m_cq_head;
+                const auto tail = __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE);
+                for (; head != tail; ++head)
+                {
+                    const auto& cqe = m_cqes[head & m_cq_mask];
+                    const auto s = static_cast<std::size_t>(cqe.user_data);
+                    const auto res = cqe.res;
+                    --m_in_flight;
+                    advance(s, res);
+                }
+                __atomic_store_n(m_cq_head, head, __ATOMIC_RELEASE);
+            }
+
+            /**
+             * \brief       Move a slot to its next step after an operation completes.
+             * \param[in]   s       The slot.
+             * \param[in]   res     The result of the operation.
+             * \throws      std::bad_alloc  This is thrown if the buffer cannot grow.
+             */
+            void advance(const std::size_t s, const int res)
+            {
+                auto& f = m_slots[s];
+                switch (f.state)
+                {
+                    case step::open:
+                        if (res < 0)
+                        {
+                            f.error = -res;
+                            finish(s);
+                            return;
+                        }
+                        f.fd = res;
+                        push_read(s);
+                        return;
+                    case step::read:
+                        if (res < 0)
+                            f.error = -res;
+                        else if (res > 0)
+                        {
+                            f.filled += static_cast<std::size_t>(res);
+                            if (f.filled == f.data.size())
+                                f.data.resize(f.data.size() * 2);
+                            push_read(s);
+                            return;
+                        }
+                        push_close(s);
+                        return;
+                    case step::close:
+                        f.fd = -1;
+                        finish(s);
+                        return;
+                }
+            }
+
+            /**
+             * \brief       Hand a slot's file to the caller, and free the slot.
+             * \param[in]   s   The slot.
+             * \throws      std::bad_alloc  This is thrown if the completed list cannot grow.
+             */
+            void finish(const std::size_t s)
+            {
+                auto& f = m_slots[s];
+                f.data.resize(f.error == 0 ? f.filled : 0);
+                m_done.push_back(file_read {f.index, std::move(f.data), f.error});
+                m_free.push_back(s);
+            }
+
+            int                      m_ring = -1;          ///< The io_uring.
+            void*                    m_sq = MAP_FAILED;    ///< The submission queue mapping.
+            void*                    m_cq = MAP_FAILED;    ///< The completion queue mapping.
+            io_uring_sqe*            m_sqes = nullptr;     ///< The submission entries.
+            std::size_t              m_sq_size = 0;        ///< The size of the submission queue mapping.
+            std::size_t              m_cq_size = 0;        ///< The size of the completion queue mapping.
+            std::size_t              m_sqe_size = 0;       ///< The size of the submission entries.
+            unsigned*                m_sq_tail = nullptr;  ///< The submission queue tail.
+            unsigned                 m_sq_mask = 0;        ///< The submission queue index mask.
+            unsigned*                m_sq_array = nullptr; ///< The submission queue's entry indices.
+            unsigned*                m_cq_head = nullptr;  ///< The completion queue head.
+            unsigned*                m_cq_tail = nullptr;  ///< The completion queue tail.
+            unsigned                 m_cq_mask = 0;        ///< The completion queue index mask.
+            io_uring_cqe*            m_cqes = nullptr;     ///< The completion entries.
+            unsigned                 m_pending = 0;        ///< Operations queued but not submitted.
+            std::size_t              m_in_flight = 0;      ///< Operations not yet completed.
+            std::vector<slot>        m_slots;              ///< The files in flight.
+            std::vector<std::size_t> m_free;               ///< The free slots.
+            std::vector<std::string> m_paths;              ///< The files in the batch.
+            std::size_t              m_next = 0;           ///< The next file to start.
+            std::size_t              m_returned = 0;       ///< The number of files returned.
+            std::deque<file_read>    m_done;               ///< Files read but not yet returned.
+        };
+
+        /**
+         * \brief       Reads files with blocking calls on a pool of threads.
+         */
+        class thread_engine final: public batch_reader::engine
+        {
+        public:
+            /**
+             * \brief       Start the reading threads.
+             * \param[in]   thread_count    The number of threads.
+             * \throws      std::system_error   This is thrown if a thread cannot be started.
+             */
+            explicit thread_engine(const std::size_t thread_count)
+            {
+                try
+                {
+                    for (std::size_t t = 0; t < thread_count; ++t)
+                        m_workers.emplace_back(&thread_engine::work, this);
+                }
+                catch (...)
+                {
+                    stop();
+                    throw;
+                }
+            }
+
+            /**
+             * \brief   Stop the threads.
+             * \throws  None
+             */
+            ~thread_engine() noexcept override { stop(); }
+
+            read_method method() const noexcept override { return read_method::threads; }
+
+            void start(std::vector<std::string> paths) override
+            {
+                // stop claiming files from the old batch, and drop the ones being read
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_next = m_paths.size();
+                ++m_batch;
+                m_idle.wait(lock, [this]() { return m_busy == 0; });
+                m_paths    = std::move(paths);
+                m_next     = 0;
+                m_returned = 0;
+                m_done.clear();
+                m_work.notify_all();
+            }
+
+            bool next(file_read& read) override
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                if (m_returned == m_paths.size())
+                    return false;
+                m_ready.wait(lock, [this]() { return !m_done.empty(); });
+                read = std::move(m_done.front());
+                m_done.pop_front();
+                ++m_returned;
+                return true;
+            }
+
+        private:
+            /**
+             * \brief   Stop and join the threads.
+             * \throws  None
+             */
+            void stop() noexcept
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_stopping = true;
+                }
+                m_work.notify_all();
+                for (auto& w : m_workers)
+                    w.join();
+            }
+
+            /**
+             * \brief   Read files until the engine stops.
+             * \throws  None
+             */
+            void work() noexcept
+            {
+                while (true)
+                {
+                    std::size_t index = 0, batch = 0;
+                    std::string path;
+                    {
+                        std::unique_lock<std::mutex> lock(m_mutex);
+                        m_work.wait(lock, [this]() { return m_stopping || m_next < m_paths.size(); });
+                        if (m_stopping)
+                            return;
+                        index = m_next++;
+                        batch = m_batch;
+                        path  = m_paths[index];
+                        ++m_busy;
+                    }
+
+                    file_read read;
+                    read.index = index;
+                    try
+                    {
+                        read_file(path, read);
+                    }
+                    catch (std::bad_alloc&)
+                    {
+                        read.bytes.clear();
+                        read.error = ENOMEM;
+                    }
+
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        --m_busy;
+                        if (batch == m_batch)
+                            m_done.push_back(std::move(read));
+                    }
+                    m_ready.notify_one();
+                    m_idle.notify_all();
+                }
+            }
+
+            /**
+             * \brief       Read one whole file.
+             * \param[in]   path    The file to read.
+             * \param[out]  read    The file's contents, or the error.
+             * \throws      std::bad_alloc  This is thrown if the buffer cannot grow.
+             */
+            static void read_file(const std::string& path, file_read& read)
+            {
+                const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                if (fd < 0)
+                {
+                    read.error = errno;
+                    return;
+                }
+                std::size_t filled = 0;
+                read.bytes.resize(first_read_size);
+                while (true)
+                {
+                    const auto count = ::read(fd, &read.bytes[filled], read.bytes.size() - filled);
+                    if (count < 0 && errno == EINTR)
+                        continue;
+                    if (count < 0)
+                        read.error = errno;
+                    if (count <= 0)
+                        break;
+                    filled += static_cast<std::size_t>(count);
+                    if (filled == read.bytes.size())
+                        read.bytes.resize(read.bytes.size() * 2);
+                }
+                ::close(fd);
+                read.bytes.resize(read.error == 0 ? filled : 0);
+            }
+
+            std::vector<std::thread> m_workers;        ///< The reading threads.
+            std::mutex               m_mutex;          ///< Guards everything below.
+            std::condition_variable  m_work;           ///< Signals that there are files to read.
+            std::condition_variable  m_ready;          ///< Signals that a file was read.
+            std::condition_variable  m_idle;           ///< Signals that a thread finished a file.
+            std::vector<std::string> m_paths;          ///< The files in the batch.
+            std::size_t              m_next = 0;       ///< The next file to read.
+            std::size_t              m_returned = 0;   ///< The number of files returned.
+            std::size_t              m_busy = 0;       ///< The number of files being read.
+            std::size_t              m_batch = 0;      ///< Counts batches, to drop stale reads.
+            bool                     m_stopping = false; ///< True when the threads should stop.
+            std::deque<file_read>    m_done;           ///< Files read but not yet returned.
+        };
+    }
+
+    //-------------------------------------------------------
+    //                            batch_reader class methods
+    //-------------------------------------------------------
+    batch_reader::batch_reader(const std::size_t queue_depth, const read_method method)
+    {
+        // io_uring rings are limited to 32768 entries
+        const auto depth = std::min<std::size_t>(std::max<std::size_t>(queue_depth, 1), 32768);
+        if (method != read_method::threads)
+        {
+            try
+            {
+                m_engine.reset(new uring_engine(depth));
+            }
+            catch (std::runtime_error&)
+            {
+                if (method == read_method::io_uring)
+                    throw;
+            }
+        }
+        if (!m_engine)
+        {
+            // blocking reads mostly wait, so use more threads than processors, but not too many
+            const auto threads = std::min<std::size_t>(depth, std::max(4u * std::thread::hardware_concurrency(), 4u));
+            m_engine.reset(new thread_engine(std::min<std::size_t>(threads, 64)));
+        }
+    }
+
+    batch_reader::batch_reader(batch_reader&& reader) noexcept = default;
+
+    batch_reader::~batch_reader() noexcept = default;
+
+    batch_reader& batch_reader::operator=(batch_reader&& reader) noexcept = default;
+
+    read_method batch_reader::method() const noexcept
+    {
+        return m_engine->method();
+    }
+
+    void batch_reader::start(std::vector<std::string> paths)
+    {
+        m_engine->start(std::move(paths));
+    }
+
+    bool batch_reader::next(file_read& read)
+    {
+        return m_engine->next(read);
+    }
+}
@@ -0,0 +1,112 @@
+#ifndef ANALYZE_BATCH_READER_H
+#define ANALYZE_BATCH_READER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace analyze
+{
+    /// The ways a batch_reader can read files.
+    enum class read_method
+    {
+        automatic, ///< Use io_uring if the kernel supports it, otherwise threads.
+        io_uring,  ///< Submit opens, reads, and closes through an io_uring.
+        threads    ///< Read files with blocking calls on a pool of threads.
+    };
+
+    /// One file read by a batch_reader.
+    struct file_read final
+    {
+        std::size_t index = 0; ///< The index of the file in the batch.
+        std::string bytes;     ///< The file's contents.
+        int         error = 0; ///< The errno value if the file could not be read, otherwise 0.
+    };
+
+    /**
+     * \brief       Reads a batch of whole files with many reads in flight at once.
+     * \details     Reading many small files one at a time is dominated by the latency of each
+     *              open and read. A batch reader keeps up to \a queue_depth files in flight, and
+     *              returns each one as soon as it has been read, so the caller can parse one file
+     *              while the others are still being read.
+     *
+     *              With io_uring, the opens, reads, and closes are submitted to the kernel in
+     *              groups, and the calling thread only enters the kernel to submit more work and
+     *              collect completions. Without it, a pool of threads reads the files with blocking
+     *              calls.
+     */
+    class batch_reader final
+    {
+    public:
+        /**
+         * \brief       Construct a reader.
+         * \param[in]   queue_depth The most files in flight at once. 0 is treated as 1.
+         * \param[in]   method      How to read the files.
+         * \throws      std::runtime_error  This is thrown if \a method is read_method::io_uring and
+         *                                  the kernel does not support it.
+         * \throws      std::system_error   This is thrown if a reading thread cannot be started.
+         */
+        explicit batch_reader(const std::size_t queue_depth, const read_method method = read_method::automatic);
+
+        /// A reader owns kernel resources, so it cannot be copied.
+        batch_reader(const batch_reader&) = delete;
+
+        /**
+         * \brief       Move a reader.
+         * \param[in]   reader  The reader to move. It cannot be used afterwards.
+         * \throws      None
+         */
+        batch_reader(batch_reader&& reader) noexcept;
+
+        /**
+         * \brief   Wait for any reads in flight, and release the reader.
+         * \throws  None
+         */
+        ~batch_reader() noexcept;
+
+        /// A reader owns kernel resources, so it cannot be copied.
+        batch_reader& operator=(const batch_reader&) = delete;
+
+        /**
+         * \brief       Move a reader.
+         * \param[in]   reader  The reader to move. It cannot be used afterwards.
+         * \return      A reference to this reader.
+         * \throws      None
+         */
+        batch_reader& operator=(batch_reader&& reader) noexcept;
+
+        /**
+         * \brief   Query how the reader reads files.
+         * \return  read_method::io_uring or read_method::threads.
+         * \throws  None
+         */
+        read_method method() const noexcept;
+
+        /**
+         * \brief       Start reading a batch of files.
+         * \param[in]   paths   The files to read.
+         * \throws      std::bad_alloc  This is thrown if memory for the batch cannot be allocated.
+         * \details     Any files left from the previous batch are discarded.
+         */
+        void start(std::vector<std::string> paths);
+
+        /**
+         * \brief       Get the next file to finish reading, waiting for one if necessary.
+         * \param[out]  read    The file. Files are returned in the order they finish, not the
+         *                      order they were given.
+         * \retval      true    A file was returned.
+         * \retval      false   Every file in the batch has been returned.
+         * \throws      std::runtime_error  This is thrown if the io_uring fails.
+         * \throws      std::bad_alloc      This is thrown if memory for a file cannot be allocated.
+         */
+        bool next(file_read& read);
+
+        /// The interface of the io_uring and thread pool implementations.
+        class engine;
+
+    private:
+        std::unique_ptr<engine> m_engine; ///< The implementation.
+    };
+}
+
+#endif
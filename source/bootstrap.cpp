@@ -0,0 +1,216 @@
+#include "bootstrap.h"
+#include "splitmix.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace analyze
+{
+    namespace
+    {
+        /**
+         * \brief       A counter based random number stream.
+         * \details     The n-th number of a stream is a hash of the stream's key and n, so any
+         *              stream can be started anywhere without generating the numbers before it.
+         *              This is SplitMix64 with its state written as a counter.
+         */
+        class counter_stream final
+        {
+        public:
+            /**
+             * \brief       Start a stream.
+             * \param[in]   seed    The seed shared by every stream.
+             * \param[in]   stream  The number of this stream.
+             * \throws      None
+             */
+            counter_stream(const std::uint64_t seed, const std::uint64_t stream) noexcept
+                : m_key(splitmix_finalize(splitmix_finalize(seed + golden_gamma) ^ (stream * golden_gamma + 1)))
+            {
+            }
+
+            /**
+             * \brief       Draw an index.
+             * \param[in]   count   The number of indices. This must not be 0.
+             * \return      An index below \a count.
+             * \throws      None
+             * \details     The modulo bias is below \f$ count / 2^{64} \f$, which is far below the
+             *              resolution of any bootstrap.
+             */
+            std::size_t index(const std::size_t count) noexcept
+            {
+                return static_cast<std::size_t>(splitmix_finalize(m_key + ++m_counter * golden_gamma) % count);
+            }
+
+        private:
+            std::uint64_t m_key;         ///< Selects the stream.
+            std::uint64_t m_counter = 0; ///< The number of numbers drawn.
+        };
+
+        /**
+         * \brief       Check the scores and settings shared by the bootstrap functions.
+         * \param[in]   scores      The scores.
+         * \param[in]   options     The settings.
+         * \throws      std::invalid_argument   This is thrown if the scores or settings cannot be
+         *                                      used.
+         */
+        void validate(const span<const double> scores, const bootstrap_options& options)
+        {
+            if (scores.empty())
+                throw std::invalid_argument("the bootstrap needs at least one score");
+            // a NaN would reach the sort of the resampled statistics, which needs an ordering
+            if (!std::all_of(scores.begin(), scores.end(), [](const double s) { return std::isfinite(s); }))
+                throw std::invalid_argument("bootstrap scores must be finite");
+            if (options.resamples == 0)
+                throw std::invalid_argument("the bootstrap needs at least one resample");
+            if (!(options.confidence > 0.0 && options.confidence < 1.0))
+                throw std::invalid_argument("the confidence level must be between 0 and 1");
+        }
+
+        /**
+         * \brief       Find the mean of some numbers.
+         * \param[in]   values  The numbers. This must not be empty.
+         * \return      The mean.
+         * \throws      None
+         */
+        double mean_of(const span<const double> values) noexcept
+        {
+            double total = 0.0;
+            for (std::size_t i = 0; i < values.size(); ++i)
+                total += values[i];
+            return total / static_cast<double>(values.size());
+        }
+
+        /**
+         * \brief       Compute a statistic for every resample, spread over threads.
+         * \param[in]   count       The number of scores each resample draws.
+         * \param[in]   options     The bootstrap settings.
+         * \param[in]   statistic   Called with a resample's stream; it returns the resample's
+         *                          statistic. It must not throw.
+         * \return      The statistic of each resample, in resample order.
+         * \throws      std::bad_alloc  This is thrown if memory for the statistics cannot be
+         *                              allocated.
+         * \details     Each thread takes a contiguous range of resamples. A thread which cannot be
+         *              started leaves its range to the calling thread.
+         */
+        template <typename function>
+        std::vector<double> resample(const std::size_t count, const bootstrap_options& options, const function& statistic)
+        {
+            std::vector<double> statistics(options.resamples);
+            std::size_t threads = options.thread_count;
+            if (threads == 0)
+                threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+            // small bootstraps are not worth a thread
+            threads = std::max(std::min(threads, options.resamples * count / 4096), std::size_t(1));
+            const auto size  = (options.resamples + threads - 1) / threads;
+            const auto range = [&](const std::size_t t) {
+                const auto end = std::min(options.resamples, (t + 1) * size);
+                for (auto r = t * size; r < end; ++r)
+                {
+                    counter_stream stream(options.seed, r);
+                    statistics[r] = statistic(stream);
+                }
+            };
+
+            std::vector<std::thread> workers;
+            try
+            {
+                workers.reserve(threads - 1);
+                for (std::size_t t = 1; t < threads; ++t)
+                    workers.emplace_back(range, t);
+            }
+            catch (...)
+            {
+            }
+            range(0);
+            for (auto t = workers.size() + 1; t < threads; ++t)
+                range(t);
+            for (auto& w : workers)
+                w.join();
+            return statistics;
+        }
+
+        /**
+         * \brief       Find a percentile interval of resampled statistics.
+         * \param[in]   estimate    The statistic of the original scores.
+         * \param[in]   statistics  The resampled statistics. They are sorted.
+         * \param[in]   confidence  The confidence level.
+         * \return      The interval.
+         * \throws      None
+         */
+        bootstrap_interval percentile_interval(const double estimate, std::vector<double>& statistics, const double confidence) noexcept
+        {
+            std::sort(statistics.begin(), statistics.end());
+
+            // linear interpolation between the order statistics
+            const auto quantile = [&statistics](const double q) {
+                const auto position = q * static_cast<double>(statistics.size() - 1);
+                const auto below    = static_cast<std::size_t>(position);
+                const auto above    = std::min(below + 1, statistics.size() - 1);
+                const auto fraction = position - static_cast<double>(below);
+                return statistics[below] + fraction * (statistics[above] - statistics[below]);
+            };
+
+            bootstrap_interval interval;
+            interval.estimate = estimate;
+            interval.lower    = quantile((1.0 - confidence) / 2.0);
+            interval.upper    = quantile((1.0 + confidence) / 2.0);
+
+            const auto mean = mean_of(statistics);
+            double squares  = 0.0;
+            for (const auto s : statistics)
+                squares += (s - mean) * (s - mean);
+            if (statistics.size() > 1)
+                interval.standard_error = std::sqrt(squares / static_cast<double>(statistics.size() - 1));
+            return interval;
+        }
+    }
+
+    bootstrap_interval bootstrap_mean(const span<const double> scores, const bootstrap_options& options)
+    {
+        validate(scores, options);
+        auto statistics = resample(scores.size(), options, [scores](counter_stream& stream) {
+            double total = 0.0;
+            for (std::size_t i = 0; i < scores.size(); ++i)
+                total += scores[stream.index(scores.size())];
+            return total / static_cast<double>(scores.size());
+        });
+        return percentile_interval(mean_of(scores), statistics, options.confidence);
+    }
+
+    bootstrap_comparison bootstrap_paired(const span<const double> first,
+                                          const span<const double> second,
+                                          const bootstrap_options& options)
+    {
+        if (first.size() != second.size())
+            throw std::invalid_argument("paired scores must be for the same sequences");
+        validate(first, options);
+        validate(second, options);
+
+        // one index picks the same sequence for both trackers
+        auto statistics = resample(first.size(), options, [first, second](counter_stream& stream) {
+            double total = 0.0;
+            for (std::size_t i = 0; i < first.size(); ++i)
+            {
+                const auto s = stream.index(first.size());
+                total += first[s] - second[s];
+            }
+            return total / static_cast<double>(first.size());
+        });
+
+        bootstrap_comparison comparison;
+        const auto observed = mean_of(first) - mean_of(second);
+        std::size_t below = 0, above = 0;
+        for (const auto s : statistics)
+        {
+            below += s <= 0.0;
+            above += s >= 0.0;
+        }
+        const auto far_side = static_cast<double>(std::min(below, above) + 1);
+        comparison.p_value    = std::min(1.0, 2.0 * far_side / static_cast<double>(statistics.size() + 1));
+        comparison.difference = percentile_interval(observed, statistics, options.confidence);
+        return comparison;
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef ANALYZE_BOOTSTRAP_H
+#define ANALYZE_BOOTSTRAP_H
+
+#include "span.h"
+#include <cstdint>
+
+namespace analyze
+{
+    /// The settings for the bootstrap functions.
+    struct bootstrap_options final
+    {
+        std::size_t   resamples    = 10000; ///< The number of bootstrap resamples.
+        double        confidence   = 0.95;  ///< The confidence level of the intervals.
+        unsigned      thread_count = 0;     ///< The number of threads; 0 uses one per processor.
+        std::uint64_t seed         = 0;     ///< Chooses the resamples.
+    };
+
+    /// A bootstrap percentile confidence interval.
+    struct bootstrap_interval final
+    {
+        double estimate       = 0.0; ///< The statistic of the original scores.
+        double lower          = 0.0; ///< The lower end of the interval.
+        double upper          = 0.0; ///< The upper end of the interval.
+        double standard_error = 0.0; ///< The standard deviation of the resampled statistics.
+    };
+
+    /// The result of a paired bootstrap comparison of two trackers.
+    struct bootstrap_comparison final
+    {
+        bootstrap_interval difference; ///< The interval of the first mean less the second.
+        double             p_value = 1.0; ///< The two sided significance of the difference.
+    };
+
+    /**
+     * \brief       Find a bootstrap confidence interval of a tracker's mean score.
+     * \param[in]   scores      One score for each sequence, such as its mean IoU.
+     * \param[in]   options     The bootstrap settings.
+     * \return      The mean of \a scores and its percentile interval.
+     * \throws      std::invalid_argument   This is thrown if \a scores is empty or holds a value
+     *                                      which is not finite, if there are no resamples, or if
+     *                                      the confidence is not between 0 and 1.
+     * \throws      std::bad_alloc          This is thrown if memory for the resampled means cannot
+     *                                      be allocated.
+     * \details     Each resample draws as many sequences as there are scores, with replacement.
+     *              Resample \a r draws its sequences from a counter based generator keyed by the
+     *              seed and \a r alone, so the resamples, and the interval, are the same however
+     *              many threads share the work. A thread which cannot be started leaves its share
+     *              to the calling thread.
+     */
+    bootstrap_interval bootstrap_mean(span<const double> scores, const bootstrap_options& options);
+
+    /**
+     * \brief       Compare two trackers with a paired bootstrap.
+     * \param[in]   first       The first tracker's score for each sequence.
+     * \param[in]   second      The second tracker's score for the same sequences, in the same order.
+     * \param[in]   options     The bootstrap settings.
+     * \return      The interval of the difference of the means, and the significance of the
+     *              difference.
+     * \throws      std::invalid_argument   This is thrown if the lists are empty or have different
+     *                                      lengths, or for the same reasons as bootstrap_mean().
+     * \throws      std::bad_alloc          This is thrown if memory for the resampled differences
+     *                                      cannot be allocated.
+     * \details     Both trackers are resampled with the same sequences, so the difference in how
+     *              hard the sequences are cancels out. The p value is twice the fraction of
+     *              resampled differences on the far side of zero from the observed difference, with
+     *              the usual one added to each count so it is never 0.
+     */
+    bootstrap_comparison bootstrap_paired(span<const double> first,
+                                          span<const double> second,
+                                          const bootstrap_options& options);
+}
+
+#endif
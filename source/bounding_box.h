@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <vector>
 
 namespace analyze
 {
@@ -117,6 +118,9 @@ namespace analyze
     /// Alias a bounding box type based on integer data.
     using integer_box = bounding_box<int>;
 
+    /// Alias the type representing a list of bounding boxes.
+    using box_list = std::vector<bounding_box<float>>;
+
     /**
      * \brief       Calculate the area of a bounding box.
      * \tparam      T       The data type of the bounding box coordinates.
@@ -0,0 +1,355 @@
+#include "box_format.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace analyze
+{
+    namespace
+    {
+        /**
+         * \brief       Determine if a character separates values.
+         * \tparam      delimiter   The dialect's delimiter.
+         * \param[in]   c           The character.
+         * \retval      true        \a c is the delimiter, or white space other than a new line.
+         * \retval      false       \a c is part of a value, or ends the line.
+         * \throws      None
+         */
+        template <char delimiter>
+        bool is_separator(const char c) noexcept
+        {
+            return c == delimiter || c == ' ' || c == '\t' || c == '\r';
+        }
+
+        /**
+         * \brief       Skip the separators before a value.
+         * \tparam      delimiter   The dialect's delimiter.
+         * \param[in]   p           The first character to check.
+         * \return      The first character which is not a separator.
+         * \throws      None
+         */
+        template <char delimiter>
+        const char* skip_separators(const char* p) noexcept
+        {
+            while (is_separator<delimiter>(*p))
+                ++p;
+            return p;
+        }
+
+        /**
+         * \brief       Describes how a convention's values make a box.
+         * \tparam      convention  The convention.
+         */
+        template <box_convention convention>
+        struct convention_traits;
+
+        /// The original format: left, width, top, height.
+        template <>
+        struct convention_traits<box_convention::left_width_top_height>
+        {
+            static constexpr std::size_t values = 4; ///< The values on a line.
+
+            /**
+             * \brief       Make a box.
+             * \param[in]   v   The line's values.
+             * \return      The box.
+             * \throws      None
+             */
+            static bounding_box<float> make(const float* v) noexcept { return {v[0], v[0] + v[1], v[2], v[2] + v[3]}; }
+
+            /**
+             * \brief       Check the box's size.
+             * \param[in]   v   The line's values, which are finite.
+             * \retval      true    The width and height are not negative.
+             * \retval      false   The width or height is negative.
+             * \throws      None
+             */
+            static bool sizes_valid(const float* v) noexcept { return v[1] >= 0.0f && v[3] >= 0.0f; }
+
+            /**
+             * \brief           Make negative sizes 0.
+             * \param[in,out]   v   The line's values, which are finite.
+             * \throws          None
+             */
+            static void clamp_sizes(float* v) noexcept
+            {
+                v[1] = std::max(v[1], 0.0f);
+                v[3] = std::max(v[3], 0.0f);
+            }
+        };
+
+        /// The OTB format: x, y, w, h.
+        template <>
+        struct convention_traits<box_convention::left_top_width_height>
+        {
+            static constexpr std::size_t values = 4; ///< The values on a line.
+
+            /// \copydoc convention_traits<box_convention::left_width_top_height>::make()
+            static bounding_box<float> make(const float* v) noexcept { return {v[0], v[0] + v[2], v[1], v[1] + v[3]}; }
+
+            /// \copydoc convention_traits<box_convention::left_width_top_height>::sizes_valid()
+            static bool sizes_valid(const float* v) noexcept { return v[2] >= 0.0f && v[3] >= 0.0f; }
+
+            /// \copydoc convention_traits<box_convention::left_width_top_height>::clamp_sizes()
+            static void clamp_sizes(float* v) noexcept
+            {
+                v[2] = std::max(v[2], 0.0f);
+                v[3] = std::max(v[3], 0.0f);
+            }
+        };
+
+        /// Two corners: x1, y1, x2, y2.
+        template <>
+        struct convention_traits<box_convention::corners>
+        {
+            static constexpr std::size_t values = 4; ///< The values on a line.
+
+            /// \copydoc convention_traits<box_convention::left_width_top_height>::make()
+            static bounding_box<float> make(const float* v) noexcept { return {v[0], v[2], v[1], v[3]}; }
+
+            /// \copydoc convention_traits<box_convention::left_width_top_height>::sizes_valid()
+            static bool sizes_valid(const float* v) noexcept { return v[2] >= v[0] && v[3] >= v[1]; }
+
+            /// \copydoc convention_traits<box_convention::left_width_top_height>::clamp_sizes()
+            static void clamp_sizes(float* v) noexcept
+            {
+                v[2] = std::max(v[2], v[0]);
+                v[3] = std::max(v[3], v[1]);
+            }
+        };
+
+        /// Four corners of a polygon.
+        template <>
+        struct convention_traits<box_convention::polygon>
+        {
+            static constexpr std::size_t values = 8; ///< The values on a line.
+
+            /// \copydoc convention_traits<box_convention::left_width_top_height>::make()
+            static bounding_box<float> make(const float* v) noexcept
+            {
+                return {std::min(std::min(v[0], v[2]), std::min(v[4], v[6])),
+                        std::max(std::max(v[0], v[2]), std::max(v[4], v[6])),
+                        std::min(std::min(v[1], v[3]), std::min(v[5], v[7])),
+                        std::max(std::max(v[1], v[3]), std::max(v[5], v[7]))};
+            }
+
+            /// A polygon's bounding box never has a negative size.
+            static bool sizes_valid(const float*) noexcept { return true; }
+
+            /// A polygon's bounding box never has a negative size.
+            static void clamp_sizes(float*) noexcept {}
+        };
+
+        /**
+         * \brief       Report an invalid line.
+         * \param[in]   status  The parser's status; the line is the current one.
+         * \param[in]   problem What is wrong with the line.
+         * \throws      std::runtime_error  This is always thrown.
+         */
+        [[noreturn]] void invalid_line(const parse_status& status, const char* const problem)
+        {
+            throw std::runtime_error("line " + std::to_string(status.line) + ": " + problem);
+        }
+
+        /**
+         * \brief   Parse lines of one dialect. See box_parser.
+         * \tparam  delimiter   The dialect's delimiter.
+         * \tparam  convention  The dialect's convention.
+         * \tparam  validate    False for validation_policy::none, true for the other policies.
+         */
+        template <char delimiter, box_convention convention, bool validate>
+        std::size_t parse_boxes(const char*& position,
+                                const char* const end,
+                                box_list& boxes,
+                                const std::size_t count,
+                                parse_status& status)
+        {
+            using traits = convention_traits<convention>;
+            std::size_t parsed = 0;
+            const char* line = position;
+            while (parsed < count && line < end)
+            {
+                auto line_end = static_cast<const char*>(std::memchr(line, '\n', static_cast<std::size_t>(end - line)));
+                if (line_end == nullptr)
+                    line_end = end;
+                const auto next = line_end == end ? end : line_end + 1;
+                ++status.line;
+
+                auto p = skip_separators<delimiter>(line);
+                if (p >= line_end)
+                {
+                    line = next;
+                    continue;
+                }
+
+                float values[traits::values];
+                std::size_t found = 0;
+                for (; found < traits::values; ++found)
+                {
+                    // strtof() skips leading white space, including the new line, so a missing
+                    // value could otherwise take the first one of the next line
+                    char* value_end = nullptr;
+                    values[found] = std::strtof(p, &value_end);
+                    if (value_end == p || value_end > line_end)
+                        break;
+                    p = skip_separators<delimiter>(value_end);
+                }
+
+                if (!validate)
+                {
+                    if (found < traits::values)
+                    {
+                        status.stopped = true;
+                        position = line;
+                        return parsed;
+                    }
+                }
+                else
+                {
+                    // the checks run on every line, but the policy is only consulted on failure
+                    const char* problem = nullptr;
+                    if (found < traits::values || p < line_end)
+                        problem = traits::values == 8 ? "expected 8 numbers" : "expected 4 numbers";
+                    else if (!std::all_of(values, values + traits::values, [](const float v) { return std::isfinite(v); }))
+                        problem = "a value is not finite";
+                    else if (!traits::sizes_valid(values))
+                        problem = "the width or height is negative";
+
+                    if (problem != nullptr)
+                    {
+                        if (status.policy == validation_policy::skip)
+                        {
+                            ++status.skipped;
+                            line = next;
+                            continue;
+                        }
+                        if (status.policy != validation_policy::clamp || found < traits::values || p < line_end)
+                            invalid_line(status, problem);
+                        for (auto& v : values)
+                            v = std::isfinite(v) ? v : 0.0f;
+                        traits::clamp_sizes(values);
+                        ++status.clamped;
+                    }
+                }
+                boxes.push_back(traits::make(values));
+                ++parsed;
+                line = next;
+            }
+            position = line;
+            return parsed;
+        }
+
+        /**
+         * \brief       Count the leading values of a line, up to eight.
+         * \param[in]   line        The first character of the line.
+         * \param[in]   line_end    The end of the line.
+         * \return      The number of values.
+         * \throws      None
+         */
+        std::size_t count_values(const char* line, const char* const line_end) noexcept
+        {
+            std::size_t count = 0;
+            auto p = skip_separators<','>(line);
+            while (count < 8 && p < line_end)
+            {
+                char* value_end = nullptr;
+                std::strtod(p, &value_end);
+                if (value_end == p || value_end > line_end)
+                    break;
+                ++count;
+                p = skip_separators<','>(value_end);
+            }
+            return count;
+        }
+    }
+
+    validation_policy parse_validation_policy(const std::string& name)
+    {
+        if (name == "none")
+            return validation_policy::none;
+        if (name == "fail")
+            return validation_policy::fail;
+        if (name == "skip")
+            return validation_policy::skip;
+        if (name == "clamp")
+            return validation_policy::clamp;
+        throw std::invalid_argument("unknown validation policy " + name);
+    }
+
+    box_convention parse_box_convention(const std::string& name)
+    {
+        if (name == "lwth")
+            return box_convention::left_width_top_height;
+        if (name == "xywh")
+            return box_convention::left_top_width_height;
+        if (name == "xyxy")
+            return box_convention::corners;
+        if (name == "polygon")
+            return box_convention::polygon;
+        throw std::invalid_argument("unknown box convention " + name);
+    }
+
+    box_format detect_box_format(const char* const data, const std::size_t size, const box_convention convention) noexcept
+    {
+        box_format format;
+        format.convention = convention;
+        const auto end = data + size;
+        for (const char* line = data; line < end;)
+        {
+            auto line_end = static_cast<const char*>(std::memchr(line, '\n', static_cast<std::size_t>(end - line)));
+            if (line_end == nullptr)
+                line_end = end;
+            const auto count = count_values(line, line_end);
+            if (count > 0)
+            {
+                const auto length = static_cast<std::size_t>(line_end - line);
+                if (std::memchr(line, ',', length) != nullptr)
+                    format.delimiter = box_delimiter::comma;
+                else if (std::memchr(line, '\t', length) != nullptr)
+                    format.delimiter = box_delimiter::tab;
+                else
+                    format.delimiter = box_delimiter::space;
+                if (count >= 8)
+                    format.convention = box_convention::polygon;
+                return format;
+            }
+            line = line_end == end ? end : line_end + 1;
+        }
+        return format;
+    }
+
+    box_parser select_box_parser(const box_format& format, const validation_policy policy) noexcept
+    {
+        // one instantiation for each dialect, with and without validation
+        static const box_parser parsers[2][3][4] = {
+            {{parse_boxes<',', box_convention::left_width_top_height, false>,
+              parse_boxes<',', box_convention::left_top_width_height, false>,
+              parse_boxes<',', box_convention::corners, false>,
+              parse_boxes<',', box_convention::polygon, false>},
+             {parse_boxes<'\t', box_convention::left_width_top_height, false>,
+              parse_boxes<'\t', box_convention::left_top_width_height, false>,
+              parse_boxes<'\t', box_convention::corners, false>,
+              parse_boxes<'\t', box_convention::polygon, false>},
+             {parse_boxes<' ', box_convention::left_width_top_height, false>,
+              parse_boxes<' ', box_convention::left_top_width_height, false>,
+              parse_boxes<' ', box_convention::corners, false>,
+              parse_boxes<' ', box_convention::polygon, false>}},
+            {{parse_boxes<',', box_convention::left_width_top_height, true>,
+              parse_boxes<',', box_convention::left_top_width_height, true>,
+              parse_boxes<',', box_convention::corners, true>,
+              parse_boxes<',', box_convention::polygon, true>},
+             {parse_boxes<'\t', box_convention::left_width_top_height, true>,
+              parse_boxes<'\t', box_convention::left_top_width_height, true>,
+              parse_boxes<'\t', box_convention::corners, true>,
+              parse_boxes<'\t', box_convention::polygon, true>},
+             {parse_boxes<' ', box_convention::left_width_top_height, true>,
+              parse_boxes<' ', box_convention::left_top_width_height, true>,
+              parse_boxes<' ', box_convention::corners, true>,
+              parse_boxes<' ', box_convention::polygon, true>}}};
+        return parsers[policy == validation_policy::none ? 0 : 1][static_cast<std::size_t>(format.delimiter)]
+                      [static_cast<std::size_t>(format.convention)];
+    }
+}
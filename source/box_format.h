@@ -0,0 +1,136 @@
+#ifndef ANALYZE_BOX_FORMAT_H
+#define ANALYZE_BOX_FORMAT_H
+
+#include "bounding_box.h"
+#include <cstddef>
+#include <string>
+
+namespace analyze
+{
+    /// The characters which separate the values of a bounding box file.
+    enum class box_delimiter
+    {
+        comma, ///< Commas, with optional white space around them.
+        tab,   ///< Tabs or spaces.
+        space  ///< Spaces or tabs.
+    };
+
+    /// The meanings of the values on a line of a bounding box file.
+    enum class box_convention
+    {
+        left_width_top_height, ///< The original format of this program: left, width, top, height.
+        left_top_width_height, ///< OTB, LaSOT, and GOT-10k: x, y, w, h.
+        corners,               ///< x1, y1, x2, y2; the top left and bottom right corners.
+        polygon                ///< Eight values, the x and y of four corners. The box is the
+                               ///< polygon's axis aligned bounding box.
+    };
+
+    /// The dialect of a bounding box file.
+    struct box_format final
+    {
+        box_delimiter  delimiter  = box_delimiter::comma;                  ///< The value separator.
+        box_convention convention = box_convention::left_width_top_height; ///< The value meanings.
+    };
+
+    /// What a box parser does with a line which is not valid.
+    enum class validation_policy
+    {
+        none,  ///< Trust the values. The data ends at the first line without enough values.
+        fail,  ///< Throw std::runtime_error, naming the line and the problem.
+        skip,  ///< Leave the line out. The boxes after it move to earlier frames.
+        clamp  ///< Replace values which are not finite with 0, and negative sizes with 0. A line
+               ///< with the wrong number of values still fails.
+    };
+
+    /// The progress of a box parser through some text.
+    struct parse_status final
+    {
+        validation_policy policy  = validation_policy::fail; ///< What to do with invalid lines.
+        std::size_t       line    = 0;     ///< The lines parsed so far, including blank lines.
+        std::size_t       skipped = 0;     ///< The lines left out by validation_policy::skip.
+        std::size_t       clamped = 0;     ///< The lines repaired by validation_policy::clamp.
+        bool              stopped = false; ///< True if validation_policy::none found a malformed
+                                           ///< line, which ends the data.
+    };
+
+    /**
+     * \brief       Parse the name of a validation policy.
+     * \param[in]   name    One of none, fail, skip, or clamp.
+     * \return      The policy.
+     * \throws      std::invalid_argument   This is thrown if \a name is not a policy.
+     */
+    validation_policy parse_validation_policy(const std::string& name);
+
+    /**
+     * \brief       Parse the name of a box convention.
+     * \param[in]   name    lwth for the original format, xywh for x, y, width, and height, xyxy for
+     *                      two corners, or polygon.
+     * \return      The convention.
+     * \throws      std::invalid_argument   This is thrown if \a name is not a convention.
+     */
+    box_convention parse_box_convention(const std::string& name);
+
+    /**
+     * \brief       Identify the dialect of bounding box text from its first line.
+     * \param[in]   data        The start of the text. The text must be followed, somewhere at or
+     *                          after \a data + \a size, by a null character, as a std::string is.
+     * \param[in]   size        The number of characters to examine.
+     * \param[in]   convention  The convention of four value lines, which the caller knows from the
+     *                          dataset. It is not guessed from the values, so the results and the
+     *                          ground truth of a sequence are always read the same way.
+     * \return      The dialect. Empty text is given a comma delimiter.
+     * \throws      None
+     * \details     The delimiter is a comma if the first line which has a value has a comma,
+     *              otherwise a tab if it has one, otherwise a space. A line of eight or more
+     *              values can only be a polygon, so that line makes the convention
+     *              box_convention::polygon whatever \a convention is.
+     */
+    box_format detect_box_format(const char* data,
+                                 const std::size_t size,
+                                 const box_convention convention = box_convention::left_width_top_height) noexcept;
+
+    /**
+     * \brief           Parses the lines of bounding box text in one dialect.
+     * \param[in,out]   position    The first character to parse. On return, this is the first
+     *                              character which was not parsed.
+     * \param[in]       end         The end of the text to parse. Only whole lines are parsed, so
+     *                              unless this is the end of the data, it must follow a new line.
+     *                              The text must be followed by a null character somewhere at or
+     *                              after \a end.
+     * \param[in,out]   boxes       The boxes are appended to this list.
+     * \param[in]       count       The most boxes to parse.
+     * \param[in,out]   status      The validation policy, and the line count and repairs so far.
+     *                              Pass the same status for each piece of the same text, so the
+     *                              line numbers are right.
+     * \return          The number of boxes appended.
+     * \throws          std::runtime_error  This is thrown, under validation_policy::fail or
+     *                                      validation_policy::clamp, if a line is invalid. The
+     *                                      message gives the line number and the problem.
+     * \throws          std::bad_alloc      This is thrown if memory for the boxes cannot be
+     *                                      allocated.
+     * \details         Blank lines are skipped. When validating, a line is invalid if it does not
+     *                  have exactly the values its dialect needs, if a value is not finite, or if
+     *                  a width or height is negative. Without validation, values past those the
+     *                  dialect needs are ignored, and a line without enough values sets
+     *                  parse_status::stopped.
+     */
+    using box_parser = std::size_t (*)(const char*& position,
+                                       const char* end,
+                                       box_list& boxes,
+                                       std::size_t count,
+                                       parse_status& status);
+
+    /**
+     * \brief       Get the parser of a dialect.
+     * \param[in]   format      The dialect.
+     * \param[in]   policy      The validation policy the parser will be given.
+     * \return      The parser. Each dialect has its own instantiation of one template, with the
+     *              delimiter, convention, and whether to validate as template parameters, so
+     *              choosing the dialect costs one call through a pointer for each batch of lines,
+     *              not a branch for each value.
+     * \throws      None
+     */
+    box_parser select_box_parser(const box_format& format, const validation_policy policy) noexcept;
+}
+
+#endif
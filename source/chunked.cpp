@@ -0,0 +1,62 @@
+#include "chunked.h"
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace analyze
+{
+    chunked_summary evaluate_chunked(const std::string& results_file,
+                                     const std::string& truth_file,
+                                     const std::string& output_file,
+                                     const std::size_t chunk_size,
+                                     const box_convention convention,
+                                     const validation_policy policy)
+    {
+        // whole strides per window keep every window's first frame on the sampling grid
+        const auto window = std::max((chunk_size + iou_stride - 1) / iou_stride, std::size_t(1)) * iou_stride;
+
+        box_reader results(results_file, policy, convention);
+        box_reader truth(truth_file, policy, convention);
+        std::ofstream file(output_file.c_str());
+        if (!file)
+            throw std::runtime_error("could not open " + output_file + " for writing IoU data");
+
+        box_list result_boxes, truth_boxes;
+        result_boxes.reserve(window);
+        truth_boxes.reserve(window);
+        iou_list ious(window / iou_stride);
+
+        // summarize() splits the series into fixed blocks, so windows do not change the result
+        chunked_summary outcome;
+        iou_accumulator accumulator;
+        std::size_t result_count = 0, truth_count = 0;
+        do
+        {
+            result_boxes.clear();
+            truth_boxes.clear();
+            result_count = results.read(result_boxes, window);
+            truth_count  = truth.read(truth_boxes, window);
+            outcome.results_count += result_count;
+            outcome.truth_count   += truth_count;
+
+            const auto count = calculate_ious(result_boxes, truth_boxes, ious, iou_stride, 0);
+            accumulator.add(span<const iou>(ious.data(), count));
+            for (std::size_t i = 0; i < count; ++i)
+                file << ious[i].value() << '\n';
+        }
+        while (result_count == window || truth_count == window);
+
+        outcome.summary = accumulator.summary();
+        const auto& summary = outcome.summary;
+        if (summary.count > 0)
+        {
+            file << "minimum: "   << summary.minimum
+                 << "\nmaximum: " << summary.maximum
+                 << "\naverage: " << summary.average;
+        }
+        file.flush();
+        if (!file)
+            throw std::runtime_error("could not write " + output_file);
+        return outcome;
+    }
+}
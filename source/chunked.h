@@ -0,0 +1,48 @@
+#ifndef ANALYZE_CHUNKED_H
+#define ANALYZE_CHUNKED_H
+
+#include "analysis.h"
+#include <string>
+
+namespace analyze
+{
+    /// The outcome of a chunked evaluation.
+    struct chunked_summary final
+    {
+        iou_summary summary;           ///< The statistics of the IoU series.
+        std::size_t results_count = 0; ///< The number of result boxes in the results file.
+        std::size_t truth_count   = 0; ///< The number of ground truth boxes.
+    };
+
+    /**
+     * \brief       Evaluate a sequence a window at a time, without loading it.
+     * \param[in]   results_file    The tracker results file.
+     * \param[in]   truth_file      The ground truth file.
+     * \param[in]   output_file     The .ious file to write.
+     * \param[in]   chunk_size      The number of boxes of each file to hold at once. This is
+     *                              rounded up to a multiple of iou_stride, and 0 is treated as
+     *                              iou_stride.
+     * \param[in]   convention      The convention of four value lines in both files.
+     * \param[in]   policy          What to do with lines of either file which are not valid; see
+     *                              box_reader.
+     * \return      The statistics of the IoU series, and the length of each file.
+     * \throws      std::runtime_error  This is thrown if a file cannot be opened or read, if a line
+     *                                  is not valid and \a policy is validation_policy::fail, or if
+     *                                  the output cannot be written.
+     * \throws      std::bad_alloc      This is thrown if memory for a window cannot be allocated.
+     * \details     Both files are read with box_reader, in windows which start at the same frame.
+     *              Each window's IoUs are calculated with calculate_ious() and appended to the
+     *              output as soon as they are known, and the statistics are kept by an
+     *              iou_accumulator, so the output file is byte for byte the one write_ious() writes for
+     *              calculate_ious() of the two files loaded with load_results(). Memory
+     *              use depends only on \a chunk_size.
+     */
+    chunked_summary evaluate_chunked(const std::string& results_file,
+                                     const std::string& truth_file,
+                                     const std::string& output_file,
+                                     const std::size_t chunk_size,
+                                     const box_convention convention = box_convention::left_width_top_height,
+                                     const validation_policy policy = validation_policy::fail);
+}
+
+#endif
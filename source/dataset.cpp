@@ -0,0 +1,395 @@
+#include "dataset.h"
+#include <algorithm>
+#include <dirent.h>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <sys/stat.h>
+
+namespace analyze
+{
+    namespace
+    {
+        /**
+         * \brief       List the entries of a directory.
+         * \param[in]   directory   The directory to list.
+         * \return      The entry names, sorted, without . and ..
+         * \throws      std::runtime_error  This is thrown if the directory cannot be read.
+         */
+        std::vector<std::string> list_directory(const std::string& directory)
+        {
+            DIR* const d = opendir(directory.c_str());
+            if (d == nullptr)
+                throw std::runtime_error("could not read directory " + directory);
+
+            std::vector<std::string> names;
+            while (const dirent* entry = readdir(d))
+            {
+                const std::string name(entry->d_name);
+                if (name != "." && name != "..")
+                    names.push_back(name);
+            }
+            closedir(d);
+            std::sort(names.begin(), names.end());
+            return names;
+        }
+
+        /**
+         * \brief       Determine if a regular file exists.
+         * \param[in]   path    The path to check.
+         * \retval      true    \a path is a regular file.
+         * \retval      false   \a path does not exist, or is not a regular file.
+         * \throws      None
+         */
+        bool is_file(const std::string& path) noexcept
+        {
+            struct stat status;
+            return stat(path.c_str(), &status) == 0 && S_ISREG(status.st_mode);
+        }
+    }
+
+    dataset_layout parse_layout(const std::string& name)
+    {
+        if (name == "struck")
+            return dataset_layout::struck;
+        if (name == "otb")
+            return dataset_layout::otb;
+        if (name == "lasot")
+            return dataset_layout::lasot;
+        if (name == "got10k")
+            return dataset_layout::got10k;
+        if (name == "trackingnet")
+            return dataset_layout::trackingnet;
+        throw std::invalid_argument("unknown dataset layout " + name);
+    }
+
+    std::string ground_truth_path(const dataset_layout layout, const std::string& root, const std::string& sequence)
+    {
+        switch (layout)
+        {
+            case dataset_layout::struck:
+                return root + "/" + sequence + "/" + sequence + "_gt.txt";
+            case dataset_layout::otb:
+                return root + "/" + sequence + "/groundtruth_rect.txt";
+            case dataset_layout::lasot:
+                // LaSOT groups sequences by class: airplane/airplane-1
+                return root + "/" + sequence.substr(0, sequence.rfind('-')) + "/" + sequence + "/groundtruth.txt";
+            case dataset_layout::got10k:
+                return root + "/" + sequence + "/groundtruth.txt";
+            case dataset_layout::trackingnet:
+                return root + "/anno/" + sequence + ".txt";
+        }
+        return std::string();
+    }
+
+    box_convention layout_convention(const dataset_layout layout) noexcept
+    {
+        return layout == dataset_layout::struck ? box_convention::left_width_top_height
+                                                : box_convention::left_top_width_height;
+    }
+
+    //-------------------------------------------------------
+    //                        dataset_manifest class methods
+    //-------------------------------------------------------
+    dataset_manifest::dataset_manifest(const dataset_layout layout,
+                                       std::string root,
+                                       std::string results_directory,
+                                       std::string results_extension)
+        : m_layout(layout),
+          m_convention(layout_convention(layout)),
+          m_root(std::move(root)),
+          m_results(std::move(results_directory)),
+          m_extension(std::move(results_extension))
+    {
+        if (!m_results.empty() && m_results.back() != '/')
+            m_results += '/';
+    }
+
+    void dataset_manifest::add(const std::string& sequence)
+    {
+        m_sequences.push_back(sequence_paths {sequence,
+                                              m_results + sequence + m_extension,
+                                              ground_truth_path(m_layout, m_root, sequence),
+                                              m_results + sequence + ".ious",
+                                              m_convention});
+    }
+
+    void dataset_manifest::convention(const box_convention convention) noexcept
+    {
+        m_convention = convention;
+        for (auto& s : m_sequences)
+            s.convention = convention;
+    }
+
+    void dataset_manifest::discover()
+    {
+        std::vector<std::string> names;
+        if (m_layout == dataset_layout::trackingnet)
+        {
+            for (const auto& file : list_directory(m_root + "/anno"))
+            {
+                if (file.size() > 4 && file.compare(file.size() - 4, 4, ".txt") == 0)
+                    names.push_back(file.substr(0, file.size() - 4));
+            }
+        }
+        else if (m_layout == dataset_layout::lasot)
+        {
+            for (const auto& group : list_directory(m_root))
+            {
+                if (is_file(m_root + "/" + group))
+                    continue;
+                for (const auto& sequence : list_directory(m_root + "/" + group))
+                    names.push_back(sequence);
+            }
+        }
+        else
+            names = list_directory(m_root);
+
+        for (const auto& name : names)
+        {
+            if (is_file(ground_truth_path(m_layout, m_root, name)))
+                add(name);
+        }
+    }
+
+    dataset_manifest load_manifest(const std::string& file_name)
+    {
+        std::ifstream file(file_name.c_str());
+        if (!file)
+            throw std::runtime_error("could not open manifest " + file_name);
+
+        std::string layout, root, results, extension = ".boxes", convention;
+        std::vector<std::string> sequences;
+        std::string line;
+        for (std::size_t number = 1; std::getline(file, line); ++number)
+        {
+            std::istringstream words(line);
+            std::string keyword, value;
+            words >> keyword;
+            if (keyword.empty() || keyword[0] == '#')
+                continue;
+            std::getline(words >> std::ws, value);
+            while (!value.empty() && (value.back() == ' ' || value.back() == '\t' || value.back() == '\r'))
+                value.pop_back();
+            if (value.empty())
+                throw std::runtime_error(file_name + ":" + std::to_string(number) + ": " + keyword + " needs a value");
+
+            if (keyword == "layout")
+                layout = value;
+            else if (keyword == "root")
+                root = value;
+            else if (keyword == "results")
+                results = value;
+            else if (keyword == "extension")
+                extension = value;
+            else if (keyword == "convention")
+                convention = value;
+            else if (keyword == "sequence")
+                sequences.push_back(value);
+            else
+                throw std::runtime_error(file_name + ":" + std::to_string(number) + ": unknown keyword " + keyword);
+        }
+        if (layout.empty() || root.empty())
+            throw std::runtime_error(file_name + ": a manifest needs a layout and a root");
+
+        try
+        {
+            dataset_manifest manifest(parse_layout(layout), root, results, extension);
+            if (!convention.empty())
+                manifest.convention(parse_box_convention(convention));
+            if (sequences.empty())
+                manifest.discover();
+            for (const auto& s : sequences)
+                manifest.add(s);
+            return manifest;
+        }
+        catch (std::invalid_argument& e)
+        {
+            throw std::runtime_error(file_name + ": " + e.what());
+        }
+    }
+
+    //-------------------------------------------------------
+    //                     sequence_prefetcher class methods
+    //-------------------------------------------------------
+    sequence_prefetcher::sequence_prefetcher(const std::vector<sequence_paths>& sequences,
+                                             const std::size_t depth,
+                                             const unsigned thread_count,
+                                             const read_method method,
+                                             const validation_policy policy,
+                                             stored_check check)
+        : m_sequences(sequences),
+          m_policy(policy),
+          m_check(std::move(check)),
+          m_slots(std::max(depth, std::size_t(1))),
+          m_ready(m_slots.size(), false)
+    {
+        // two files for each sequence
+        for (unsigned t = 0; t < std::max(thread_count, 1u); ++t)
+            m_readers.emplace_back(2 * m_slots.size(), method);
+        try
+        {
+            for (auto& r : m_readers)
+                m_workers.emplace_back(&sequence_prefetcher::work, this, std::ref(r));
+        }
+        catch (...)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopping = true;
+            }
+            m_freed.notify_all();
+            for (auto& w : m_workers)
+                w.join();
+            throw;
+        }
+    }
+
+    sequence_prefetcher::~sequence_prefetcher() noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_freed.notify_all();
+        for (auto& w : m_workers)
+        {
+            if (w.joinable())
+                w.join();
+        }
+    }
+
+    bool sequence_prefetcher::next(loaded_sequence& sequence) noexcept
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_consumed == m_sequences.size())
+            return false;
+
+        const auto slot = m_consumed % m_slots.size();
+        m_loaded.wait(lock, [this, slot]() { return m_ready[slot]; });
+        sequence = std::move(m_slots[slot]);
+        m_ready[slot] = false;
+        ++m_consumed;
+        lock.unlock();
+        m_freed.notify_all();
+        return true;
+    }
+
+    void sequence_prefetcher::work(batch_reader& reader) noexcept
+    {
+        while (true)
+        {
+            std::size_t first = 0, count = 0;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_freed.wait(lock, [this]() {
+                    return m_stopping || m_claimed == m_sequences.size() || m_claimed < m_consumed + m_slots.size();
+                });
+                if (m_stopping || m_claimed == m_sequences.size())
+                    return;
+                first = m_claimed;
+                count = std::min(m_consumed + m_slots.size(), m_sequences.size()) - first;
+                m_claimed += count;
+            }
+
+            std::vector<loaded_sequence> batch(count);
+            std::vector<unsigned> remaining(count, 2);
+            std::vector<std::string> held(m_check ? 2 * count : 0); // bytes waiting for the check
+            try
+            {
+                std::vector<std::string> paths;
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    batch[i].paths = &m_sequences[first + i];
+                    paths.push_back(batch[i].paths->results);
+                    paths.push_back(batch[i].paths->ground_truth);
+                }
+                reader.start(paths);
+
+                const auto parse = [this, &paths](loaded_sequence& loaded, const std::size_t index, const std::string& bytes) {
+                    try
+                    {
+                        (index % 2 == 0 ? loaded.results : loaded.ground_truth) = parse_results(bytes, m_policy, loaded.paths->convention);
+                    }
+                    catch (std::runtime_error& e)
+                    {
+                        // a corrupt compressed file, or an invalid line, only fails its own sequence
+                        if (loaded.error.empty())
+                            loaded.error = "could not read results file " + paths[index] + ": " + e.what();
+                    }
+                };
+
+                file_read read;
+                while (reader.next(read))
+                {
+                    const auto i = read.index / 2;
+                    auto& loaded = batch[i];
+                    if (read.error != 0)
+                    {
+                        // the same message as load_results()
+                        if (loaded.error.empty())
+                            loaded.error = "could not open results file " + paths[read.index];
+                    }
+                    else if (!m_check)
+                        parse(loaded, read.index, read.bytes);
+                    else
+                    {
+                        content_hash hash;
+                        hash.update(read.bytes.data(), read.bytes.size());
+                        (read.index % 2 == 0 ? loaded.results_hash : loaded.truth_hash) = hash.finish();
+                        held[read.index] = std::move(read.bytes);
+                    }
+                    if (--remaining[i] != 0)
+                        continue;
+
+                    if (m_check && loaded.error.empty())
+                    {
+                        // every file of the sequence is in, so it must be published whatever happens
+                        try
+                        {
+                            loaded.stored = m_check(*loaded.paths, loaded.results_hash, loaded.truth_hash);
+                            for (const auto f : {2 * i, 2 * i + 1})
+                            {
+                                if (!loaded.stored)
+                                    parse(loaded, f, held[f]);
+                                std::string().swap(held[f]);
+                            }
+                        }
+                        catch (std::exception& e)
+                        {
+                            loaded.error = e.what();
+                        }
+                    }
+                    publish(first + i, std::move(loaded));
+                }
+            }
+            catch (std::exception& e)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    if (remaining[i] == 0)
+                        continue;
+                    batch[i].error = e.what();
+                    publish(first + i, std::move(batch[i]));
+                }
+            }
+        }
+    }
+
+    void sequence_prefetcher::publish(const std::size_t index, loaded_sequence&& loaded) noexcept
+    {
+        if (!loaded.error.empty())
+        {
+            loaded.results.clear();
+            loaded.ground_truth.clear();
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const auto slot = index % m_slots.size();
+            m_slots[slot] = std::move(loaded);
+            m_ready[slot] = true;
+        }
+        m_loaded.notify_all();
+    }
+}
@@ -0,0 +1,288 @@
+#ifndef ANALYZE_DATASET_H
+#define ANALYZE_DATASET_H
+
+#include "analysis.h"
+#include "batch_reader.h"
+#include "result_store.h"
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace analyze
+{
+    /// The directory layouts of the supported tracking datasets.
+    enum class dataset_layout
+    {
+        struck,      ///< <em>root</em>/<em>sequence</em>/<em>sequence</em>_gt.txt
+        otb,         ///< <em>root</em>/<em>sequence</em>/groundtruth_rect.txt
+        lasot,       ///< <em>root</em>/<em>class</em>/<em>class</em>-<em>n</em>/groundtruth.txt
+        got10k,      ///< <em>root</em>/<em>sequence</em>/groundtruth.txt, with root being a split
+        trackingnet  ///< <em>root</em>/anno/<em>sequence</em>.txt, with root being a chunk
+    };
+
+    /**
+     * \brief       Parse the name of a dataset layout.
+     * \param[in]   name    One of struck, otb, lasot, got10k, or trackingnet.
+     * \return      The layout.
+     * \throws      std::invalid_argument   This is thrown if \a name is not a layout.
+     */
+    dataset_layout parse_layout(const std::string& name);
+
+    /**
+     * \brief       Find the ground truth file of a sequence.
+     * \param[in]   layout      The dataset's layout.
+     * \param[in]   root        The dataset's root directory.
+     * \param[in]   sequence    The name of the sequence.
+     * \return      The path to the sequence's ground truth file. The file is not checked.
+     * \throws      std::bad_alloc  This is thrown if memory for the path cannot be allocated.
+     */
+    std::string ground_truth_path(const dataset_layout layout, const std::string& root, const std::string& sequence);
+
+    /**
+     * \brief       Find the box convention of a dataset's ground truth.
+     * \param[in]   layout  The dataset's layout.
+     * \return      left_width_top_height for struck, which is the original convention, and
+     *              left_top_width_height for the others, which use x, y, width, and height.
+     * \throws      None
+     */
+    box_convention layout_convention(const dataset_layout layout) noexcept;
+
+    /// The files of one sequence in a dataset_manifest.
+    struct sequence_paths final
+    {
+        std::string name;         ///< The sequence name.
+        std::string results;      ///< The tracker results file.
+        std::string ground_truth; ///< The ground truth file.
+        std::string output;       ///< The .ious file to write.
+
+        /// The convention of both the results and the ground truth.
+        box_convention convention = box_convention::left_width_top_height;
+    };
+
+    /**
+     * \brief       The sequences of a dataset, with every file path resolved.
+     * \details     Results are read from <em>results</em>/<em>sequence</em>.boxes, and IoUs are
+     *              written to <em>results</em>/<em>sequence</em>.ious, whatever the layout. Only
+     *              the ground truth path depends on the layout. Compressed results can be given
+     *              another extension, such as .boxes.gz; load_results() recognizes them by their
+     *              contents.
+     */
+    class dataset_manifest final
+    {
+    public:
+        /**
+         * \brief       Construct a manifest with no sequences.
+         * \param[in]   layout              The dataset's layout.
+         * \param[in]   root                The dataset's root directory.
+         * \param[in]   results_directory   The directory holding the tracker's results. If this is
+         *                                  empty, the working directory is used.
+         * \param[in]   results_extension   The extension of the results files.
+         * \throws      std::bad_alloc  This is thrown if memory for the paths cannot be allocated.
+         * \details     The box convention is layout_convention() of \a layout.
+         */
+        dataset_manifest(const dataset_layout layout,
+                         std::string root,
+                         std::string results_directory,
+                         std::string results_extension = ".boxes");
+
+        /**
+         * \brief       Add a sequence to the manifest.
+         * \param[in]   sequence    The name of the sequence.
+         * \throws      std::bad_alloc  This is thrown if memory for the paths cannot be allocated.
+         */
+        void add(const std::string& sequence);
+
+        /**
+         * \brief   Add every sequence in the dataset, in name order.
+         * \throws  std::runtime_error  This is thrown if the root directory cannot be read.
+         * \details A sequence is found when its ground truth file exists.
+         */
+        void discover();
+
+        /**
+         * \brief   Get the sequences.
+         * \return  The sequences, in the order they were added.
+         * \throws  None
+         */
+        const std::vector<sequence_paths>& sequences() const noexcept { return m_sequences; }
+
+        /**
+         * \brief   Query the dataset's layout.
+         * \return  The layout given at construction.
+         * \throws  None
+         */
+        dataset_layout layout() const noexcept { return m_layout; }
+
+        /**
+         * \brief       Set the box convention of the results and ground truth files.
+         * \param[in]   convention  The convention. Sequences already added use it, too.
+         * \throws      None
+         */
+        void convention(const box_convention convention) noexcept;
+
+        /**
+         * \brief   Query the box convention of the results and ground truth files.
+         * \return  The convention.
+         * \throws  None
+         */
+        box_convention convention() const noexcept { return m_convention; }
+
+    private:
+        dataset_layout              m_layout;     ///< The dataset's layout.
+        box_convention              m_convention; ///< The convention of every file.
+        std::string                 m_root;       ///< The dataset's root directory.
+        std::string                 m_results;    ///< The results directory, with a trailing slash.
+        std::string                 m_extension;  ///< The extension of the results files.
+        std::vector<sequence_paths> m_sequences;  ///< The resolved sequences.
+    };
+
+    /**
+     * \brief       Read a manifest file.
+     * \param[in]   file_name   The manifest file.
+     * \return      The manifest.
+     * \throws      std::runtime_error  This is thrown if the file cannot be read or is malformed,
+     *                                  or if it lists no sequences and the dataset cannot be read.
+     * \details     Each line is a keyword and a value. Blank lines, and lines starting with #, are
+     *              ignored.
+     *              \li <tt>layout</tt> names the layout; see parse_layout(). It is required.
+     *              \li <tt>root</tt> is the dataset's root directory. It is required.
+     *              \li <tt>results</tt> is the results directory. It defaults to the working
+     *              directory.
+     *              \li <tt>extension</tt> is the extension of the results files. It defaults to
+     *              .boxes; compressed results might use .boxes.gz or .boxes.zst.
+     *              \li <tt>convention</tt> names the convention of four value lines, in both the
+     *              results and the ground truth; see parse_box_convention(). It defaults to
+     *              layout_convention().
+     *              \li <tt>sequence</tt> adds a sequence, and may be repeated. If there are none,
+     *              every sequence in the dataset is added; see dataset_manifest::discover().
+     */
+    dataset_manifest load_manifest(const std::string& file_name);
+
+    /// One sequence's boxes, read by a sequence_prefetcher.
+    struct loaded_sequence final
+    {
+        const sequence_paths* paths = nullptr; ///< The sequence's files.
+        box_list              results;         ///< The tracker results.
+        box_list              ground_truth;    ///< The ground truth.
+        std::string           error;           ///< Why the boxes could not be read, if they could not.
+        store_key             results_hash;    ///< The hash of the results file, with a stored_check.
+        store_key             truth_hash;      ///< The hash of the ground truth file, likewise.
+        bool                  stored = false;  ///< True if the stored_check found the result, so
+                                               ///< the boxes were not parsed.
+    };
+
+    /**
+     * \brief       Decides, on a loading thread, that a sequence's boxes are not needed.
+     * \details     It is called with the sequence's files and the content_hash of each file's
+     *              bytes, and returns true if the result is already known, such as when a
+     *              result_store holds it. It must be safe to call from several threads at once.
+     */
+    using stored_check = std::function<bool(const sequence_paths&, const store_key&, const store_key&)>;
+
+    /**
+     * \brief       Reads and parses upcoming sequences in the background.
+     * \details     Worker threads load sequences in order, but no more than \a depth sequences
+     *              ahead of the consumer, so memory stays bounded however long the list is. While
+     *              the consumer evaluates one sequence, the next ones are read, so storage latency
+     *              is hidden behind the evaluation.
+     *
+     *              Each worker claims every free slot at once, and reads the claimed sequences'
+     *              files together with a batch_reader, parsing each file as soon as it arrives. A
+     *              deep prefetcher therefore keeps hundreds of small files in flight, which is what
+     *              datasets like GOT-10k need.
+     *
+     *              With a stored_check, each file's bytes are hashed as they arrive, and a
+     *              sequence's files are parsed only once both are read and the check says they are
+     *              needed. A sequence whose result is stored therefore costs one read of each file,
+     *              and no parsing.
+     */
+    class sequence_prefetcher final
+    {
+    public:
+        /**
+         * \brief       Start prefetching.
+         * \param[in]   sequences       The sequences to load. They must outlive the prefetcher.
+         * \param[in]   depth           The most sequences loaded ahead of the consumer. A depth of
+         *                              0 is treated as 1.
+         * \param[in]   thread_count    The number of loading threads. 0 is treated as 1.
+         * \param[in]   method          How the loading threads read files.
+         * \param[in]   policy          What to do with lines of the files which are not valid. A
+         *                              file with a line which fails gives its sequence an error.
+         * \param[in]   check           If this is set, sequences it accepts are not parsed.
+         * \throws      std::runtime_error  This is thrown if \a method is read_method::io_uring and
+         *                                  the kernel does not support it.
+         * \throws      std::system_error   This is thrown if a thread cannot be started.
+         * \throws      std::bad_alloc      This is thrown if memory for the buffers cannot be
+         *                                  allocated.
+         */
+        sequence_prefetcher(const std::vector<sequence_paths>& sequences,
+                            const std::size_t depth,
+                            const unsigned thread_count,
+                            const read_method method = read_method::automatic,
+                            const validation_policy policy = validation_policy::fail,
+                            stored_check check = nullptr);
+
+        /// A prefetcher owns threads, so it cannot be copied.
+        sequence_prefetcher(const sequence_prefetcher&) = delete;
+
+        /// A prefetcher's threads refer to it, so it cannot be moved.
+        sequence_prefetcher(sequence_prefetcher&&) = delete;
+
+        /**
+         * \brief   Stop prefetching, and wait for the threads to finish.
+         * \throws  None
+         */
+        ~sequence_prefetcher() noexcept;
+
+        /// A prefetcher owns threads, so it cannot be copied.
+        sequence_prefetcher& operator=(const sequence_prefetcher&) = delete;
+
+        /// A prefetcher's threads refer to it, so it cannot be moved.
+        sequence_prefetcher& operator=(sequence_prefetcher&&) = delete;
+
+        /**
+         * \brief       Get the next sequence, waiting for it to load if necessary.
+         * \param[out]  sequence    The next sequence's boxes. If it could not be read, the boxes
+         *                          are empty and the error says why.
+         * \retval      true        A sequence was returned.
+         * \retval      false       Every sequence has been returned.
+         * \throws      None
+         */
+        bool next(loaded_sequence& sequence) noexcept;
+
+    private:
+        /**
+         * \brief       Load sequences until every one is claimed or the prefetcher stops.
+         * \param[in]   reader  The worker's file reader.
+         * \throws      None
+         */
+        void work(batch_reader& reader) noexcept;
+
+        /**
+         * \brief       Hand a loaded sequence to the consumer.
+         * \param[in]   index   The index of the sequence.
+         * \param[in]   loaded  The sequence's boxes.
+         * \throws      None
+         */
+        void publish(const std::size_t index, loaded_sequence&& loaded) noexcept;
+
+        const std::vector<sequence_paths>& m_sequences;     ///< The sequences to load.
+        validation_policy                  m_policy;        ///< What to do with invalid lines.
+        stored_check                       m_check;         ///< Finds sequences not to parse.
+        std::vector<loaded_sequence>       m_slots;         ///< Loaded sequences, by index modulo depth.
+        std::vector<bool>                  m_ready;         ///< True for each slot which is loaded.
+        std::size_t                        m_claimed = 0;   ///< The next sequence to load.
+        std::size_t                        m_consumed = 0;  ///< The next sequence to return.
+        bool                               m_stopping = false; ///< True when the threads should stop.
+        std::mutex                         m_mutex;         ///< Guards the slots and counters.
+        std::condition_variable            m_loaded;        ///< Signals that a slot was loaded.
+        std::condition_variable            m_freed;         ///< Signals that a slot was freed.
+        std::vector<batch_reader>          m_readers;       ///< Each loading thread's file reader.
+        std::vector<std::thread>           m_workers;       ///< The loading threads.
+    };
+}
+
+#endif
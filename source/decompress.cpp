@@ -0,0 +1,257 @@
+#include "decompress.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <zlib.h>
+#ifdef ANALYZE_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace analyze
+{
+    /// The interface of the gzip and zstd decoders.
+    class decompressing_buffer::decoder
+    {
+    public:
+        /**
+         * \brief   Destroy the decoder.
+         * \throws  None
+         */
+        virtual ~decoder() noexcept = default;
+
+        /**
+         * \brief           Decode some compressed data.
+         * \param[in,out]   next        The next compressed byte. It is advanced past the bytes
+         *                              which were consumed.
+         * \param[in,out]   available   The number of compressed bytes at \a next. It is reduced
+         *                              by the bytes which were consumed.
+         * \param[out]      output      Receives the decoded bytes.
+         * \param[in]       size        The capacity of \a output.
+         * \return          The number of bytes written to \a output. This can be 0 even when bytes
+         *                  were consumed.
+         * \throws          std::runtime_error  This is thrown if the data is corrupt.
+         */
+        virtual std::size_t decode(const char*& next, std::size_t& available, char* output, const std::size_t size) = 0;
+
+        /**
+         * \brief   Determine if the data decoded so far ends cleanly.
+         * \retval  true    The last gzip member or zstd frame is complete.
+         * \retval  false   The data stops part way through a member or frame.
+         * \throws  None
+         */
+        virtual bool complete() const noexcept = 0;
+    };
+
+    namespace
+    {
+        /// The size of each chunk of compressed data read from a stream.
+        constexpr std::size_t input_size = 128 * 1024;
+
+        /// The size of each chunk of decoded text.
+        constexpr std::size_t output_size = 128 * 1024;
+
+        /// Decodes gzip members with zlib.
+        class gzip_decoder final: public decompressing_buffer::decoder
+        {
+        public:
+            /**
+             * \brief   Start a zlib inflate stream.
+             * \throws  std::runtime_error  This is thrown if zlib cannot be initialized.
+             */
+            gzip_decoder()
+            {
+                std::memset(&m_stream, 0, sizeof(m_stream));
+                // 16 selects the gzip wrapper rather than the zlib one
+                if (inflateInit2(&m_stream, 16 + MAX_WBITS) != Z_OK)
+                    throw std::runtime_error("could not start a gzip decoder");
+            }
+
+            gzip_decoder(const gzip_decoder&) = delete;
+            gzip_decoder(gzip_decoder&&) = delete;
+
+            /**
+             * \brief   Release the inflate stream.
+             * \throws  None
+             */
+            ~gzip_decoder() noexcept override { inflateEnd(&m_stream); }
+
+            gzip_decoder& operator=(const gzip_decoder&) = delete;
+            gzip_decoder& operator=(gzip_decoder&&) = delete;
+
+            std::size_t decode(const char*& next, std::size_t& available, char* output, const std::size_t size) override
+            {
+                if (m_ended)
+                {
+                    // another member follows the last one, as pigz and cat write
+                    inflateReset(&m_stream);
+                    m_ended = false;
+                }
+
+                // zlib counts in unsigned int, so hand it at most that much at once
+                const auto in  = static_cast<uInt>(std::min<std::size_t>(available, UINT_MAX));
+                const auto out = static_cast<uInt>(std::min<std::size_t>(size, UINT_MAX));
+                m_stream.next_in   = reinterpret_cast<Bytef*>(const_cast<char*>(next));
+                m_stream.avail_in  = in;
+                m_stream.next_out  = reinterpret_cast<Bytef*>(output);
+                m_stream.avail_out = out;
+
+                const int status = inflate(&m_stream, Z_NO_FLUSH);
+                if (status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR)
+                {
+                    throw std::runtime_error(std::string("corrupt gzip data: ") +
+                                             (m_stream.msg != nullptr ? m_stream.msg : "unknown error"));
+                }
+                m_ended = status == Z_STREAM_END;
+
+                next      += in - m_stream.avail_in;
+                available -= in - m_stream.avail_in;
+                return out - m_stream.avail_out;
+            }
+
+            bool complete() const noexcept override { return m_ended; }
+
+        private:
+            z_stream m_stream;        ///< The zlib state.
+            bool     m_ended = false; ///< True if the last member was finished.
+        };
+
+#ifdef ANALYZE_HAVE_ZSTD
+        /// Decodes zstd frames with libzstd.
+        class zstd_decoder final: public decompressing_buffer::decoder
+        {
+        public:
+            /**
+             * \brief   Start a zstd decompression stream.
+             * \throws  std::runtime_error  This is thrown if libzstd cannot be initialized.
+             */
+            zstd_decoder() : m_stream(ZSTD_createDStream())
+            {
+                if (m_stream == nullptr || ZSTD_isError(ZSTD_initDStream(m_stream)))
+                {
+                    ZSTD_freeDStream(m_stream);
+                    throw std::runtime_error("could not start a zstd decoder");
+                }
+            }
+
+            zstd_decoder(const zstd_decoder&) = delete;
+            zstd_decoder(zstd_decoder&&) = delete;
+
+            /**
+             * \brief   Release the decompression stream.
+             * \throws  None
+             */
+            ~zstd_decoder() noexcept override { ZSTD_freeDStream(m_stream); }
+
+            zstd_decoder& operator=(const zstd_decoder&) = delete;
+            zstd_decoder& operator=(zstd_decoder&&) = delete;
+
+            std::size_t decode(const char*& next, std::size_t& available, char* output, const std::size_t size) override
+            {
+                ZSTD_inBuffer in   = {next, available, 0};
+                ZSTD_outBuffer out = {output, size, 0};
+
+                // a finished frame is followed by the next one without a reset
+                const auto status = ZSTD_decompressStream(m_stream, &out, &in);
+                if (ZSTD_isError(status))
+                    throw std::runtime_error(std::string("corrupt zstd data: ") + ZSTD_getErrorName(status));
+                m_ended = status == 0;
+
+                next      += in.pos;
+                available -= in.pos;
+                return out.pos;
+            }
+
+            bool complete() const noexcept override { return m_ended; }
+
+        private:
+            ZSTD_DStream* m_stream;        ///< The libzstd state.
+            bool          m_ended = false; ///< True if the last frame was finished.
+        };
+#endif
+
+        /**
+         * \brief       Make the decoder for a format.
+         * \param[in]   format  The compression format.
+         * \return      The decoder.
+         * \throws      std::runtime_error  This is thrown if the format is not supported by this
+         *                                  build, or if the decoder cannot be started.
+         */
+        std::unique_ptr<decompressing_buffer::decoder> make_decoder(const compression format)
+        {
+            switch (format)
+            {
+                case compression::gzip:
+                    return std::unique_ptr<decompressing_buffer::decoder>(new gzip_decoder);
+                case compression::zstd:
+#ifdef ANALYZE_HAVE_ZSTD
+                    return std::unique_ptr<decompressing_buffer::decoder>(new zstd_decoder);
+#else
+                    throw std::runtime_error("this build cannot read zstd data; rebuild with libzstd installed");
+#endif
+                case compression::none:
+                    break;
+            }
+            throw std::runtime_error("the data is not compressed");
+        }
+    }
+
+    compression detect_compression(const char* data, const std::size_t size) noexcept
+    {
+        static const unsigned char gzip_magic[] = {0x1f, 0x8b};
+        static const unsigned char zstd_magic[] = {0x28, 0xb5, 0x2f, 0xfd};
+        if (size >= sizeof(gzip_magic) && std::memcmp(data, gzip_magic, sizeof(gzip_magic)) == 0)
+            return compression::gzip;
+        if (size >= sizeof(zstd_magic) && std::memcmp(data, zstd_magic, sizeof(zstd_magic)) == 0)
+            return compression::zstd;
+        return compression::none;
+    }
+
+    //-------------------------------------------------------
+    //                    decompressing_buffer class methods
+    //-------------------------------------------------------
+    decompressing_buffer::decompressing_buffer(std::istream& source, const compression format)
+        : m_decoder(make_decoder(format)), m_source(&source), m_input(input_size), m_output(output_size)
+    {
+    }
+
+    decompressing_buffer::decompressing_buffer(const char* data, const std::size_t size, const compression format)
+        : m_decoder(make_decoder(format)), m_next(data), m_available(size), m_output(output_size)
+    {
+    }
+
+    decompressing_buffer::~decompressing_buffer() noexcept = default;
+
+    decompressing_buffer::int_type decompressing_buffer::underflow()
+    {
+        if (gptr() < egptr())
+            return traits_type::to_int_type(*gptr());
+
+        while (m_available > 0 || refill())
+        {
+            const auto before = m_available;
+            const auto size   = m_decoder->decode(m_next, m_available, m_output.data(), m_output.size());
+            if (size > 0)
+            {
+                setg(m_output.data(), m_output.data(), m_output.data() + size);
+                return traits_type::to_int_type(*gptr());
+            }
+            if (m_available == before)
+                throw std::runtime_error("the compressed data cannot be decoded");
+        }
+        if (!m_decoder->complete())
+            throw std::runtime_error("the compressed data is truncated");
+        return traits_type::eof();
+    }
+
+    bool decompressing_buffer::refill() noexcept
+    {
+        if (m_source == nullptr)
+            return false;
+        m_source->read(m_input.data(), static_cast<std::streamsize>(m_input.size()));
+        m_next      = m_input.data();
+        m_available = static_cast<std::size_t>(m_source->gcount());
+        return m_available > 0;
+    }
+}
@@ -0,0 +1,110 @@
+#ifndef ANALYZE_DECOMPRESS_H
+#define ANALYZE_DECOMPRESS_H
+
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <vector>
+
+namespace analyze
+{
+    /// The compression formats a decompressing_buffer can read.
+    enum class compression
+    {
+        none, ///< Plain text.
+        gzip, ///< gzip, as written by gzip and pigz.
+        zstd  ///< Zstandard, as written by zstd. This needs a build with libzstd.
+    };
+
+    /**
+     * \brief       Identify the compression of some data by its magic number.
+     * \param[in]   data    The start of the data.
+     * \param[in]   size    The number of bytes at \a data. Four bytes are enough.
+     * \return      The data's compression; compression::none if it has no known magic number.
+     * \throws      None
+     */
+    compression detect_compression(const char* data, const std::size_t size) noexcept;
+
+    /**
+     * \brief       A stream buffer which decompresses another stream, or a block of memory, as it
+     *              is read.
+     * \details     Compressed data is read in fixed size chunks, and each chunk is decoded into a
+     *              fixed size buffer which the reading stream consumes, so the decompressed text is
+     *              never held in memory at once. Concatenated gzip members and zstd frames are read
+     *              as one stream.
+     *
+     *              Corrupt or truncated data is reported by throwing from underflow(). Wrap the
+     *              buffer in a stream whose exception mask has std::ios::badbit to see the error;
+     *              otherwise, the stream just stops.
+     */
+    class decompressing_buffer final: public std::streambuf
+    {
+    public:
+        /**
+         * \brief       Decompress a stream.
+         * \param[in]   source  The compressed stream. It must outlive the buffer.
+         * \param[in]   format  The compression of \a source. This must not be compression::none.
+         * \throws      std::runtime_error  This is thrown if the format is not supported by this
+         *                                  build, or if the decoder cannot be started.
+         */
+        decompressing_buffer(std::istream& source, const compression format);
+
+        /**
+         * \brief       Decompress a block of memory.
+         * \param[in]   data    The compressed data. It must outlive the buffer.
+         * \param[in]   size    The number of bytes at \a data.
+         * \param[in]   format  The compression of \a data. This must not be compression::none.
+         * \throws      std::runtime_error  This is thrown if the format is not supported by this
+         *                                  build, or if the decoder cannot be started.
+         */
+        decompressing_buffer(const char* data, const std::size_t size, const compression format);
+
+        /// A buffer owns its decoder's state, so it cannot be copied.
+        decompressing_buffer(const decompressing_buffer&) = delete;
+
+        /// A buffer's get area points into itself, so it cannot be moved.
+        decompressing_buffer(decompressing_buffer&&) = delete;
+
+        /**
+         * \brief   Release the decoder.
+         * \throws  None
+         */
+        ~decompressing_buffer() noexcept override;
+
+        /// A buffer owns its decoder's state, so it cannot be copied.
+        decompressing_buffer& operator=(const decompressing_buffer&) = delete;
+
+        /// A buffer's get area points into itself, so it cannot be moved.
+        decompressing_buffer& operator=(decompressing_buffer&&) = delete;
+
+        /// Decodes one compression format.
+        class decoder;
+
+    protected:
+        /**
+         * \brief   Decode the next chunk of text.
+         * \return  The next character, or end of file if the data is exhausted.
+         * \throws  std::runtime_error  This is thrown if the data is corrupt or truncated.
+         */
+        int_type underflow() override;
+
+    private:
+        /**
+         * \brief   Refill the input chunk from the source stream.
+         * \retval  true    More compressed data is available.
+         * \retval  false   The source is exhausted.
+         * \throws  None
+         */
+        bool refill() noexcept;
+
+        std::unique_ptr<decoder> m_decoder;            ///< The format's decoder.
+        std::istream*            m_source = nullptr;   ///< The compressed stream; null for memory.
+        std::vector<char>        m_input;              ///< The chunk read from m_source.
+        const char*              m_next = nullptr;     ///< The next compressed byte to decode.
+        std::size_t              m_available = 0;      ///< The compressed bytes left at m_next.
+        std::vector<char>        m_output;             ///< The decoded text.
+    };
+}
+
+#endif
@@ -0,0 +1,243 @@
+#include "incremental.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace analyze
+{
+    namespace
+    {
+        /**
+         * \brief           Read part of a file.
+         * \param[in]       descriptor  The open file.
+         * \param[in]       offset      The first byte to read.
+         * \param[in]       size        The number of bytes to read.
+         * \param[in,out]   bytes       The bytes are appended to this.
+         * \throws          std::bad_alloc  This is thrown if \a bytes cannot grow.
+         * \details         If the file is shorter than expected, only the bytes which exist are
+         *                  appended.
+         */
+        void read_range(const int descriptor, std::size_t offset, std::size_t size, std::string& bytes)
+        {
+            const auto start = bytes.size();
+            bytes.resize(start + size);
+            std::size_t done = 0;
+            while (done < size)
+            {
+                const auto count = pread(descriptor, &bytes[start + done], size - done, static_cast<off_t>(offset + done));
+                if (count < 0 && errno == EINTR)
+                    continue;
+                if (count <= 0)
+                    break;
+                done += static_cast<std::size_t>(count);
+            }
+            bytes.resize(start + done);
+        }
+
+        /**
+         * \brief       Skip the separators between values on a line.
+         * \param[in]   p   The current position.
+         * \return      The first character which is not a comma, space, or tab.
+         * \throws      None
+         */
+        const char* skip_separators(const char* p) noexcept
+        {
+            while (*p == ',' || *p == ' ' || *p == '\t' || *p == '\r')
+                ++p;
+            return p;
+        }
+    }
+
+    //-------------------------------------------------------
+    //                            box_follower class methods
+    //-------------------------------------------------------
+    constexpr std::size_t box_follower::unchanged;
+
+    box_follower::box_follower(std::string file_name) : m_file_name(std::move(file_name))
+    {
+    }
+
+    std::size_t box_follower::update()
+    {
+        const int descriptor = open(m_file_name.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat status;
+        if (descriptor < 0 || fstat(descriptor, &status) != 0)
+        {
+            if (descriptor >= 0)
+                close(descriptor);
+            const bool had_data = !m_bytes.empty();
+            truncate(0);
+            m_bytes.clear();
+            return had_data ? 0 : unchanged;
+        }
+
+        // a writer may truncate and rewrite the file in place, or edit any line, and still leave
+        // it larger with the same last line, so every parsed byte is compared, not just the end;
+        // comparing is much cheaper than parsing
+        std::string bytes;
+        read_range(descriptor, 0, static_cast<std::size_t>(status.st_size), bytes);
+        close(descriptor);
+        const auto common = static_cast<std::size_t>(
+            std::mismatch(bytes.begin(), bytes.begin() + std::min(bytes.size(), m_parsed), m_bytes.begin()).first -
+            bytes.begin());
+
+        const auto old_count = m_boxes.size();
+        const auto first = static_cast<std::size_t>(std::upper_bound(m_line_ends.begin(), m_line_ends.end(), common) -
+                                                    m_line_ends.begin());
+        truncate(first);
+        m_bytes = std::move(bytes);
+
+        m_stopped = false;
+        parse(m_parsed);
+        return first == old_count && m_boxes.size() == old_count ? unchanged : first;
+    }
+
+    void box_follower::parse(std::size_t offset)
+    {
+        const char* const bytes = m_bytes.c_str();
+        while (!m_stopped)
+        {
+            const auto newline = m_bytes.find('\n', offset);
+            if (newline == std::string::npos)
+                return;
+
+            const char* p = skip_separators(bytes + offset);
+            if (p == bytes + newline)
+            {
+                offset = m_parsed = newline + 1;
+                continue;
+            }
+
+            float values[4];
+            for (auto& v : values)
+            {
+                char* end = nullptr;
+                v = std::strtof(p, &end);
+                if (end == p || end > bytes + newline)
+                {
+                    // like validation_policy::none, the data ends at the first malformed line, which a
+                    // tracker may still be writing
+                    m_stopped = true;
+                    return;
+                }
+                p = skip_separators(end);
+            }
+
+            m_boxes.emplace_back(values[0], values[0] + values[1], values[2], values[2] + values[3]);
+            m_line_ends.push_back(newline + 1);
+            offset = m_parsed = newline + 1;
+        }
+    }
+
+    void box_follower::truncate(const std::size_t first) noexcept
+    {
+        m_boxes.resize(std::min(first, m_boxes.size()));
+        m_line_ends.resize(m_boxes.size());
+        m_parsed = m_line_ends.empty() ? 0 : m_line_ends.back();
+    }
+
+    //-------------------------------------------------------
+    //                        incremental_ious class methods
+    //-------------------------------------------------------
+    incremental_ious::incremental_ious(std::string file_name, const std::size_t stride)
+        : m_file_name(std::move(file_name)), m_stride(std::max(stride, std::size_t(1)))
+    {
+    }
+
+    void incremental_ious::update(const box_span results, const box_span ground_truth, const std::size_t first_frame)
+    {
+        const auto length = std::min(results.size(), ground_truth.size());
+        const auto count  = (length + m_stride - 1) / m_stride;
+        auto first = first_frame >= length ? count : (first_frame + m_stride - 1) / m_stride;
+        first = std::min(first, std::min(count, m_ious.size()));
+
+        m_ious.resize(count);
+        m_totals.resize(count);
+        for (auto i = first; i < count; ++i)
+        {
+            m_ious[i] = make_iou(results[i * m_stride], ground_truth[i * m_stride]);
+            const auto v = m_ious[i].value();
+            if (i == 0)
+                m_totals[i] = running_total {v, v};
+            else
+            {
+                const auto& previous = m_totals[i - 1];
+                m_totals[i] = running_total {std::min(previous.minimum, v), std::max(previous.maximum, v)};
+            }
+        }
+
+        // retotal the blocks from the one holding the first change, the same way as summarize()
+        constexpr auto block = iou_accumulator::block_size;
+        m_blocks.resize((count + block - 1) / block);
+        for (auto b = first / block; b < m_blocks.size(); ++b)
+        {
+            iou::value_type total = 0.0f;
+            for (auto i = b * block; i < std::min(count, (b + 1) * block); ++i)
+                total += m_ious[i].value();
+            m_blocks[b] = total;
+        }
+
+        if (!m_file_name.empty())
+            write(first);
+    }
+
+    iou_summary incremental_ious::summary() const noexcept
+    {
+        iou_summary summary;
+        if (m_totals.empty())
+            return summary;
+        summary.minimum = m_totals.back().minimum;
+        summary.maximum = m_totals.back().maximum;
+        summary.count   = m_totals.size();
+        pairwise_sum total;
+        for (const auto b : m_blocks)
+            total.add(b);
+        summary.average = total.total() / static_cast<iou::value_type>(summary.count);
+        return summary;
+    }
+
+    void incremental_ious::write(const std::size_t first)
+    {
+        // the same text as write_ious(); the unchanged lines are kept, not formatted again
+        m_text.resize(first < m_line_starts.size() ? m_line_starts[first] : m_text.size());
+        m_line_starts.resize(m_ious.size());
+        std::ostringstream text;
+        for (auto i = first; i < m_ious.size(); ++i)
+        {
+            m_line_starts[i] = m_text.size() + static_cast<std::size_t>(text.tellp());
+            text << m_ious[i].value() << '\n';
+        }
+        m_text += text.str();
+
+        // a reader never sees a partial file, and a failed write leaves the last one in place
+        const auto temporary = m_file_name + ".tmp." + std::to_string(getpid());
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            file << m_text;
+            if (!m_ious.empty())
+            {
+                const auto s = summary();
+                file << "minimum: " << s.minimum << "\nmaximum: " << s.maximum << "\naverage: " << s.average;
+            }
+            if (!file)
+            {
+                std::remove(temporary.c_str());
+                throw std::runtime_error("could not write " + m_file_name);
+            }
+        }
+        if (std::rename(temporary.c_str(), m_file_name.c_str()) != 0)
+        {
+            std::remove(temporary.c_str());
+            throw std::runtime_error("could not replace " + m_file_name + ": " + std::strerror(errno));
+        }
+    }
+}
@@ -0,0 +1,153 @@
+#ifndef ANALYZE_INCREMENTAL_H
+#define ANALYZE_INCREMENTAL_H
+
+#include "analysis.h"
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace analyze
+{
+    /**
+     * \brief       Follows a bounding box file as it is written or edited, parsing only what
+     *              changed.
+     * \details     The file format is the one read by load_results(). The follower keeps the bytes
+     *              it has parsed, and where each box's line ends. Each update reads the file and
+     *              compares it with the parsed bytes, and parsing restarts at the first line which
+     *              differs, so only appended and edited lines are parsed. A trailing line without a
+     *              newline is left for the next update, since the writer may not have finished it.
+     */
+    class box_follower final
+    {
+    public:
+        /// The value returned by update() when no box changed.
+        static constexpr std::size_t unchanged = std::numeric_limits<std::size_t>::max();
+
+        /**
+         * \brief       Construct a follower. The file is not read until update() is called.
+         * \param[in]   file_name   The path to the file to follow. It need not exist yet.
+         * \throws      std::bad_alloc  This is thrown if memory for the path cannot be allocated.
+         */
+        explicit box_follower(std::string file_name);
+
+        /**
+         * \brief   Bring the boxes up to date with the file.
+         * \return  The index of the first box which was added, removed, or changed, or
+         *          box_follower::unchanged.
+         * \throws  std::bad_alloc  This is thrown if memory for the file or boxes cannot be
+         *                          allocated.
+         * \details A missing or unreadable file has no boxes.
+         */
+        std::size_t update();
+
+        /**
+         * \brief   Get the parsed boxes.
+         * \return  The boxes from the complete lines of the file, as of the last update().
+         * \throws  None
+         */
+        const box_list& boxes() const noexcept { return m_boxes; }
+
+        /**
+         * \brief   Get the path of the followed file.
+         * \return  The file name given at construction.
+         * \throws  None
+         */
+        const std::string& file_name() const noexcept { return m_file_name; }
+
+    private:
+        /**
+         * \brief       Parse complete lines from the stored bytes.
+         * \param[in]   offset  The byte at which to start parsing. It must be the start of a line.
+         * \throws      std::bad_alloc  This is thrown if memory for the boxes cannot be allocated.
+         */
+        void parse(std::size_t offset);
+
+        /**
+         * \brief       Discard the boxes from an index on.
+         * \param[in]   first   The index of the first box to discard.
+         * \throws      None
+         */
+        void truncate(const std::size_t first) noexcept;
+
+        std::string              m_file_name;     ///< The followed file.
+        std::string              m_bytes;         ///< The file contents which have been read.
+        box_list                 m_boxes;         ///< The parsed boxes.
+        std::vector<std::size_t> m_line_ends;     ///< The offset just past each box's line.
+        std::size_t              m_parsed = 0;    ///< The offset just past the last parsed line.
+        bool                     m_stopped = false; ///< True if a malformed line ended the data.
+    };
+
+    /**
+     * \brief       An IoU series and its .ious file, updated from the first changed frame on.
+     * \details     The series and file match what calculate_ious() and write_ious() produce for
+     *              the same boxes, byte for byte. The extremes of every prefix of the series, and
+     *              the total of every iou_accumulator block, are kept, so the summary after a
+     *              change is rebuilt from the last unchanged frame rather than from the start. The
+     *              file's text is kept too, so only the lines from the first change on are formatted
+     *              again. The file is written to a temporary file and renamed, so a reader never
+     *              sees a partial file.
+     */
+    class incremental_ious final
+    {
+    public:
+        /**
+         * \brief       Construct an empty series.
+         * \param[in]   file_name   The .ious file to keep up to date. If this is empty, no file is
+         *                          written.
+         * \param[in]   stride      Only every \a stride frame is compared; see calculate_ious().
+         * \throws      std::bad_alloc  This is thrown if memory for the path cannot be allocated.
+         */
+        incremental_ious(std::string file_name, const std::size_t stride);
+
+        /**
+         * \brief       Bring the series up to date after the boxes change.
+         * \param[in]   results         All the result boxes.
+         * \param[in]   ground_truth    All the ground truth boxes.
+         * \param[in]   first_frame     The first frame whose result or ground truth box changed.
+         *                              Frames before it must be the same as in the last update.
+         * \throws      std::runtime_error  This is thrown if the .ious file cannot be written.
+         * \throws      std::bad_alloc      This is thrown if memory for the series cannot be
+         *                                  allocated.
+         */
+        void update(box_span results, box_span ground_truth, const std::size_t first_frame);
+
+        /**
+         * \brief   Get the IoU series.
+         * \return  One IoU for every \a stride frame.
+         * \throws  None
+         */
+        const iou_list& ious() const noexcept { return m_ious; }
+
+        /**
+         * \brief   Get the summary of the whole series.
+         * \return  The same statistics summarize() gives for ious().
+         * \throws  None
+         */
+        iou_summary summary() const noexcept;
+
+    private:
+        /// The extremes of a prefix of the series.
+        struct running_total final
+        {
+            iou::value_type minimum = 0.0f; ///< The smallest IoU in the prefix.
+            iou::value_type maximum = 0.0f; ///< The largest IoU in the prefix.
+        };
+
+        /**
+         * \brief       Format the .ious file's text from one line on, and replace the file.
+         * \param[in]   first   The index of the first line which changed.
+         * \throws      std::runtime_error  This is thrown if the file cannot be written.
+         */
+        void write(const std::size_t first);
+
+        std::string                m_file_name;   ///< The .ious file.
+        std::size_t                m_stride;      ///< The frame stride.
+        iou_list                   m_ious;        ///< The IoU series.
+        std::vector<running_total> m_totals;      ///< The extremes of each prefix of the series.
+        std::vector<iou::value_type> m_blocks;    ///< The total of each block of the series, in order.
+        std::string                m_text;        ///< The IoU lines of the file.
+        std::vector<std::size_t>   m_line_starts; ///< The offset of each IoU's line in the text.
+    };
+}
+
+#endif
@@ -1,5 +1,6 @@
 #include "iou.h"
-#include <QtGlobal>
+#include <algorithm>
+#include <cmath>
 
 namespace analyze
 {
@@ -89,7 +90,8 @@ namespace analyze
     //-------------------------------------------------------
     bool operator==(const iou& a, const iou& b) noexcept
     {
-        return qFuzzyCompare(a.value(), b.value());
+        // the same relative tolerance as qFuzzyCompare(), without making the library depend on Qt
+        return std::abs(a.value() - b.value()) * 100000.0f <= std::min(std::abs(a.value()), std::abs(b.value()));
     }
 
     bool operator!=(const iou& a, const iou& b) noexcept
@@ -3,6 +3,7 @@
 
 #include "bounding_box.h"
 #include <iostream>
+#include <vector>
 
 namespace analyze
 {
@@ -142,6 +143,9 @@ namespace analyze
         float m_value = 0.0f; ///< The value of the IoU.
     };
 
+    /// Alias the type representing a list of IoU objects.
+    using iou_list = std::vector<iou>;
+
     /// \name Comparison
     /// \{
 
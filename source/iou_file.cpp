@@ -0,0 +1,134 @@
+#include "iou_file.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace analyze
+{
+    static_assert(sizeof(iou) == sizeof(float), "stored IoU values are used in place, so iou must be a float");
+
+    void write_iou_file(const span<const iou> ious,
+                        const std::string& file_name,
+                        const std::size_t stride,
+                        const std::size_t first_frame)
+    {
+        const auto summary = summarize(ious);
+        iou_file_header header;
+        std::memset(&header, 0, sizeof(header));
+        header.magic       = iou_file_magic;
+        header.version     = iou_file_version;
+        header.count       = ious.size();
+        header.first_frame = first_frame;
+        header.stride      = std::max(stride, std::size_t(1));
+        header.values      = sizeof(header);
+        header.minimum     = summary.minimum;
+        header.maximum     = summary.maximum;
+        header.average     = summary.average;
+
+        const auto temporary = file_name + ".tmp." + std::to_string(getpid());
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(ious.data()), static_cast<std::streamsize>(ious.size() * sizeof(iou)));
+            if (!file)
+            {
+                std::remove(temporary.c_str());
+                throw std::runtime_error("could not write " + file_name);
+            }
+        }
+        if (std::rename(temporary.c_str(), file_name.c_str()) != 0)
+        {
+            std::remove(temporary.c_str());
+            throw std::runtime_error("could not replace " + file_name);
+        }
+    }
+
+    bool is_iou_file(const std::string& file_name) noexcept
+    {
+        std::uint32_t magic = 0;
+        std::ifstream file(file_name.c_str(), std::ios::binary);
+        file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+        return file && magic == iou_file_magic;
+    }
+
+    //-------------------------------------------------------
+    //                                iou_file class methods
+    //-------------------------------------------------------
+    iou_file::iou_file(const std::string& file_name)
+    {
+        const int descriptor = open(file_name.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat status;
+        if (descriptor < 0 || fstat(descriptor, &status) != 0)
+        {
+            const auto message = "could not open IoU file " + file_name + ": " + std::strerror(errno);
+            if (descriptor >= 0)
+                ::close(descriptor);
+            throw std::runtime_error(message);
+        }
+        m_size = static_cast<std::size_t>(status.st_size);
+        if (m_size < sizeof(iou_file_header))
+        {
+            ::close(descriptor);
+            throw std::runtime_error(file_name + " is not a binary IoU file");
+        }
+
+        void* const data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        ::close(descriptor);
+        if (data == MAP_FAILED)
+            throw std::runtime_error("could not map IoU file " + file_name + ": " + std::strerror(errno));
+        m_data = static_cast<const char*>(data);
+
+        // the values must be inside the file, and aligned for use in place
+        const auto& h = header();
+        if (h.magic != iou_file_magic || h.version != iou_file_version || h.stride == 0 ||
+            h.values < sizeof(iou_file_header) || h.values % alignof(iou) != 0 || h.values > m_size ||
+            h.count > (m_size - h.values) / sizeof(iou))
+        {
+            munmap(const_cast<char*>(m_data), m_size);
+            throw std::runtime_error(file_name + " is not a valid binary IoU file");
+        }
+        m_ious = span<const iou>(reinterpret_cast<const iou*>(m_data + h.values), static_cast<std::size_t>(h.count));
+
+        // consumers usually read every value in order
+        madvise(const_cast<char*>(m_data), m_size, MADV_SEQUENTIAL);
+    }
+
+    iou_file::iou_file(iou_file&& file) noexcept : m_data(file.m_data), m_size(file.m_size), m_ious(file.m_ious)
+    {
+        file.m_data = nullptr;
+        file.m_size = 0;
+        file.m_ious = span<const iou>();
+    }
+
+    iou_file::~iou_file() noexcept
+    {
+        if (m_data != nullptr)
+            munmap(const_cast<char*>(m_data), m_size);
+    }
+
+    iou_file& iou_file::operator=(iou_file&& file) noexcept
+    {
+        std::swap(m_data, file.m_data);
+        std::swap(m_size, file.m_size);
+        std::swap(m_ious, file.m_ious);
+        return *this;
+    }
+
+    iou_summary iou_file::summary() const noexcept
+    {
+        iou_summary s;
+        s.minimum = header().minimum;
+        s.maximum = header().maximum;
+        s.average = header().average;
+        s.count   = m_ious.size();
+        return s;
+    }
+}
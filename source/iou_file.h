@@ -0,0 +1,150 @@
+#ifndef ANALYZE_IOU_FILE_H
+#define ANALYZE_IOU_FILE_H
+
+#include "analysis.h"
+#include <cstdint>
+#include <string>
+
+namespace analyze
+{
+    /// Identifies a binary IoU file: "ANIU".
+    constexpr std::uint32_t iou_file_magic = 0x55494e41;
+
+    /// The version of the binary IoU file format.
+    constexpr std::uint32_t iou_file_version = 1;
+
+    /**
+     * \brief       The start of a binary IoU file.
+     * \details     The header is 64 bytes, and the IoU values follow it as an array of 32 bit
+     *              floats, so a consumer which does not link this library can map the file and read
+     *              the values at \a values. Numbers are in the host's byte order; \a magic reads
+     *              as "ANIU" in a little endian file.
+     */
+    struct iou_file_header final
+    {
+        std::uint32_t magic;       ///< iou_file_magic.
+        std::uint32_t version;     ///< iou_file_version.
+        std::uint64_t count;       ///< The number of IoU values.
+        std::uint64_t first_frame; ///< The frame of the first IoU value.
+        std::uint64_t stride;      ///< IoU value \a i is for frame \a first_frame + \a i * \a stride.
+        std::uint64_t values;      ///< The file offset of the values.
+        float         minimum;     ///< The summarize() minimum of the values.
+        float         maximum;     ///< The summarize() maximum of the values.
+        float         average;     ///< The summarize() average of the values.
+        std::uint32_t reserved[3]; ///< 0, for later versions.
+    };
+
+    static_assert(sizeof(iou_file_header) == 64, "the IoU file header is part of the file format");
+
+    /**
+     * \brief       Write a list of IoU values to a binary IoU file.
+     * \param[in]   ious        The IoU values to write.
+     * \param[in]   file_name   The file to write. An existing file is replaced.
+     * \param[in]   stride      The frames between IoU values; calculate_ious() uses iou_stride. 0 is
+     *                          treated as 1.
+     * \param[in]   first_frame The frame of the first IoU value.
+     * \throws      std::runtime_error  This is thrown if the file cannot be written.
+     * \throws      std::bad_alloc      This is thrown if memory for the file cannot be allocated.
+     * \details     This holds the same information as write_ious(), but the values are stored,
+     *              not printed, so they read back exactly and a reader does not parse anything. See
+     *              iou_file_header for the format. The file is written to a temporary file and
+     *              renamed, so a reader never sees a partial file.
+     */
+    void write_iou_file(span<const iou> ious,
+                        const std::string& file_name,
+                        const std::size_t stride,
+                        const std::size_t first_frame = 0);
+
+    /**
+     * \brief       A read only view of a binary IoU file, mapped into memory.
+     * \details     The header is checked when the file is opened. After that, the values are read
+     *              in place, without copying them.
+     */
+    class iou_file final
+    {
+    public:
+        /**
+         * \brief       Map a binary IoU file.
+         * \param[in]   file_name   The file to open.
+         * \throws      std::runtime_error  This is thrown if the file cannot be mapped or is not a
+         *                                  valid binary IoU file.
+         */
+        explicit iou_file(const std::string& file_name);
+
+        /// A file owns its mapping, so it cannot be copied.
+        iou_file(const iou_file&) = delete;
+
+        /**
+         * \brief       Move a file.
+         * \param[in]   file    The file to move. It cannot be used afterwards.
+         * \throws      None
+         */
+        iou_file(iou_file&& file) noexcept;
+
+        /**
+         * \brief   Unmap the file.
+         * \throws  None
+         */
+        ~iou_file() noexcept;
+
+        /// A file owns its mapping, so it cannot be copied.
+        iou_file& operator=(const iou_file&) = delete;
+
+        /**
+         * \brief       Move a file.
+         * \param[in]   file    The file to move. It holds this file's mapping afterwards.
+         * \return      A reference to this file.
+         * \throws      None
+         */
+        iou_file& operator=(iou_file&& file) noexcept;
+
+        /**
+         * \brief   Get the IoU values.
+         * \return  The values, in the mapping.
+         * \throws  None
+         */
+        span<const iou> ious() const noexcept { return m_ious; }
+
+        /**
+         * \brief   Get the statistics written with the values.
+         * \return  The minimum, maximum, and average, and the number of values.
+         * \throws  None
+         */
+        iou_summary summary() const noexcept;
+
+        /**
+         * \brief       Find the frame an IoU value is for.
+         * \param[in]   index   The position of the value.
+         * \return      The frame number.
+         * \throws      None
+         */
+        std::uint64_t frame(const std::size_t index) const noexcept
+        {
+            return header().first_frame + index * header().stride;
+        }
+
+        /**
+         * \brief   Get the file's header.
+         * \return  The header, in the mapping.
+         * \throws  None
+         */
+        const iou_file_header& header() const noexcept { return *reinterpret_cast<const iou_file_header*>(m_data); }
+
+    private:
+        const char*     m_data = nullptr; ///< The mapping.
+        std::size_t     m_size = 0;       ///< The size of the mapping.
+        span<const iou> m_ious;           ///< The values.
+    };
+
+    /**
+     * \brief       Check whether a file is a binary IoU file.
+     * \param[in]   file_name   The file to check.
+     * \retval      true        The file starts with iou_file_magic.
+     * \retval      false       The file cannot be read, or starts with something else, as a text
+     *                          IoU file does.
+     * \throws      None
+     */
+    bool is_iou_file(const std::string& file_name) noexcept;
+}
+
+#endif
@@ -0,0 +1,78 @@
+#include "iou_matrix.h"
+#include <algorithm>
+
+namespace analyze
+{
+    namespace
+    {
+        /// The number of boxes in one side of a tile. 64 boxes in SoA form fit in 1 KiB.
+        constexpr std::size_t tile_size = 64;
+    }
+
+    //-------------------------------------------------------
+    //                             iou_matrix class methods
+    //-------------------------------------------------------
+    iou_matrix::iou_matrix(const size_type rows, const size_type columns)
+        : m_rows(rows), m_columns(columns), m_values(rows * columns, 0.0f)
+    {
+    }
+
+    //-------------------------------------------------------
+    //                                IoU matrix calculation
+    //-------------------------------------------------------
+    void calculate_iou_matrix(const bounding_box<float>* results,
+                              const std::size_t          result_count,
+                              const bounding_box<float>* ground_truth,
+                              const std::size_t          truth_count,
+                              iou::value_type*           matrix) noexcept
+    {
+        float left[tile_size], right[tile_size], top[tile_size], bottom[tile_size],
+            truth_area[tile_size];
+
+        for (std::size_t c0 = 0; c0 < truth_count; c0 += tile_size)
+        {
+            // unpack the ground truth tile into SoA form
+            const auto columns = std::min(tile_size, truth_count - c0);
+            for (std::size_t c = 0; c < columns; ++c)
+            {
+                const auto& g = ground_truth[c0 + c];
+                left[c]       = g.left();
+                right[c]      = g.right();
+                top[c]        = g.top();
+                bottom[c]     = g.bottom();
+                truth_area[c] = area(g);
+            }
+
+            for (std::size_t r0 = 0; r0 < result_count; r0 += tile_size)
+            {
+                const auto rows = std::min(tile_size, result_count - r0);
+                for (std::size_t r = 0; r < rows; ++r)
+                {
+                    const auto& b = results[r0 + r];
+                    const float b_left = b.left(), b_right = b.right(), b_top = b.top(),
+                                b_bottom = b.bottom(), b_area = area(b);
+                    float* row = matrix + (r0 + r) * truth_count + c0;
+                    for (std::size_t c = 0; c < columns; ++c)
+                    {
+                        const float w = std::max(0.0f, std::min(b_right, right[c]) - std::max(b_left, left[c]));
+                        const float h = std::max(0.0f, std::min(b_bottom, bottom[c]) - std::max(b_top, top[c]));
+                        const float overlap  = w * h;
+                        const float combined = b_area + truth_area[c] - overlap;
+                        row[c] = combined > 0.0f ? overlap / combined : 0.0f;
+                    }
+                }
+            }
+        }
+    }
+
+    iou_matrix make_iou_matrix(const box_list& results, const box_list& ground_truth)
+    {
+        iou_matrix matrix(results.size(), ground_truth.size());
+        calculate_iou_matrix(results.data(),
+                             results.size(),
+                             ground_truth.data(),
+                             ground_truth.size(),
+                             matrix.data());
+        return matrix;
+    }
+}
@@ -0,0 +1,162 @@
+#include "leaderboard.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+namespace analyze
+{
+    namespace
+    {
+        /// The number of frames in one tile. 256 frames of five columns fit in 5 KiB.
+        constexpr std::size_t tile_size = 256;
+
+        /**
+         * \brief       Evaluate one sequence for every tracker.
+         * \param[in]   options     The trackers and settings.
+         * \param[in]   s           The index of the sequence in \a options.
+         * \param[out]  board       The results are written to column \a s.
+         * \throws      None
+         */
+        void evaluate_sequence(const leaderboard_options& options, const std::size_t s, leaderboard& board) noexcept
+        {
+            const auto& sequence = options.sequences[s];
+            try
+            {
+                const truth_columns truth(load_results(options.truth_directory + "/" + sequence + "/" + sequence + "_gt.txt"),
+                                          iou_stride);
+
+                std::vector<box_list> results(options.trackers.size());
+                std::vector<std::size_t> loaded;
+                for (std::size_t t = 0; t < options.trackers.size(); ++t)
+                {
+                    try
+                    {
+                        results[loaded.size()] = load_results(options.trackers[t] + "/" + sequence + ".boxes");
+                        loaded.push_back(t);
+                    }
+                    catch (std::exception& e)
+                    {
+                        board[t][s].error = e.what();
+                    }
+                }
+                results.resize(loaded.size());
+
+                const auto ious = calculate_tracker_ious(truth, results);
+                for (std::size_t l = 0; l < loaded.size(); ++l)
+                {
+                    auto& result = board[loaded[l]][s];
+                    if (options.write_ious)
+                        write_ious(ious[l], options.trackers[loaded[l]] + "/" + sequence + ".ious");
+                    result.summary = summarize(ious[l]);
+                    result.ok      = true;
+                }
+            }
+            catch (std::exception& e)
+            {
+                for (auto& row : board)
+                {
+                    if (row[s].error.empty())
+                        row[s] = sequence_result {false, iou_summary(), e.what()};
+                }
+            }
+        }
+    }
+
+    //-------------------------------------------------------
+    //                           truth_columns class methods
+    //-------------------------------------------------------
+    truth_columns::truth_columns(const box_span ground_truth, const std::size_t stride)
+        : m_stride(std::max(stride, std::size_t(1))), m_frames(ground_truth.size())
+    {
+        const auto count = (m_frames + m_stride - 1) / m_stride;
+        m_left.reserve(count);
+        m_right.reserve(count);
+        m_top.reserve(count);
+        m_bottom.reserve(count);
+        m_area.reserve(count);
+        for (std::size_t f = 0; f < m_frames; f += m_stride)
+        {
+            const auto& g = ground_truth[f];
+            m_left.push_back(g.left());
+            m_right.push_back(g.right());
+            m_top.push_back(g.top());
+            m_bottom.push_back(g.bottom());
+            m_area.push_back(analyze::area(g));
+        }
+    }
+
+    //-------------------------------------------------------
+    //                               leaderboard calculation
+    //-------------------------------------------------------
+    std::vector<iou_list> calculate_tracker_ious(const truth_columns& truth, const span<const box_list> trackers)
+    {
+        std::vector<iou_list> ious(trackers.size());
+        for (std::size_t t = 0; t < trackers.size(); ++t)
+        {
+            const auto length = std::min(trackers[t].size(), truth.frames());
+            ious[t].resize((length + truth.stride() - 1) / truth.stride());
+        }
+
+        const auto* const left   = truth.left();
+        const auto* const right  = truth.right();
+        const auto* const top    = truth.top();
+        const auto* const bottom = truth.bottom();
+        const auto* const areas  = truth.area();
+        for (std::size_t i0 = 0; i0 < truth.size(); i0 += tile_size)
+        {
+            for (std::size_t t = 0; t < trackers.size(); ++t)
+            {
+                const auto& boxes = trackers[t];
+                auto& values      = ious[t];
+                const auto end    = std::min(i0 + tile_size, values.size());
+                for (auto i = i0; i < end; ++i)
+                {
+                    // the same operations, in the same order, as make_iou()
+                    const auto& b = boxes[i * truth.stride()];
+                    const bool disjoint = b.bottom() < top[i] || bottom[i] < b.top() ||
+                                          b.right() < left[i] || right[i] < b.left();
+                    const float overlap = disjoint ? 0.0f :
+                        std::fabs(std::max(b.left(), left[i]) - std::min(b.right(), right[i])) *
+                        std::fabs(std::max(b.top(), top[i]) - std::min(b.bottom(), bottom[i]));
+                    values[i] = iou(overlap / (area(b) + areas[i] - overlap));
+                }
+            }
+        }
+        return ious;
+    }
+
+    leaderboard evaluate_leaderboard(const leaderboard_options& options)
+    {
+        if (options.truth_directory.empty())
+            throw std::invalid_argument("the leaderboard needs a truth directory");
+        leaderboard board(options.trackers.size(), std::vector<sequence_result>(options.sequences.size()));
+
+        auto threads = options.thread_count;
+        if (threads == 0)
+            threads = std::max(std::thread::hardware_concurrency(), 1u);
+        threads = static_cast<unsigned>(std::min<std::size_t>(threads, options.sequences.size()));
+
+        // each sequence writes its own column, so the workers share nothing but the counter
+        std::atomic<std::size_t> next(0);
+        const auto work = [&options, &board, &next]() {
+            for (auto s = next++; s < options.sequences.size(); s = next++)
+                evaluate_sequence(options, s, board);
+        };
+        // the calling thread works too, so it takes the sequences of any worker which cannot start
+        std::vector<std::thread> workers;
+        try
+        {
+            for (unsigned w = 1; w < threads; ++w)
+                workers.emplace_back(work);
+        }
+        catch (...)
+        {
+        }
+        work();
+        for (auto& w : workers)
+            w.join();
+        return board;
+    }
+}
@@ -0,0 +1,133 @@
+#ifndef ANALYZE_LEADERBOARD_H
+#define ANALYZE_LEADERBOARD_H
+
+#include "analysis.h"
+#include "protocol.h"
+#include <string>
+#include <vector>
+
+namespace analyze
+{
+    /**
+     * \brief       The compared frames of a ground truth sequence, in structure-of-arrays form.
+     * \details     Only every \a stride frame is kept, and each box's area is calculated once, so
+     *              comparing several trackers against the same ground truth reads five dense
+     *              arrays instead of reloading and unpacking the boxes for each tracker.
+     */
+    class truth_columns final
+    {
+    public:
+        /**
+         * \brief       Unpack ground truth boxes.
+         * \param[in]   ground_truth    The ground truth boxes, one for each frame.
+         * \param[in]   stride          Only every \a stride frame is kept. A stride of 0 is treated
+         *                              as 1.
+         * \throws      std::bad_alloc  This is thrown if memory for the columns cannot be allocated.
+         */
+        truth_columns(box_span ground_truth, const std::size_t stride);
+
+        /**
+         * \brief   Query the number of kept frames.
+         * \return  The number of boxes in each column.
+         * \throws  None
+         */
+        std::size_t size() const noexcept { return m_left.size(); }
+
+        /**
+         * \brief   Query the frame stride.
+         * \return  The number of frames between kept boxes.
+         * \throws  None
+         */
+        std::size_t stride() const noexcept { return m_stride; }
+
+        /**
+         * \brief   Query the length of the sequence.
+         * \return  The number of ground truth frames, including those which were not kept.
+         * \throws  None
+         */
+        std::size_t frames() const noexcept { return m_frames; }
+
+        /**
+         * \brief   Get the columns of box coordinates and areas.
+         * \return  The first of size() values.
+         * \throws  None
+         */
+        const float* left() const noexcept { return m_left.data(); }
+
+        /// \copydoc left()
+        const float* right() const noexcept { return m_right.data(); }
+
+        /// \copydoc left()
+        const float* top() const noexcept { return m_top.data(); }
+
+        /// \copydoc left()
+        const float* bottom() const noexcept { return m_bottom.data(); }
+
+        /// \copydoc left()
+        const float* area() const noexcept { return m_area.data(); }
+
+    private:
+        std::size_t        m_stride;     ///< The number of frames between kept boxes.
+        std::size_t        m_frames;     ///< The length of the sequence.
+        std::vector<float> m_left;       ///< The left edge of each kept box.
+        std::vector<float> m_right;      ///< The right edge of each kept box.
+        std::vector<float> m_top;        ///< The top edge of each kept box.
+        std::vector<float> m_bottom;     ///< The bottom edge of each kept box.
+        std::vector<float> m_area;       ///< The area of each kept box.
+    };
+
+    /**
+     * \brief       Calculate IoU values for several trackers against the same ground truth.
+     * \param[in]   truth       The ground truth.
+     * \param[in]   trackers    The result boxes of each tracker.
+     * \return      One IoU list for each tracker. Each list is the same, bit for bit, as
+     *              calculate_ious() gives for the tracker's results and the ground truth, at the
+     *              truth's stride.
+     * \throws      std::bad_alloc  This is thrown if memory for the IoU lists cannot be allocated.
+     * \details     The frames are processed in tiles. Every tracker is compared against a tile
+     *              before the next tile is read, so the ground truth is read from memory once no
+     *              matter how many trackers there are.
+     */
+    std::vector<iou_list> calculate_tracker_ious(const truth_columns& truth, span<const box_list> trackers);
+
+    /// The settings for evaluate_leaderboard().
+    struct leaderboard_options final
+    {
+        /// The directories holding each tracker's <em>sequence</em>.boxes files.
+        std::vector<std::string> trackers;
+
+        /// The sequences to evaluate.
+        std::vector<std::string> sequences;
+
+        /// The directory holding <em>sequence</em>/<em>sequence</em>_gt.txt for each sequence. It is
+        /// required.
+        std::string truth_directory;
+
+        /// The number of sequences evaluated at once. 0 uses one per processor.
+        unsigned thread_count = 0;
+
+        /// If true, each tracker's IoUs are written to <em>sequence</em>.ious in its directory.
+        bool write_ious = true;
+    };
+
+    /// The result of every tracker on every sequence; one row per tracker, in order.
+    using leaderboard = std::vector<std::vector<sequence_result>>;
+
+    /**
+     * \brief       Evaluate several trackers on the same sequences.
+     * \param[in]   options The trackers, sequences, and settings.
+     * \return      One row for each tracker, with one result for each sequence.
+     * \throws      std::invalid_argument   This is thrown if \a options has no truth directory.
+     * \throws      std::bad_alloc          This is thrown if memory for the results cannot be
+     *                                      allocated.
+     * \details     Each sequence's ground truth is loaded once and unpacked into truth_columns,
+     *              and then every tracker is compared against it with calculate_tracker_ious().
+     *              Sequences are spread over the worker threads, and the calling thread; if a
+     *              worker cannot be started, the others take its sequences. A file which cannot be
+     *              read only fails the results which need it, with the reason in
+     *              sequence_result::error.
+     */
+    leaderboard evaluate_leaderboard(const leaderboard_options& options);
+}
+
+#endif
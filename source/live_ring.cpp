@@ -0,0 +1,236 @@
+#include "live_ring.h"
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <new>
+#include <signal.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "shared ring indices must be lock free to work across processes");
+
+namespace analyze
+{
+    namespace
+    {
+        /// The size of a cache line, used to keep the producer and consumer indices apart.
+        constexpr std::size_t cache_line = 64;
+
+        /// Identifies shared memory which holds an initialized ring.
+        constexpr std::uint64_t ring_magic = 0x676e69722d7a6c61; // "alz-ring"
+
+        /**
+         * \brief       Make an error message which includes the system error.
+         * \param[in]   what    The operation which failed.
+         * \param[in]   name    The shared memory name.
+         * \return      The error message.
+         * \throws      std::bad_alloc  This is thrown if memory for the message cannot be
+         *                              allocated.
+         */
+        std::string system_error(const std::string& what, const std::string& name)
+        {
+            return "could not " + what + " live ring " + name + ": " + std::strerror(errno);
+        }
+    }
+
+    /// The start of the shared memory. The records follow it.
+    struct live_ring::shared_header final
+    {
+        std::atomic<std::uint64_t> magic;    ///< ring_magic once the ring is initialized.
+        size_type                  capacity; ///< The number of record slots.
+
+        alignas(cache_line) std::atomic<size_type> head;     ///< The producer's next position.
+        alignas(cache_line) std::atomic<size_type> tail;     ///< The consumer's next position.
+        alignas(cache_line) std::atomic<std::uint32_t> done; ///< Set when the producer closes.
+        std::atomic<std::int32_t> producer;                  ///< The producer's process ID, or 0.
+    };
+
+    //-------------------------------------------------------
+    //                               live_ring class methods
+    //-------------------------------------------------------
+    live_ring::live_ring(const std::string& name, const size_type capacity) : m_name(name)
+    {
+        // the capacity is rounded up to a power of 2, and the whole ring must fit in a file
+        constexpr auto largest_slots = size_type(1) << (std::numeric_limits<size_type>::digits - 1);
+        constexpr auto largest_bytes = static_cast<size_type>(std::numeric_limits<off_t>::max());
+        if (capacity == 0)
+            throw std::invalid_argument("a live ring needs a capacity of at least 1");
+        if (capacity > largest_slots)
+            throw std::invalid_argument("a live ring's capacity is too large");
+        size_type slots = 1;
+        while (slots < capacity)
+            slots <<= 1;
+        if (slots > (largest_bytes - sizeof(shared_header)) / sizeof(live_record))
+            throw std::invalid_argument("a live ring's capacity is too large");
+
+        // another consumer may still be using a ring with this name, so it is never replaced
+        const int descriptor = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (descriptor < 0)
+        {
+            if (errno == EEXIST)
+                throw std::runtime_error("could not create live ring " + name + ": it already exists; if no "
+                                         "consumer is running, remove /dev/shm" + name);
+            throw std::runtime_error(system_error("create", name));
+        }
+
+        const auto bytes = sizeof(shared_header) + slots * sizeof(live_record);
+        if (ftruncate(descriptor, static_cast<off_t>(bytes)) != 0)
+        {
+            const auto message = system_error("size", name);
+            ::close(descriptor);
+            shm_unlink(name.c_str());
+            throw std::runtime_error(message);
+        }
+
+        try
+        {
+            map(descriptor, bytes, name);
+        }
+        catch (...)
+        {
+            shm_unlink(name.c_str());
+            throw;
+        }
+
+        m_header = new (m_memory) shared_header;
+        m_header->capacity = slots;
+        m_header->head.store(0, std::memory_order_relaxed);
+        m_header->tail.store(0, std::memory_order_relaxed);
+        m_header->done.store(0, std::memory_order_relaxed);
+        m_header->producer.store(0, std::memory_order_relaxed);
+        m_header->magic.store(ring_magic, std::memory_order_release);
+        m_slots = reinterpret_cast<live_record*>(static_cast<char*>(m_memory) + sizeof(shared_header));
+        m_mask  = slots - 1;
+    }
+
+    live_ring::live_ring(const std::string& name)
+    {
+        const int descriptor = shm_open(name.c_str(), O_RDWR, 0);
+        if (descriptor < 0)
+            throw std::runtime_error(system_error("open", name));
+
+        struct stat status;
+        if (fstat(descriptor, &status) != 0 || static_cast<std::size_t>(status.st_size) < sizeof(shared_header))
+        {
+            ::close(descriptor);
+            throw std::runtime_error("shared memory " + name + " is not a live ring");
+        }
+        map(descriptor, static_cast<std::size_t>(status.st_size), name);
+
+        m_header = static_cast<shared_header*>(m_memory);
+        const auto slots = m_header->capacity;
+        if (m_header->magic.load(std::memory_order_acquire) != ring_magic || slots == 0 ||
+            (slots & (slots - 1)) != 0 || sizeof(shared_header) + slots * sizeof(live_record) > m_bytes)
+        {
+            munmap(m_memory, m_bytes);
+            throw std::runtime_error("shared memory " + name + " is not a live ring");
+        }
+        m_slots       = reinterpret_cast<live_record*>(static_cast<char*>(m_memory) + sizeof(shared_header));
+        m_mask        = slots - 1;
+        m_cached_head = m_header->head.load(std::memory_order_acquire);
+        m_cached_tail = m_header->tail.load(std::memory_order_acquire);
+        m_header->producer.store(static_cast<std::int32_t>(getpid()), std::memory_order_release);
+    }
+
+    live_ring::live_ring(live_ring&& ring) noexcept
+        : m_name(std::move(ring.m_name)),
+          m_memory(ring.m_memory),
+          m_bytes(ring.m_bytes),
+          m_header(ring.m_header),
+          m_slots(ring.m_slots),
+          m_mask(ring.m_mask),
+          m_cached_head(ring.m_cached_head),
+          m_cached_tail(ring.m_cached_tail)
+    {
+        ring.m_name.clear();
+        ring.m_memory = nullptr;
+        ring.m_header = nullptr;
+        ring.m_slots  = nullptr;
+    }
+
+    live_ring::~live_ring() noexcept
+    {
+        if (m_memory != nullptr)
+            munmap(m_memory, m_bytes);
+        if (!m_name.empty())
+            shm_unlink(m_name.c_str());
+    }
+
+    live_ring& live_ring::operator=(live_ring&& ring) noexcept
+    {
+        std::swap(m_name, ring.m_name);
+        std::swap(m_memory, ring.m_memory);
+        std::swap(m_bytes, ring.m_bytes);
+        std::swap(m_header, ring.m_header);
+        std::swap(m_slots, ring.m_slots);
+        std::swap(m_mask, ring.m_mask);
+        std::swap(m_cached_head, ring.m_cached_head);
+        std::swap(m_cached_tail, ring.m_cached_tail);
+        return *this;
+    }
+
+    bool live_ring::try_push(const live_record& record) noexcept
+    {
+        const auto head = m_header->head.load(std::memory_order_relaxed);
+        if (head - m_cached_tail > m_mask)
+        {
+            m_cached_tail = m_header->tail.load(std::memory_order_acquire);
+            if (head - m_cached_tail > m_mask)
+                return false;
+        }
+        m_slots[head & m_mask] = record;
+        m_header->head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool live_ring::try_pop(live_record& record) noexcept
+    {
+        const auto tail = m_header->tail.load(std::memory_order_relaxed);
+        if (tail == m_cached_head)
+        {
+            m_cached_head = m_header->head.load(std::memory_order_acquire);
+            if (tail == m_cached_head)
+                return false;
+        }
+        record = m_slots[tail & m_mask];
+        m_header->tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    void live_ring::close() noexcept
+    {
+        m_header->done.store(1, std::memory_order_release);
+    }
+
+    bool live_ring::closed() const noexcept
+    {
+        return m_header->done.load(std::memory_order_acquire) != 0;
+    }
+
+    bool live_ring::attached() const noexcept
+    {
+        return m_header->producer.load(std::memory_order_acquire) != 0;
+    }
+
+    bool live_ring::producer_alive() const noexcept
+    {
+        const auto producer = static_cast<pid_t>(m_header->producer.load(std::memory_order_acquire));
+        return producer == 0 || kill(producer, 0) == 0 || errno != ESRCH;
+    }
+
+    void live_ring::map(const int descriptor, const std::size_t bytes, const std::string& name)
+    {
+        void* memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+        const auto message = memory == MAP_FAILED ? system_error("map", name) : std::string();
+        ::close(descriptor);
+        if (memory == MAP_FAILED)
+            throw std::runtime_error(message);
+        m_memory = memory;
+        m_bytes  = bytes;
+    }
+}
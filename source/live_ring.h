@@ -0,0 +1,170 @@
+#ifndef ANALYZE_LIVE_RING_H
+#define ANALYZE_LIVE_RING_H
+
+#include "bounding_box.h"
+#include <cstdint>
+#include <string>
+
+namespace analyze
+{
+    /// One tracker result, as passed through a live_ring.
+    struct live_record final
+    {
+        std::uint64_t       frame = 0; ///< The frame number, counting from 0.
+        bounding_box<float> box;       ///< The tracker's box for the frame.
+    };
+
+    /**
+     * \brief       A single producer, single consumer ring buffer of tracker results in POSIX
+     *              shared memory.
+     * \details     One process, usually <tt>analyze --live</tt>, creates the ring, and the tracker
+     *              opens it by name. The tracker pushes one live_record per frame and the consumer
+     *              pops them. Pushing and popping are wait free: each side owns one index, and
+     *              publishes it with a release store. Neither touches the kernel, so the latency
+     *              from push to pop is bounded by how often the consumer polls.
+     *
+     *              The producer and consumer indices live on separate cache lines, and each side
+     *              keeps a private copy of the other side's index, so the shared lines are only
+     *              read when the ring looks full or empty.
+     */
+    class live_ring final
+    {
+    public:
+        /// The type used for ring positions and sizes.
+        using size_type = std::uint64_t;
+
+        /**
+         * \brief       Create a ring in shared memory.
+         * \param[in]   name        The shared memory name. It must start with a '/'; see
+         *                          shm_open().
+         * \param[in]   capacity    The minimum number of records the ring can hold. It is rounded
+         *                          up to a power of 2.
+         * \throws      std::invalid_argument   This is thrown if \a capacity is 0, or if the ring
+         *                                      would be too large to map.
+         * \throws      std::runtime_error      This is thrown if the shared memory cannot be
+         *                                      created or mapped, or if \a name already exists.
+         * \details     The ring removes the shared memory name when it is destroyed. Processes
+         *              which have already opened the ring keep their mapping. An existing name is
+         *              never replaced, since another consumer may still be reading it; a ring left
+         *              behind by a consumer which was killed has to be removed by hand.
+         */
+        live_ring(const std::string& name, const size_type capacity);
+
+        /**
+         * \brief       Open a ring which another process created.
+         * \param[in]   name    The shared memory name given to the creator.
+         * \throws      std::runtime_error  This is thrown if the shared memory cannot be opened or
+         *                                  mapped, or does not hold a ring.
+         * \details     The opening process is the producer: its process ID is recorded in the ring,
+         *              so the consumer can tell if it exits without calling close().
+         */
+        explicit live_ring(const std::string& name);
+
+        /// A ring owns a mapping, so it cannot be copied.
+        live_ring(const live_ring&) = delete;
+
+        /**
+         * \brief   Move a ring.
+         * \throws  None
+         */
+        live_ring(live_ring&& ring) noexcept;
+
+        /**
+         * \brief   Unmap the ring, and remove its name if this process created it.
+         * \throws  None
+         */
+        ~live_ring() noexcept;
+
+        /// A ring owns a mapping, so it cannot be copied.
+        live_ring& operator=(const live_ring&) = delete;
+
+        /**
+         * \brief   Move a ring.
+         * \return  A reference to this ring.
+         * \throws  None
+         */
+        live_ring& operator=(live_ring&& ring) noexcept;
+
+        /**
+         * \brief   Query the number of records the ring can hold.
+         * \return  The ring's capacity, a power of 2.
+         * \throws  None
+         */
+        size_type capacity() const noexcept { return m_mask + 1; }
+
+        /**
+         * \brief       Add a record to the ring. Only one thread may push.
+         * \param[in]   record  The record to add.
+         * \retval      true    The record was added.
+         * \retval      false   The ring is full; nothing was added.
+         * \throws      None
+         */
+        bool try_push(const live_record& record) noexcept;
+
+        /**
+         * \brief       Remove the oldest record from the ring. Only one thread may pop.
+         * \param[out]  record  The removed record. This is unchanged if the ring is empty.
+         * \retval      true    A record was removed.
+         * \retval      false   The ring is empty.
+         * \throws      None
+         */
+        bool try_pop(live_record& record) noexcept;
+
+        /**
+         * \brief   Mark the end of the stream. The producer calls this after its last push.
+         * \throws  None
+         */
+        void close() noexcept;
+
+        /**
+         * \brief   Query if the producer has finished.
+         * \retval  true    The producer called close(). Records may still be waiting to be popped.
+         * \retval  false   The producer may push more records.
+         * \throws  None
+         */
+        bool closed() const noexcept;
+
+        /**
+         * \brief   Query if a producer has opened the ring.
+         * \retval  true    A process has opened the ring by name.
+         * \retval  false   The ring has not been opened yet.
+         * \throws  None
+         */
+        bool attached() const noexcept;
+
+        /**
+         * \brief   Check that the producer is still running. This makes a system call, so a
+         *          consumer should only check it occasionally while the ring is empty.
+         * \retval  true    The producer is running, or has not opened the ring yet.
+         * \retval  false   The producer exited. If it did not call close(), it will push nothing
+         *                  more.
+         * \throws  None
+         */
+        bool producer_alive() const noexcept;
+
+    private:
+        /// The layout of the shared memory; see live_ring.cpp.
+        struct shared_header;
+
+        /**
+         * \brief       Map the shared memory.
+         * \param[in]   descriptor  The shared memory file descriptor. It is closed before this
+         *                          returns.
+         * \param[in]   bytes       The number of bytes to map.
+         * \param[in]   name        The shared memory name, for error messages.
+         * \throws      std::runtime_error  This is thrown if the memory cannot be mapped.
+         */
+        void map(const int descriptor, const std::size_t bytes, const std::string& name);
+
+        std::string    m_name;              ///< The shared memory name, if this process owns it.
+        void*          m_memory = nullptr;  ///< The start of the mapping.
+        std::size_t    m_bytes  = 0;        ///< The size of the mapping.
+        shared_header* m_header = nullptr;  ///< The shared indices.
+        live_record*   m_slots  = nullptr;  ///< The shared records.
+        size_type      m_mask   = 0;        ///< The capacity minus 1, for wrapping positions.
+        size_type      m_cached_head = 0;   ///< The consumer's copy of the producer's position.
+        size_type      m_cached_tail = 0;   ///< The producer's copy of the consumer's position.
+    };
+}
+
+#endif
@@ -1,77 +1,50 @@
-#include "bounding_box.h"
-#include "comma_ctype.h"
-#include "iou.h"
+#include "analysis.h"
+#include "archive.h"
+#include "attributes.h"
+#include "batch_reader.h"
+#include "bootstrap.h"
+#include "chunked.h"
+#include "dataset.h"
+#include "incremental.h"
+#include "iou_file.h"
+#include "leaderboard.h"
+#include "live_ring.h"
+#include "mask.h"
+#include "matching.h"
+#include "mot.h"
+#include "nms.h"
+#include "polygon.h"
+#include "result_store.h"
+#include "robustness.h"
+#include "sampling.h"
+#include "server.h"
 #include "version.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
+#include <iomanip>
+#include <initializer_list>
 #include <iostream>
-#include <numeric>
+#include <limits>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
 #include <vector>
 
 
 namespace analyze
 {
-    /// Alias the type representing a list of bounding boxes.
-    using box_list = std::vector<bounding_box<float>>;
-
-    /// Alias the type representing a list of IoU objects.
-    using iou_list = std::vector<iou>;
-
-    /**
-     * \brief       Read bounding box data from a file.
-     * \param[in]   file_name   The path to the file containing the bounding box data.
-     * \return      A list of bounding box data from the file.
-     * \throws      std::runtime_error  This is thrown if the file cannot be opened.
-     * \details     Bounding box data in the file must adhere to these restrictions:
-     *              \li The file must be plain text.
-     *              \li Each line must correspond to one frame of imagery or video.
-     *              \li Each line must contain four values, in this order: bounding box left edge,
-     *              bounding box width, bounding box top edge, bounding box height, all measured in
-     *              pixels.
-     *              \li Fractional pixels are allowed, but not required.
-     *              \li Each value in a line must be separated by a comma.
-     *              \li Nothing else may be on the line.
-     *              Results are undefined if the file violates any of these restrictions.
-     */
-    box_list load_results(const std::string& file_name)
-    {
-        std::ifstream file(file_name.c_str());
-        if (!file)
-            throw std::runtime_error("could not open results file " + file_name);
-
-        std::locale comma_delimiter(std::locale::classic(), new ctype);
-        file.imbue(comma_delimiter);
-
-        float left, width, top, height;
-        box_list boxes;
-        while (file)
-        {
-            file >> left >> width >> top >> height;
-            if (file)
-                boxes.emplace_back(left, left + width, top, top + height);
-        }
-        return boxes;
-    }
-
-    /**
-     * \brief       Calculate IoU values for two lists of bounding boxes.
-     * \param[in]   results         The list of bounding boxes representing algorithm results.
-     * \param[in]   ground_truth    The list of bounding boxes representing ground truth.
-     * \return      A list of intersection-over-union (IoU) values.
-     * \throws      None
-     * \details     Each entry in the IoU list is the IoU for the corresponding entries in the
-     *              \a results and \a ground_truth lists. The IoU formula is:
-     *              \f$ IoU(B,G) = \frac{B \cap G}{B \cup G} \f$
-     */
-    iou_list calculate_ious(const box_list& results, const box_list& ground_truth) noexcept
-    {
-        iou_list ious;
-
-        constexpr box_list::size_type stride = 5;
-        const auto length = std::min(results.size(), ground_truth.size());
-        for (box_list::size_type b = 0; b < length; b += stride)
-            ious.emplace_back(make_iou(results[b], ground_truth[b]));
-        return ious;
-    }
+    /// The directory holding the struck_data, mot_data, and vot_data ground truth, unless --data is given.
+    constexpr const char* default_data_directory = "/home/brendan/Videos";
 
     /**
      * \brief       Write a list of bounding boxes to a file.
@@ -93,86 +66,1378 @@ namespace analyze
         }
     }
 
+    /**
+     * \brief       Determine if there are an equal number of results as ground truth.
+     * \param[in]   results         The number of algorithm results bounding boxes.
+     * \param[in]   ground_truth    The number of ground truth bounding boxes.
+     * \throws      None
+     */
+    void validate_box_counts(const std::size_t results, const std::size_t ground_truth) noexcept
+    {
+        if (results != ground_truth)
+        {
+            std::cerr << "warning: There are " << results << " results boxes, and " << ground_truth << " ground truth boxes.\n"
+                      << "         Only the first " << std::min(results, ground_truth) << " boxes will be considered.\n";
+        }
+    }
+
     /**
      * \brief       Determine if there are an equal number of results as ground truth.
      * \param[in]   results         The list of algorithm results bounding boxes.
      * \param[in]   ground_truth    The list of ground truth bounding boxes.
      * \throws      None
      */
-    void validate_box_lists(const box_list& results, const box_list& ground_truth) noexcept
+    void validate_box_lists(const box_span results, const box_span ground_truth) noexcept
     {
-        if (results.size() != ground_truth.size())
+        validate_box_counts(results.size(), ground_truth.size());
+    }
+
+    /**
+     * \brief       Add a sequence's attribute statistics to the dataset's.
+     * \param[in]       paths       The sequence's files. Attributes are read from the ground
+     *                              truth's directory.
+     * \param[in]       ious        The sequence's IoU series, from calculate_ious().
+     * \param[in,out]   attributes  The dataset's statistics. If this is null, nothing is done.
+     * \throws          std::runtime_error  This is thrown if an attribute file cannot be parsed.
+     * \throws          std::length_error   This is thrown if the sequence has too many attributes.
+     */
+    void add_attributes(const sequence_paths& paths, const iou_list& ious, std::vector<attribute_statistics>* attributes)
+    {
+        if (attributes == nullptr)
+            return;
+        const auto slash = paths.ground_truth.rfind('/');
+        const auto directory = slash == std::string::npos ? std::string(".") : paths.ground_truth.substr(0, slash);
+        merge_attributes(*attributes, summarize_attributes(ious, iou_stride, load_attributes(directory)));
+    }
+
+    /**
+     * \brief       Write a sequence's IoU series.
+     * \param[in]   ious        The series, from calculate_ious().
+     * \param[in]   file_name   The file to write.
+     * \param[in]   binary      If true, the file is a binary IoU file; see iou_file_header.
+     *                          Otherwise, it is the text write_ious() writes.
+     * \throws      std::runtime_error  This is thrown if a binary file cannot be written.
+     */
+    void save_ious(const span<const iou> ious, const std::string& file_name, const bool binary)
+    {
+        if (binary)
+            write_iou_file(ious, file_name, iou_stride);
+        else
+            write_ious(ious, file_name);
+    }
+
+    /**
+     * \brief       Describe every setting which changes a sequence's IoU series or its summary.
+     * \param[in]   policy      The validation policy the boxes are parsed with.
+     * \param[in]   convention  The convention the boxes are parsed with.
+     * \return      The configuration part of the sequence's store key; see make_store_key().
+     * \throws      std::bad_alloc  This is thrown if memory for the description cannot be
+     *                              allocated.
+     * \details     Change this if calculate_ious() or summarize() changes. A file which fails
+     *              validation never reaches the store, and a valid file parses the same under every
+     *              policy, so only the policies which repair files need their own keys. The same
+     *              goes for conventions other than the original one.
+     */
+    std::string store_configuration(const validation_policy policy, const box_convention convention)
+    {
+        auto configuration = "boxes stride=" + std::to_string(iou_stride) + " sum=pairwise";
+        if (policy == validation_policy::skip)
+            configuration += " invalid=skip";
+        else if (policy == validation_policy::clamp)
+            configuration += " invalid=clamp";
+        if (convention != box_convention::left_width_top_height)
+            configuration += " convention=" + std::to_string(static_cast<int>(convention));
+        return configuration;
+    }
+
+    /**
+     * \brief       Analyze the tracking results for a video or image sequence.
+     * \param[in]   sequence    The sequence's files and boxes, from a sequence_prefetcher.
+     * \param[in]   store       If this is not null, results are reused from and added to this
+     *                          store. The prefetcher must have hashed the files; see
+     *                          analyze_dataset().
+     * \param[in,out]   attributes  If this is not null, the IoU statistics of each of the
+     *                              sequence's attributes are added to it; see load_attributes().
+     * \param[in]   policy      The validation policy the boxes were parsed with.
+     * \param[in]   binary      If true, the output file is a binary IoU file.
+     * \throws      None
+     * \details     This calculates the IoU data for the loaded boxes, and writes it to the
+     *              sequence's output file. With a store, the key is made from the hashes the
+     *              prefetcher took of the files' bytes, and if the store already holds the result,
+     *              the stored IoUs are written without comparing any boxes; the prefetcher did not
+     *              parse them either.
+     */
+    void analyze(const loaded_sequence& sequence,
+                 result_store* store,
+                 std::vector<attribute_statistics>* attributes,
+                 const validation_policy policy,
+                 const bool binary) noexcept
+    {
+        const auto& paths = *sequence.paths;
+        std::cout << "analyzing " << paths.name << "...\n";
+        try
         {
-            std::cerr << "warning: There are " << results.size() << " results boxes, and " << ground_truth.size() << " ground truth boxes.\n"
-                      << "         Only the first " << std::min(results.size(), ground_truth.size()) << " boxes will be considered.\n";
+            if (!sequence.error.empty())
+                throw std::runtime_error(sequence.error);
+
+            store_key key;
+            if (store != nullptr)
+            {
+                key = make_store_key(sequence.results_hash, sequence.truth_hash, store_configuration(policy, paths.convention));
+                stored_result stored;
+                if (store->find(key, stored))
+                {
+                    std::cout << "  unchanged since the last analysis; reusing " << key.hex() << '\n';
+                    save_ious(stored.ious, paths.output, binary);
+                    add_attributes(paths, stored.ious, attributes);
+                    return;
+                }
+            }
+
+            //sanity_check(sequence.results, "results.txt");
+            //sanity_check(sequence.ground_truth, "ground_truth.txt");
+
+            // the result was in the index when the files were read, but is gone now
+            box_list reloaded_results, reloaded_truth;
+            if (sequence.stored)
+            {
+                reloaded_results = load_results(paths.results, policy, paths.convention);
+                reloaded_truth   = load_results(paths.ground_truth, policy, paths.convention);
+            }
+            const auto& results      = sequence.stored ? reloaded_results : sequence.results;
+            const auto& ground_truth = sequence.stored ? reloaded_truth : sequence.ground_truth;
+            validate_box_lists(results, ground_truth);
+            const auto ious = calculate_ious(results, ground_truth);
+            save_ious(ious, paths.output, binary);
+            add_attributes(paths, ious, attributes);
+            if (store != nullptr)
+                store->insert(key, stored_result {ious, summarize(ious)});
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "error in " << __func__ << ": " << e.what() << std::endl;
         }
     }
 
     /**
-     * \brief       Write a list of IoU values to a file.
-     * \param[in]   ious        The list of IoU values to write.
-     * \param[in]   file_name   The path to the file to write.
+     * \brief       Print the pooled IoU statistics of each attribute.
+     * \param[in]   attributes  The statistics.
      * \throws      None
-     * \details     This writes one IoU for each line.
      */
-    void write_ious(const iou_list& ious, const std::string& file_name) noexcept
+    void print_attributes(const std::vector<attribute_statistics>& attributes) noexcept
+    {
+        if (attributes.empty())
+        {
+            std::cout << "no sequence has attributes\n";
+            return;
+        }
+        std::size_t width = std::strlen("attribute");
+        for (const auto& a : attributes)
+            width = std::max(width, a.name.size());
+        std::cout << std::left << std::setw(static_cast<int>(width)) << "attribute" << std::right << std::setw(10)
+                  << "frames" << std::setw(10) << "average" << std::setw(10) << "success" << '\n';
+        for (const auto& a : attributes)
+        {
+            const auto frames = static_cast<double>(std::max(a.frames, std::size_t(1)));
+            std::cout << std::left << std::setw(static_cast<int>(width)) << a.name << std::right << std::setw(10)
+                      << a.frames << std::setw(10) << a.total / frames << std::setw(10)
+                      << static_cast<double>(a.successes) / frames << '\n';
+        }
+    }
+
+    /**
+     * \brief       Analyze every sequence in a dataset.
+     * \param[in]   manifest    The dataset's sequences.
+     * \param[in]   store       If this is not null, results are reused from and added to this
+     *                          store.
+     * \param[in]   depth       The most sequences to read ahead of the one being analyzed.
+     * \param[in]   by_attribute    If this is true, the IoU statistics of each attribute are
+     *                              printed after every sequence is analyzed.
+     * \param[in]   policy      What to do with lines of the box files which are not valid.
+     * \param[in]   binary      If true, the output files are binary IoU files.
+     * \throws      None
+     * \details     Two threads read and parse the upcoming sequences while the current one is
+     *              analyzed; see sequence_prefetcher. Each reads its files with io_uring where the
+     *              kernel supports it; see batch_reader.
+     */
+    void analyze_dataset(const dataset_manifest& manifest,
+                         result_store* store,
+                         const std::size_t depth,
+                         const bool by_attribute,
+                         const validation_policy policy,
+                         const bool binary) noexcept
+    {
+        constexpr unsigned prefetch_threads = 2;
+        try
+        {
+            // with a store, the prefetcher hashes the bytes it reads, and skips parsing stored results
+            stored_check check;
+            if (store != nullptr)
+            {
+                check = [store, policy](const sequence_paths& paths, const store_key& results, const store_key& truth) {
+                    return store->contains(make_store_key(results, truth, store_configuration(policy, paths.convention)));
+                };
+            }
+            sequence_prefetcher prefetcher(manifest.sequences(), depth, prefetch_threads, read_method::automatic, policy, check);
+            loaded_sequence sequence;
+            std::vector<attribute_statistics> attributes;
+            while (prefetcher.next(sequence))
+                analyze(sequence, store, by_attribute ? &attributes : nullptr, policy, binary);
+            if (by_attribute)
+                print_attributes(attributes);
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "error in " << __func__ << ": " << e.what() << std::endl;
+        }
+    }
+
+    /**
+     * \brief       Analyze every sequence in a dataset, a window of boxes at a time.
+     * \param[in]   manifest    The dataset's sequences.
+     * \param[in]   chunk_size  The number of boxes of each file to hold in memory at once.
+     * \param[in]   policy      What to do with lines of the box files which are not valid.
+     * \throws      None
+     * \details     This is for sequences too long to load; see evaluate_chunked(). The IoU files are
+     *              the same as analyze() writes.
+     */
+    void analyze_chunked(const dataset_manifest& manifest, const std::size_t chunk_size, const validation_policy policy) noexcept
+    {
+        for (const auto& paths : manifest.sequences())
+        {
+            std::cout << "analyzing " << paths.name << "...\n";
+            try
+            {
+                const auto outcome = evaluate_chunked(paths.results, paths.ground_truth, paths.output, chunk_size, paths.convention, policy);
+                validate_box_counts(outcome.results_count, outcome.truth_count);
+            }
+            catch (std::exception& e)
+            {
+                std::cerr << "error in " << __func__ << ": " << e.what() << std::endl;
+            }
+        }
+    }
+
+    /**
+     * \brief       Print a sampled estimate of a sequence's statistics.
+     * \param[in]   name        The sequence's name.
+     * \param[in]   estimate    The estimate to print.
+     * \throws      None
+     */
+    void print_estimate(const std::string& name, const sampled_estimate& estimate) noexcept
+    {
+        std::cout << "  " << name << ": mean IoU " << estimate.mean << " +/- " << estimate.mean_margin
+                  << ", success rate " << estimate.success_rate << " +/- " << estimate.success_margin << ", "
+                  << estimate.frames_evaluated << " of " << estimate.frames_total << " frames";
+        if (estimate.frames_undefined > 0)
+            std::cout << " (" << estimate.frames_undefined << " undefined)";
+        if (!estimate.converged)
+            std::cout << " (frame limit reached)";
+        std::cout << '\n';
+    }
+
+    /**
+     * \brief       Estimate the statistics of every sequence in a dataset from samples of frames.
+     * \param[in]   manifest    The dataset's sequences.
+     * \param[in]   options     The sampling settings.
+     * \param[in]   depth       The most sequences to read ahead of the one being estimated.
+     * \param[in]   policy      What to do with lines of the box files which are not valid.
+     * \throws      None
+     * \details     This is for screening trackers quickly; see estimate_ious(). No IoU files are
+     *              written, and the result store is not used, because the full series is not known.
+     */
+    void screen_dataset(const dataset_manifest& manifest,
+                        const sampling_options& options,
+                        const std::size_t depth,
+                        const validation_policy policy) noexcept
+    {
+        constexpr unsigned prefetch_threads = 2;
+        try
+        {
+            sequence_prefetcher prefetcher(manifest.sequences(), depth, prefetch_threads, read_method::automatic, policy);
+            loaded_sequence sequence;
+            while (prefetcher.next(sequence))
+            {
+                try
+                {
+                    if (!sequence.error.empty())
+                        throw std::runtime_error(sequence.error);
+                    validate_box_lists(sequence.results, sequence.ground_truth);
+                    print_estimate(sequence.paths->name, estimate_ious(sequence.results, sequence.ground_truth, options));
+                }
+                catch (std::exception& e)
+                {
+                    std::cerr << "error in " << __func__ << ": " << e.what() << std::endl;
+                }
+            }
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "error in " << __func__ << ": " << e.what() << std::endl;
+        }
+    }
+
+    /**
+     * \brief       Analyze sequences from a dataset archive.
+     * \param[in]   archive_file    The archive holding the ground truth.
+     * \param[in]   sequences       The sequences to analyze. If this is empty, every sequence in
+     *                              the archive is analyzed.
+     * \param[in]   policy          What to do with lines of results files which are not valid.
+     * \param[in]   convention      The convention of four value lines in results files.
+     * \param[in]   binary          If true, the output files are binary IoU files.
+     * \throws      None
+     * \details     The archive is mapped once, and each sequence is found with a binary search of
+     *              its index; see dataset_archive. If the archive holds the tracker results, they
+     *              are used, otherwise they are read from <em>sequence</em>.boxes with \a policy and
+     *              \a convention; the archived boxes were parsed when they were packed. The IoUs are
+     *              written to <em>sequence</em>.ious, as analyze() does.
+     */
+    void analyze_archive(const std::string& archive_file,
+                         const std::vector<std::string>& sequences,
+                         const validation_policy policy,
+                         const box_convention convention,
+                         const bool binary) noexcept
+    {
+        try
+        {
+            const dataset_archive archive(archive_file);
+            std::vector<std::string> names(sequences);
+            if (names.empty())
+            {
+                for (std::size_t s = 0; s < archive.size(); ++s)
+                    names.push_back(archive.at(s).name);
+            }
+
+            archived_sequence sequence;
+            box_list loaded;
+            for (const auto& name : names)
+            {
+                std::cout << "analyzing " << name << "...\n";
+                try
+                {
+                    if (!archive.find(name, sequence))
+                        throw std::runtime_error(archive_file + " has no sequence " + name);
+                    box_span results = sequence.results;
+                    if (!sequence.has_results)
+                    {
+                        loaded  = load_results(name + ".boxes", policy, convention);
+                        results = loaded;
+                    }
+
+                    validate_box_lists(results, sequence.ground_truth);
+                    iou_list ious((std::min(results.size(), sequence.ground_truth.size()) + iou_stride - 1) / iou_stride);
+                    calculate_ious(results, sequence.ground_truth, ious, iou_stride);
+                    save_ious(ious, name + ".ious", binary);
+                }
+                catch (std::exception& e)
+                {
+                    std::cerr << "error in " << __func__ << ": " << e.what() << std::endl;
+                }
+            }
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "error in " << __func__ << ": " << e.what() << std::endl;
+        }
+    }
+
+    /**
+     * \brief       Pack a dataset into an archive.
+     * \param[in]   manifest        The dataset's sequences.
+     * \param[in]   archive_file    The archive to write.
+     * \param[in]   with_results    If true, the tracker results are packed too.
+     * \retval      true            Every file was packed.
+     * \retval      false           A file could not be read or parsed, or the archive could not
+     *                              be written.
+     * \throws      None
+     * \details     Every file is read with one batch_reader, so many small files are in flight at
+     *              once. A sequence whose ground truth cannot be read or parsed is left out, and a
+     *              sequence whose results cannot be read or parsed is packed without them; either
+     *              way, the file is named in a warning.
+     */
+    bool pack_dataset(const dataset_manifest& manifest, const std::string& archive_file, const bool with_results) noexcept
+    {
+        try
+        {
+            const auto& paths = manifest.sequences();
+            const std::size_t files = with_results ? 2 : 1;
+            std::vector<std::string> names;
+            for (const auto& p : paths)
+            {
+                names.push_back(p.ground_truth);
+                if (with_results)
+                    names.push_back(p.results);
+            }
+
+            std::vector<packed_sequence> packed(paths.size());
+            std::vector<bool> missing(paths.size(), false);
+            bool complete = true;
+            batch_reader reader(256);
+            reader.start(names);
+            file_read read;
+            while (reader.next(read))
+            {
+                const auto s = read.index / files;
+                auto& sequence = packed[s];
+                sequence.name = paths[s].name;
+
+                // a file which cannot be parsed is left out, as one which cannot be read is
+                bool ok = read.error == 0;
+                box_list boxes;
+                if (!ok)
+                    std::cerr << "warning: could not read " << names[read.index] << '\n';
+                else
+                {
+                    try
+                    {
+                        boxes = parse_results(read.bytes, validation_policy::fail, paths[s].convention);
+                    }
+                    catch (std::runtime_error& e)
+                    {
+                        std::cerr << "warning: could not parse " << names[read.index] << ": " << e.what() << '\n';
+                        ok = false;
+                    }
+                }
+                complete = complete && ok;
+
+                if (read.index % files == 0)
+                {
+                    missing[s]            = !ok;
+                    sequence.ground_truth = std::move(boxes);
+                }
+                else
+                {
+                    sequence.has_results = ok;
+                    sequence.results     = std::move(boxes);
+                    if (!ok)
+                        std::cerr << "warning: packing " << paths[s].name << " without results\n";
+                }
+            }
+
+            std::vector<packed_sequence> kept;
+            for (std::size_t s = 0; s < packed.size(); ++s)
+            {
+                if (missing[s])
+                    std::cerr << "warning: leaving " << paths[s].name << " out\n";
+                else
+                    kept.push_back(std::move(packed[s]));
+            }
+            const auto count = kept.size();
+            write_archive(archive_file, std::move(kept));
+            std::cout << "packed " << count << " sequences into " << archive_file << '\n';
+            return complete;
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "error in " << __func__ << ": " << e.what() << std::endl;
+            return false;
+        }
+    }
+
+    /**
+     * \brief       Write a list of bounding boxes in the format load_results() reads.
+     * \param[in]   boxes       The boxes to write.
+     * \param[in]   file_name   The file to write.
+     * \throws      std::runtime_error  This is thrown if the file cannot be written.
+     * \details     Each box is written as left, width, top, height, with enough digits that the
+     *              values read back are within rounding of the packed boxes.
+     */
+    void save_boxes(const box_span boxes, const std::string& file_name)
     {
         std::ofstream file(file_name.c_str());
+        file.precision(std::numeric_limits<float>::max_digits10);
+        for (const auto& box : boxes)
+            file << box.left() << ',' << box.right() - box.left() << ',' << box.top() << ',' << box.bottom() - box.top() << '\n';
         if (!file)
+            throw std::runtime_error("could not write " + file_name);
+    }
+
+    /**
+     * \brief       Unpack a dataset archive into files.
+     * \param[in]   archive_file    The archive to unpack.
+     * \param[in]   directory       The directory to unpack into. It must exist.
+     * \throws      None
+     * \details     The ground truth is written in the struck layout,
+     *              <em>directory</em>/<em>sequence</em>/<em>sequence</em>_gt.txt, and any packed
+     *              results to <em>directory</em>/<em>sequence</em>.boxes.
+     */
+    void unpack_archive(const std::string& archive_file, const std::string& directory) noexcept
+    {
+        try
         {
-            std::cerr << "error: could not open " << file_name << " for writing IoU data.\n";
-            return;
+            const dataset_archive archive(archive_file);
+            for (std::size_t s = 0; s < archive.size(); ++s)
+            {
+                const auto sequence = archive.at(s);
+                const auto sequence_directory = directory + "/" + sequence.name;
+                if (mkdir(sequence_directory.c_str(), 0755) != 0 && errno != EEXIST)
+                    throw std::runtime_error("could not create " + sequence_directory);
+                save_boxes(sequence.ground_truth, sequence_directory + "/" + sequence.name + "_gt.txt");
+                if (sequence.has_results)
+                    save_boxes(sequence.results, directory + "/" + sequence.name + ".boxes");
+            }
+            std::cout << "unpacked " << archive.size() << " sequences into " << directory << '\n';
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "error in " << __func__ << ": " << e.what() << std::endl;
+        }
+    }
+
+    /**
+     * \brief       Remove old results from a result store.
+     * \param[in]   directory       The store directory.
+     * \param[in]   maximum_days    Results not used for this many days are removed; 0 for no
+     *                              limit.
+     * \param[in]   maximum_mb      Then least recently used results are removed until the store
+     *                              is no larger than this many megabytes; 0 for no limit.
+     * \throws      None
+     */
+    void collect_store_garbage(const std::string& directory,
+                               const std::uint64_t maximum_days,
+                               const std::uint64_t maximum_mb) noexcept
+    {
+        try
+        {
+            result_store store(directory);
+            const auto report = store.collect_garbage(maximum_days * 24 * 60 * 60, maximum_mb * 1024 * 1024);
+            std::cout << "removed " << report.removed_entries << " results (" << report.removed_bytes
+                      << " bytes), kept " << report.kept_entries << " results (" << report.kept_bytes
+                      << " bytes)\n";
         }
+        catch (std::exception& e)
+        {
+            std::cerr << "error in " << __func__ << ": " << e.what() << std::endl;
+        }
+    }
+
+    /**
+     * \brief       Analyze the multi-object tracking results for a video sequence.
+     * \param[in]   sequence        The name of the sequence to analyze.
+     * \param[in]   nms_threshold   If this is greater than 0, non-maximum suppression is applied
+     *                              to the results at this IoU threshold before they are analyzed.
+     * \param[in]   data            The root of the ground truth.
+     * \throws      None
+     * \details     The results are read from <em>sequence</em>.txt, and the ground truth is read
+     *              from the MOTChallenge layout under \a data. Both must be in MOTChallenge format; see
+     *              load_mot() and load_mot_ground_truth(). The per frame coverage is written to
+     *              <em>sequence</em>.ious, and the CLEAR MOT metrics are written to standard output.
+     *              Results are matched to ground truth with the Hungarian algorithm, at an IoU
+     *              threshold of 0.5.
+     */
+    void analyze_mot(const std::string& sequence, const float nms_threshold, const std::string& data) noexcept
+    {
+        std::cout << "analyzing " << sequence << "...\n";
+        try
+        {
+            auto results = load_mot(sequence + ".txt");
+            if (nms_threshold > 0.0f)
+            {
+                nms_options options;
+                options.threshold = nms_threshold;
+                options.use_grid  = true;
+                results = non_maximum_suppression(results, options);
+            }
 
-        for (const auto i : ious)
-            file << i.value() << std::endl;
+            std::string ground_truth_path(data + "/mot_data/");
+            ground_truth_path.append(sequence).append("/gt/gt.txt");
+            const auto ground_truth = load_mot_ground_truth(ground_truth_path);
 
-        // write the minimum, average, and maximum
-        file << "minimum: "   << std::min_element(ious.cbegin(), ious.cend())->value()
-             << "\nmaximum: " << std::max_element(ious.cbegin(), ious.cend())->value()
-             << "\naverage: " << std::accumulate(ious.cbegin(), ious.cend(), iou(0.0f)) / ious.size();
+            write_ious(calculate_coverage(results, ground_truth), sequence + ".ious");
+
+            const auto matches = match_sequence(results, ground_truth, 0.5f, match_method::hungarian);
+            const auto metrics = calculate_clear_mot(results, ground_truth, matches);
+            std::cout << "  MOTA: " << metrics.accuracy()
+                      << "\n  MOTP: " << metrics.precision()
+                      << "\n  misses: " << metrics.misses
+                      << "\n  false positives: " << metrics.false_positives
+                      << "\n  identity switches: " << metrics.id_switches << '\n';
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "error in " << __func__ << ": " << e.what() << std::endl;
+        }
     }
 
     /**
-     * \brief       Analyze the tracking results for a video or image sequence.
-     * \param[in]   sequence
+     * \brief       Analyze the VOT region results for a video sequence.
+     * \param[in]       sequence    The name of the sequence to analyze.
+     * \param[in,out]   eao         The sequence's segments are added to this.
+     * \param[in]       data        The root of the ground truth.
+     * \throws      None
+     * \details     The results are read from <em>sequence</em>.boxes, and the ground truth is read
+     *              from the VOT layout under \a data. Both may mix rotated regions and axis aligned boxes; see
+     *              load_regions(). The IoU of every frame is written to <em>sequence</em>.ious, and
+     *              the failures and accuracy are printed; see evaluate_robustness(). If the results
+     *              record where the tracker was initialized and skipped frames, those frames are
+     *              NaN; see apply_region_statuses().
+     */
+    void analyze_vot(const std::string& sequence, eao_accumulator& eao, const std::string& data) noexcept
+    {
+        std::cout << "analyzing " << sequence << "...\n";
+        try
+        {
+            std::vector<region_status> statuses;
+            const auto results = load_regions(sequence + ".boxes", &statuses);
+
+            std::string ground_truth_path(data + "/vot_data/");
+            ground_truth_path.append(sequence).append("/groundtruth.txt");
+            const auto ground_truth = load_regions(ground_truth_path);
+
+            if (results.size() != ground_truth.size())
+            {
+                std::cerr << "warning: There are " << results.size() << " results regions, and " << ground_truth.size() << " ground truth regions.\n"
+                          << "         Only the first " << std::min(results.size(), ground_truth.size()) << " regions will be considered.\n";
+            }
+            iou_list ious(std::min(results.size(), ground_truth.size()));
+            calculate_ious(results.data(), ground_truth.data(), ious.size(), ious.data());
+            apply_region_statuses(ious, statuses);
+            write_ious(ious, sequence + ".ious");
+
+            const auto robustness = evaluate_robustness(ious, vot_options());
+            eao.add(ious, robustness.segments);
+            std::cout << "  failures: " << robustness.failures << ", accuracy: " << robustness.accuracy << " over "
+                      << robustness.accuracy_frames << " frames\n";
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "error in " << __func__ << ": " << e.what() << std::endl;
+        }
+    }
+
+    /**
+     * \brief       Analyze the VOT segmentation mask results for a video sequence.
+     * \param[in]   sequence    The name of the sequence to analyze.
+     * \param[in]   data        The root of the ground truth.
      * \throws      None
-     * \details     This will load the bounding box results and ground truth, then calculate and
-     *              output IoU data.
+     * \details     The results are read from <em>sequence</em>.boxes, and the ground truth is read
+     *              from the VOT layout under \a data. Both may mix masks and axis aligned boxes; see
+     *              load_masks(). The mask IoU of every frame is written to <em>sequence</em>.ious.
+     *              If the results record where the tracker was initialized and skipped frames,
+     *              those frames are NaN; see apply_region_statuses().
      */
-    void analyze(const std::string& sequence) noexcept
+    void analyze_vot_masks(const std::string& sequence, const std::string& data) noexcept
     {
         std::cout << "analyzing " << sequence << "...\n";
         try
         {
-            // load the struck results for the sequence
-            auto results = load_results(sequence + ".boxes");
+            std::vector<region_status> statuses;
+            const auto results = load_masks(sequence + ".boxes", &statuses);
+
+            std::string ground_truth_path(data + "/vot_data/");
+            ground_truth_path.append(sequence).append("/groundtruth.txt");
+            const auto ground_truth = load_masks(ground_truth_path);
+
+            if (results.size() != ground_truth.size())
+            {
+                std::cerr << "warning: There are " << results.size() << " results masks, and " << ground_truth.size() << " ground truth masks.\n"
+                          << "         Only the first " << std::min(results.size(), ground_truth.size()) << " masks will be considered.\n";
+            }
+            iou_list ious;
+            for (std::size_t m = 0; m < std::min(results.size(), ground_truth.size()); ++m)
+                ious.push_back(make_iou(results[m], ground_truth[m]));
+            apply_region_statuses(ious, statuses);
+            write_ious(ious, sequence + ".ious");
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "error in " << __func__ << ": " << e.what() << std::endl;
+        }
+    }
+
+    /**
+     * \brief       Analyze tracking results while the tracker produces them.
+     * \param[in]   sequence    The name of the sequence being tracked.
+     * \param[in]   ring_name   The shared memory name of the live_ring to create.
+     * \param[in]   timeout     How long the ring may stay empty before the analysis stops, or 0
+     *                          to wait for as long as the tracker runs.
+     * \param[in]   data        The root of the ground truth.
+     * \throws      None
+     * \details     The ground truth is loaded from the struck layout under \a data before the ring is created, so nothing is parsed
+     *              while the tracker runs. The tracker opens the ring and pushes one live_record per
+     *              frame. Each record is paired with the ground truth for its frame, and the running
+     *              minimum, maximum, and average IoU are written to standard output every
+     *              report_interval frames. When the tracker closes the ring, the IoU of every frame
+     *              is written to <em>sequence</em>.ious.
+     *
+     *              An empty ring is polled without sleeping for a while, so a record is picked up
+     *              within a few hundred nanoseconds of being pushed. The consumer only yields its
+     *              processor after the tracker has been quiet for spin_limit polls. While it is
+     *              yielding, it checks every check_interval polls that the tracker is still running
+     *              and that \a timeout has not passed, so a tracker which crashes, or never starts,
+     *              does not leave the analysis waiting forever. The IoU of the frames received up to
+     *              then are still written.
+     */
+    void analyze_live(const std::string& sequence,
+                      const std::string& ring_name,
+                      const std::chrono::seconds timeout,
+                      const std::string& data) noexcept
+    {
+        constexpr live_ring::size_type capacity = 4096;
+        constexpr std::size_t report_interval   = 30;
+        constexpr std::uint64_t spin_limit      = 10000;
+        constexpr std::uint64_t check_interval  = 1024;
 
-            // load the ground truth for the sequence
-            std::string ground_truth_path("/home/brendan/Videos/struck_data/");
+        std::cout << "analyzing " << sequence << " from " << ring_name << "...\n";
+        try
+        {
+            std::string ground_truth_path(data + "/struck_data/");
             ground_truth_path.append(sequence)
                              .append("/")
                              .append(sequence)
                              .append("_gt.txt");
-            auto ground_truth = load_results(ground_truth_path);
+            const auto ground_truth = load_results(ground_truth_path);
 
-            //sanity_check(results, "results.txt");
-            //sanity_check(ground_truth, "ground_truth.txt");
+            live_ring ring(ring_name, capacity);
+            iou_list ious;
+            ious.reserve(ground_truth.size());
+            iou_summary summary;
+            live_record record;
+            std::uint64_t idle = 0;
+            auto quiet_since = std::chrono::steady_clock::now();
+            bool abandoned = false;
+            while (true)
+            {
+                const bool finished = abandoned || ring.closed();
+                if (!ring.try_pop(record))
+                {
+                    if (finished)
+                        break;
+                    if (++idle <= spin_limit)
+                        continue;
+                    std::this_thread::yield();
+
+                    // checking the tracker makes system calls, so it is not done on every poll
+                    if (idle == spin_limit + 1)
+                        quiet_since = std::chrono::steady_clock::now();
+                    else if (idle % check_interval == 0)
+                    {
+                        if (!ring.producer_alive())
+                        {
+                            std::cerr << "warning: the tracker exited without closing " << ring_name << '\n';
+                            abandoned = true;
+                        }
+                        else if (timeout.count() > 0 && std::chrono::steady_clock::now() - quiet_since > timeout)
+                        {
+                            std::cerr << "warning: " << (ring.attached() ? "nothing was pushed to " : "no tracker opened ")
+                                      << ring_name << " for " << timeout.count() << " seconds\n";
+                            abandoned = true;
+                        }
+                    }
+                    continue;
+                }
+
+                idle = 0;
+                if (record.frame >= ground_truth.size())
+                    continue;
+                ious.push_back(make_iou(record.box, ground_truth[record.frame]));
+                accumulate(summary, ious.back());
+                if (summary.count % report_interval == 0)
+                {
+                    std::cout << "  frame " << record.frame << ": IoU " << ious.back()
+                              << ", minimum " << summary.minimum << ", maximum " << summary.maximum
+                              << ", average " << summary.average << '\n';
+                }
+            }
 
-            validate_box_lists(results, ground_truth);
-            const auto ious = calculate_ious(results, ground_truth);
             write_ious(ious, sequence + ".ious");
+            std::cout << "  " << summary.count << " frames, average IoU " << summary.average << '\n';
         }
         catch (std::exception& e)
         {
             std::cerr << "error in " << __func__ << ": " << e.what() << std::endl;
         }
     }
-}
 
+    /**
+     * \brief       Keep the analysis of several sequences up to date as their files change.
+     * \param[in]   sequences   The names of the sequences to watch.
+     * \param[in]   data        The root of the ground truth.
+     * \throws      None
+     * \details     The <em>sequence</em>.boxes files in the working directory, and the ground
+     *              truth directories of the struck layout under \a data, are watched with inotify. When a file changes, only the lines
+     *              which were appended or edited are parsed, see box_follower, and only the IoUs
+     *              from the first changed frame on are recalculated and rewritten to
+     *              <em>sequence</em>.ious, see incremental_ious. The summary of each updated
+     *              sequence is written to standard output. If the kernel's event queue overflows,
+     *              every sequence is checked again. A sequence which cannot be updated, for example
+     *              because its .ious file cannot be written, is reported, and its changed frames
+     *              are recalculated with its next change; the others are still watched. This runs
+     *              until it is interrupted.
+     */
+    void analyze_watch(const std::vector<std::string>& sequences, const std::string& data) noexcept
+    {
+        /// A watched sequence, and the state of its files.
+        struct watched_sequence final
+        {
+            std::string      name;    ///< The sequence name.
+            box_follower     results; ///< The tracker results.
+            box_follower     truth;   ///< The ground truth.
+            incremental_ious ious;    ///< The IoU series and .ious file.
+        };
 
-int main(int argc, char** argv)
+        /// The inotify instance, closed however the watch ends.
+        struct event_queue final
+        {
+            event_queue() = default;
+            event_queue(const event_queue&) = delete;
+            ~event_queue() noexcept
+            {
+                if (descriptor >= 0)
+                    close(descriptor);
+            }
+            event_queue& operator=(const event_queue&) = delete;
+
+            const int descriptor = inotify_init1(IN_CLOEXEC); ///< The instance.
+        };
+
+        constexpr std::uint32_t changes = IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE | IN_DELETE;
+        try
+        {
+            const event_queue queue;
+            const int events = queue.descriptor;
+            if (events < 0)
+                throw std::runtime_error(std::string("could not start watching files: ") + std::strerror(errno));
+            const int results_watch = inotify_add_watch(events, ".", changes);
+            if (results_watch < 0)
+                throw std::runtime_error(std::string("could not watch the working directory: ") + std::strerror(errno));
+
+            std::vector<watched_sequence> watched;
+            std::map<int, std::size_t> truth_watches;
+            for (const auto& sequence : sequences)
+            {
+                const auto directory = data + "/struck_data/" + sequence;
+                const int w = inotify_add_watch(events, directory.c_str(), changes);
+                if (w < 0)
+                    std::cerr << "warning: could not watch " << directory << '\n';
+                else
+                    truth_watches[w] = watched.size();
+                watched.push_back(watched_sequence {sequence,
+                                                    box_follower(sequence + ".boxes"),
+                                                    box_follower(directory + "/" + sequence + "_gt.txt"),
+                                                    incremental_ious(sequence + ".ious", iou_stride)});
+            }
+
+            std::cout << "watching " << sequences.size() << " sequences...\n";
+            std::vector<bool> dirty(watched.size(), true);
+            std::vector<std::size_t> pending(watched.size(), box_follower::unchanged);
+            alignas(inotify_event) char buffer[16 * 1024];
+            while (true)
+            {
+                for (std::size_t s = 0; s < watched.size(); ++s)
+                {
+                    if (!dirty[s])
+                        continue;
+                    dirty[s] = false;
+                    auto& w = watched[s];
+                    try
+                    {
+                        // the first changed frame is kept until the IoUs are written, so a failed
+                        // update is finished by the next one
+                        pending[s] = std::min(pending[s], w.results.update());
+                        pending[s] = std::min(pending[s], w.truth.update());
+                        if (pending[s] == box_follower::unchanged)
+                            continue;
+                        const auto first = pending[s];
+                        w.ious.update(w.results.boxes(), w.truth.boxes(), first);
+                        pending[s] = box_follower::unchanged;
+                        const auto summary = w.ious.summary();
+                        std::cout << w.name << ": " << summary.count << " IoUs, from frame " << first
+                                  << " on recalculated, minimum " << summary.minimum << ", maximum "
+                                  << summary.maximum << ", average " << summary.average << std::endl;
+                    }
+                    catch (std::exception& e)
+                    {
+                        std::cerr << "error in " << __func__ << ": " << w.name << ": " << e.what() << std::endl;
+                    }
+                }
+
+                const auto length = read(events, buffer, sizeof(buffer));
+                if (length < 0 && errno == EINTR)
+                    continue;
+                if (length <= 0)
+                    throw std::runtime_error("could not read file changes");
+                for (auto p = buffer; p < buffer + length;)
+                {
+                    const auto* event = reinterpret_cast<const inotify_event*>(p);
+                    p += sizeof(inotify_event) + event->len;
+                    if ((event->mask & IN_Q_OVERFLOW) != 0)
+                    {
+                        // changes were dropped, so any file may have changed
+                        std::fill(dirty.begin(), dirty.end(), true);
+                        continue;
+                    }
+                    if (event->wd != results_watch)
+                    {
+                        const auto t = truth_watches.find(event->wd);
+                        if (t != truth_watches.end())
+                            dirty[t->second] = true;
+                        continue;
+                    }
+                    for (std::size_t s = 0; s < watched.size(); ++s)
+                        dirty[s] = dirty[s] || (event->len > 0 && watched[s].name + ".boxes" == event->name);
+                }
+            }
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "error in " << __func__ << ": " << e.what() << std::endl;
+        }
+    }
+
+    /// Command line options of the form <tt>--name value</tt>, and the other arguments.
+    struct command_line final
+    {
+        std::map<std::string, std::string> options;   ///< The option values, by option name.
+        std::vector<std::string>           arguments; ///< The arguments which are not options.
+
+        /**
+         * \brief       Get an option value.
+         * \param[in]   name        The option name, including the leading dashes.
+         * \param[in]   fallback    The value to use if the option was not given.
+         * \return      The option's value, or \a fallback.
+         * \throws      std::bad_alloc  This is thrown if memory for the value cannot be allocated.
+         */
+        std::string option(const std::string& name, const std::string& fallback) const
+        {
+            const auto o = options.find(name);
+            return o == options.end() ? fallback : o->second;
+        }
+    };
+
+    /**
+     * \brief       Split command line arguments into options and other arguments.
+     * \param[in]   argc,argv   The command line, as given to main().
+     * \param[in]   first       The index of the first argument to parse.
+     * \param[in]   names       The names of the options which take a value.
+     * \return      The parsed command line.
+     * \throws      std::bad_alloc  This is thrown if memory for the arguments cannot be allocated.
+     */
+    command_line parse_command_line(const int argc,
+                                    char** argv,
+                                    const int first,
+                                    std::initializer_list<const char*> names)
+    {
+        command_line parsed;
+        for (int a = first; a < argc; ++a)
+        {
+            const std::string argument(argv[a]);
+            const bool is_option = std::any_of(names.begin(), names.end(), [&argument](const char* n) {
+                return argument == n;
+            });
+            if (is_option && a + 1 < argc)
+                parsed.options[argument] = argv[++a];
+            else
+                parsed.arguments.push_back(argument);
+        }
+        return parsed;
+    }
+
+    /**
+     * \brief       Parse the name of an evaluation metric.
+     * \param[in]   name    One of boxes, mot, vot, or vot-masks.
+     * \return      The metric.
+     * \throws      std::invalid_argument   This is thrown if \a name is not a metric.
+     */
+    evaluation_metric parse_metric(const std::string& name)
+    {
+        if (name == "boxes")
+            return evaluation_metric::boxes;
+        if (name == "mot")
+            return evaluation_metric::mot;
+        if (name == "vot")
+            return evaluation_metric::vot;
+        if (name == "vot-masks")
+            return evaluation_metric::vot_masks;
+        throw std::invalid_argument("unknown metric " + name);
+    }
+
+    /**
+     * \brief       Get the current working directory.
+     * \return      The absolute path of the working directory, or an empty string if it cannot be
+     *              determined.
+     * \throws      std::bad_alloc  This is thrown if memory for the path cannot be allocated.
+     */
+    std::string working_directory()
+    {
+        std::vector<char> path(4096);
+        return getcwd(path.data(), path.size()) == nullptr ? std::string() : std::string(path.data());
+    }
+
+    /**
+     * \brief       Split a comma separated list.
+     * \param[in]   list    The list to split.
+     * \return      The items in the list. Empty items are dropped.
+     * \throws      std::bad_alloc  This is thrown if memory for the items cannot be allocated.
+     */
+    std::vector<std::string> split_list(const std::string& list)
+    {
+        std::vector<std::string> items;
+        std::istringstream stream(list);
+        std::string item;
+        while (std::getline(stream, item, ','))
+        {
+            if (!item.empty())
+                items.push_back(item);
+        }
+        return items;
+    }
+
+    /**
+     * \brief       Print bootstrap confidence intervals of each tracker's mean sequence score.
+     * \param[in]   options     The trackers and sequences.
+     * \param[in]   board       The evaluated leaderboard.
+     * \param[in]   bootstrap   The bootstrap settings.
+     * \throws      std::invalid_argument   This is thrown if the bootstrap settings are not valid.
+     * \throws      std::bad_alloc          This is thrown if memory for the scores cannot be
+     *                                      allocated.
+     * \details     A sequence's score is its average IoU. Only sequences which every tracker
+     *              completed with a finite average are used, so the trackers are compared on the
+     *              same sequences. Every
+     *              tracker after the first is compared with the first by a paired bootstrap.
+     */
+    void print_bootstrap(const leaderboard_options& options, const leaderboard& board, const bootstrap_options& bootstrap)
+    {
+        std::vector<std::vector<double>> scores(board.size());
+        for (std::size_t s = 0; s < options.sequences.size(); ++s)
+        {
+            const auto usable = std::all_of(board.begin(), board.end(), [s](const std::vector<sequence_result>& row) {
+                return row[s].ok && row[s].summary.count > 0 && std::isfinite(row[s].summary.average);
+            });
+            if (!usable)
+                continue;
+            for (std::size_t t = 0; t < board.size(); ++t)
+                scores[t].push_back(board[t][s].summary.average);
+        }
+        if (scores.front().empty())
+        {
+            std::cout << "\nno sequence was completed by every tracker; there is no bootstrap\n";
+            return;
+        }
+
+        std::cout << "\nbootstrap of the mean sequence average over " << scores.front().size() << " sequences, "
+                  << bootstrap.resamples << " resamples, " << bootstrap.confidence * 100.0 << "% intervals\n";
+        for (std::size_t t = 0; t < board.size(); ++t)
+        {
+            const auto interval = bootstrap_mean(scores[t], bootstrap);
+            std::cout << "  " << options.trackers[t] << ": " << interval.estimate << " [" << interval.lower << ", "
+                      << interval.upper << "]\n";
+        }
+        for (std::size_t t = 1; t < board.size(); ++t)
+        {
+            const auto comparison = bootstrap_paired(scores[t], scores.front(), bootstrap);
+            std::cout << "  " << options.trackers[t] << " - " << options.trackers.front() << ": "
+                      << comparison.difference.estimate << " [" << comparison.difference.lower << ", "
+                      << comparison.difference.upper << "], p = " << comparison.p_value << '\n';
+        }
+    }
+
+    /**
+     * \brief       Evaluate several trackers on the same sequences, and print a table for each.
+     * \param[in]   options     The trackers, sequences, and settings.
+     * \param[in]   bootstrap   If this is not null, confidence intervals are printed after the
+     *                          tables; see print_bootstrap().
+     * \throws      None
+     * \details     See evaluate_leaderboard(). Each table lists the IoU statistics of every
+     *              sequence, and a final row for all the tracker's compared frames together.
+     */
+    void analyze_matrix(const leaderboard_options& options, const bootstrap_options* bootstrap) noexcept
+    {
+        try
+        {
+            std::cout << "analyzing " << options.trackers.size() << " trackers on "
+                      << options.sequences.size() << " sequences...\n";
+            const auto board = evaluate_leaderboard(options);
+
+            std::size_t width = std::strlen("sequence");
+            for (const auto& sequence : options.sequences)
+                width = std::max(width, sequence.size());
+            for (std::size_t t = 0; t < board.size(); ++t)
+            {
+                std::cout << '\n' << options.trackers[t] << '\n'
+                          << "  " << std::left << std::setw(static_cast<int>(width)) << "sequence" << std::right
+                          << std::setw(8) << "frames" << std::setw(10) << "minimum" << std::setw(10)
+                          << "maximum" << std::setw(10) << "average" << '\n';
+
+                iou_summary all;
+                double total = 0.0;
+                for (std::size_t s = 0; s < board[t].size(); ++s)
+                {
+                    const auto& r = board[t][s];
+                    std::cout << "  " << std::left << std::setw(static_cast<int>(width)) << options.sequences[s]
+                              << std::right;
+                    if (!r.ok)
+                    {
+                        std::cout << "  error: " << r.error << '\n';
+                        continue;
+                    }
+                    std::cout << std::setw(8) << r.summary.count << std::setw(10) << r.summary.minimum
+                              << std::setw(10) << r.summary.maximum << std::setw(10) << r.summary.average << '\n';
+                    if (r.summary.count == 0)
+                        continue;
+                    all.minimum = all.count == 0 ? r.summary.minimum : std::min(all.minimum, r.summary.minimum);
+                    all.maximum = all.count == 0 ? r.summary.maximum : std::max(all.maximum, r.summary.maximum);
+                    all.count += r.summary.count;
+                    total += static_cast<double>(r.summary.average) * static_cast<double>(r.summary.count);
+                }
+                if (all.count > 0)
+                    all.average = static_cast<iou::value_type>(total / static_cast<double>(all.count));
+                std::cout << "  " << std::left << std::setw(static_cast<int>(width)) << "all" << std::right
+                          << std::setw(8) << all.count << std::setw(10) << all.minimum << std::setw(10)
+                          << all.maximum << std::setw(10) << all.average << '\n';
+            }
+            if (bootstrap != nullptr)
+                print_bootstrap(options, board, *bootstrap);
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "error in " << __func__ << ": " << e.what() << std::endl;
+        }
+    }
+
+    /**
+     * \brief       Run an evaluation server until it is interrupted.
+     * \param[in]   options The server settings.
+     * \throws      None
+     * \details     SIGINT and SIGTERM are blocked in every thread, and a dedicated thread waits
+     *              for them and stops the server, so the socket is always removed.
+     */
+    void serve(const server_options& options) noexcept
+    {
+        try
+        {
+            sigset_t signals;
+            sigemptyset(&signals);
+            sigaddset(&signals, SIGINT);
+            sigaddset(&signals, SIGTERM);
+            pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+            evaluation_server server(options);
+            std::thread waiter([&server, signals]() {
+                int signal = 0;
+                sigwait(&signals, &signal);
+                server.stop();
+            });
+            std::cout << "serving on " << options.socket_path << '\n';
+            try
+            {
+                server.run();
+            }
+            catch (...)
+            {
+                kill(getpid(), SIGTERM);
+                waiter.join();
+                throw;
+            }
+            waiter.join();
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "error in " << __func__ << ": " << e.what() << std::endl;
+        }
+    }
+
+    /**
+     * \brief       Ask an evaluation server to run an evaluation, and print the results.
+     * \param[in]   socket_path The server's socket.
+     * \param[in]   request     The evaluation to run.
+     * \throws      None
+     */
+    void request_evaluation(const std::string& socket_path, const evaluation_request& request) noexcept
+    {
+        try
+        {
+            evaluation_client client(socket_path);
+            const auto response = client.evaluate(request);
+            for (std::size_t s = 0; s < response.size(); ++s)
+            {
+                const auto& r = response[s];
+                std::cout << request.sequences[s] << ": ";
+                if (r.ok)
+                {
+                    std::cout << r.summary.count << " frames, minimum " << r.summary.minimum
+                              << ", maximum " << r.summary.maximum << ", average " << r.summary.average << '\n';
+                }
+                else
+                    std::cout << "error: " << r.error << '\n';
+            }
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "error in " << __func__ << ": " << e.what() << std::endl;
+        }
+    }
+
+    /**
+     * \brief       Measure the request latency of an evaluation server.
+     * \param[in]   socket_path     The server's socket.
+     * \param[in]   request         The evaluation to send repeatedly.
+     * \param[in]   client_count    The number of concurrent clients.
+     * \param[in]   request_count   The number of requests each client sends.
+     * \throws      None
+     * \details     Each client opens one connection and sends its requests back to back. The
+     *              first request from each client is not timed, so the results measure a warm
+     *              server. The latency percentiles over all clients, and the overall request rate,
+     *              are written to standard output.
+     */
+    void benchmark_server(const std::string& socket_path,
+                          const evaluation_request& request,
+                          const unsigned client_count,
+                          const unsigned request_count) noexcept
+    {
+        using clock = std::chrono::steady_clock;
+        try
+        {
+            std::vector<std::vector<double>> latencies(client_count);
+            std::vector<std::string> errors(client_count);
+            std::vector<std::thread> clients;
+            const auto start = clock::now();
+            for (unsigned c = 0; c < client_count; ++c)
+            {
+                clients.emplace_back([&, c]() {
+                    try
+                    {
+                        evaluation_client client(socket_path);
+                        client.evaluate(request);
+                        for (unsigned r = 0; r < request_count; ++r)
+                        {
+                            const auto sent = clock::now();
+                            client.evaluate(request);
+                            latencies[c].push_back(std::chrono::duration<double, std::micro>(clock::now() - sent).count());
+                        }
+                    }
+                    catch (std::exception& e)
+                    {
+                        errors[c] = e.what();
+                    }
+                });
+            }
+            for (auto& c : clients)
+                c.join();
+            const std::chrono::duration<double> elapsed = clock::now() - start;
+
+            std::vector<double> all;
+            for (unsigned c = 0; c < client_count; ++c)
+            {
+                if (!errors[c].empty())
+                    std::cerr << "warning: client " << c << " failed: " << errors[c] << '\n';
+                all.insert(all.end(), latencies[c].begin(), latencies[c].end());
+            }
+            if (all.empty())
+                return;
+
+            std::sort(all.begin(), all.end());
+            const auto percentile = [&all](const double p) {
+                return all[std::min(all.size() - 1, static_cast<std::size_t>(p * all.size()))];
+            };
+            std::cout << all.size() << " requests from " << client_count << " clients in "
+                      << elapsed.count() << " s (" << all.size() / elapsed.count() << " requests/s)\n"
+                      << "  latency p50: " << percentile(0.50) << " us\n"
+                      << "  latency p90: " << percentile(0.90) << " us\n"
+                      << "  latency p99: " << percentile(0.99) << " us\n"
+                      << "  latency max: " << all.back() << " us\n";
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "error in " << __func__ << ": " << e.what() << std::endl;
+        }
+    }
+
+    /**
+     * \brief       Convert a binary IoU file to text.
+     * \param[in]   input   The binary IoU file.
+     * \param[in]   output  The text file to write, in the format write_ious() writes.
+     * \throws      None
+     * \details     The text is the same as the analysis would have written without --binary, so
+     *              the tools which read text IoU files can read it.
+     */
+    void convert_ious(const std::string& input, const std::string& output) noexcept
+    {
+        try
+        {
+            const iou_file file(input);
+            write_ious(file.ious(), output);
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "error in " << __func__ << ": " << e.what() << std::endl;
+        }
+    }
+
+    /**
+     * \brief       Measure what input validation costs the box parser.
+     * \param[in]   file_name   A bounding box file. It is read into memory once.
+     * \param[in]   repeats     The number of times each policy parses the file.
+     * \throws      None
+     * \details     The file is parsed without validation and with validation_policy::fail in
+     *              turn, so both see the same cache and frequency conditions. The fastest run of
+     *              each is kept, and the throughputs and the relative cost of validation are
+     *              written to standard output.
+     */
+    void benchmark_parse(const std::string& file_name, const unsigned repeats) noexcept
+    {
+        using clock = std::chrono::steady_clock;
+        try
+        {
+            std::ifstream file(file_name.c_str(), std::ios::binary);
+            if (!file)
+                throw std::runtime_error("could not open " + file_name);
+            std::ostringstream contents;
+            contents << file.rdbuf();
+            const auto text = contents.str();
+
+            const validation_policy policies[] = {validation_policy::none, validation_policy::fail};
+            double best[2] = {std::numeric_limits<double>::max(), std::numeric_limits<double>::max()};
+            std::size_t count = 0;
+            for (unsigned r = 0; r < std::max(repeats, 1u); ++r)
+            {
+                for (std::size_t p = 0; p < 2; ++p)
+                {
+                    const auto start = clock::now();
+                    count = parse_results(text, policies[p]).size();
+                    const std::chrono::duration<double> elapsed = clock::now() - start;
+                    best[p] = std::min(best[p], elapsed.count());
+                }
+            }
+
+            const auto megabytes = static_cast<double>(text.size()) / (1 << 20);
+            std::cout << count << " boxes, " << megabytes << " MiB\n"
+                      << "  no validation: " << megabytes / best[0] << " MiB/s\n"
+                      << "  validation:    " << megabytes / best[1] << " MiB/s\n"
+                      << "  cost:          " << 100.0 * (best[1] - best[0]) / best[0] << " %\n";
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "error in " << __func__ << ": " << e.what() << std::endl;
+        }
+    }
+}
+
+/**
+ * \brief       Run the mode named on the command line.
+ * \param[in]   argc    The number of command line arguments.
+ * \param[in]   argv    The command line arguments.
+ * \return      The exit status.
+ * \throws      std::exception  Any exception from parsing the options, such as a number which is
+ *                              not a number, is left to main().
+ */
+static int dispatch(int argc, char** argv)
 {
+    // analyze [--data directory] mode...
+    // every mode reads the ground truth from the same root, so --data is taken out before the mode
+    std::string data(analyze::default_data_directory);
+    std::vector<char*> arguments(argv, argv + argc);
+    const auto data_option = std::find_if(arguments.begin(), arguments.end(), [](const char* a) {
+        return std::strcmp(a, "--data") == 0;
+    });
+    if (data_option != arguments.end() && data_option + 1 != arguments.end())
+    {
+        data = *(data_option + 1);
+        arguments.erase(data_option, data_option + 2);
+    }
+    argc = static_cast<int>(arguments.size());
+    argv = arguments.data();
+
     if (argc < 2)
     {
         std::cerr << "error: at least one sequence is required\n";
@@ -186,8 +1451,330 @@ int main(int argc, char** argv)
         return EXIT_SUCCESS;
     }
 
-    for (int a = 1; a < argc; ++a)
-        analyze::analyze(argv[a]);
+    if (argument == "--mot")
+    {
+        // analyze --mot [--nms threshold] sequence...
+        int first = 2;
+        float nms_threshold = 0.0f;
+        if (argc > 3 && std::string(argv[2]) == "--nms")
+        {
+            nms_threshold = std::stof(argv[3]);
+            first = 4;
+        }
+        for (int a = first; a < argc; ++a)
+            analyze::analyze_mot(argv[a], nms_threshold, data);
+        return EXIT_SUCCESS;
+    }
+
+    if (argument == "--live")
+    {
+        // analyze --live [--ring name] [--timeout seconds] sequence
+        const auto command = analyze::parse_command_line(argc, argv, 2, {"--ring", "--timeout"});
+        if (command.arguments.empty())
+        {
+            std::cerr << "error: --live needs a sequence\n";
+            return EXIT_FAILURE;
+        }
+        analyze::analyze_live(command.arguments.front(),
+                              command.option("--ring", "/analyze-live"),
+                              std::chrono::seconds(std::stoul(command.option("--timeout", "60"))),
+                              data);
+        return EXIT_SUCCESS;
+    }
+
+    if (argument == "--watch")
+    {
+        analyze::analyze_watch(std::vector<std::string>(argv + 2, argv + argc), data);
+        return EXIT_SUCCESS;
+    }
+
+    if (argument == "--matrix")
+    {
+        // analyze --matrix --trackers directory,directory... [--threads count] [--truth directory]
+        //                  [--bootstrap resamples [--confidence level] [--seed n]] sequence...
+        const auto command = analyze::parse_command_line(
+            argc, argv, 2, {"--trackers", "--threads", "--truth", "--bootstrap", "--confidence", "--seed"});
+        analyze::leaderboard_options options;
+        options.trackers        = analyze::split_list(command.option("--trackers", ""));
+        options.sequences       = command.arguments;
+        options.thread_count    = static_cast<unsigned>(std::stoul(command.option("--threads", "0")));
+        options.truth_directory = command.option("--truth", data + "/struck_data");
+        if (options.trackers.empty())
+        {
+            std::cerr << "error: --matrix needs --trackers\n";
+            return EXIT_FAILURE;
+        }
+        std::unique_ptr<analyze::bootstrap_options> bootstrap;
+        if (!command.option("--bootstrap", "").empty())
+        {
+            bootstrap.reset(new analyze::bootstrap_options);
+            bootstrap->resamples    = std::stoul(command.option("--bootstrap", ""));
+            bootstrap->confidence   = std::stod(command.option("--confidence", "0.95"));
+            bootstrap->seed         = std::stoull(command.option("--seed", "0"));
+            bootstrap->thread_count = options.thread_count;
+        }
+        analyze::analyze_matrix(options, bootstrap.get());
+        return EXIT_SUCCESS;
+    }
+
+    if (argument == "--serve")
+    {
+        // analyze --serve [--socket path] [--threads count] [--results directory]
+        const auto command = analyze::parse_command_line(argc, argv, 2, {"--socket", "--threads", "--results"});
+        analyze::server_options options;
+        options.socket_path    = command.option("--socket", options.socket_path);
+        options.thread_count   = static_cast<unsigned>(std::stoul(command.option("--threads", "0")));
+        options.data_directory = data;
+        options.results_root   = command.option("--results", analyze::working_directory());
+        analyze::serve(options);
+        return EXIT_SUCCESS;
+    }
+
+    if (argument == "--request" || argument == "--bench-server")
+    {
+        // analyze --request [--socket path] [--metric name] [--results directory] [--output directory]
+        //                   sequence...
+        // analyze --bench-server [--socket path] [--metric name] [--results directory] [--clients count]
+        //                        [--requests count] sequence...
+        // the directories are relative to the server's --results directory
+        const auto command = analyze::parse_command_line(
+            argc, argv, 2, {"--socket", "--metric", "--results", "--output", "--clients", "--requests"});
+        const auto socket_path = command.option("--socket", analyze::server_options().socket_path);
+        analyze::evaluation_request request;
+        request.metric            = analyze::parse_metric(command.option("--metric", "boxes"));
+        request.results_directory = command.option("--results", "");
+        request.output_directory  = command.option("--output", "");
+        request.sequences         = command.arguments;
+        if (argument == "--request")
+            analyze::request_evaluation(socket_path, request);
+        else
+        {
+            analyze::benchmark_server(socket_path,
+                                      request,
+                                      static_cast<unsigned>(std::stoul(command.option("--clients", "4"))),
+                                      static_cast<unsigned>(std::stoul(command.option("--requests", "1000"))));
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (argument == "--ious-to-text")
+    {
+        // analyze --ious-to-text binary-file text-file
+        if (argc != 4)
+        {
+            std::cerr << "error: --ious-to-text needs a binary IoU file and a text file\n";
+            return EXIT_FAILURE;
+        }
+        analyze::convert_ious(argv[2], argv[3]);
+        return EXIT_SUCCESS;
+    }
+
+    if (argument == "--bench-parse")
+    {
+        // analyze --bench-parse [--repeat count] file
+        const auto command = analyze::parse_command_line(argc, argv, 2, {"--repeat"});
+        if (command.arguments.size() != 1)
+        {
+            std::cerr << "error: --bench-parse needs one file\n";
+            return EXIT_FAILURE;
+        }
+        analyze::benchmark_parse(command.arguments.front(), static_cast<unsigned>(std::stoul(command.option("--repeat", "10"))));
+        return EXIT_SUCCESS;
+    }
+
+    if (argument == "--vot-masks")
+    {
+        for (int a = 2; a < argc; ++a)
+            analyze::analyze_vot_masks(argv[a], data);
+        return EXIT_SUCCESS;
+    }
+
+    if (argument == "--vot")
+    {
+        // analyze --vot [--eao-low length] [--eao-high length] sequence...
+        const auto command = analyze::parse_command_line(argc, argv, 2, {"--eao-low", "--eao-high"});
+        analyze::eao_accumulator eao;
+        for (const auto& sequence : command.arguments)
+            analyze::analyze_vot(sequence, eao, data);
+        std::cout << "expected average overlap: "
+                  << eao.average(std::stoul(command.option("--eao-low", "0")), std::stoul(command.option("--eao-high", "0")))
+                  << '\n';
+        return EXIT_SUCCESS;
+    }
+
+    if (argument == "--pack")
+    {
+        // analyze --pack archive [--dataset manifest] [--with-results] [sequence...]
+        auto command = analyze::parse_command_line(argc, argv, 2, {"--dataset"});
+        const auto flag = std::find(command.arguments.begin(), command.arguments.end(), "--with-results");
+        const bool with_results = flag != command.arguments.end();
+        if (with_results)
+            command.arguments.erase(flag);
+        if (command.arguments.empty())
+        {
+            std::cerr << "error: --pack needs an archive\n";
+            return EXIT_FAILURE;
+        }
+        try
+        {
+            const auto manifest_file = command.option("--dataset", "");
+            auto manifest = manifest_file.empty()
+                                ? analyze::dataset_manifest(analyze::dataset_layout::struck, data + "/struck_data", "")
+                                : analyze::load_manifest(manifest_file);
+            for (auto a = command.arguments.begin() + 1; a != command.arguments.end(); ++a)
+                manifest.add(*a);
+            if (!analyze::pack_dataset(manifest, command.arguments.front(), with_results))
+                return EXIT_FAILURE;
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "error: " << e.what() << '\n';
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (argument == "--unpack")
+    {
+        // analyze --unpack archive [--output directory]
+        const auto command = analyze::parse_command_line(argc, argv, 2, {"--output"});
+        if (command.arguments.size() != 1)
+        {
+            std::cerr << "error: --unpack needs one archive\n";
+            return EXIT_FAILURE;
+        }
+        analyze::unpack_archive(command.arguments.front(), command.option("--output", "."));
+        return EXIT_SUCCESS;
+    }
+
+    if (argument == "--store-gc")
+    {
+        // analyze --store-gc --store directory [--max-age days] [--max-size megabytes]
+        const auto command = analyze::parse_command_line(argc, argv, 2, {"--store", "--max-age", "--max-size"});
+        const auto directory = command.option("--store", "");
+        if (directory.empty())
+        {
+            std::cerr << "error: --store-gc needs --store\n";
+            return EXIT_FAILURE;
+        }
+        analyze::collect_store_garbage(directory,
+                                       std::stoull(command.option("--max-age", "30")),
+                                       std::stoull(command.option("--max-size", "0")));
+        return EXIT_SUCCESS;
+    }
+
+    // analyze [--store directory] [--prefetch depth] [--dataset manifest] [--by-attribute] [--binary]
+    //         [--on-invalid none|fail|skip|clamp] [--convention lwth|xywh|xyxy] [sequence...]
+    // analyze --chunk boxes [--dataset manifest] [--on-invalid none|fail|skip|clamp] [--convention lwth|xywh|xyxy]
+    //         [sequence...]
+    // analyze --sample tolerance [--confidence level] [--order stratified|random] [--seed n]
+    //         [--max-frames n] [--prefetch depth] [--dataset manifest] [--on-invalid none|fail|skip|clamp]
+    //         [--convention lwth|xywh|xyxy] [sequence...]
+    // analyze --archive archive [--binary] [--on-invalid none|fail|skip|clamp] [--convention lwth|xywh|xyxy]
+    //         [sequence...]
+    auto command = analyze::parse_command_line(
+        argc, argv, 1,
+        {"--store", "--prefetch", "--dataset", "--archive", "--chunk", "--sample", "--confidence", "--order", "--seed",
+         "--max-frames", "--on-invalid", "--convention"});
+    const auto flag = std::find(command.arguments.begin(), command.arguments.end(), "--by-attribute");
+    const bool by_attribute = flag != command.arguments.end();
+    if (by_attribute)
+        command.arguments.erase(flag);
+    const auto binary_flag = std::find(command.arguments.begin(), command.arguments.end(), "--binary");
+    const bool binary = binary_flag != command.arguments.end();
+    if (binary)
+        command.arguments.erase(binary_flag);
+    if (!command.option("--archive", "").empty())
+    {
+        if (!command.option("--store", "").empty())
+            std::cerr << "warning: the result store is not used with --archive\n";
+        if (by_attribute)
+            std::cerr << "warning: an archive holds no attributes, so --by-attribute is not used with --archive\n";
+        try
+        {
+            const auto convention = command.option("--convention", "");
+            analyze::analyze_archive(command.option("--archive", ""),
+                                     command.arguments,
+                                     analyze::parse_validation_policy(command.option("--on-invalid", "fail")),
+                                     convention.empty() ? analyze::box_convention::left_width_top_height
+                                                        : analyze::parse_box_convention(convention),
+                                     binary);
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "error: " << e.what() << '\n';
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    std::unique_ptr<analyze::result_store> store;
+    try
+    {
+        if (!command.option("--store", "").empty())
+            store.reset(new analyze::result_store(command.option("--store", "")));
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "warning: the result store is unavailable: " << e.what() << '\n';
+    }
+    try
+    {
+        const auto manifest_file = command.option("--dataset", "");
+        auto manifest = manifest_file.empty()
+                            ? analyze::dataset_manifest(analyze::dataset_layout::struck, data + "/struck_data", "")
+                            : analyze::load_manifest(manifest_file);
+        if (!command.option("--convention", "").empty())
+            manifest.convention(analyze::parse_box_convention(command.option("--convention", "")));
+        for (const auto& sequence : command.arguments)
+            manifest.add(sequence);
+        const auto policy = analyze::parse_validation_policy(command.option("--on-invalid", "fail"));
+        if (!command.option("--sample", "").empty())
+        {
+            if (store)
+                std::cerr << "warning: the result store is not used with --sample\n";
+            analyze::sampling_options options;
+            options.tolerance      = std::stod(command.option("--sample", ""));
+            options.confidence     = std::stod(command.option("--confidence", "0.95"));
+            options.order          = analyze::parse_sampling_order(command.option("--order", "stratified"));
+            options.seed           = std::stoull(command.option("--seed", "0"));
+            options.maximum_frames = std::stoul(command.option("--max-frames", "0"));
+            analyze::screen_dataset(manifest, options, std::stoul(command.option("--prefetch", "64")), policy);
+        }
+        else if (!command.option("--chunk", "").empty())
+        {
+            if (store)
+                std::cerr << "warning: the result store is not used with --chunk\n";
+            if (binary)
+                std::cerr << "warning: --chunk writes text IoU files\n";
+            analyze::analyze_chunked(manifest, std::stoul(command.option("--chunk", "")), policy);
+        }
+        else
+            analyze::analyze_dataset(manifest,
+                                     store.get(),
+                                     std::stoul(command.option("--prefetch", "64")),
+                                     by_attribute,
+                                     policy,
+                                     binary);
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "error: " << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
 
     return EXIT_SUCCESS;
 }
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        return dispatch(argc, argv);
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "error: " << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,408 @@
+#include "mask.h"
+#include "comma_ctype.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace analyze
+{
+    namespace
+    {
+        /// The number of pixels packed in one word of a bit mask.
+        constexpr int word_bits = 64;
+
+        /**
+         * \brief       Calculate the smallest box containing two boxes.
+         * \param[in]   a,b The boxes to enclose.
+         * \return      The union bounding box of \a a and \a b.
+         * \throws      None
+         */
+        integer_box enclose(const integer_box& a, const integer_box& b) noexcept
+        {
+            return integer_box(std::min(a.left(), b.left()),
+                               std::max(a.right(), b.right()),
+                               std::min(a.top(), b.top()),
+                               std::max(a.bottom(), b.bottom()));
+        }
+
+        /**
+         * \brief       Determine if two boxes have the same coordinates.
+         * \param[in]   a,b The boxes to compare.
+         * \retval      true    All four coordinates are equal.
+         * \retval      false   At least one coordinate differs.
+         * \throws      None
+         */
+        bool same_box(const integer_box& a, const integer_box& b) noexcept
+        {
+            return a.left() == b.left() && a.right() == b.right() && a.top() == b.top() &&
+                   a.bottom() == b.bottom();
+        }
+
+        /**
+         * \brief       Check that a region read from a mask file can be converted to runs.
+         * \param[in]   left,right,top,bottom   The edges of the region's bounding box.
+         * \throws      std::invalid_argument   This is thrown if an edge is not finite or does not
+         *                                      fit in an int, or if the region covers more than
+         *                                      max_region_rows rows.
+         */
+        void check_region(const double left, const double right, const double top, const double bottom)
+        {
+            constexpr double limit = std::numeric_limits<int>::max();
+            if (!std::isfinite(left) || !std::isfinite(right) || !std::isfinite(top) || !std::isfinite(bottom))
+                throw std::invalid_argument("a region's coordinates must be finite");
+            if (left < -limit || right > limit || top < -limit || bottom > limit)
+                throw std::invalid_argument("a region is out of range");
+            if (bottom - top > max_region_rows)
+                throw std::invalid_argument("a region covers too many rows");
+        }
+
+        /**
+         * \brief       Convert a box to a mask.
+         * \param[in]   v   The left edge, top edge, width, and height of the box.
+         * \return      The mask, with each edge rounded to the nearest pixel.
+         * \throws      std::invalid_argument   This is thrown if the box cannot be converted; see
+         *                                      check_region().
+         * \throws      std::bad_alloc          This is thrown if memory for the runs cannot be
+         *                                      allocated.
+         */
+        rle_mask box_mask(const double (&v)[8])
+        {
+            if (!(v[2] >= 0.0) || !(v[3] >= 0.0))
+                throw std::invalid_argument("a box's size must not be negative");
+            check_region(v[0], v[0] + v[2], v[1], v[1] + v[3]);
+
+            const auto left = static_cast<int>(std::lround(v[0])), top = static_cast<int>(std::lround(v[1]));
+            const auto right = static_cast<int>(std::lround(v[0] + v[2]));
+            const auto bottom = static_cast<int>(std::lround(v[1] + v[3]));
+            std::vector<mask_run> runs;
+            for (int row = top; row < bottom; ++row)
+                runs.push_back(mask_run {row, left, right});
+            return rle_mask(std::move(runs));
+        }
+
+        /**
+         * \brief       Convert a convex polygon to a mask.
+         * \param[in]   v   The corners of the polygon: \f$ x_1, y_1, \ldots, x_4, y_4 \f$.
+         * \return      The mask, holding the pixels whose centres are inside the polygon.
+         * \throws      std::invalid_argument   This is thrown if the polygon cannot be converted;
+         *                                      see check_region().
+         * \throws      std::bad_alloc          This is thrown if memory for the runs cannot be
+         *                                      allocated.
+         */
+        rle_mask polygon_mask(const double (&v)[8])
+        {
+            check_region(std::min({v[0], v[2], v[4], v[6]}),
+                         std::max({v[0], v[2], v[4], v[6]}),
+                         std::min({v[1], v[3], v[5], v[7]}),
+                         std::max({v[1], v[3], v[5], v[7]}));
+
+            // cross each row through its pixel centres; a convex polygon covers one run of each row
+            const auto first = static_cast<int>(std::ceil(std::min({v[1], v[3], v[5], v[7]}) - 0.5));
+            const auto last  = static_cast<int>(std::ceil(std::max({v[1], v[3], v[5], v[7]}) - 0.5));
+            std::vector<mask_run> runs;
+            for (int row = first; row < last; ++row)
+            {
+                const double y = row + 0.5;
+                double begin = std::numeric_limits<double>::infinity(), end = -begin;
+                for (std::size_t c = 0; c < 8; c += 2)
+                {
+                    const double x1 = v[c], y1 = v[c + 1], x2 = v[(c + 2) % 8], y2 = v[(c + 3) % 8];
+                    if ((y1 <= y) != (y2 <= y))
+                    {
+                        const double x = x1 + (y - y1) * (x2 - x1) / (y2 - y1);
+                        begin = std::min(begin, x);
+                        end = std::max(end, x);
+                    }
+                }
+                if (begin <= end)
+                {
+                    runs.push_back(mask_run {row,
+                                             static_cast<int>(std::ceil(begin - 0.5)),
+                                             static_cast<int>(std::ceil(end - 0.5))});
+                }
+            }
+            return rle_mask(std::move(runs));
+        }
+    }
+
+    //-------------------------------------------------------
+    //                                rle_mask class methods
+    //-------------------------------------------------------
+    rle_mask::rle_mask(std::vector<mask_run> runs) : m_runs(std::move(runs))
+    {
+        m_runs.erase(std::remove_if(m_runs.begin(), m_runs.end(), [](const mask_run& r) {
+                         return r.end <= r.begin;
+                     }),
+                     m_runs.end());
+        for (const auto& r : m_runs)
+        {
+            const integer_box run_box(r.begin, r.end, r.row, r.row + 1);
+            m_bounds = m_pixel_count == 0 ? run_box : enclose(m_bounds, run_box);
+            m_pixel_count += static_cast<std::size_t>(r.end - r.begin);
+        }
+    }
+
+    //-------------------------------------------------------
+    //                                bit_mask class methods
+    //-------------------------------------------------------
+    bit_mask::bit_mask(const integer_box& frame)
+        : m_frame(frame),
+          m_words_per_row(static_cast<std::size_t>((frame.right() - frame.left() + word_bits - 1) / word_bits)),
+          m_words(m_words_per_row * static_cast<std::size_t>(frame.bottom() - frame.top()), 0)
+    {
+    }
+
+    void bit_mask::set(const int column, const int row) noexcept
+    {
+        if (column < m_frame.left() || column >= m_frame.right() || row < m_frame.top() ||
+            row >= m_frame.bottom() || test(column, row))
+        {
+            return;
+        }
+
+        const auto offset = column - m_frame.left();
+        m_words[static_cast<std::size_t>(row - m_frame.top()) * m_words_per_row + offset / word_bits] |=
+            word_type(1) << (offset % word_bits);
+
+        const integer_box pixel(column, column + 1, row, row + 1);
+        m_bounds = m_pixel_count == 0 ? pixel : enclose(m_bounds, pixel);
+        ++m_pixel_count;
+    }
+
+    void bit_mask::set(const mask_run& run) noexcept
+    {
+        const int begin = std::max(run.begin, m_frame.left()), end = std::min(run.end, m_frame.right());
+        if (run.row < m_frame.top() || run.row >= m_frame.bottom() || begin >= end)
+            return;
+
+        const bool was_empty = m_pixel_count == 0;
+        auto* words = m_words.data() + static_cast<std::size_t>(run.row - m_frame.top()) * m_words_per_row;
+        const int first = begin - m_frame.left(), last = end - m_frame.left(); // [first, last)
+        for (int w = first / word_bits; w <= (last - 1) / word_bits; ++w)
+        {
+            const int low  = std::max(first - w * word_bits, 0);
+            const int high = std::min(last - w * word_bits, word_bits);
+            const word_type high_mask = high == word_bits ? ~word_type(0) : (word_type(1) << high) - 1;
+            const word_type bits = high_mask & ~((word_type(1) << low) - 1);
+            m_pixel_count += static_cast<std::size_t>(__builtin_popcountll(bits & ~words[w]));
+            words[w] |= bits;
+        }
+
+        const integer_box run_box(begin, end, run.row, run.row + 1);
+        m_bounds = was_empty ? run_box : enclose(m_bounds, run_box);
+    }
+
+    bool bit_mask::test(const int column, const int row) const noexcept
+    {
+        if (column < m_frame.left() || column >= m_frame.right() || row < m_frame.top() ||
+            row >= m_frame.bottom())
+        {
+            return false;
+        }
+
+        const auto offset = column - m_frame.left();
+        return (row_words(row)[offset / word_bits] >> (offset % word_bits)) & 1;
+    }
+
+    //-------------------------------------------------------
+    //                                     mask conversions
+    //-------------------------------------------------------
+    bit_mask to_bit_mask(const rle_mask& mask, const integer_box& frame)
+    {
+        bit_mask bits(frame);
+        for (const auto& r : mask.runs())
+            bits.set(r);
+        return bits;
+    }
+
+    //-------------------------------------------------------
+    //                                             mask IoU
+    //-------------------------------------------------------
+    iou make_iou(const rle_mask& a, const rle_mask& b) noexcept
+    {
+        const auto overlap_box = intersection(a.bounds(), b.bounds());
+        if (area(overlap_box) <= 0)
+            return iou();
+
+        // skip the runs above the overlapping rows
+        const auto first_row = [&overlap_box](const std::vector<mask_run>& runs) {
+            return std::lower_bound(runs.cbegin(), runs.cend(), overlap_box.top(), [](const mask_run& r, const int row) {
+                return r.row < row;
+            });
+        };
+        auto i = first_row(a.runs()), j = first_row(b.runs());
+        const auto a_end = a.runs().cend(), b_end = b.runs().cend();
+
+        std::size_t overlap = 0;
+        while (i != a_end && j != b_end && i->row < overlap_box.bottom() && j->row < overlap_box.bottom())
+        {
+            if (i->row != j->row)
+            {
+                (i->row < j->row) ? ++i : ++j;
+                continue;
+            }
+            overlap += static_cast<std::size_t>(std::max(0, std::min(i->end, j->end) - std::max(i->begin, j->begin)));
+            (i->end < j->end) ? ++i : ++j;
+        }
+
+        const auto combined = a.pixel_count() + b.pixel_count() - overlap;
+        return iou(static_cast<float>(overlap) / static_cast<float>(combined));
+    }
+
+    iou make_iou(const bit_mask& a, const bit_mask& b)
+    {
+        if (!same_box(a.frame(), b.frame()))
+            throw std::invalid_argument("bit masks must cover the same frame to be compared");
+
+        const auto overlap_box = intersection(a.bounds(), b.bounds());
+        if (area(overlap_box) <= 0)
+            return iou();
+
+        const auto first_word = static_cast<std::size_t>((overlap_box.left() - a.frame().left()) / word_bits);
+        const auto last_word  = static_cast<std::size_t>((overlap_box.right() - 1 - a.frame().left()) / word_bits);
+        std::size_t overlap = 0;
+        for (int row = overlap_box.top(); row < overlap_box.bottom(); ++row)
+        {
+            const auto* a_words = a.row_words(row);
+            const auto* b_words = b.row_words(row);
+            for (auto w = first_word; w <= last_word; ++w)
+                overlap += static_cast<std::size_t>(__builtin_popcountll(a_words[w] & b_words[w]));
+        }
+
+        const auto combined = a.pixel_count() + b.pixel_count() - overlap;
+        return iou(static_cast<float>(overlap) / static_cast<float>(combined));
+    }
+
+    //-------------------------------------------------------
+    //                                        mask loading
+    //-------------------------------------------------------
+    rle_mask parse_vot_mask(const std::string& region)
+    {
+        if (region.empty() || region[0] != 'm')
+            throw std::invalid_argument("a VOT mask must start with 'm'");
+
+        // read the header and the counts
+        std::vector<long> values;
+        const char* p = region.c_str() + 1;
+        while (*p != '\0')
+        {
+            char* end = nullptr;
+            const long v = std::strtol(p, &end, 10);
+            if (end == p)
+                break;
+            values.push_back(v);
+            p = *end == ',' ? end + 1 : end;
+        }
+        if (values.size() < 4 || values[2] <= 0 || values[3] <= 0)
+            throw std::invalid_argument("a VOT mask needs an offset and a positive size");
+
+        // the run edges are ints, so the whole box must fit in one
+        constexpr long limit = std::numeric_limits<int>::max();
+        if (values[2] > limit || values[3] > limit || values[0] < -limit || values[0] > limit - values[2] ||
+            values[1] < -limit || values[1] > limit - values[3])
+            throw std::invalid_argument("a VOT mask's box is out of range");
+        if (std::any_of(values.begin() + 4, values.end(), [](const long v) { return v < 0; }))
+            throw std::invalid_argument("a VOT mask's counts must not be negative");
+
+        const auto left = static_cast<int>(values[0]), top = static_cast<int>(values[1]);
+        const long width = values[2], height = values[3];
+
+        // convert the alternating counts to runs, splitting runs which wrap onto the next row
+        std::vector<mask_run> runs;
+        long position = 0;
+        for (std::size_t c = 4; c < values.size() && position < width * height; ++c)
+        {
+            long count = std::min(values[c], width * height - position);
+            if ((c - 4) % 2 == 1)
+            {
+                while (count > 0)
+                {
+                    const long row = position / width, column = position % width;
+                    const long length = std::min(count, width - column);
+                    runs.push_back(mask_run {top + static_cast<int>(row),
+                                             left + static_cast<int>(column),
+                                             left + static_cast<int>(column + length)});
+                    position += length;
+                    count -= length;
+                }
+            }
+            else
+                position += count;
+        }
+        return rle_mask(std::move(runs));
+    }
+
+    mask_list load_masks(const std::string& file_name, std::vector<region_status>* const statuses)
+    {
+        std::ifstream file(file_name.c_str());
+        if (!file)
+            throw std::runtime_error("could not open mask file " + file_name);
+
+        const std::locale comma_delimiter(std::locale::classic(), new ctype);
+        mask_list masks;
+        if (statuses != nullptr)
+            statuses->clear();
+        std::string line;
+        std::istringstream values;
+        values.imbue(comma_delimiter);
+        for (std::size_t number = 1; std::getline(file, line); ++number)
+        {
+            const auto where = file_name + ": line " + std::to_string(number) + ": ";
+            auto status = region_status::tracked;
+            if (!line.empty() && line[0] == 'm')
+            {
+                try
+                {
+                    masks.push_back(parse_vot_mask(line));
+                }
+                catch (std::invalid_argument& e)
+                {
+                    throw std::invalid_argument(where + e.what());
+                }
+                if (statuses != nullptr)
+                    statuses->push_back(status);
+                continue;
+            }
+
+            values.clear();
+            values.str(line);
+            double v[8];
+            std::size_t count = 0;
+            while (count < 8 && values >> v[count])
+                ++count;
+            values.clear();
+            if (!(values >> std::ws).eof())
+                count = 0;
+            else if (count == 0)
+                continue;
+
+            try
+            {
+                if (count == 8)
+                    masks.push_back(polygon_mask(v));
+                else if (count == 4)
+                    masks.push_back(box_mask(v));
+                else if (count == 1 && (v[0] == 0.0 || v[0] == 1.0 || v[0] == 2.0))
+                {
+                    status = v[0] == 1.0 ? region_status::initialized
+                             : v[0] == 2.0 ? region_status::failed
+                                           : region_status::skipped;
+                    masks.emplace_back();
+                }
+                else
+                    throw std::runtime_error(where + "expected a mask, a region or a status");
+            }
+            catch (std::invalid_argument& e)
+            {
+                throw std::invalid_argument(where + e.what());
+            }
+            if (statuses != nullptr)
+                statuses->push_back(status);
+        }
+        return masks;
+    }
+}
@@ -0,0 +1,246 @@
+#ifndef ANALYZE_MASK_H
+#define ANALYZE_MASK_H
+
+#include "bounding_box.h"
+#include "iou.h"
+#include "polygon.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace analyze
+{
+    /// Represents a horizontal run of set pixels in a segmentation mask.
+    struct mask_run final
+    {
+        int row   = 0; ///< The image row of the run.
+        int begin = 0; ///< The column of the first pixel in the run.
+        int end   = 0; ///< One past the column of the last pixel in the run.
+    };
+
+    /**
+     * \brief       Represents a segmentation mask as run-length encoded rows.
+     * \details     The mask is a list of runs of set pixels, sorted by row, then by column. Runs
+     *              are in image coordinates, so masks with different offsets can be compared
+     *              without decoding them. The mask's bounding box and pixel count are calculated
+     *              once, at construction.
+     */
+    class rle_mask final
+    {
+    public:
+        /**
+         * \brief   Construct an empty mask.
+         * \throws  None
+         */
+        rle_mask() = default;
+
+        /**
+         * \brief       Construct a mask from runs of set pixels.
+         * \param[in]   runs    The runs of set pixels. They must be sorted by row, then by column,
+         *                      and must not overlap. Empty runs are dropped.
+         * \throws      std::bad_alloc  This is thrown if memory for the runs cannot be allocated.
+         */
+        explicit rle_mask(std::vector<mask_run> runs);
+
+        /**
+         * \brief   Get the runs of set pixels.
+         * \return  The runs, sorted by row, then by column.
+         * \throws  None
+         */
+        const std::vector<mask_run>& runs() const noexcept { return m_runs; }
+
+        /**
+         * \brief   Get the bounding box of the set pixels.
+         * \return  The smallest box containing every set pixel. The right and bottom edges are one
+         *          past the last set column and row, so area(bounds()) counts pixels.
+         * \throws  None
+         */
+        const integer_box& bounds() const noexcept { return m_bounds; }
+
+        /**
+         * \brief   Query the number of set pixels.
+         * \return  The number of set pixels in the mask.
+         * \throws  None
+         */
+        std::size_t pixel_count() const noexcept { return m_pixel_count; }
+
+    private:
+        std::vector<mask_run> m_runs;            ///< The runs of set pixels.
+        integer_box           m_bounds;          ///< The bounding box of the set pixels.
+        std::size_t           m_pixel_count = 0; ///< The number of set pixels.
+    };
+
+    /**
+     * \brief       Represents a segmentation mask as one bit per pixel.
+     * \details     Each row of the mask's frame is packed into 64 bit words, so the overlap of two
+     *              masks is a bitwise AND and a population count per word. The bounding box of the
+     *              set pixels is tracked, so comparisons can skip the rows and words outside it.
+     */
+    class bit_mask final
+    {
+    public:
+        /// The type of one word of packed pixels.
+        using word_type = std::uint64_t;
+
+        /**
+         * \brief   Construct an empty mask with an empty frame.
+         * \throws  None
+         */
+        bit_mask() = default;
+
+        /**
+         * \brief       Construct an empty mask covering a frame.
+         * \param[in]   frame   The image region which the mask covers.
+         * \throws      std::bad_alloc  This is thrown if memory for the mask cannot be allocated.
+         */
+        explicit bit_mask(const integer_box& frame);
+
+        /**
+         * \brief       Set a pixel.
+         * \param[in]   column,row  The image coordinates of the pixel. Pixels outside the frame are
+         *                          ignored.
+         * \throws      None
+         */
+        void set(const int column, const int row) noexcept;
+
+        /**
+         * \brief       Set a run of pixels.
+         * \param[in]   run The pixels to set. The part of the run outside the frame is ignored.
+         * \throws      None
+         * \details     The run is set a word at a time, not a pixel at a time.
+         */
+        void set(const mask_run& run) noexcept;
+
+        /**
+         * \brief       Query a pixel.
+         * \param[in]   column,row  The image coordinates of the pixel.
+         * \retval      true        The pixel is set.
+         * \retval      false       The pixel is not set, or is outside the frame.
+         * \throws      None
+         */
+        bool test(const int column, const int row) const noexcept;
+
+        /**
+         * \brief   Get the image region which the mask covers.
+         * \return  The mask's frame.
+         * \throws  None
+         */
+        const integer_box& frame() const noexcept { return m_frame; }
+
+        /**
+         * \brief   Get the bounding box of the set pixels.
+         * \return  The smallest box containing every set pixel; see rle_mask::bounds().
+         * \throws  None
+         */
+        const integer_box& bounds() const noexcept { return m_bounds; }
+
+        /**
+         * \brief   Query the number of set pixels.
+         * \return  The number of set pixels in the mask.
+         * \throws  None
+         */
+        std::size_t pixel_count() const noexcept { return m_pixel_count; }
+
+        /**
+         * \brief       Get the packed words for one row of the frame.
+         * \param[in]   row The image row.
+         * \return      A pointer to words_per_row() words. Bit \f$ b \f$ of word \f$ w \f$ is
+         *              column \f$ frame().left() + 64w + b \f$.
+         * \throws      None
+         */
+        const word_type* row_words(const int row) const noexcept
+        {
+            return m_words.data() + static_cast<std::size_t>(row - m_frame.top()) * m_words_per_row;
+        }
+
+        /**
+         * \brief   Query the number of words which make up one row.
+         * \return  The number of words in each row.
+         * \throws  None
+         */
+        std::size_t words_per_row() const noexcept { return m_words_per_row; }
+
+    private:
+        integer_box            m_frame;             ///< The image region covered by the mask.
+        integer_box            m_bounds;            ///< The bounding box of the set pixels.
+        std::size_t            m_words_per_row = 0; ///< The number of words in each row.
+        std::size_t            m_pixel_count   = 0; ///< The number of set pixels.
+        std::vector<word_type> m_words;             ///< The packed pixels, row by row.
+    };
+
+    /**
+     * \brief       Decode a run-length encoded mask into bits.
+     * \param[in]   mask    The mask to decode.
+     * \param[in]   frame   The image region for the bit mask. Runs outside it are clipped.
+     * \return      The bit packed mask.
+     * \throws      std::bad_alloc  This is thrown if memory for the mask cannot be allocated.
+     */
+    bit_mask to_bit_mask(const rle_mask& mask, const integer_box& frame);
+
+    /**
+     * \brief       Construct an IoU for two run-length encoded masks.
+     * \param[in]   a,b     The masks for which to calculate the IoU.
+     * \return      The IoU of \a a and \a b. If neither has any set pixels, the IoU is 0.
+     * \throws      None
+     * \details     If the mask bounds do not intersect(), the runs are never visited. Otherwise the
+     *              two run lists are merged from the first row of the bounds intersection, so the
+     *              cost is proportional to the number of runs, not the number of pixels.
+     */
+    iou make_iou(const rle_mask& a, const rle_mask& b) noexcept;
+
+    /**
+     * \brief       Construct an IoU for two bit packed masks.
+     * \param[in]   a,b     The masks for which to calculate the IoU. They must cover the same
+     *                      frame.
+     * \return      The IoU of \a a and \a b. If neither has any set pixels, the IoU is 0.
+     * \throws      std::invalid_argument   This is thrown if the masks cover different frames.
+     * \details     If the mask bounds do not intersect(), no pixel data is read. Otherwise only
+     *              the words inside the bounds intersection are combined. The population count
+     *              loop has no branches, so the compiler can vectorize it where the target has a
+     *              vector population count.
+     */
+    iou make_iou(const bit_mask& a, const bit_mask& b);
+
+    /**
+     * \brief       Parse a VOT mask region.
+     * \param[in]   region  The region text, in the form
+     *                      <tt>m</tt><em>left</em>,<em>top</em>,<em>width</em>,<em>height</em>,<em>counts...</em>
+     *                      The counts alternate between unset and set pixels, starting with unset,
+     *                      and scan the \a width by \a height box row by row.
+     * \return      The mask in image coordinates.
+     * \throws      std::invalid_argument   This is thrown if \a region is not a VOT mask, if a
+     *                                      count is negative, or if the box does not fit in int
+     *                                      coordinates.
+     * \throws      std::bad_alloc          This is thrown if memory for the runs cannot be
+     *                                      allocated.
+     */
+    rle_mask parse_vot_mask(const std::string& region);
+
+    /// Alias the type representing a list of masks.
+    using mask_list = std::vector<rle_mask>;
+
+    /// The most rows a box or polygon line of a mask file may cover, as each row is one run.
+    constexpr double max_region_rows = 65536.0;
+
+    /**
+     * \brief       Read VOT mask data from a file.
+     * \param[in]   file_name   The path to the file containing the masks.
+     * \param[out]  statuses    If this is not null, it is given the status of each frame.
+     * \return      A list of masks from the file.
+     * \throws      std::runtime_error      This is thrown if the file cannot be opened, or if a
+     *                                      line matches none of the forms below.
+     * \throws      std::invalid_argument   This is thrown if a mask is malformed, see
+     *                                      parse_vot_mask(), or if a box or polygon is not finite,
+     *                                      does not fit in int coordinates, or covers more than
+     *                                      max_region_rows rows.
+     * \details     Each line must correspond to one frame, and be a VOT mask, see
+     *              parse_vot_mask(), or hold comma separated values in one of the forms read by
+     *              load_regions(): the corners of a polygon, which covers the pixels whose centres
+     *              are inside it; a box, given by its left edge, top edge, width, and height, with
+     *              the edges rounded to the nearest pixel; or a VOT status, whose mask is empty.
+     *              Blank lines are skipped.
+     */
+    mask_list load_masks(const std::string& file_name, std::vector<region_status>* statuses = nullptr);
+}
+
+#endif
@@ -0,0 +1,341 @@
+#include "matching.h"
+#include "spatial_grid.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <unordered_map>
+
+namespace analyze
+{
+    namespace
+    {
+        /**
+         * \brief           Find the representative of a disjoint set, halving the path to it.
+         * \param[in,out]   parents The parent of each element.
+         * \param[in]       i       The element to look up.
+         * \return          The representative element of the set containing \a i.
+         * \throws          None
+         */
+        std::size_t find_root(std::vector<std::size_t>& parents, std::size_t i) noexcept
+        {
+            while (parents[i] != i)
+            {
+                parents[i] = parents[parents[i]];
+                i = parents[i];
+            }
+            return i;
+        }
+
+        /**
+         * \brief           Match the edges of one component greedily, by descending IoU.
+         * \param[in,out]   first,last  The candidate pairs in the component. They are sorted.
+         * \param[in,out]   matched     Receives the accepted pairs.
+         * \param[in,out]   result_used Flags for results that already have a match.
+         * \param[in,out]   truth_used  Flags for ground truth that already has a match.
+         * \throws          std::bad_alloc  This is thrown if \a matched cannot grow.
+         */
+        void match_greedy(match* first,
+                          match* last,
+                          match_list& matched,
+                          std::vector<char>& result_used,
+                          std::vector<char>& truth_used)
+        {
+            std::sort(first, last, [](const match& a, const match& b) {
+                if (a.value != b.value)
+                    return a.value > b.value;
+                return a.result != b.result ? a.result < b.result : a.truth < b.truth;
+            });
+            for (auto e = first; e != last; ++e)
+            {
+                if (!result_used[e->result] && !truth_used[e->truth])
+                {
+                    result_used[e->result] = truth_used[e->truth] = 1;
+                    matched.push_back(*e);
+                }
+            }
+        }
+
+        /**
+         * \brief           Match the edges of one component to maximize the total IoU.
+         * \param[in]       first,last  The candidate pairs in the component.
+         * \param[in,out]   matched     Receives the accepted pairs.
+         * \throws          std::bad_alloc  This is thrown if memory for the cost matrix cannot be
+         *                                  allocated.
+         * \details         The component is expanded to a dense cost matrix, where pairs which are
+         *                  not candidates have a weight of 0. The Hungarian algorithm with dual
+         *                  potentials finds the minimum cost assignment in \f$ O(n^2 m) \f$. Any
+         *                  assigned pair which is not a candidate is dropped afterwards.
+         */
+        void match_hungarian(const match* first, const match* last, match_list& matched)
+        {
+            // give the component's boxes compact local indices
+            std::vector<std::size_t> results, truths;
+            for (auto e = first; e != last; ++e)
+            {
+                results.push_back(e->result);
+                truths.push_back(e->truth);
+            }
+            std::sort(results.begin(), results.end());
+            results.erase(std::unique(results.begin(), results.end()), results.end());
+            std::sort(truths.begin(), truths.end());
+            truths.erase(std::unique(truths.begin(), truths.end()), truths.end());
+
+            // the algorithm needs no more rows than columns, so transpose if necessary
+            const bool transposed = results.size() > truths.size();
+            const auto& row_ids    = transposed ? truths : results;
+            const auto& column_ids = transposed ? results : truths;
+            const auto n = row_ids.size(), m = column_ids.size();
+
+            std::vector<double> cost((n + 1) * (m + 1), 0.0);
+            std::vector<const match*> pair((n + 1) * (m + 1), nullptr);
+            for (auto e = first; e != last; ++e)
+            {
+                const auto r = std::lower_bound(results.cbegin(), results.cend(), e->result) - results.cbegin();
+                const auto t = std::lower_bound(truths.cbegin(), truths.cend(), e->truth) - truths.cbegin();
+                const auto i = static_cast<std::size_t>(transposed ? t : r) + 1;
+                const auto j = static_cast<std::size_t>(transposed ? r : t) + 1;
+                cost[i * (m + 1) + j] = -static_cast<double>(e->value);
+                pair[i * (m + 1) + j] = e;
+            }
+
+            constexpr auto infinity = std::numeric_limits<double>::infinity();
+            std::vector<double> u(n + 1, 0.0), v(m + 1, 0.0), min_slack(m + 1);
+            std::vector<std::size_t> assigned_row(m + 1, 0), way(m + 1, 0);
+            std::vector<char> visited(m + 1);
+            for (std::size_t i = 1; i <= n; ++i)
+            {
+                assigned_row[0] = i;
+                std::size_t j0 = 0;
+                std::fill(min_slack.begin(), min_slack.end(), infinity);
+                std::fill(visited.begin(), visited.end(), 0);
+                do
+                {
+                    visited[j0] = 1;
+                    const auto i0 = assigned_row[j0];
+                    double delta = infinity;
+                    std::size_t j1 = 0;
+                    for (std::size_t j = 1; j <= m; ++j)
+                    {
+                        if (visited[j])
+                            continue;
+                        const auto slack = cost[i0 * (m + 1) + j] - u[i0] - v[j];
+                        if (slack < min_slack[j])
+                        {
+                            min_slack[j] = slack;
+                            way[j] = j0;
+                        }
+                        if (min_slack[j] < delta)
+                        {
+                            delta = min_slack[j];
+                            j1 = j;
+                        }
+                    }
+                    for (std::size_t j = 0; j <= m; ++j)
+                    {
+                        if (visited[j])
+                        {
+                            u[assigned_row[j]] += delta;
+                            v[j] -= delta;
+                        }
+                        else
+                            min_slack[j] -= delta;
+                    }
+                    j0 = j1;
+                } while (assigned_row[j0] != 0);
+
+                // follow the augmenting path back to the start
+                do
+                {
+                    const auto j1 = way[j0];
+                    assigned_row[j0] = assigned_row[j1];
+                    j0 = j1;
+                } while (j0 != 0);
+            }
+
+            for (std::size_t j = 1; j <= m; ++j)
+            {
+                const auto i = assigned_row[j];
+                if (i != 0 && pair[i * (m + 1) + j] != nullptr)
+                    matched.push_back(*pair[i * (m + 1) + j]);
+            }
+        }
+    }
+
+    //-------------------------------------------------------
+    //                                       frame matching
+    //-------------------------------------------------------
+    match_list match_boxes(const bounding_box<float>* results,
+                           const std::size_t          result_count,
+                           const bounding_box<float>* ground_truth,
+                           const std::size_t          truth_count,
+                           const iou::value_type      threshold,
+                           const match_method         method)
+    {
+        // collect the candidate pairs which pass the threshold
+        match_list edges;
+        const spatial_grid<float> grid(ground_truth, truth_count);
+        std::vector<std::size_t> candidates;
+        for (std::size_t r = 0; r < result_count; ++r)
+        {
+            candidates.clear();
+            grid.query(results[r], candidates);
+            for (const auto t : candidates)
+            {
+                const auto overlap = make_iou(results[r], ground_truth[t]).value();
+                if (overlap >= threshold)
+                    edges.push_back(match {r, t, overlap});
+            }
+        }
+
+        match_list matched;
+        if (edges.empty())
+            return matched;
+
+        // split the bipartite graph into connected components; ground truth node t is
+        // result_count + t
+        std::vector<std::size_t> parents(result_count + truth_count);
+        std::iota(parents.begin(), parents.end(), 0);
+        for (const auto& e : edges)
+        {
+            const auto a = find_root(parents, e.result);
+            const auto b = find_root(parents, result_count + e.truth);
+            if (a != b)
+                parents[a] = b;
+        }
+
+        // group the edges by component, so each component is a contiguous range
+        std::vector<std::size_t> component(result_count);
+        for (std::size_t r = 0; r < result_count; ++r)
+            component[r] = find_root(parents, r);
+        std::stable_sort(edges.begin(), edges.end(), [&component](const match& a, const match& b) {
+            return component[a.result] < component[b.result];
+        });
+
+        std::vector<char> result_used(result_count, 0), truth_used(truth_count, 0);
+        auto first = edges.begin();
+        while (first != edges.end())
+        {
+            auto last = first + 1;
+            while (last != edges.end() && component[last->result] == component[first->result])
+                ++last;
+
+            if (last - first == 1)
+                matched.push_back(*first);
+            else if (method == match_method::greedy)
+                match_greedy(&*first, &*first + (last - first), matched, result_used, truth_used);
+            else
+                match_hungarian(&*first, &*first + (last - first), matched);
+            first = last;
+        }
+
+        std::sort(matched.begin(), matched.end(), [](const match& a, const match& b) {
+            return a.result < b.result;
+        });
+        return matched;
+    }
+
+    std::vector<match_list> match_sequence(const mot_sequence&   results,
+                                           const mot_sequence&   ground_truth,
+                                           const iou::value_type threshold,
+                                           const match_method    method,
+                                           unsigned              thread_count)
+    {
+        const auto frame_count = std::max(results.frame_count(), ground_truth.frame_count());
+        std::vector<match_list> matches(frame_count);
+
+        // the first failure stops every worker claiming frames, and is thrown after they finish
+        std::atomic<std::size_t> next_frame(0);
+        std::mutex               error_mutex;
+        std::exception_ptr       error;
+        const auto work = [&]() noexcept {
+            try
+            {
+                for (auto f = next_frame++; f < frame_count; f = next_frame++)
+                {
+                    const auto r = results.frame(f);
+                    const auto t = ground_truth.frame(f);
+                    if (r.size != 0 && t.size != 0)
+                        matches[f] = match_boxes(r.boxes, r.size, t.boxes, t.size, threshold, method);
+                }
+            }
+            catch (...)
+            {
+                next_frame = frame_count;
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error)
+                    error = std::current_exception();
+            }
+        };
+
+        // frames are claimed from the counter, so the calling thread does the frames of any
+        // worker which cannot be started
+        if (thread_count == 0)
+            thread_count = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<std::thread> workers;
+        try
+        {
+            workers.reserve(thread_count - 1);
+            for (unsigned t = 1; t < thread_count; ++t)
+                workers.emplace_back(work);
+        }
+        catch (...)
+        {
+        }
+        work();
+        for (auto& w : workers)
+            w.join();
+        if (error)
+            std::rethrow_exception(error);
+        return matches;
+    }
+
+    //-------------------------------------------------------
+    //                                      CLEAR MOT metrics
+    //-------------------------------------------------------
+    double clear_mot::accuracy() const noexcept
+    {
+        if (ground_truth == 0)
+            return 0.0;
+        return 1.0 - static_cast<double>(misses + false_positives + id_switches) / ground_truth;
+    }
+
+    double clear_mot::precision() const noexcept
+    {
+        return matches == 0 ? 0.0 : total_iou / matches;
+    }
+
+    clear_mot calculate_clear_mot(const mot_sequence&            results,
+                                  const mot_sequence&            ground_truth,
+                                  const std::vector<match_list>& matches)
+    {
+        clear_mot metrics;
+        std::unordered_map<int, int> last_match; // ground truth identity -> result identity
+        const auto frame_count = std::max(results.frame_count(), ground_truth.frame_count());
+        for (mot_sequence::size_type f = 0; f < frame_count; ++f)
+        {
+            const auto r = results.frame(f);
+            const auto t = ground_truth.frame(f);
+            const auto matched = f < matches.size() ? matches[f].size() : 0;
+            metrics.ground_truth    += t.size;
+            metrics.matches         += matched;
+            metrics.misses          += t.size - matched;
+            metrics.false_positives += r.size - matched;
+            if (matched == 0)
+                continue;
+
+            for (const auto& m : matches[f])
+            {
+                metrics.total_iou += m.value;
+                const auto previous = last_match.find(t.ids[m.truth]);
+                if (previous != last_match.end() && previous->second != r.ids[m.result])
+                    ++metrics.id_switches;
+                last_match[t.ids[m.truth]] = r.ids[m.result];
+            }
+        }
+        return metrics;
+    }
+}
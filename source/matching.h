@@ -0,0 +1,117 @@
+#ifndef ANALYZE_MATCHING_H
+#define ANALYZE_MATCHING_H
+
+#include "bounding_box.h"
+#include "iou.h"
+#include "mot.h"
+#include <vector>
+
+namespace analyze
+{
+    /// The algorithms available for assigning results to ground truth.
+    enum class match_method
+    {
+        greedy,   ///< Repeatedly match the remaining pair with the highest IoU.
+        hungarian ///< Match to maximize the total IoU, using the Hungarian algorithm.
+    };
+
+    /// Represents one assignment of an algorithm result to a ground truth object.
+    struct match final
+    {
+        std::size_t     result = 0; ///< The index of the result box.
+        std::size_t     truth  = 0; ///< The index of the ground truth box.
+        iou::value_type value  = 0; ///< The IoU between the two boxes.
+    };
+
+    /// Alias the type representing a list of matches.
+    using match_list = std::vector<match>;
+
+    /**
+     * \brief       Assign algorithm results to ground truth in one frame.
+     * \param[in]   results         The first of \a result_count algorithm result boxes.
+     * \param[in]   result_count    The number of algorithm result boxes.
+     * \param[in]   ground_truth    The first of \a truth_count ground truth boxes.
+     * \param[in]   truth_count     The number of ground truth boxes.
+     * \param[in]   threshold       The minimum IoU for a result and ground truth object to match.
+     *                              This should be greater than 0.
+     * \param[in]   method          The assignment algorithm.
+     * \return      The matches, sorted by result index. Each result and each ground truth object
+     *              appears in at most one match.
+     * \throws      std::bad_alloc  This is thrown if memory for the matching cannot be allocated.
+     * \details     Candidate pairs come from a spatial_grid over the ground truth, and pairs with
+     *              an IoU below \a threshold are discarded before any assignment is done. The
+     *              remaining pairs form a sparse bipartite graph, which is split into connected
+     *              components. Each component is solved independently. A component with one pair
+     *              is matched directly, so the dense Hungarian algorithm only runs on the small
+     *              clusters where objects actually compete.
+     */
+    match_list match_boxes(const bounding_box<float>* results,
+                           const std::size_t          result_count,
+                           const bounding_box<float>* ground_truth,
+                           const std::size_t          truth_count,
+                           const iou::value_type      threshold,
+                           const match_method         method);
+
+    /**
+     * \brief       Assign algorithm results to ground truth in every frame of a sequence.
+     * \param[in]   results         The multi-object algorithm results.
+     * \param[in]   ground_truth    The multi-object ground truth.
+     * \param[in]   threshold       The minimum IoU for a match; see match_boxes().
+     * \param[in]   method          The assignment algorithm.
+     * \param[in]   thread_count    The number of threads to use. 0 uses one thread per core.
+     * \return      One match list for each frame, indexed by frame number. The indices in each
+     *              match refer to the objects in that frame.
+     * \throws      std::bad_alloc      This is thrown if memory for the matching cannot be
+     *                                  allocated, on any thread.
+     * \details     Frames are independent, so worker threads claim frames from a shared counter
+     *              and write each frame's matches to its own slot. The output does not depend on
+     *              the number of threads. The calling thread works too, so if a worker cannot be
+     *              started, its frames are matched by the others.
+     */
+    std::vector<match_list> match_sequence(const mot_sequence&   results,
+                                           const mot_sequence&   ground_truth,
+                                           const iou::value_type threshold,
+                                           const match_method    method,
+                                           unsigned              thread_count = 0);
+
+    /// Represents the CLEAR MOT metrics for a multi-object sequence.
+    struct clear_mot final
+    {
+        std::size_t ground_truth    = 0; ///< The number of ground truth objects.
+        std::size_t matches         = 0; ///< The number of matched objects.
+        std::size_t misses          = 0; ///< The number of unmatched ground truth objects.
+        std::size_t false_positives = 0; ///< The number of unmatched results.
+        std::size_t id_switches     = 0; ///< The number of times a ground truth identity changes
+                                         ///< the result identity matched to it.
+        double      total_iou       = 0; ///< The sum of the IoU over all matches.
+
+        /**
+         * \brief   Calculate the multi-object tracking accuracy.
+         * \return  \f$ 1 - \frac{misses + false\ positives + id\ switches}{ground\ truth} \f$
+         * \throws  None
+         */
+        double accuracy() const noexcept;
+
+        /**
+         * \brief   Calculate the multi-object tracking precision.
+         * \return  The average IoU of the matches.
+         * \throws  None
+         */
+        double precision() const noexcept;
+    };
+
+    /**
+     * \brief       Calculate the CLEAR MOT metrics from per frame matches.
+     * \param[in]   results         The multi-object algorithm results.
+     * \param[in]   ground_truth    The multi-object ground truth.
+     * \param[in]   matches         The matches for each frame, as returned by match_sequence().
+     * \return      The CLEAR MOT metrics for the sequence.
+     * \throws      std::bad_alloc  This is thrown if memory for identity tracking cannot be
+     *                              allocated.
+     */
+    clear_mot calculate_clear_mot(const mot_sequence&            results,
+                                  const mot_sequence&            ground_truth,
+                                  const std::vector<match_list>& matches);
+}
+
+#endif
@@ -0,0 +1,191 @@
+#include "mot.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace analyze
+{
+    namespace
+    {
+        /**
+         * \brief           Parse the comma separated numbers on one line.
+         * \param[in]       begin,end   The range of characters which make up the line.
+         * \param[out]      values      The parsed numbers.
+         * \param[in]       capacity    The maximum number of values to parse.
+         * \return          The number of values parsed.
+         * \throws          None
+         * \details         Parsing stops at the first field which is not a number, or when
+         *                  \a capacity values have been parsed.
+         */
+        std::size_t parse_line(const char* begin,
+                               const char* end,
+                               double* values,
+                               const std::size_t capacity) noexcept
+        {
+            std::size_t count = 0;
+            const char* p = begin;
+            while (count < capacity && p < end)
+            {
+                char* field_end = nullptr;
+                const double v = std::strtod(p, &field_end);
+
+                // strtod() skips leading white space, including the new line, so a missing field
+                // could otherwise consume the first number of the next line.
+                if (field_end == p || field_end > end)
+                    break;
+                values[count++] = v;
+
+                p = field_end;
+                while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+                    ++p;
+                if (p < end && *p == ',')
+                    ++p;
+            }
+            return count;
+        }
+    }
+
+    //-------------------------------------------------------
+    //                           mot_sequence class methods
+    //-------------------------------------------------------
+    mot_sequence::mot_sequence(const std::vector<size_type>& frames,
+                               const std::vector<int>&       ids,
+                               const box_list&               boxes,
+                               const std::vector<float>&     scores)
+    {
+        const auto count = frames.size();
+        if (ids.size() != count || boxes.size() != count || scores.size() != count)
+            throw std::invalid_argument("multi-object data lists have different sizes");
+        if (count == 0)
+            return;
+
+        // count the objects in each frame, then convert the counts to offsets
+        const auto last_frame = *std::max_element(frames.cbegin(), frames.cend());
+        m_offsets.assign(last_frame + 2, 0);
+        for (const auto f : frames)
+            ++m_offsets[f + 1];
+        for (size_type f = 1; f < m_offsets.size(); ++f)
+            m_offsets[f] += m_offsets[f - 1];
+
+        // scatter each object to its frame's slot
+        m_boxes.resize(count);
+        m_ids.resize(count);
+        m_scores.resize(count);
+        std::vector<size_type> next(m_offsets.cbegin(), m_offsets.cend() - 1);
+        for (size_type i = 0; i < count; ++i)
+        {
+            const auto slot = next[frames[i]]++;
+            m_boxes[slot]  = boxes[i];
+            m_ids[slot]    = ids[i];
+            m_scores[slot] = scores[i];
+        }
+    }
+
+    mot_sequence::size_type mot_sequence::frame_count() const noexcept
+    {
+        return m_offsets.empty() ? 0 : m_offsets.size() - 1;
+    }
+
+    mot_sequence::size_type mot_sequence::object_count() const noexcept
+    {
+        return m_boxes.size();
+    }
+
+    mot_frame mot_sequence::frame(const size_type f) const noexcept
+    {
+        mot_frame view;
+        if (f < frame_count())
+        {
+            const auto begin = m_offsets[f];
+            view.boxes  = m_boxes.data() + begin;
+            view.ids    = m_ids.data() + begin;
+            view.scores = m_scores.data() + begin;
+            view.size   = m_offsets[f + 1] - begin;
+        }
+        return view;
+    }
+
+    //-------------------------------------------------------
+    //                                    MOT file loading
+    //-------------------------------------------------------
+    namespace
+    {
+        /**
+         * \brief       Read multi-object tracking data from a file.
+         * \param[in]   file_name       The path to the file containing the tracking data.
+         * \param[in]   ground_truth    If this is true, the seventh value is the consider flag;
+         *                              otherwise it is a confidence score.
+         * \return      The tracking data, grouped by frame.
+         * \throws      std::runtime_error  This is thrown if the file cannot be opened, or if a
+         *                                  frame number or identity is out of range.
+         * \throws      std::bad_alloc      This is thrown if memory for the data cannot be
+         *                                  allocated.
+         */
+        mot_sequence parse_mot(const std::string& file_name, const bool ground_truth)
+        {
+            std::ifstream file(file_name.c_str(), std::ios::binary);
+            if (!file)
+                throw std::runtime_error("could not open multi-object file " + file_name);
+
+            // read the whole file at once; the parser walks the buffer instead of the stream
+            std::ostringstream buffer;
+            buffer << file.rdbuf();
+            const std::string text = buffer.str();
+
+            std::vector<mot_sequence::size_type> frames;
+            std::vector<int> ids;
+            box_list boxes;
+            std::vector<float> scores;
+
+            const char* p   = text.c_str();
+            const char* end = p + text.size();
+            for (std::size_t line = 1; p < end; ++line)
+            {
+                const char* line_end = static_cast<const char*>(std::memchr(p, '\n', end - p));
+                if (line_end == nullptr)
+                    line_end = end;
+
+                double values[7];
+                const auto count = parse_line(p, line_end, values, 7);
+                p = line_end + 1;
+                if (count < 6)
+                    continue;
+
+                // the frame number sizes the sequence, and converting a value out of range is
+                // undefined, so both are checked before they are used
+                if (!(values[0] >= 0.0 && values[0] <= static_cast<double>(max_mot_frame)))
+                    throw std::runtime_error(file_name + ": line " + std::to_string(line) + ": frame number out of range");
+                if (!(values[1] >= std::numeric_limits<int>::min() && values[1] <= std::numeric_limits<int>::max()))
+                    throw std::runtime_error(file_name + ": line " + std::to_string(line) + ": identity out of range");
+                if (ground_truth && count > 6 && values[6] == 0.0)
+                    continue;
+
+                const auto left = static_cast<float>(values[2]);
+                const auto top  = static_cast<float>(values[3]);
+                frames.push_back(static_cast<mot_sequence::size_type>(values[0]));
+                ids.push_back(static_cast<int>(values[1]));
+                boxes.emplace_back(left,
+                                   left + static_cast<float>(values[4]),
+                                   top,
+                                   top + static_cast<float>(values[5]));
+                scores.push_back(count > 6 && !ground_truth ? static_cast<float>(values[6]) : 1.0f);
+            }
+
+            return mot_sequence(frames, ids, boxes, scores);
+        }
+    }
+
+    mot_sequence load_mot(const std::string& file_name)
+    {
+        return parse_mot(file_name, false);
+    }
+
+    mot_sequence load_mot_ground_truth(const std::string& file_name)
+    {
+        return parse_mot(file_name, true);
+    }
+}
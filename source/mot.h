@@ -0,0 +1,129 @@
+#ifndef ANALYZE_MOT_H
+#define ANALYZE_MOT_H
+
+#include "bounding_box.h"
+#include <string>
+#include <vector>
+
+namespace analyze
+{
+    /**
+     * \brief       A read only view of the objects in one frame of a multi-object sequence.
+     * \details     The pointers refer to contiguous storage owned by a mot_sequence. They are
+     *              valid as long as the sequence is alive and unmodified.
+     */
+    struct mot_frame final
+    {
+        const bounding_box<float>* boxes  = nullptr; ///< The object bounding boxes.
+        const int*                 ids    = nullptr; ///< The object identities.
+        const float*               scores = nullptr; ///< The object confidence scores.
+        std::size_t                size   = 0;       ///< The number of objects in the frame.
+    };
+
+    /**
+     * \brief       Represents multi-object tracking data, grouped by frame.
+     * \details     The objects are stored in compressed sparse row (CSR) layout. All the boxes,
+     *              identities and scores are stored in contiguous arrays, sorted by frame. A
+     *              separate offset array records where each frame starts, so the objects for frame
+     *              \f$ f \f$ are the elements on \f$ [offset_f, offset_{f+1}) \f$. Frames are
+     *              indexed by their frame number from the input data, so a frame with no objects is
+     *              simply an empty range.
+     */
+    class mot_sequence final
+    {
+    public:
+        /// The type used for frame numbers, object counts, and offsets.
+        using size_type = std::size_t;
+
+        /**
+         * \brief   Construct an empty sequence.
+         * \throws  None
+         */
+        mot_sequence() = default;
+
+        /**
+         * \brief       Construct a sequence from unordered object data.
+         * \param[in]   frames  The frame number of each object.
+         * \param[in]   ids     The identity of each object.
+         * \param[in]   boxes   The bounding box of each object.
+         * \param[in]   scores  The confidence score of each object.
+         * \throws      std::invalid_argument   This is thrown if the four lists are not the same
+         *                                      size.
+         * \throws      std::bad_alloc          This is thrown if memory for the sequence cannot be
+         *                                      allocated.
+         * \details     The objects may be in any order. They are grouped by frame with a stable
+         *              counting sort, so objects within a frame keep their relative order.
+         */
+        mot_sequence(const std::vector<size_type>& frames,
+                     const std::vector<int>&       ids,
+                     const box_list&               boxes,
+                     const std::vector<float>&     scores);
+
+        /**
+         * \brief   Query the number of frames in the sequence.
+         * \return  One more than the largest frame number in the sequence, or 0 if the sequence is
+         *          empty.
+         * \throws  None
+         */
+        size_type frame_count() const noexcept;
+
+        /**
+         * \brief   Query the number of objects in the sequence, across all frames.
+         * \return  The total number of objects.
+         * \throws  None
+         */
+        size_type object_count() const noexcept;
+
+        /**
+         * \brief       Get the objects in one frame.
+         * \param[in]   f   The frame number.
+         * \return      A view of the objects in frame \a f. If \a f is not less than frame_count(),
+         *              the view is empty.
+         * \throws      None
+         */
+        mot_frame frame(const size_type f) const noexcept;
+
+    private:
+        std::vector<size_type> m_offsets; ///< The start of each frame; frame_count() + 1 entries.
+        box_list               m_boxes;   ///< The bounding boxes of all objects.
+        std::vector<int>       m_ids;     ///< The identities of all objects.
+        std::vector<float>     m_scores;  ///< The confidence scores of all objects.
+    };
+
+    /// The largest frame number a multi-object file may use: over 3 days of video at 30 frames per
+    /// second. The sequence holds an offset for every frame up to the last, so this bounds its size.
+    constexpr mot_sequence::size_type max_mot_frame = 10000000;
+
+    /**
+     * \brief       Read multi-object tracking results from a file.
+     * \param[in]   file_name   The path to the file containing the tracking data.
+     * \return      The tracking data, grouped by frame.
+     * \throws      std::runtime_error  This is thrown if the file cannot be opened, or if a line
+     *                                  has a frame number which is negative, not a number, or
+     *                                  greater than max_mot_frame, or an identity which does not
+     *                                  fit in an int.
+     * \throws      std::bad_alloc      This is thrown if memory for the data cannot be allocated.
+     * \details     The file must use the MOTChallenge layout. Each line is one object, and holds
+     *              comma separated values in this order: frame number, object identity, bounding
+     *              box left edge, bounding box top edge, bounding box width, bounding box height,
+     *              and optionally a confidence score. Any further values on a line are ignored.
+     *              Lines with fewer than six values are skipped. A missing confidence score is read
+     *              as 1.
+     */
+    mot_sequence load_mot(const std::string& file_name);
+
+    /**
+     * \brief       Read multi-object ground truth from a file.
+     * \param[in]   file_name   The path to the file containing the ground truth.
+     * \return      The objects to score, grouped by frame. Every score is 1.
+     * \throws      std::runtime_error  This is thrown in the same cases as load_mot().
+     * \throws      std::bad_alloc      This is thrown if memory for the data cannot be allocated.
+     * \details     The layout is the same as for load_mot(), except that the seventh value is the
+     *              MOTChallenge consider flag. Objects whose flag is 0 are left out, as the
+     *              MOTChallenge evaluation does, so they are neither matched nor missed. An object
+     *              without a flag is scored.
+     */
+    mot_sequence load_mot_ground_truth(const std::string& file_name);
+}
+
+#endif
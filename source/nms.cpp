@@ -0,0 +1,288 @@
+#include "nms.h"
+#include "spatial_grid.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+namespace analyze
+{
+    namespace
+    {
+        /**
+         * \brief       Detections sorted by descending score, in structure-of-arrays form.
+         * \details     Keeping each coordinate in its own array lets the one-vs-many IoU loops
+         *              run over contiguous floats.
+         */
+        struct detection_table final
+        {
+            std::vector<std::size_t>   index;  ///< The index of each row in the caller's list.
+            box_list                   boxes;  ///< The boxes, for the optional spatial grid.
+            std::vector<float>         left, right, top, bottom, area, score;
+            std::vector<unsigned char> alive;  ///< 1 if the row is neither selected nor discarded.
+        };
+
+        /**
+         * \brief       Sort detections by score, and unpack them.
+         * \param[in]   boxes,scores    The detections.
+         * \return      The sorted detection table.
+         * \throws      std::bad_alloc  This is thrown if the table cannot be allocated.
+         */
+        detection_table make_table(const box_list& boxes, const std::vector<float>& scores)
+        {
+            detection_table t;
+            const auto n = boxes.size();
+            t.index.resize(n);
+            std::iota(t.index.begin(), t.index.end(), 0);
+            std::stable_sort(t.index.begin(), t.index.end(), [&scores](const std::size_t a, const std::size_t b) {
+                return scores[a] > scores[b];
+            });
+
+            t.boxes.reserve(n);
+            for (const auto i : t.index)
+            {
+                const auto& b = boxes[i];
+                t.boxes.push_back(b);
+                t.left.push_back(b.left());
+                t.right.push_back(b.right());
+                t.top.push_back(b.top());
+                t.bottom.push_back(b.bottom());
+                t.area.push_back(analyze::area(b));
+                t.score.push_back(scores[i]);
+            }
+            t.alive.assign(n, 1);
+            return t;
+        }
+
+        /**
+         * \brief       Calculate the IoU between one row of the table and another.
+         * \param[in]   t       The detection table.
+         * \param[in]   i,j     The rows to compare.
+         * \return      The IoU of rows \a i and \a j, or 0 if neither has any area.
+         * \throws      None
+         */
+        inline float row_iou(const detection_table& t, const std::size_t i, const std::size_t j) noexcept
+        {
+            const float w = std::max(0.0f, std::min(t.right[i], t.right[j]) - std::max(t.left[i], t.left[j]));
+            const float h = std::max(0.0f, std::min(t.bottom[i], t.bottom[j]) - std::max(t.top[i], t.top[j]));
+            const float overlap  = w * h;
+            const float combined = t.area[i] + t.area[j] - overlap;
+            return combined > 0.0f ? overlap / combined : 0.0f;
+        }
+
+        /**
+         * \brief       Determine if the IoU between two rows of the table is above a threshold.
+         * \param[in]   t           The detection table.
+         * \param[in]   i,j         The rows to compare.
+         * \param[in]   threshold   The IoU threshold.
+         * \retval      true        The IoU of rows \a i and \a j is above \a threshold.
+         * \retval      false       The IoU is not above \a threshold, or neither row has area.
+         * \throws      None
+         * \details     This compares without dividing: \f$ IoU > t \iff A(i \cap j) > t A(i \cup j) \f$
+         */
+        inline bool above_threshold(const detection_table& t,
+                                    const std::size_t i,
+                                    const std::size_t j,
+                                    const float threshold) noexcept
+        {
+            const float w = std::max(0.0f, std::min(t.right[i], t.right[j]) - std::max(t.left[i], t.left[j]));
+            const float h = std::max(0.0f, std::min(t.bottom[i], t.bottom[j]) - std::max(t.top[i], t.top[j]));
+            const float overlap = w * h;
+            return overlap > threshold * (t.area[i] + t.area[j] - overlap);
+        }
+
+        /**
+         * \brief       Calculate the score multiplier for a box overlapping a selected box.
+         * \param[in]   overlap The IoU between the two boxes.
+         * \param[in]   options The suppression settings.
+         * \return      The factor by which to scale the overlapping box's score.
+         * \throws      None
+         */
+        inline float decay(const float overlap, const nms_options& options) noexcept
+        {
+            switch (options.method)
+            {
+            case nms_method::linear:
+                return overlap > options.threshold ? 1.0f - overlap : 1.0f;
+            case nms_method::gaussian:
+                return std::exp(-overlap * overlap / options.sigma);
+            case nms_method::hard:
+                break;
+            }
+            return overlap > options.threshold ? 0.0f : 1.0f;
+        }
+
+        /**
+         * \brief           Apply a selected row's suppression to every other live row.
+         * \param[in,out]   t       The detection table.
+         * \param[in]       i       The selected row.
+         * \param[in]       options The suppression settings.
+         * \throws          None
+         */
+        void suppress_all(detection_table& t, const std::size_t i, const nms_options& options) noexcept
+        {
+            const auto n = t.score.size();
+            if (options.method == nms_method::hard)
+            {
+                for (std::size_t j = i + 1; j < n; ++j)
+                    t.alive[j] &= static_cast<unsigned char>(!above_threshold(t, i, j, options.threshold));
+                return;
+            }
+
+            // selected and discarded rows keep their scores; the select keeps this branch free
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                const float decayed = t.score[j] * decay(row_iou(t, i, j), options);
+                t.score[j] = t.alive[j] ? decayed : t.score[j];
+                t.alive[j] &= static_cast<unsigned char>(t.score[j] >= options.score_threshold);
+            }
+        }
+
+        /**
+         * \brief           Apply a selected row's suppression to the live rows which overlap it.
+         * \param[in,out]   t           The detection table.
+         * \param[in]       grid        A spatial grid over the table's boxes.
+         * \param[in]       i           The selected row.
+         * \param[in]       options     The suppression settings.
+         * \param[in,out]   candidates  Scratch space for the grid query.
+         * \throws          std::bad_alloc  This is thrown if \a candidates cannot grow.
+         * \details         Boxes which do not overlap have an IoU of 0, which never suppresses or
+         *                  decays a score, so only the grid's candidates need to be visited.
+         */
+        void suppress_near(detection_table& t,
+                           const spatial_grid<float>& grid,
+                           const std::size_t i,
+                           const nms_options& options,
+                           std::vector<std::size_t>& candidates)
+        {
+            candidates.clear();
+            grid.query(t.boxes[i], candidates);
+            for (const auto j : candidates)
+            {
+                if (!t.alive[j])
+                    continue;
+                if (options.method == nms_method::hard)
+                {
+                    t.alive[j] = static_cast<unsigned char>(!above_threshold(t, i, j, options.threshold));
+                    continue;
+                }
+                t.score[j] *= decay(row_iou(t, i, j), options);
+                t.alive[j] = static_cast<unsigned char>(t.score[j] >= options.score_threshold);
+            }
+        }
+    }
+
+    std::vector<std::size_t> non_maximum_suppression(const box_list&      boxes,
+                                                     std::vector<float>&  scores,
+                                                     const nms_options&   options)
+    {
+        if (boxes.size() != scores.size())
+            throw std::invalid_argument("there must be one score for each box");
+
+        auto t = make_table(boxes, scores);
+        const auto n = boxes.size();
+        spatial_grid<float> grid;
+        std::vector<std::size_t> candidates;
+        if (options.use_grid)
+            grid.build(t.boxes.data(), n);
+
+        std::vector<std::size_t> kept;
+        for (std::size_t step = 0; step < n; ++step)
+        {
+            // hard suppression never changes scores, so the sorted order is the selection order
+            std::size_t i = step;
+            if (options.method != nms_method::hard)
+            {
+                i = n;
+                for (std::size_t j = 0; j < n; ++j)
+                {
+                    if (t.alive[j] && (i == n || t.score[j] > t.score[i]))
+                        i = j;
+                }
+                if (i == n)
+                    break;
+            }
+            else if (!t.alive[i])
+                continue;
+
+            kept.push_back(t.index[i]);
+            t.alive[i] = 0;
+            if (options.use_grid)
+                suppress_near(t, grid, i, options, candidates);
+            else
+                suppress_all(t, i, options);
+        }
+
+        if (options.method != nms_method::hard)
+        {
+            for (std::size_t j = 0; j < n; ++j)
+                scores[t.index[j]] = t.score[j];
+        }
+        return kept;
+    }
+
+    std::vector<std::size_t> non_maximum_suppression(const box_list&         boxes,
+                                                     std::vector<float>&     scores,
+                                                     const std::vector<int>& classes,
+                                                     const nms_options&      options)
+    {
+        if (boxes.size() != scores.size() || boxes.size() != classes.size())
+            throw std::invalid_argument("there must be one score and one class for each box");
+
+        // gather the boxes of each class together
+        std::vector<std::size_t> order(boxes.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&classes](const std::size_t a, const std::size_t b) {
+            return classes[a] < classes[b];
+        });
+
+        std::vector<std::size_t> kept;
+        box_list class_boxes;
+        std::vector<float> class_scores;
+        auto first = order.cbegin();
+        while (first != order.cend())
+        {
+            auto last = first;
+            class_boxes.clear();
+            class_scores.clear();
+            for (; last != order.cend() && classes[*last] == classes[*first]; ++last)
+            {
+                class_boxes.push_back(boxes[*last]);
+                class_scores.push_back(scores[*last]);
+            }
+
+            for (const auto k : non_maximum_suppression(class_boxes, class_scores, options))
+                kept.push_back(first[k]);
+            for (std::size_t k = 0; k < class_scores.size(); ++k)
+                scores[first[k]] = class_scores[k];
+            first = last;
+        }
+
+        std::stable_sort(kept.begin(), kept.end(), [&scores](const std::size_t a, const std::size_t b) {
+            return scores[a] > scores[b];
+        });
+        return kept;
+    }
+
+    mot_sequence non_maximum_suppression(const mot_sequence& detections, const nms_options& options)
+    {
+        std::vector<mot_sequence::size_type> frames;
+        std::vector<int> ids;
+        box_list boxes, frame_boxes;
+        std::vector<float> scores, frame_scores;
+        for (mot_sequence::size_type f = 0; f < detections.frame_count(); ++f)
+        {
+            const auto d = detections.frame(f);
+            frame_boxes.assign(d.boxes, d.boxes + d.size);
+            frame_scores.assign(d.scores, d.scores + d.size);
+            for (const auto k : non_maximum_suppression(frame_boxes, frame_scores, options))
+            {
+                frames.push_back(f);
+                ids.push_back(d.ids[k]);
+                boxes.push_back(frame_boxes[k]);
+                scores.push_back(frame_scores[k]);
+            }
+        }
+        return mot_sequence(frames, ids, boxes, scores);
+    }
+}
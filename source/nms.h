@@ -0,0 +1,85 @@
+#ifndef ANALYZE_NMS_H
+#define ANALYZE_NMS_H
+
+#include "bounding_box.h"
+#include "iou.h"
+#include "mot.h"
+#include <vector>
+
+namespace analyze
+{
+    /// The ways non-maximum suppression can treat an overlapping, lower scoring box.
+    enum class nms_method
+    {
+        hard,    ///< Discard the box if its IoU is above the threshold.
+        linear,  ///< Scale the score by \f$ 1 - IoU \f$ if the IoU is above the threshold.
+        gaussian ///< Scale the score by \f$ e^{-IoU^2 / \sigma} \f$.
+    };
+
+    /// The settings for non-maximum suppression.
+    struct nms_options final
+    {
+        nms_method      method          = nms_method::hard; ///< The suppression method.
+        iou::value_type threshold       = 0.5f;   ///< The IoU above which boxes are suppressed.
+        float           sigma           = 0.5f;   ///< The spread of gaussian suppression.
+        float           score_threshold = 0.001f; ///< Boxes whose score decays below this are
+                                                  ///< discarded by soft suppression.
+        bool            use_grid        = false;  ///< Find overlapping boxes with a spatial_grid
+                                                  ///< instead of comparing every pair. This helps
+                                                  ///< when there are many boxes spread over the
+                                                  ///< image.
+    };
+
+    /**
+     * \brief           Remove duplicate detections, keeping the highest scoring boxes.
+     * \param[in]       boxes   The detected boxes.
+     * \param[in,out]   scores  The score of each box. Soft suppression methods replace the scores
+     *                          with the decayed scores; hard suppression leaves them unchanged.
+     * \param[in]       options The suppression settings.
+     * \return          The indices of the boxes which survive, in the order they were selected.
+     *                  For hard suppression, that is descending score order.
+     * \throws          std::invalid_argument   This is thrown if \a boxes and \a scores are not the
+     *                                          same size.
+     * \throws          std::bad_alloc          This is thrown if working memory cannot be
+     *                                          allocated.
+     * \details         The boxes are sorted by descending score and unpacked into structure-of-
+     *                  arrays form. Each selected box is then compared against all the remaining
+     *                  boxes in one branch free loop, which the compiler can vectorize. Hard
+     *                  suppression selects boxes in sorted order; soft suppression selects the
+     *                  highest decayed score remaining at each step.
+     */
+    std::vector<std::size_t> non_maximum_suppression(const box_list&      boxes,
+                                                     std::vector<float>&  scores,
+                                                     const nms_options&   options);
+
+    /**
+     * \brief           Remove duplicate detections within each object class.
+     * \param[in]       boxes   The detected boxes.
+     * \param[in,out]   scores  The score of each box. See the class agnostic overload.
+     * \param[in]       classes The object class of each box. Boxes only suppress other boxes of
+     *                          the same class.
+     * \param[in]       options The suppression settings.
+     * \return          The indices of the boxes which survive, in descending score order.
+     * \throws          std::invalid_argument   This is thrown if \a boxes, \a scores, and
+     *                                          \a classes are not all the same size.
+     * \throws          std::bad_alloc          This is thrown if working memory cannot be
+     *                                          allocated.
+     */
+    std::vector<std::size_t> non_maximum_suppression(const box_list&         boxes,
+                                                     std::vector<float>&     scores,
+                                                     const std::vector<int>& classes,
+                                                     const nms_options&      options);
+
+    /**
+     * \brief       Remove duplicate detections from every frame of a multi-object sequence.
+     * \param[in]   detections  The multi-object detections. The object scores are used for
+     *                          suppression.
+     * \param[in]   options     The suppression settings.
+     * \return      The surviving detections, with their scores after suppression.
+     * \throws      std::bad_alloc  This is thrown if memory for the new sequence cannot be
+     *                              allocated.
+     */
+    mot_sequence non_maximum_suppression(const mot_sequence& detections, const nms_options& options);
+}
+
+#endif
@@ -0,0 +1,215 @@
+#include "polygon.h"
+#include "comma_ctype.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace analyze
+{
+    namespace
+    {
+        /// The most corners a quadrilateral can have after clipping by another quadrilateral.
+        constexpr std::size_t max_clipped_corners = 8;
+
+        /// The clipping buffer size. One clipping pass emits at most two corners per input corner.
+        constexpr std::size_t clip_buffer_size = 2 * max_clipped_corners;
+
+        /**
+         * \brief       Calculate the cross product of two edges which share a start point.
+         * \param[in]   o   The shared start point.
+         * \param[in]   a,b The end points of the two edges.
+         * \return      The z component of \f$ (a - o) \times (b - o) \f$.
+         * \throws      None
+         */
+        inline float cross(const point& o, const point& a, const point& b) noexcept
+        {
+            return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+        }
+
+        /**
+         * \brief       Calculate the signed area of a polygon with the shoelace formula.
+         * \param[in]   corners The first of \a count polygon corners.
+         * \param[in]   count   The number of corners.
+         * \return      The signed area; the sign gives the winding order.
+         * \throws      None
+         */
+        float signed_area(const point* corners, const std::size_t count) noexcept
+        {
+            float sum = 0.0f;
+            for (std::size_t i = 0, j = count - 1; i < count; j = i++)
+                sum += corners[j].x * corners[i].y - corners[i].x * corners[j].y;
+            return 0.5f * sum;
+        }
+    }
+
+    //-------------------------------------------------------
+    //                          quadrilateral class methods
+    //-------------------------------------------------------
+    quadrilateral::quadrilateral(const corner_list& corners) noexcept : m_corners(corners)
+    {
+        // store a positive winding, so clipping always keeps the left side of each edge
+        if (signed_area(m_corners.data(), m_corners.size()) < 0.0f)
+            std::swap(m_corners[1], m_corners[3]);
+    }
+
+    quadrilateral::quadrilateral(const bounding_box<float>& box) noexcept
+        : quadrilateral(corner_list {{{box.left(), box.top()},
+                                      {box.right(), box.top()},
+                                      {box.right(), box.bottom()},
+                                      {box.left(), box.bottom()}}})
+    {
+    }
+
+    quadrilateral make_rotated_box(const point& center,
+                                   const float  width,
+                                   const float  height,
+                                   const float  angle) noexcept
+    {
+        const float c = std::cos(angle), s = std::sin(angle);
+        const float w = 0.5f * width, h = 0.5f * height;
+        quadrilateral::corner_list corners;
+        const float offsets[4][2] = {{-w, -h}, {w, -h}, {w, h}, {-w, h}};
+        for (std::size_t i = 0; i < corners.size(); ++i)
+        {
+            corners[i].x = center.x + offsets[i][0] * c - offsets[i][1] * s;
+            corners[i].y = center.y + offsets[i][0] * s + offsets[i][1] * c;
+        }
+        return quadrilateral(corners);
+    }
+
+    //-------------------------------------------------------
+    //                                 quadrilateral geometry
+    //-------------------------------------------------------
+    float area(const quadrilateral& q) noexcept
+    {
+        return std::fabs(signed_area(q.corners().data(), q.corners().size()));
+    }
+
+    bounding_box<float> bounding_hull(const quadrilateral& q) noexcept
+    {
+        const auto& c = q.corners();
+        return bounding_box<float>(std::min(std::min(c[0].x, c[1].x), std::min(c[2].x, c[3].x)),
+                                   std::max(std::max(c[0].x, c[1].x), std::max(c[2].x, c[3].x)),
+                                   std::min(std::min(c[0].y, c[1].y), std::min(c[2].y, c[3].y)),
+                                   std::max(std::max(c[0].y, c[1].y), std::max(c[2].y, c[3].y)));
+    }
+
+    iou make_iou(const quadrilateral& a, const quadrilateral& b) noexcept
+    {
+        if (area(intersection(bounding_hull(a), bounding_hull(b))) <= 0.0f)
+            return iou();
+
+        const float area_a = area(a), area_b = area(b);
+        if (area_a <= 0.0f || area_b <= 0.0f)
+            return iou();
+
+        // clip a against each edge of b, ping-ponging between two buffers
+        point buffers[2][clip_buffer_size];
+        std::copy(a.corners().cbegin(), a.corners().cend(), buffers[0]);
+        std::size_t count = a.corners().size();
+        const auto& clip = b.corners();
+        for (std::size_t e = 0; e < clip.size() && count > 0; ++e)
+        {
+            const auto& e0 = clip[e];
+            const auto& e1 = clip[(e + 1) % clip.size()];
+            const point* in = buffers[e % 2];
+            point* out = buffers[(e + 1) % 2];
+            std::size_t out_count = 0;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const auto& p = in[i];
+                const auto& q = in[(i + 1) % count];
+                const float cp = cross(e0, e1, p), cq = cross(e0, e1, q);
+                if (cp >= 0.0f)
+                    out[out_count++] = p;
+                if ((cp >= 0.0f) != (cq >= 0.0f))
+                {
+                    const float t = cp / (cp - cq);
+                    out[out_count++] = point {p.x + t * (q.x - p.x), p.y + t * (q.y - p.y)};
+                }
+            }
+            count = std::min(out_count, max_clipped_corners);
+        }
+
+        const float overlap = count < 3 ? 0.0f
+                                        : std::min(std::fabs(signed_area(buffers[clip.size() % 2], count)),
+                                                   std::min(area_a, area_b));
+        return iou(overlap / (area_a + area_b - overlap));
+    }
+
+    void calculate_ious(const quadrilateral* results,
+                        const quadrilateral* ground_truth,
+                        const std::size_t    count,
+                        iou*                 ious) noexcept
+    {
+        for (std::size_t i = 0; i < count; ++i)
+            ious[i] = make_iou(results[i], ground_truth[i]);
+    }
+
+    //-------------------------------------------------------
+    //                                       region loading
+    //-------------------------------------------------------
+    quadrilateral_list load_regions(const std::string& file_name, std::vector<region_status>* const statuses)
+    {
+        std::ifstream file(file_name.c_str());
+        if (!file)
+            throw std::runtime_error("could not open region file " + file_name);
+
+        const std::locale comma_delimiter(std::locale::classic(), new ctype);
+        quadrilateral_list regions;
+        if (statuses != nullptr)
+            statuses->clear();
+        std::string line;
+        std::istringstream values;
+        values.imbue(comma_delimiter);
+        for (std::size_t number = 1; std::getline(file, line); ++number)
+        {
+            values.clear();
+            values.str(line);
+            float v[8];
+            std::size_t count = 0;
+            while (count < 8 && values >> v[count])
+                ++count;
+            values.clear();
+            if (!(values >> std::ws).eof())
+                count = 0;
+            else if (count == 0)
+                continue;
+
+            auto status = region_status::tracked;
+            if (count == 8)
+            {
+                regions.emplace_back(quadrilateral::corner_list {{{v[0], v[1]},
+                                                                  {v[2], v[3]},
+                                                                  {v[4], v[5]},
+                                                                  {v[6], v[7]}}});
+            }
+            else if (count == 4)
+                regions.emplace_back(bounding_box<float>(v[0], v[0] + v[2], v[1], v[1] + v[3]));
+            else if (count == 1 && (v[0] == 0.0f || v[0] == 1.0f || v[0] == 2.0f))
+            {
+                status = v[0] == 1.0f ? region_status::initialized
+                         : v[0] == 2.0f ? region_status::failed
+                                        : region_status::skipped;
+                regions.emplace_back();
+            }
+            else
+                throw std::runtime_error(file_name + ": line " + std::to_string(number) + ": expected a region or a status");
+            if (statuses != nullptr)
+                statuses->push_back(status);
+        }
+        return regions;
+    }
+
+    void apply_region_statuses(iou_list& ious, const std::vector<region_status>& statuses) noexcept
+    {
+        for (std::size_t i = 0; i < std::min(ious.size(), statuses.size()); ++i)
+        {
+            if (statuses[i] == region_status::initialized || statuses[i] == region_status::skipped)
+                ious[i] = iou(std::numeric_limits<float>::quiet_NaN());
+        }
+    }
+}
@@ -0,0 +1,167 @@
+#ifndef ANALYZE_POLYGON_H
+#define ANALYZE_POLYGON_H
+
+#include "bounding_box.h"
+#include "iou.h"
+#include <array>
+#include <string>
+#include <vector>
+
+namespace analyze
+{
+    /// Represents a point on an image.
+    struct point final
+    {
+        float x = 0.0f; ///< The column coordinate of the point.
+        float y = 0.0f; ///< The row coordinate of the point.
+    };
+
+    /**
+     * \brief       Represents a convex four sided region on an image, such as a rotated box.
+     * \details     VOT ground truth is recorded as four corner points. The corners may be listed
+     *              in either winding order; they are stored in a consistent winding so the IoU
+     *              calculation does not need to check. The region is assumed to be convex.
+     */
+    class quadrilateral final
+    {
+    public:
+        /// The type of the container holding the corners.
+        using corner_list = std::array<point, 4>;
+
+        /**
+         * \brief   Construct a default quadrilateral.
+         * \throws  None
+         * \details All the corners are at (0, 0).
+         */
+        quadrilateral() = default;
+
+        /**
+         * \brief       Construct a quadrilateral from its corners.
+         * \param[in]   corners The corners, in order around the quadrilateral.
+         * \throws      None
+         */
+        explicit quadrilateral(const corner_list& corners) noexcept;
+
+        /**
+         * \brief       Construct a quadrilateral from an axis aligned bounding box.
+         * \param[in]   box The bounding box.
+         * \throws      None
+         */
+        explicit quadrilateral(const bounding_box<float>& box) noexcept;
+
+        /**
+         * \brief   Get the corners of the quadrilateral.
+         * \return  The corners, in a consistent winding order.
+         * \throws  None
+         */
+        const corner_list& corners() const noexcept { return m_corners; }
+
+    private:
+        corner_list m_corners; ///< The corners of the quadrilateral.
+    };
+
+    /**
+     * \brief       Make a quadrilateral from a rotated rectangle.
+     * \param[in]   center  The center of the rectangle.
+     * \param[in]   width   The width of the rectangle, before rotation.
+     * \param[in]   height  The height of the rectangle, before rotation.
+     * \param[in]   angle   The rotation, in radians.
+     * \return      The corners of the rotated rectangle.
+     * \throws      None
+     */
+    quadrilateral make_rotated_box(const point& center,
+                                   const float  width,
+                                   const float  height,
+                                   const float  angle) noexcept;
+
+    /**
+     * \brief       Calculate the area of a quadrilateral.
+     * \param[in]   q   The quadrilateral for which to calculate the area.
+     * \return      The area of \a q, measured in pixel coordinates.
+     * \throws      None
+     * \related     quadrilateral
+     */
+    float area(const quadrilateral& q) noexcept;
+
+    /**
+     * \brief       Calculate the smallest axis aligned box containing a quadrilateral.
+     * \param[in]   q   The quadrilateral to enclose.
+     * \return      The bounding box of \a q.
+     * \throws      None
+     * \related     quadrilateral
+     */
+    bounding_box<float> bounding_hull(const quadrilateral& q) noexcept;
+
+    /**
+     * \brief       Construct an IoU for two quadrilaterals.
+     * \param[in]   a,b     The quadrilaterals for which to calculate the IoU.
+     * \return      The IoU of \a a and \a b. If neither has any area, the IoU is 0.
+     * \throws      None
+     * \details     If the bounding hulls do not intersect(), the IoU is 0 and no clipping is done.
+     *              Otherwise \a a is clipped against each edge of \a b with the Sutherland-Hodgman
+     *              algorithm. The clipped polygon never has more than eight corners, so all the
+     *              work is done in fixed size arrays on the stack.
+     */
+    iou make_iou(const quadrilateral& a, const quadrilateral& b) noexcept;
+
+    /**
+     * \brief       Calculate IoU values for two lists of quadrilaterals.
+     * \param[in]   results         The first of \a count algorithm result regions.
+     * \param[in]   ground_truth    The first of \a count ground truth regions.
+     * \param[in]   count           The number of regions in each list.
+     * \param[out]  ious            The first of \a count IoU values to write. Entry \f$ i \f$ is
+     *                              the IoU of \a results[i] and \a ground_truth[i].
+     * \throws      None
+     * \details     The bounding hulls of each pair are tested first, so frames where the result
+     *              has lost the target cost only a few comparisons.
+     */
+    void calculate_ious(const quadrilateral* results,
+                        const quadrilateral* ground_truth,
+                        const std::size_t    count,
+                        iou*                 ious) noexcept;
+
+    /// Alias the type representing a list of quadrilaterals.
+    using quadrilateral_list = std::vector<quadrilateral>;
+
+    /// The state of the tracker on one frame of a VOT region file.
+    enum class region_status
+    {
+        tracked,     ///< The line is a region.
+        initialized, ///< The line is 1: the tracker was initialized on this frame.
+        failed,      ///< The line is 2: the tracker failed on this frame.
+        skipped      ///< The line is 0: the frame was skipped after a failure.
+    };
+
+    /**
+     * \brief       Read VOT region data from a file.
+     * \param[in]   file_name   The path to the file containing the regions.
+     * \param[out]  statuses    If this is not null, it is given the status of each frame.
+     * \return      A list of regions from the file.
+     * \throws      std::runtime_error  This is thrown if the file cannot be opened, or if a line
+     *                                  matches none of the forms below.
+     * \details     Each line must correspond to one frame, and hold comma separated values in one
+     *              of three forms:
+     *              \li eight values: \f$ x_1, y_1, x_2, y_2, x_3, y_3, x_4, y_4 \f$, the corners of
+     *              the region.
+     *              \li four values: left edge, top edge, width, and height of an axis aligned
+     *              box, in the VOT order.
+     *              \li one value, 1, 2, or 0: a frame of a VOT results file on which the tracker
+     *              was initialized, failed, or was skipped; see region_status. The frame's region
+     *              is empty, so it overlaps nothing.
+     *              Blank lines, and lines holding only whitespace, are skipped.
+     */
+    quadrilateral_list load_regions(const std::string& file_name, std::vector<region_status>* statuses = nullptr);
+
+    /**
+     * \brief       Leave the frames on which a tracker was not tracking out of an IoU series.
+     * \param[in,out]   ious    The IoUs of the regions. Only the first \a statuses.size() are
+     *                          changed.
+     * \param[in]   statuses    The statuses from load_regions().
+     * \throws      None
+     * \details     Initialized and skipped frames become NaN, so evaluate_robustness() neither
+     *              counts them as failures nor averages them. Failed frames keep their IoU of 0.
+     */
+    void apply_region_statuses(iou_list& ious, const std::vector<region_status>& statuses) noexcept;
+}
+
+#endif
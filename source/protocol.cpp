@@ -0,0 +1,268 @@
+#include "protocol.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace analyze
+{
+    namespace
+    {
+        /// Identifies a request message: "ANRQ".
+        constexpr std::uint32_t request_magic = 0x51524e41;
+
+        /// Identifies a response message: "ANRS".
+        constexpr std::uint32_t response_magic = 0x53524e41;
+
+        /// The protocol version. Change this whenever the layout of a message changes.
+        constexpr std::uint32_t protocol_version = 1;
+
+        /// The largest message payload, in bytes.
+        constexpr std::uint32_t maximum_message = 16 * 1024 * 1024;
+
+        /**
+         * \brief           Append a number to a message.
+         * \tparam          T       The type of the number.
+         * \param[in,out]   message The message to extend.
+         * \param[in]       value   The number to append.
+         * \throws          std::bad_alloc  This is thrown if the message cannot grow.
+         */
+        template <class T>
+        void put(std::string& message, const T value)
+        {
+            message.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        /**
+         * \brief           Append a string to a message.
+         * \param[in,out]   message The message to extend.
+         * \param[in]       value   The string to append. It is preceded by its length.
+         * \throws          std::bad_alloc  This is thrown if the message cannot grow.
+         */
+        void put(std::string& message, const std::string& value)
+        {
+            put(message, static_cast<std::uint32_t>(value.size()));
+            message.append(value);
+        }
+
+        /// Reads values from a message, checking that each one is inside the message.
+        class message_reader final
+        {
+        public:
+            /**
+             * \brief       Construct a reader for a message.
+             * \param[in]   message The message to read. It must outlive the reader.
+             * \throws      None
+             */
+            explicit message_reader(const std::string& message) noexcept : m_message(message) {}
+
+            /**
+             * \brief   Read a number.
+             * \tparam  T   The type of the number.
+             * \return  The next number in the message.
+             * \throws  std::invalid_argument   This is thrown if the message is too short.
+             */
+            template <class T>
+            T get()
+            {
+                T value;
+                std::memcpy(&value, take(sizeof(value)), sizeof(value));
+                return value;
+            }
+
+            /**
+             * \brief   Read a string.
+             * \return  The next string in the message.
+             * \throws  std::invalid_argument   This is thrown if the message is too short.
+             */
+            std::string get_string()
+            {
+                const auto length = get<std::uint32_t>();
+                return std::string(take(length), length);
+            }
+
+            /**
+             * \brief   Query if the whole message has been read.
+             * \retval  true    Every byte has been read.
+             * \retval  false   Some bytes are left.
+             * \throws  None
+             */
+            bool done() const noexcept { return m_position == m_message.size(); }
+
+        private:
+            /**
+             * \brief       Consume bytes from the message.
+             * \param[in]   count   The number of bytes to consume.
+             * \return      A pointer to the first consumed byte.
+             * \throws      std::invalid_argument   This is thrown if fewer than \a count bytes are
+             *                                      left.
+             */
+            const char* take(const std::size_t count)
+            {
+                if (m_message.size() - m_position < count)
+                    throw std::invalid_argument("truncated evaluation message");
+                const auto* start = m_message.data() + m_position;
+                m_position += count;
+                return start;
+            }
+
+            const std::string& m_message;      ///< The message being read.
+            std::size_t        m_position = 0; ///< The offset of the next unread byte.
+        };
+
+        /**
+         * \brief           Read a message header and check it.
+         * \param[in,out]   reader  The reader at the start of the message.
+         * \param[in]       magic   The expected magic number.
+         * \throws          std::invalid_argument   This is thrown if the header is wrong.
+         */
+        void check_header(message_reader& reader, const std::uint32_t magic)
+        {
+            if (reader.get<std::uint32_t>() != magic)
+                throw std::invalid_argument("not an evaluation message");
+            if (reader.get<std::uint32_t>() != protocol_version)
+                throw std::invalid_argument("unsupported evaluation protocol version");
+        }
+
+        /**
+         * \brief       Transfer a whole buffer over a socket.
+         * \tparam      Transfer    A callable with the signature of recv() or send().
+         * \param[in]   socket      The connected socket.
+         * \param[in]   data        The buffer.
+         * \param[in]   size        The number of bytes to transfer.
+         * \param[in]   transfer    The function which moves the bytes.
+         * \return      The number of bytes transferred. This is less than \a size only if the peer
+         *              closed the connection.
+         * \throws      std::runtime_error  This is thrown if the socket fails.
+         */
+        template <class Transfer>
+        std::size_t transfer_all(const int socket, char* data, const std::size_t size, Transfer transfer)
+        {
+            std::size_t done = 0;
+            while (done < size)
+            {
+                const auto count = transfer(socket, data + done, size - done);
+                if (count < 0 && errno == EINTR)
+                    continue;
+                if (count < 0)
+                    throw std::runtime_error(std::string("socket error: ") + std::strerror(errno));
+                if (count == 0)
+                    break;
+                done += static_cast<std::size_t>(count);
+            }
+            return done;
+        }
+    }
+
+    std::string encode_request(const evaluation_request& request)
+    {
+        std::string message;
+        put(message, request_magic);
+        put(message, protocol_version);
+        put(message, static_cast<std::uint8_t>(request.metric));
+        put(message, request.results_directory);
+        put(message, request.output_directory);
+        put(message, static_cast<std::uint32_t>(request.sequences.size()));
+        for (const auto& s : request.sequences)
+            put(message, s);
+        return message;
+    }
+
+    evaluation_request decode_request(const std::string& message)
+    {
+        message_reader reader(message);
+        check_header(reader, request_magic);
+
+        evaluation_request request;
+        const auto metric = reader.get<std::uint8_t>();
+        if (metric > static_cast<std::uint8_t>(evaluation_metric::vot_masks))
+            throw std::invalid_argument("unknown evaluation metric");
+        request.metric            = static_cast<evaluation_metric>(metric);
+        request.results_directory = reader.get_string();
+        request.output_directory  = reader.get_string();
+        const auto count          = reader.get<std::uint32_t>();
+        for (std::uint32_t s = 0; s < count; ++s)
+            request.sequences.push_back(reader.get_string());
+        if (!reader.done())
+            throw std::invalid_argument("trailing data after evaluation request");
+        return request;
+    }
+
+    std::string encode_response(const evaluation_response& response)
+    {
+        std::string message;
+        put(message, response_magic);
+        put(message, protocol_version);
+        put(message, static_cast<std::uint32_t>(response.size()));
+        for (const auto& r : response)
+        {
+            put(message, static_cast<std::uint8_t>(r.ok ? 1 : 0));
+            put(message, static_cast<std::uint64_t>(r.summary.count));
+            put(message, r.summary.minimum);
+            put(message, r.summary.maximum);
+            put(message, r.summary.average);
+            put(message, r.error);
+        }
+        return message;
+    }
+
+    evaluation_response decode_response(const std::string& message)
+    {
+        message_reader reader(message);
+        check_header(reader, response_magic);
+
+        // every result takes more than one byte, so this bounds the allocation
+        const auto count = reader.get<std::uint32_t>();
+        if (count > message.size())
+            throw std::invalid_argument("truncated evaluation message");
+        evaluation_response response(count);
+        for (auto& r : response)
+        {
+            r.ok              = reader.get<std::uint8_t>() != 0;
+            r.summary.count   = static_cast<std::size_t>(reader.get<std::uint64_t>());
+            r.summary.minimum = reader.get<iou::value_type>();
+            r.summary.maximum = reader.get<iou::value_type>();
+            r.summary.average = reader.get<iou::value_type>();
+            r.error           = reader.get_string();
+        }
+        if (!reader.done())
+            throw std::invalid_argument("trailing data after evaluation response");
+        return response;
+    }
+
+    void write_message(const int socket, const std::string& message)
+    {
+        const auto send_some = [](const int s, char* data, const std::size_t size) {
+            return ::send(s, data, size, MSG_NOSIGNAL);
+        };
+
+        std::string frame;
+        frame.reserve(sizeof(std::uint32_t) + message.size());
+        put(frame, static_cast<std::uint32_t>(message.size()));
+        frame.append(message);
+        if (transfer_all(socket, &frame[0], frame.size(), send_some) != frame.size())
+            throw std::runtime_error("connection closed while writing a message");
+    }
+
+    bool read_message(const int socket, std::string& message)
+    {
+        const auto receive_some = [](const int s, char* data, const std::size_t size) {
+            return ::recv(s, data, size, 0);
+        };
+
+        std::uint32_t length = 0;
+        const auto header = transfer_all(socket, reinterpret_cast<char*>(&length), sizeof(length), receive_some);
+        if (header == 0)
+            return false;
+        if (header != sizeof(length))
+            throw std::runtime_error("connection closed while reading a message");
+        if (length > maximum_message)
+            throw std::runtime_error("message is larger than the protocol allows");
+
+        message.resize(length);
+        if (length > 0 && transfer_all(socket, &message[0], length, receive_some) != length)
+            throw std::runtime_error("connection closed while reading a message");
+        return true;
+    }
+}
@@ -0,0 +1,101 @@
+#ifndef ANALYZE_PROTOCOL_H
+#define ANALYZE_PROTOCOL_H
+
+#include "analysis.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace analyze
+{
+    /// The kinds of evaluation which the server can run; see the analyze_* functions in main.cpp.
+    enum class evaluation_metric : std::uint8_t
+    {
+        boxes,    ///< Single object boxes against the Struck ground truth.
+        mot,      ///< Multi-object coverage against the MOTChallenge ground truth.
+        vot,      ///< VOT regions against the VOT ground truth.
+        vot_masks ///< VOT segmentation masks against the VOT ground truth.
+    };
+
+    /// A request to evaluate a list of sequences.
+    struct evaluation_request final
+    {
+        evaluation_metric        metric = evaluation_metric::boxes; ///< The evaluation to run.
+        std::string              results_directory; ///< The results files' directory, under the server's root.
+        std::string              output_directory;  ///< Where to write .ious files, likewise; empty for none.
+        std::vector<std::string> sequences;         ///< The names of the sequences to evaluate.
+    };
+
+    /// The outcome of evaluating one sequence.
+    struct sequence_result final
+    {
+        bool        ok = false; ///< True if the sequence was evaluated.
+        iou_summary summary;    ///< The IoU statistics, if the sequence was evaluated.
+        std::string error;      ///< Why the sequence was not evaluated.
+    };
+
+    /// The response to an evaluation_request; one result for each requested sequence.
+    using evaluation_response = std::vector<sequence_result>;
+
+    /**
+     * \brief       Encode an evaluation request as a message.
+     * \param[in]   request The request to encode.
+     * \return      The message payload. See write_message() for framing.
+     * \throws      std::bad_alloc  This is thrown if memory for the message cannot be allocated.
+     * \details     The protocol only runs over a local socket, so numbers are in the host's byte
+     *              order. A request is a magic number and version, the metric, the two directories,
+     *              then the sequence names. Each string is a 32 bit length and the characters.
+     */
+    std::string encode_request(const evaluation_request& request);
+
+    /**
+     * \brief       Decode an evaluation request message.
+     * \param[in]   message The message payload.
+     * \return      The decoded request.
+     * \throws      std::invalid_argument   This is thrown if \a message is not a valid request.
+     * \throws      std::bad_alloc          This is thrown if memory for the request cannot be
+     *                                      allocated.
+     */
+    evaluation_request decode_request(const std::string& message);
+
+    /**
+     * \brief       Encode an evaluation response as a message.
+     * \param[in]   response    The response to encode.
+     * \return      The message payload.
+     * \throws      std::bad_alloc  This is thrown if memory for the message cannot be allocated.
+     */
+    std::string encode_response(const evaluation_response& response);
+
+    /**
+     * \brief       Decode an evaluation response message.
+     * \param[in]   message The message payload.
+     * \return      The decoded response.
+     * \throws      std::invalid_argument   This is thrown if \a message is not a valid response.
+     * \throws      std::bad_alloc          This is thrown if memory for the response cannot be
+     *                                      allocated.
+     */
+    evaluation_response decode_response(const std::string& message);
+
+    /**
+     * \brief       Write one message to a socket.
+     * \param[in]   socket  The connected socket.
+     * \param[in]   message The message payload.
+     * \throws      std::runtime_error  This is thrown if the message cannot be written.
+     * \details     The payload is preceded by its 32 bit length.
+     */
+    void write_message(const int socket, const std::string& message);
+
+    /**
+     * \brief       Read one message from a socket.
+     * \param[in]   socket  The connected socket.
+     * \param[out]  message The message payload.
+     * \retval      true    A message was read.
+     * \retval      false   The peer closed the connection before a new message started.
+     * \throws      std::runtime_error  This is thrown if the socket fails, the connection closes
+     *                                  part way through a message, or the message is larger than
+     *                                  the protocol allows.
+     */
+    bool read_message(const int socket, std::string& message);
+}
+
+#endif
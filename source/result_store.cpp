@@ -0,0 +1,533 @@
+#include "result_store.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fstream>
+#include <stdexcept>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace analyze
+{
+    namespace
+    {
+        /// The multipliers and seeds for the two hash lanes.
+        constexpr std::uint64_t prime_1 = 0x9e3779b185ebca87, prime_2 = 0xc2b2ae3d27d4eb4f;
+        constexpr std::uint64_t seed_1 = 0x243f6a8885a308d3, seed_2 = 0x13198a2e03707344;
+
+        /// Identifies an index file: "ANLZIDX1".
+        constexpr std::uint64_t index_magic = 0x315844495a4c4e41;
+
+        /// Identifies a result file: "ANRS", and its layout version.
+        constexpr std::uint32_t object_magic = 0x53524e41, object_version = 1;
+
+        /// The size of a result file before its IoUs: the magic, version, count, and summary.
+        constexpr std::uint64_t object_header_size = 2 * sizeof(std::uint32_t) + sizeof(std::uint64_t) + 3 * sizeof(float);
+
+        /// Result files younger than this, in seconds, are not treated as orphans.
+        constexpr std::uint64_t orphan_age = 3600;
+
+        /**
+         * \brief       Rotate a word left.
+         * \param[in]   x       The word to rotate.
+         * \param[in]   bits    The number of bits to rotate by, from 1 to 63.
+         * \return      The rotated word.
+         * \throws      None
+         */
+        constexpr std::uint64_t rotate(const std::uint64_t x, const int bits) noexcept
+        {
+            return (x << bits) | (x >> (64 - bits));
+        }
+
+        /**
+         * \brief       Spread every bit of a word over the whole word.
+         * \param[in]   x   The word to mix.
+         * \return      The mixed word.
+         * \throws      None
+         */
+        std::uint64_t avalanche(std::uint64_t x) noexcept
+        {
+            x ^= x >> 33;
+            x *= 0xff51afd7ed558ccd;
+            x ^= x >> 33;
+            x *= 0xc4ceb9fe1a85ec53;
+            return x ^ (x >> 33);
+        }
+
+        /**
+         * \brief       Get the current time.
+         * \return      The number of seconds since 1970.
+         * \throws      None
+         */
+        std::uint64_t now() noexcept
+        {
+            return static_cast<std::uint64_t>(std::time(nullptr));
+        }
+
+        /**
+         * \brief       Create a directory if it does not exist.
+         * \param[in]   path    The directory to create.
+         * \throws      std::runtime_error  This is thrown if the directory cannot be created.
+         */
+        void make_directory(const std::string& path)
+        {
+            if (mkdir(path.c_str(), 0755) != 0 && errno != EEXIST)
+                throw std::runtime_error("could not create " + path + ": " + std::strerror(errno));
+        }
+
+        /**
+         * \brief       Write a file so that readers see either the old or the new contents.
+         * \param[in]   file_name   The file to write.
+         * \param[in]   bytes       The new contents.
+         * \throws      std::runtime_error  This is thrown if the file cannot be written.
+         * \details     The contents are written to a temporary file, which is renamed over
+         *              \a file_name.
+         */
+        void replace_file(const std::string& file_name, const std::string& bytes)
+        {
+            const auto temporary = file_name + ".tmp." + std::to_string(getpid());
+            {
+                std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+                file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+                if (!file)
+                {
+                    std::remove(temporary.c_str());
+                    throw std::runtime_error("could not write " + file_name);
+                }
+            }
+            if (std::rename(temporary.c_str(), file_name.c_str()) != 0)
+            {
+                std::remove(temporary.c_str());
+                throw std::runtime_error("could not replace " + file_name);
+            }
+        }
+
+        /**
+         * \brief           Append a value's bytes to a buffer.
+         * \tparam          T       The type of the value.
+         * \param[in,out]   bytes   The buffer.
+         * \param[in]       value   The value to append.
+         * \throws          std::bad_alloc  This is thrown if the buffer cannot grow.
+         */
+        template <class T>
+        void put(std::string& bytes, const T& value)
+        {
+            bytes.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        /// Holds an exclusive lock on a store while it is alive.
+        class store_lock final
+        {
+        public:
+            /**
+             * \brief       Lock a store, waiting for other processes to release it.
+             * \param[in]   directory   The store directory.
+             * \throws      std::runtime_error  This is thrown if the lock cannot be taken.
+             */
+            explicit store_lock(const std::string& directory)
+                : m_descriptor(open((directory + "/lock").c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644))
+            {
+                if (m_descriptor < 0 || flock(m_descriptor, LOCK_EX) != 0)
+                {
+                    if (m_descriptor >= 0)
+                        close(m_descriptor);
+                    throw std::runtime_error("could not lock the result store " + directory);
+                }
+            }
+
+            /// A lock cannot be copied.
+            store_lock(const store_lock&) = delete;
+
+            /// A lock cannot be moved.
+            store_lock(store_lock&&) = delete;
+
+            /**
+             * \brief   Release the lock.
+             * \throws  None
+             */
+            ~store_lock() noexcept { close(m_descriptor); }
+
+            /// A lock cannot be copied.
+            store_lock& operator=(const store_lock&) = delete;
+
+            /// A lock cannot be moved.
+            store_lock& operator=(store_lock&&) = delete;
+
+        private:
+            int m_descriptor; ///< The locked file.
+        };
+    }
+
+    //-------------------------------------------------------
+    //                               store_key class methods
+    //-------------------------------------------------------
+    std::string store_key::hex() const
+    {
+        char text[33];
+        std::snprintf(text, sizeof(text), "%016llx%016llx", static_cast<unsigned long long>(high),
+                      static_cast<unsigned long long>(low));
+        return text;
+    }
+
+    //-------------------------------------------------------
+    //                            content_hash class methods
+    //-------------------------------------------------------
+    content_hash::content_hash() noexcept : m_high(seed_1), m_low(seed_2)
+    {
+    }
+
+    void content_hash::update(const void* data, std::size_t size) noexcept
+    {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        m_length += size;
+
+        // finish a word started by the last call
+        if (m_pending_size > 0)
+        {
+            const auto count = std::min(size, sizeof(m_pending) - m_pending_size);
+            std::memcpy(m_pending + m_pending_size, bytes, count);
+            m_pending_size += count;
+            bytes += count;
+            size -= count;
+            if (m_pending_size < sizeof(m_pending))
+                return;
+            std::uint64_t word;
+            std::memcpy(&word, m_pending, sizeof(word));
+            mix(word);
+            m_pending_size = 0;
+        }
+
+        for (; size >= sizeof(std::uint64_t); bytes += sizeof(std::uint64_t), size -= sizeof(std::uint64_t))
+        {
+            std::uint64_t word;
+            std::memcpy(&word, bytes, sizeof(word));
+            mix(word);
+        }
+        std::memcpy(m_pending, bytes, size);
+        m_pending_size = size;
+    }
+
+    store_key content_hash::finish() const noexcept
+    {
+        std::uint64_t tail = 0;
+        std::memcpy(&tail, m_pending, m_pending_size);
+        auto high = m_high ^ rotate(tail * prime_2, 29) ^ m_length;
+        auto low  = m_low ^ rotate(tail * prime_1, 31) ^ (m_length * prime_2);
+        high = avalanche(high + low);
+        low  = avalanche(low ^ high);
+        return store_key {high, low};
+    }
+
+    void content_hash::mix(const std::uint64_t word) noexcept
+    {
+        m_high = rotate(m_high ^ (word * prime_1), 31) * prime_2;
+        m_low  = rotate(m_low ^ (word * prime_2), 27) * prime_1;
+    }
+
+    //-------------------------------------------------------
+    //                                        key functions
+    //-------------------------------------------------------
+    store_key hash_file(const std::string& file_name)
+    {
+        std::ifstream file(file_name.c_str(), std::ios::binary);
+        if (!file)
+            throw std::runtime_error("could not open " + file_name);
+
+        content_hash hash;
+        std::vector<char> buffer(64 * 1024);
+        while (file)
+        {
+            file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            hash.update(buffer.data(), static_cast<std::size_t>(file.gcount()));
+        }
+        if (!file.eof())
+            throw std::runtime_error("could not read " + file_name);
+        return hash.finish();
+    }
+
+    store_key make_store_key(const std::string& results_file,
+                             const std::string& truth_file,
+                             const std::string& configuration)
+    {
+        return make_store_key(hash_file(results_file), hash_file(truth_file), configuration);
+    }
+
+    store_key make_store_key(const store_key& results_hash,
+                             const store_key& truth_hash,
+                             const std::string& configuration) noexcept
+    {
+        const store_key parts[] = {results_hash, truth_hash};
+        content_hash hash;
+        hash.update(parts, sizeof(parts));
+        hash.update(configuration.data(), configuration.size());
+        return hash.finish();
+    }
+
+    //-------------------------------------------------------
+    //                            result_store class methods
+    //-------------------------------------------------------
+    result_store::result_store(std::string directory) : m_directory(std::move(directory))
+    {
+        make_directory(m_directory);
+        make_directory(m_directory + "/objects");
+        m_index = read_index();
+    }
+
+    result_store::~result_store() noexcept
+    {
+        try
+        {
+            flush();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    bool result_store::contains(const store_key& key) const noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return std::binary_search(m_index.begin(), m_index.end(), index_entry {key, 0, 0}, [](const index_entry& a, const index_entry& b) {
+            return a.key < b.key;
+        });
+    }
+
+    bool result_store::find(const store_key& key, stored_result& result)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto entry = std::lower_bound(m_index.begin(), m_index.end(), key, [](const index_entry& e, const store_key& k) {
+            return e.key < k;
+        });
+        if (entry == m_index.end() || !(entry->key == key))
+            return false;
+
+        std::ifstream file(object_path(key), std::ios::binary);
+        std::uint32_t magic = 0, version = 0;
+        std::uint64_t count = 0;
+        file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+        file.read(reinterpret_cast<char*>(&version), sizeof(version));
+        file.read(reinterpret_cast<char*>(&count), sizeof(count));
+        if (!file || magic != object_magic || version != object_version || entry->bytes < object_header_size ||
+            count > (entry->bytes - object_header_size) / sizeof(iou::value_type))
+        {
+            // the result file was removed or damaged, so forget it
+            forget(entry);
+            return false;
+        }
+
+        stored_result stored;
+        file.read(reinterpret_cast<char*>(&stored.summary.minimum), sizeof(stored.summary.minimum));
+        file.read(reinterpret_cast<char*>(&stored.summary.maximum), sizeof(stored.summary.maximum));
+        file.read(reinterpret_cast<char*>(&stored.summary.average), sizeof(stored.summary.average));
+        std::vector<iou::value_type> values(static_cast<std::size_t>(count));
+        file.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(iou::value_type)));
+        if (!file)
+        {
+            forget(entry);
+            return false;
+        }
+
+        stored.summary.count = values.size();
+        stored.ious.assign(values.begin(), values.end());
+        result = std::move(stored);
+        entry->last_used = now();
+        m_used[key] = entry->last_used;
+        return true;
+    }
+
+    void result_store::insert(const store_key& key, const stored_result& result)
+    {
+        std::string bytes;
+        put(bytes, object_magic);
+        put(bytes, object_version);
+        put(bytes, static_cast<std::uint64_t>(result.ious.size()));
+        put(bytes, result.summary.minimum);
+        put(bytes, result.summary.maximum);
+        put(bytes, result.summary.average);
+        for (const auto i : result.ious)
+            put(bytes, i.value());
+        replace_file(object_path(key), bytes);
+
+        const index_entry added {key, now(), bytes.size()};
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto entry = std::lower_bound(m_index.begin(), m_index.end(), key, [](const index_entry& e, const store_key& k) {
+            return e.key < k;
+        });
+        if (entry != m_index.end() && entry->key == key)
+            *entry = added;
+        else
+            m_index.insert(entry, added);
+        m_added[key] = added;
+        m_removed.erase(key);
+    }
+
+    void result_store::flush()
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        if (m_added.empty() && m_used.empty() && m_removed.empty())
+            return;
+        store_lock lock(m_directory);
+        merge_index();
+        write_index();
+        m_added.clear();
+        m_used.clear();
+        m_removed.clear();
+    }
+
+    garbage_report result_store::collect_garbage(const std::uint64_t maximum_age, const std::uint64_t maximum_bytes)
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        store_lock lock(m_directory);
+        merge_index();
+
+        // choose the victims: too old first, then least recently used until the store fits
+        const auto time = now();
+        std::vector<index_entry> by_use(m_index);
+        std::sort(by_use.begin(), by_use.end(), [](const index_entry& a, const index_entry& b) {
+            return a.last_used < b.last_used;
+        });
+        std::uint64_t total = 0;
+        for (const auto& e : by_use)
+            total += e.bytes;
+
+        garbage_report report;
+        std::vector<store_key> removed;
+        for (const auto& e : by_use)
+        {
+            const bool too_old = maximum_age > 0 && time > e.last_used && time - e.last_used > maximum_age;
+            const bool too_big = maximum_bytes > 0 && total > maximum_bytes;
+            if (!too_old && !too_big)
+                break;
+            std::remove(object_path(e.key).c_str());
+            removed.push_back(e.key);
+            total -= e.bytes;
+            ++report.removed_entries;
+            report.removed_bytes += e.bytes;
+        }
+        std::sort(removed.begin(), removed.end());
+        m_index.erase(std::remove_if(m_index.begin(), m_index.end(), [&removed](const index_entry& e) {
+                          return std::binary_search(removed.begin(), removed.end(), e.key);
+                      }),
+                      m_index.end());
+
+        // remove result files which no index entry refers to
+        const auto objects = m_directory + "/objects";
+        if (DIR* listing = opendir(objects.c_str()))
+        {
+            std::vector<std::string> names;
+            while (const dirent* d = readdir(listing))
+                names.push_back(d->d_name);
+            closedir(listing);
+
+            std::vector<std::string> indexed;
+            for (const auto& e : m_index)
+                indexed.push_back(e.key.hex());
+            for (const auto& name : names)
+            {
+                struct stat status;
+                const auto path = objects + "/" + name;
+                if (name[0] == '.' || std::binary_search(indexed.begin(), indexed.end(), name) ||
+                    stat(path.c_str(), &status) != 0 || static_cast<std::uint64_t>(status.st_mtime) > time ||
+                    time - static_cast<std::uint64_t>(status.st_mtime) < orphan_age)
+                {
+                    continue;
+                }
+                std::remove(path.c_str());
+                ++report.removed_entries;
+                report.removed_bytes += static_cast<std::uint64_t>(status.st_size);
+            }
+        }
+
+        write_index();
+        m_added.clear();
+        m_used.clear();
+        m_removed.clear();
+        report.kept_entries = m_index.size();
+        report.kept_bytes   = total;
+        return report;
+    }
+
+    std::vector<result_store::index_entry> result_store::read_index() const
+    {
+        std::vector<index_entry> index;
+        std::ifstream file(m_directory + "/index", std::ios::binary);
+        if (!file)
+            return index;
+
+        std::uint64_t magic = 0, count = 0;
+        file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+        file.read(reinterpret_cast<char*>(&count), sizeof(count));
+        if (!file || magic != index_magic || count > (1ull << 32))
+            throw std::runtime_error("the result store index in " + m_directory + " is damaged");
+        index.resize(static_cast<std::size_t>(count));
+        file.read(reinterpret_cast<char*>(index.data()), static_cast<std::streamsize>(index.size() * sizeof(index_entry)));
+        if (!file)
+            throw std::runtime_error("the result store index in " + m_directory + " is damaged");
+        return index;
+    }
+
+    void result_store::merge_index()
+    {
+        // only this process's own changes are applied, so entries which another process added or
+        // removed since this one read the index are left as that process left them
+        const auto stored = read_index();
+        std::vector<index_entry> merged;
+        merged.reserve(stored.size() + m_added.size());
+        auto a = stored.cbegin();
+        auto b = m_added.cbegin();
+        while (a != stored.cend() || b != m_added.cend())
+        {
+            if (b == m_added.cend() || (a != stored.cend() && a->key < b->first))
+            {
+                if (m_removed.count(a->key) == 0)
+                    merged.push_back(*a);
+                ++a;
+            }
+            else if (a == stored.cend() || b->first < a->key)
+                merged.push_back((b++)->second);
+            else
+            {
+                merged.push_back(b->second);
+                merged.back().last_used = std::max(a->last_used, b->second.last_used);
+                ++a;
+                ++b;
+            }
+        }
+
+        // a result this process used is only marked as used if it is still listed
+        for (auto& e : merged)
+        {
+            const auto used = m_used.find(e.key);
+            if (used != m_used.end())
+                e.last_used = std::max(e.last_used, used->second);
+        }
+        m_index = std::move(merged);
+    }
+
+    void result_store::forget(const std::vector<index_entry>::iterator entry)
+    {
+        m_added.erase(entry->key);
+        m_used.erase(entry->key);
+        m_removed.insert(entry->key);
+        m_index.erase(entry);
+    }
+
+    void result_store::write_index() const
+    {
+        std::string bytes;
+        put(bytes, index_magic);
+        put(bytes, static_cast<std::uint64_t>(m_index.size()));
+        bytes.append(reinterpret_cast<const char*>(m_index.data()), m_index.size() * sizeof(index_entry));
+        replace_file(m_directory + "/index", bytes);
+    }
+
+    std::string result_store::object_path(const store_key& key) const
+    {
+        return m_directory + "/objects/" + key.hex();
+    }
+}
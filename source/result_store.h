@@ -0,0 +1,309 @@
+#ifndef ANALYZE_RESULT_STORE_H
+#define ANALYZE_RESULT_STORE_H
+
+#include "analysis.h"
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace analyze
+{
+    /// A 128 bit content hash, used to identify stored results.
+    struct store_key final
+    {
+        std::uint64_t high = 0; ///< The high 64 bits of the hash.
+        std::uint64_t low  = 0; ///< The low 64 bits of the hash.
+
+        /**
+         * \brief   Format the key as text.
+         * \return  The key as 32 hexadecimal digits.
+         * \throws  std::bad_alloc  This is thrown if memory for the text cannot be allocated.
+         */
+        std::string hex() const;
+    };
+
+    /**
+     * \brief       Compare two keys for equality.
+     * \param[in]   a,b     The keys to compare.
+     * \retval      true    The keys are the same.
+     * \retval      false   The keys differ.
+     * \throws      None
+     */
+    inline bool operator==(const store_key& a, const store_key& b) noexcept
+    {
+        return a.high == b.high && a.low == b.low;
+    }
+
+    /**
+     * \brief       Order two keys.
+     * \param[in]   a,b     The keys to compare.
+     * \retval      true    \a a sorts before \a b.
+     * \retval      false   \a a does not sort before \a b.
+     * \throws      None
+     */
+    inline bool operator<(const store_key& a, const store_key& b) noexcept
+    {
+        return a.high < b.high || (a.high == b.high && a.low < b.low);
+    }
+
+    /**
+     * \brief       Calculates a 128 bit hash of a stream of bytes.
+     * \details     Bytes are consumed eight at a time in two independently seeded lanes, so the
+     *              hash runs at memory speed. It is not a cryptographic hash; it only needs to
+     *              make accidental collisions between result files vanishingly unlikely.
+     */
+    class content_hash final
+    {
+    public:
+        /**
+         * \brief   Start a new hash.
+         * \throws  None
+         */
+        content_hash() noexcept;
+
+        /**
+         * \brief       Add bytes to the hash.
+         * \param[in]   data    The bytes to add.
+         * \param[in]   size    The number of bytes to add.
+         * \throws      None
+         * \details     The hash depends only on the concatenation of the bytes, not on how they are
+         *              split between calls.
+         */
+        void update(const void* data, std::size_t size) noexcept;
+
+        /**
+         * \brief   Finish the hash.
+         * \return  The hash of every byte added so far.
+         * \throws  None
+         */
+        store_key finish() const noexcept;
+
+    private:
+        /**
+         * \brief       Mix one word into both lanes.
+         * \param[in]   word    The next eight bytes.
+         * \throws      None
+         */
+        void mix(const std::uint64_t word) noexcept;
+
+        std::uint64_t m_high;          ///< The first lane.
+        std::uint64_t m_low;           ///< The second lane.
+        std::uint64_t m_length = 0;    ///< The number of bytes added.
+        unsigned char m_pending[8];    ///< Bytes waiting to fill a word.
+        std::size_t   m_pending_size = 0; ///< The number of pending bytes.
+    };
+
+    /**
+     * \brief       Hash the contents of a file.
+     * \param[in]   file_name   The file to hash.
+     * \return      The hash of the file's bytes.
+     * \throws      std::runtime_error  This is thrown if the file cannot be read.
+     */
+    store_key hash_file(const std::string& file_name);
+
+    /**
+     * \brief       Make the key for one evaluation.
+     * \param[in]   results_file    The tracker results file.
+     * \param[in]   truth_file      The ground truth file.
+     * \param[in]   configuration   A description of every setting which affects the result, such
+     *                              as the metric and frame stride.
+     * \return      A key which changes if either file's contents or the configuration changes.
+     * \throws      std::runtime_error  This is thrown if either file cannot be read.
+     */
+    store_key make_store_key(const std::string& results_file,
+                             const std::string& truth_file,
+                             const std::string& configuration);
+
+    /**
+     * \brief       Make the key for one evaluation from the hashes of its files.
+     * \param[in]   results_hash    The hash of the tracker results file, from hash_file() or a
+     *                              content_hash of its bytes.
+     * \param[in]   truth_hash      The hash of the ground truth file.
+     * \param[in]   configuration   A description of every setting which affects the result.
+     * \return      The same key as make_store_key() of the files.
+     * \throws      None
+     * \details     This is for callers which already hold the files' bytes, so the files are not
+     *              read again.
+     */
+    store_key make_store_key(const store_key& results_hash,
+                             const store_key& truth_hash,
+                             const std::string& configuration) noexcept;
+
+    /// An evaluation result kept in a result_store.
+    struct stored_result final
+    {
+        iou_list    ious;    ///< The IoU series.
+        iou_summary summary; ///< The statistics of the series.
+    };
+
+    /// What result_store::collect_garbage() removed.
+    struct garbage_report final
+    {
+        std::size_t   removed_entries = 0; ///< The number of results removed.
+        std::uint64_t removed_bytes   = 0; ///< The space freed, in bytes.
+        std::size_t   kept_entries    = 0; ///< The number of results left.
+        std::uint64_t kept_bytes      = 0; ///< The space still used, in bytes.
+    };
+
+    /**
+     * \brief       A persistent store of evaluation results, keyed by content hash.
+     * \details     Each result is a file in <em>directory</em>/objects, named by its key. The
+     *              <em>directory</em>/index file lists every key, sorted, with its size and when it
+     *              was last used, so a lookup is a binary search over an array loaded with one
+     *              read. Changes to the index are kept in memory and merged into the file by
+     *              flush(), under a lock, so several processes can share a store. Within a
+     *              process, the store may be used from several threads at once.
+     */
+    class result_store final
+    {
+    public:
+        /**
+         * \brief       Open a store, creating it if needed.
+         * \param[in]   directory   The store directory.
+         * \throws      std::runtime_error  This is thrown if the directory cannot be created, or
+         *                                  the index is damaged.
+         */
+        explicit result_store(std::string directory);
+
+        /// A store has pending index changes, so it cannot be copied.
+        result_store(const result_store&) = delete;
+
+        /// A store has pending index changes, so it cannot be moved.
+        result_store(result_store&&) = delete;
+
+        /**
+         * \brief   Flush the index and close the store.
+         * \throws  None
+         * \details A failure to flush is ignored; the next process to use the store rebuilds the
+         *          lost index entries as it recalculates their results.
+         */
+        ~result_store() noexcept;
+
+        /// A store has pending index changes, so it cannot be copied.
+        result_store& operator=(const result_store&) = delete;
+
+        /// A store has pending index changes, so it cannot be moved.
+        result_store& operator=(result_store&&) = delete;
+
+        /**
+         * \brief       Look up a result.
+         * \param[in]   key     The key of the result.
+         * \param[out]  result  The stored result, if it was found.
+         * \retval      true    The result was found.
+         * \retval      false   The store does not hold the result.
+         * \throws      std::bad_alloc  This is thrown if memory for the result cannot be allocated.
+         * \details     A hit marks the result as used now, for collect_garbage().
+         */
+        bool find(const store_key& key, stored_result& result);
+
+        /**
+         * \brief       Check whether the index lists a result, without reading it.
+         * \param[in]   key     The key of the result.
+         * \retval      true    The index lists the result. find() may still miss, if the result
+         *                      file has been removed since.
+         * \retval      false   The store does not hold the result.
+         * \throws      None
+         */
+        bool contains(const store_key& key) const noexcept;
+
+        /**
+         * \brief       Add a result to the store.
+         * \param[in]   key     The key of the result.
+         * \param[in]   result  The result to store.
+         * \throws      std::runtime_error  This is thrown if the result cannot be written.
+         */
+        void insert(const store_key& key, const stored_result& result);
+
+        /**
+         * \brief   Merge this process's index changes into the index file.
+         * \throws  std::runtime_error  This is thrown if the index cannot be written.
+         */
+        void flush();
+
+        /**
+         * \brief       Remove old results until the store fits a budget.
+         * \param[in]   maximum_age     Results not used for this many seconds are removed. Use 0
+         *                              to keep results regardless of age.
+         * \param[in]   maximum_bytes   After that, the least recently used results are removed
+         *                              until the store is no larger than this. Use 0 for no limit.
+         * \return      What was removed and what is left.
+         * \throws      std::runtime_error  This is thrown if the index cannot be written.
+         * \details     Result files which are not in the index, and are more than an hour old, are
+         *              removed too. The hour protects results which another process has written
+         *              but not yet added to the index.
+         */
+        garbage_report collect_garbage(const std::uint64_t maximum_age, const std::uint64_t maximum_bytes);
+
+        /**
+         * \brief   Query the number of results in the index.
+         * \return  The number of indexed results, including this process's additions.
+         * \throws  None
+         */
+        std::size_t size() const noexcept
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_index.size();
+        }
+
+    private:
+        /// One index record, as stored in the index file.
+        struct index_entry final
+        {
+            store_key     key;           ///< The result's key.
+            std::uint64_t last_used = 0; ///< When the result was last used, in seconds since 1970.
+            std::uint64_t bytes     = 0; ///< The size of the result file.
+        };
+
+        /**
+         * \brief   Read the index file.
+         * \return  The index entries, sorted by key.
+         * \throws  std::runtime_error  This is thrown if the index is damaged.
+         */
+        std::vector<index_entry> read_index() const;
+
+        /**
+         * \brief       Apply this process's index changes to the index file's entries, and make the
+         *              result the in memory index.
+         * \throws      std::runtime_error  This is thrown if the index is damaged.
+         * \details     The store must be locked. Only entries this process added, used, or removed
+         *              are merged, so the snapshot read when the store was opened does not bring
+         *              back results another process has since removed.
+         */
+        void merge_index();
+
+        /**
+         * \brief       Remove an entry whose result file is missing or damaged.
+         * \param[in]   entry   The entry, in the in memory index.
+         * \throws      std::bad_alloc  This is thrown if memory for the removal cannot be allocated.
+         * \details     The store must be locked.
+         */
+        void forget(std::vector<index_entry>::iterator entry);
+
+        /**
+         * \brief   Write the in memory index to the index file.
+         * \throws  std::runtime_error  This is thrown if the index cannot be written.
+         * \details The store must be locked.
+         */
+        void write_index() const;
+
+        /**
+         * \brief       Get the path of a result file.
+         * \param[in]   key The key of the result.
+         * \return      The path of the result's file.
+         * \throws      std::bad_alloc  This is thrown if memory for the path cannot be allocated.
+         */
+        std::string object_path(const store_key& key) const;
+
+        std::string                        m_directory; ///< The store directory.
+        std::vector<index_entry>           m_index;     ///< The index, sorted by key.
+        std::map<store_key, index_entry>   m_added;     ///< Unflushed entries this process added.
+        std::map<store_key, std::uint64_t> m_used;      ///< Unflushed last use times, by key.
+        std::set<store_key>                m_removed;   ///< Unflushed keys this process removed.
+        mutable std::mutex                 m_mutex;     ///< Guards the in memory index and changes.
+    };
+}
+
+#endif
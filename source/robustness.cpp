@@ -0,0 +1,131 @@
+#include "robustness.h"
+#include <algorithm>
+#include <cmath>
+
+namespace analyze
+{
+    namespace
+    {
+        /**
+         * \brief       Get an IoU as an overlap, with NaN as no overlap.
+         * \param[in]   value   The IoU.
+         * \return      The overlap.
+         * \throws      None
+         */
+        double overlap(const iou& value) noexcept
+        {
+            const auto v = value.value();
+            return std::isnan(v) ? 0.0 : static_cast<double>(v);
+        }
+    }
+
+    robustness_summary evaluate_robustness(const span<const iou> ious, const vot_options& options)
+    {
+        // prefix sums of the defined IoUs and their count, so each segment's accuracy is a difference
+        std::vector<double>      totals(ious.size() + 1, 0.0);
+        std::vector<std::size_t> defined(ious.size() + 1, 0);
+        for (std::size_t f = 0; f < ious.size(); ++f)
+        {
+            const auto v  = ious[f].value();
+            totals[f + 1]  = totals[f] + overlap(ious[f]);
+            defined[f + 1] = defined[f] + (std::isnan(v) ? 0 : 1);
+        }
+
+        robustness_summary summary;
+        double accuracy_total = 0.0;
+        std::size_t begin = 0;
+        while (begin < ious.size())
+        {
+            vot_segment segment;
+            segment.begin = begin;
+            auto end = begin;
+            while (end < ious.size() && !(ious[end].value() <= options.failure_threshold))
+                ++end;
+            segment.failed = end < ious.size();
+            segment.length = end - begin + (segment.failed ? 1 : 0);
+            summary.segments.push_back(segment);
+
+            // the failure frame itself is left out of the accuracy
+            const auto first = std::min(begin + options.burn_in, end);
+            accuracy_total += totals[end] - totals[first];
+            summary.accuracy_frames += defined[end] - defined[first];
+
+            if (!segment.failed)
+                break;
+            ++summary.failures;
+            begin = end + 1 + options.reinit_gap;
+        }
+        if (summary.accuracy_frames > 0)
+            summary.accuracy = accuracy_total / static_cast<double>(summary.accuracy_frames);
+        return summary;
+    }
+
+    //-------------------------------------------------------
+    //                         eao_accumulator class methods
+    //-------------------------------------------------------
+    void eao_accumulator::add(const span<const iou> ious, const std::vector<vot_segment>& segments)
+    {
+        for (const auto& segment : segments)
+        {
+            const auto length = std::min(segment.length, ious.size() - std::min(segment.begin, ious.size()));
+            if (length == 0)
+                continue;
+            if (m_overlaps.size() < length)
+            {
+                m_overlaps.resize(length, 0.0);
+                m_finished.resize(length, 0.0);
+                m_ended.resize(length, 0);
+            }
+
+            double total = 0.0;
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                const auto v = overlap(ious[segment.begin + i]);
+                m_overlaps[i] += v;
+                total += v;
+            }
+            if (segment.failed)
+            {
+                ++m_failed;
+                continue;
+            }
+            ++m_unfailed;
+            m_finished[length - 1] += total;
+            ++m_ended[length - 1];
+        }
+    }
+
+    std::vector<double> eao_accumulator::curve() const
+    {
+        std::vector<double> expected(m_overlaps.size(), 0.0);
+
+        // every segment's total over its first n frames, less those of unfailed segments too short for n
+        double all = 0.0, too_short = 0.0;
+        std::size_t ended = 0;
+        for (std::size_t n = 1; n <= expected.size(); ++n)
+        {
+            all += m_overlaps[n - 1];
+            const auto segments = m_failed + m_unfailed - ended;
+            if (segments > 0)
+                expected[n - 1] = (all - too_short) / static_cast<double>(n) / static_cast<double>(segments);
+            too_short += m_finished[n - 1];
+            ended     += m_ended[n - 1];
+        }
+        return expected;
+    }
+
+    double eao_accumulator::average(std::size_t low, std::size_t high) const
+    {
+        const auto expected = curve();
+        low = std::max(low, std::size_t(1));
+        if (high == 0 || high > expected.size())
+            high = expected.size();
+        if (low > high)
+            return 0.0;
+
+        double total = 0.0;
+        for (auto n = low; n <= high; ++n)
+            total += expected[n - 1];
+        return total / static_cast<double>(high - low + 1);
+    }
+}
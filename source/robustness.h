@@ -0,0 +1,105 @@
+#ifndef ANALYZE_ROBUSTNESS_H
+#define ANALYZE_ROBUSTNESS_H
+
+#include "iou.h"
+#include "span.h"
+#include <vector>
+
+namespace analyze
+{
+    /// The settings of the VOT failure and re-initialization protocol.
+    struct vot_options final
+    {
+        iou::value_type failure_threshold = 0.0f; ///< A frame whose IoU is at most this is a failure.
+        std::size_t     reinit_gap        = 5;    ///< The frames skipped after a failure before the
+                                                  ///< tracker is initialized again.
+        std::size_t     burn_in           = 10;   ///< The frames after each initialization left out
+                                                  ///< of the accuracy.
+    };
+
+    /// The frames tracked from one initialization.
+    struct vot_segment final
+    {
+        std::size_t begin  = 0;     ///< The frame the tracker was initialized on.
+        std::size_t length = 0;     ///< The frames tracked, including a failure frame.
+        bool        failed = false; ///< True if the segment ends with a failure, false if it ends
+                                    ///< with the sequence.
+    };
+
+    /// The VOT accuracy and robustness of one sequence.
+    struct robustness_summary final
+    {
+        std::vector<vot_segment> segments;            ///< The segments, in frame order.
+        std::size_t              failures        = 0; ///< The number of failures.
+        std::size_t              accuracy_frames = 0; ///< The frames the accuracy averages.
+        double                   accuracy        = 0; ///< The mean IoU of the frames which are
+                                                      ///< not failures, burn in, or NaN.
+    };
+
+    /**
+     * \brief       Find the failures and accuracy of a sequence.
+     * \param[in]   ious        One IoU for each frame, such as the region calculate_ious() gives.
+     * \param[in]   options     The protocol settings.
+     * \return      The segments, failures, and accuracy.
+     * \throws      std::bad_alloc  This is thrown if memory for the segments cannot be allocated.
+     * \details     The tracker is initialized on the first frame. Each frame whose IoU is at most
+     *              the failure threshold ends a segment, and the next segment starts
+     *              \a reinit_gap frames after it. NaN frames are never failures. The accuracy is
+     *              read from a prefix sum of the IoUs, so the whole sequence is scanned once.
+     */
+    robustness_summary evaluate_robustness(span<const iou> ious, const vot_options& options);
+
+    /**
+     * \brief       Finds the expected average overlap of the segments of several sequences.
+     * \details     The expected overlap for a length \f$ N \f$ is the mean, over the segments, of
+     *              the average IoU of the segment's first \f$ N \f$ frames. A failed segment counts
+     *              0 for every frame after its failure, and a segment which reaches the end of its
+     *              sequence before \f$ N \f$ frames is left out. NaN frames count 0.
+     *
+     *              Done directly, every length needs a pass over every segment. Instead, the IoUs
+     *              of frame \a i of every segment are added into one total for \a i, and each
+     *              segment which ends without failing records its total at its length, so one
+     *              prefix sum over lengths gives every expected overlap. Adding a sequence costs
+     *              time linear in its length, and curve() is linear in the longest segment.
+     */
+    class eao_accumulator final
+    {
+    public:
+        /**
+         * \brief       Add the segments of a sequence.
+         * \param[in]   ious        The sequence's IoU series.
+         * \param[in]   segments    The sequence's segments, from evaluate_robustness().
+         * \throws      std::bad_alloc  This is thrown if memory for the totals cannot be allocated.
+         */
+        void add(span<const iou> ious, const std::vector<vot_segment>& segments);
+
+        /**
+         * \brief   Find the expected overlap for every length.
+         * \return  Element \a n - 1 is the expected overlap for length \a n, for every length up to
+         *          the longest segment. A length with no segments has an expected overlap of 0.
+         * \throws  std::bad_alloc  This is thrown if memory for the curve cannot be allocated.
+         */
+        std::vector<double> curve() const;
+
+        /**
+         * \brief       Find the expected average overlap.
+         * \param[in]   low     The shortest length averaged. 0 is treated as 1.
+         * \param[in]   high    The longest length averaged. 0, or a length past the longest
+         *                      segment, is treated as the longest segment.
+         * \return      The mean of the expected overlaps of the lengths from \a low to \a high. If
+         *              there are no lengths, this is 0.
+         * \throws      std::bad_alloc  This is thrown if memory for the curve cannot be allocated.
+         */
+        double average(std::size_t low = 0, std::size_t high = 0) const;
+
+    private:
+        std::vector<double>      m_overlaps;     ///< The total IoU of frame i of every segment.
+        std::vector<double>      m_finished;     ///< The total IoU of the segments which end
+                                                 ///< unfailed after i + 1 frames.
+        std::vector<std::size_t> m_ended;        ///< The number of those segments.
+        std::size_t              m_failed = 0;   ///< The number of failed segments.
+        std::size_t              m_unfailed = 0; ///< The number of segments which did not fail.
+    };
+}
+
+#endif
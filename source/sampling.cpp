@@ -0,0 +1,200 @@
+#include "sampling.h"
+#include "splitmix.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace analyze
+{
+    namespace
+    {
+        /// The number of frames compared between checks of the intervals.
+        constexpr std::size_t batch_size = 32;
+
+        /**
+         * \brief       Visits every frame of a sequence once, in a sampling order, without storing
+         *              the order.
+         * \details     Both orders are bijections of the smallest power of two range holding every
+         *              frame. Positions which map past the last frame are skipped, which at worst
+         *              doubles the positions tried.
+         */
+        class frame_order final
+        {
+        public:
+            /**
+             * \brief       Set up an order.
+             * \param[in]   count   The number of frames.
+             * \param[in]   order   The kind of order.
+             * \param[in]   seed    Chooses the order.
+             * \throws      None
+             */
+            frame_order(const std::size_t count, const sampling_order order, const std::uint64_t seed) noexcept
+                : m_count(count), m_order(order)
+            {
+                while (m_bits < 64 && (std::uint64_t(1) << m_bits) < count)
+                    ++m_bits;
+                m_mask = m_bits == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << m_bits) - 1;
+                // each key is one SplitMix64 step from the seed
+                for (std::size_t k = 0; k < 3; ++k)
+                {
+                    m_multipliers[k] = splitmix_finalize(seed + 2 * k + golden_gamma) | 1;
+                    m_keys[k]        = splitmix_finalize(seed + 2 * k + 1 + golden_gamma);
+                }
+            }
+
+            /**
+             * \brief   Get the next frame. This must not be called more than count times.
+             * \return  The index of the frame.
+             * \throws  None
+             */
+            std::size_t next() noexcept
+            {
+                while (true)
+                {
+                    const auto frame = permute(m_position++);
+                    if (frame < m_count)
+                        return static_cast<std::size_t>(frame);
+                }
+            }
+
+        private:
+            /**
+             * \brief       Map a position to a frame.
+             * \param[in]   position    The position, within the power of two range.
+             * \return      The frame, which may be past the last frame.
+             * \throws      None
+             */
+            std::uint64_t permute(std::uint64_t position) const noexcept
+            {
+                if (m_order == sampling_order::stratified)
+                {
+                    // reversing the bits halves the gaps between samples with each power of two
+                    std::uint64_t reversed = 0;
+                    for (unsigned b = 0; b < m_bits; ++b, position >>= 1)
+                        reversed = (reversed << 1) | (position & 1);
+                    return (reversed + m_keys[0]) & m_mask;
+                }
+
+                // odd multiplication, xorshift, and addition are each invertible modulo 2^bits
+                for (std::size_t k = 0; k < 3; ++k)
+                {
+                    position = (position * m_multipliers[k]) & m_mask;
+                    position ^= position >> (m_bits / 2 + 1);
+                    position = (position + m_keys[k]) & m_mask;
+                }
+                return position;
+            }
+
+            std::size_t    m_count;            ///< The number of frames.
+            sampling_order m_order;            ///< The kind of order.
+            unsigned       m_bits = 0;         ///< The log of the power of two range.
+            std::uint64_t  m_mask = 0;         ///< The power of two range, less one.
+            std::uint64_t  m_multipliers[3];   ///< The odd multiplier of each random round.
+            std::uint64_t  m_keys[3];          ///< The offset of each round.
+            std::uint64_t  m_position = 0;     ///< The next position to map.
+        };
+    }
+
+    sampling_order parse_sampling_order(const std::string& name)
+    {
+        if (name == "stratified")
+            return sampling_order::stratified;
+        if (name == "random")
+            return sampling_order::random;
+        throw std::invalid_argument("unknown sampling order " + name);
+    }
+
+    double normal_critical_value(const double confidence)
+    {
+        if (!(confidence > 0.0 && confidence < 1.0))
+            throw std::invalid_argument("the confidence level must be between 0 and 1");
+
+        // P(|Z| <= z) = erf(z / sqrt 2) rises with z, so bisect
+        double low = 0.0, high = 40.0;
+        for (int i = 0; i < 200 && low < high; ++i)
+        {
+            const auto middle = (low + high) / 2.0;
+            if (middle == low || middle == high)
+                break;
+            if (std::erf(middle / std::sqrt(2.0)) < confidence)
+                low = middle;
+            else
+                high = middle;
+        }
+        return (low + high) / 2.0;
+    }
+
+    sampled_estimate estimate_ious(const box_span results, const box_span ground_truth, const sampling_options& options)
+    {
+        if (!(options.tolerance > 0.0))
+            throw std::invalid_argument("the sampling tolerance must be positive");
+        const auto z = normal_critical_value(options.confidence);
+
+        sampled_estimate estimate;
+        estimate.frames_total = std::min(results.size(), ground_truth.size());
+        frame_order order(estimate.frames_total, options.order, options.seed);
+
+        // Welford's running mean and sum of squared deviations
+        const auto limit = options.maximum_frames == 0 ? estimate.frames_total
+                                                        : std::min(options.maximum_frames, estimate.frames_total);
+        std::size_t n = 0, successes = 0;
+        double mean = 0.0, squares = 0.0;
+        while (estimate.frames_evaluated < limit)
+        {
+            const auto batch = std::min(batch_size, limit - estimate.frames_evaluated);
+            for (std::size_t b = 0; b < batch; ++b)
+            {
+                const auto frame = order.next();
+                const auto v = make_iou(results[frame], ground_truth[frame]).value();
+                if (std::isnan(v))
+                {
+                    ++estimate.frames_undefined;
+                    continue;
+                }
+                ++n;
+                const auto delta = v - mean;
+                mean += delta / static_cast<double>(n);
+                squares += delta * (v - mean);
+                if (v > options.success_threshold)
+                    ++successes;
+            }
+            estimate.frames_evaluated += batch;
+            if (n < 2 || estimate.frames_evaluated == estimate.frames_total)
+                continue;
+
+            // sampling without replacement: the intervals shrink to nothing as the sample nears
+            // the whole sequence
+            const auto population = static_cast<double>(estimate.frames_total);
+            const auto sampled    = static_cast<double>(estimate.frames_evaluated);
+            const auto correction = std::sqrt((population - sampled) / (population - 1.0));
+
+            const auto count    = static_cast<double>(n);
+            const auto variance = squares / (count - 1.0);
+            estimate.mean_margin = z * std::sqrt(variance / count) * correction;
+
+            const auto p      = static_cast<double>(successes) / count;
+            const auto z2     = z * z;
+            const auto scale  = 1.0 + z2 / count;
+            const auto centre = (p + z2 / (2.0 * count)) / scale;
+            const auto half   = z * std::sqrt(p * (1.0 - p) / count + z2 / (4.0 * count * count)) / scale;
+            estimate.success_margin = (std::fabs(centre - p) + half) * correction;
+
+            if (n >= options.minimum_frames && estimate.mean_margin <= options.tolerance &&
+                estimate.success_margin <= options.tolerance)
+            {
+                estimate.converged = true;
+                break;
+            }
+        }
+
+        if (estimate.frames_evaluated == estimate.frames_total)
+        {
+            // every frame was compared, so the statistics are exact
+            estimate.mean_margin = estimate.success_margin = 0.0;
+            estimate.converged = true;
+        }
+        estimate.mean         = mean;
+        estimate.success_rate = n == 0 ? 0.0 : static_cast<double>(successes) / static_cast<double>(n);
+        return estimate;
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef ANALYZE_SAMPLING_H
+#define ANALYZE_SAMPLING_H
+
+#include "analysis.h"
+#include <cstdint>
+#include <string>
+
+namespace analyze
+{
+    /// The orders in which estimate_ious() samples frames.
+    enum class sampling_order
+    {
+        stratified, ///< Every prefix of the sample covers the sequence evenly.
+        random      ///< A uniformly random order, without replacement.
+    };
+
+    /// The settings for estimate_ious().
+    struct sampling_options final
+    {
+        sampling_order  order             = sampling_order::stratified; ///< The order frames are sampled in.
+        double          tolerance         = 0.01;  ///< Sampling stops when both confidence intervals
+                                                   ///< are within this of their estimates.
+        double          confidence        = 0.95;  ///< The confidence level of the intervals.
+        iou::value_type success_threshold = 0.5f;  ///< A frame succeeds if its IoU is above this.
+        std::size_t     minimum_frames    = 30;    ///< The fewest frames to sample before stopping.
+        std::size_t     maximum_frames    = 0;     ///< The most frames to sample; 0 is no limit.
+        std::uint64_t   seed              = 0;     ///< Chooses the sampling order.
+    };
+
+    /// An estimate of a sequence's IoU statistics from a sample of its frames.
+    struct sampled_estimate final
+    {
+        double      mean               = 0.0;   ///< The estimated mean IoU.
+        double      mean_margin        = 0.0;   ///< The half width of the mean's confidence interval.
+        double      success_rate       = 0.0;   ///< The estimated fraction of successful frames.
+        double      success_margin     = 0.0;   ///< The half width of the success rate's interval.
+        std::size_t frames_evaluated   = 0;     ///< The number of frames compared.
+        std::size_t frames_undefined   = 0;     ///< Compared frames whose IoU is NaN; they are
+                                                ///< left out of the estimates.
+        std::size_t frames_total       = 0;     ///< The number of frames in the sequence.
+        bool        converged          = false; ///< True if both intervals reached the tolerance,
+                                                ///< false if the frame limit was reached first.
+    };
+
+    /**
+     * \brief       Parse the name of a sampling order.
+     * \param[in]   name    Either stratified or random.
+     * \return      The order.
+     * \throws      std::invalid_argument   This is thrown if \a name is not an order.
+     */
+    sampling_order parse_sampling_order(const std::string& name);
+
+    /**
+     * \brief       Find the two sided critical value of the standard normal distribution.
+     * \param[in]   confidence  The confidence level, between 0 and 1 exclusive.
+     * \return      The \f$ z \f$ for which \f$ P(|Z| \le z) \f$ is \a confidence.
+     * \throws      std::invalid_argument   This is thrown if \a confidence is not between 0 and 1.
+     */
+    double normal_critical_value(const double confidence);
+
+    /**
+     * \brief       Estimate the mean IoU and success rate of a sequence from a sample of frames.
+     * \param[in]   results         The tracker results.
+     * \param[in]   ground_truth    The ground truth.
+     * \param[in]   options         The sampling settings.
+     * \return      The estimates, their confidence intervals, and how many frames were compared.
+     * \throws      std::invalid_argument   This is thrown if the confidence or tolerance is not
+     *                                      valid.
+     * \details     Every frame both lists have is in the population; there is no stride. Frames
+     *              are compared in the sampling order, in batches, and after each batch the
+     *              normal interval of the mean and the Wilson interval of the success rate are
+     *              found, both with the finite population correction. Sampling stops once both
+     *              half widths are within the tolerance, once the frame limit is reached, or once
+     *              every frame has been compared, in which case the intervals have no width.
+     *              Nothing is allocated, so the sample order costs no memory however long the
+     *              sequence is.
+     *
+     *              The stratified order visits frames in bit reversed order, rotated by a random
+     *              offset, so after \f$ 2^k \f$ samples each of \f$ 2^k \f$ equal strata of the
+     *              sequence has been sampled once. Tracking failures come in runs, so this
+     *              usually converges sooner than a random order.
+     */
+    sampled_estimate estimate_ious(box_span results, box_span ground_truth, const sampling_options& options);
+}
+
+#endif
@@ -0,0 +1,478 @@
+#include "server.h"
+#include "mask.h"
+#include "polygon.h"
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <system_error>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace analyze
+{
+    namespace
+    {
+        /**
+         * \brief       Make a Unix socket address.
+         * \param[in]   path    The socket path.
+         * \return      The address.
+         * \throws      std::invalid_argument   This is thrown if \a path is too long.
+         */
+        sockaddr_un make_address(const std::string& path)
+        {
+            sockaddr_un address;
+            std::memset(&address, 0, sizeof(address));
+            address.sun_family = AF_UNIX;
+            if (path.size() >= sizeof(address.sun_path))
+                throw std::invalid_argument("socket path is too long: " + path);
+            std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+            return address;
+        }
+
+        /**
+         * \brief       Make an error message which includes the system error.
+         * \param[in]   what    The operation which failed.
+         * \return      The error message.
+         * \throws      std::bad_alloc  This is thrown if memory for the message cannot be
+         *                              allocated.
+         */
+        std::string system_error(const std::string& what)
+        {
+            return "could not " + what + ": " + std::strerror(errno);
+        }
+
+        /**
+         * \brief       Check that a path from a request cannot leave the directory it is joined to.
+         * \param[in]   path    The path to check.
+         * \param[in]   what    What the path is, for the error message.
+         * \param[in]   name    If true, \a path must be one name, without a /.
+         * \throws      std::invalid_argument   This is thrown if \a path is absolute or contains
+         *                                      "..", or if \a name is true and \a path is empty or
+         *                                      contains a /.
+         */
+        void check_request_path(const std::string& path, const char* const what, const bool name)
+        {
+            if ((!path.empty() && path[0] == '/') || path.find("..") != std::string::npos)
+                throw std::invalid_argument(std::string(what) + " must be relative, without ..: " + path);
+            if (name && (path.empty() || path.find('/') != std::string::npos))
+                throw std::invalid_argument(std::string(what) + " must be a name, without /: " + path);
+        }
+
+        /**
+         * \brief       A thread safe cache of parsed files.
+         * \tparam      T   The type of the parsed data.
+         * \details     Entries are keyed by path, and are reloaded when the file's modification
+         *              time or size changes. Parsing happens outside the lock, so a slow file does
+         *              not block requests for other files.
+         */
+        template <class T>
+        class file_cache final
+        {
+        public:
+            /// The type of function which parses a file.
+            using loader_type = T (*)(const std::string&);
+
+            /**
+             * \brief       Construct an empty cache.
+             * \param[in]   loader  The function which parses a file.
+             * \throws      None
+             */
+            explicit file_cache(const loader_type loader) noexcept : m_loader(loader) {}
+
+            /**
+             * \brief       Get the parsed contents of a file.
+             * \param[in]   path    The file to get.
+             * \return      The parsed data. It stays valid after the cache entry is replaced.
+             * \throws      std::runtime_error  This is thrown if the file does not exist, or the
+             *                                  loader throws it.
+             */
+            std::shared_ptr<const T> get(const std::string& path)
+            {
+                struct stat status;
+                if (stat(path.c_str(), &status) != 0)
+                    throw std::runtime_error("could not open " + path);
+                const file_stamp stamp {status.st_mtim.tv_sec, status.st_mtim.tv_nsec, status.st_size};
+
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    const auto e = m_entries.find(path);
+                    if (e != m_entries.end() && e->second.stamp == stamp)
+                        return e->second.data;
+                }
+
+                auto data = std::make_shared<const T>(m_loader(path));
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_entries[path] = entry {stamp, data};
+                return data;
+            }
+
+        private:
+            /// Identifies one version of a file.
+            struct file_stamp final
+            {
+                long long seconds     = 0; ///< The modification time, in seconds.
+                long long nanoseconds = 0; ///< The fraction of the modification time.
+                long long size        = 0; ///< The size of the file, in bytes.
+
+                /**
+                 * \brief       Compare two file versions.
+                 * \param[in]   s       The version to compare with this one.
+                 * \retval      true    The versions are the same.
+                 * \retval      false   The file has changed.
+                 * \throws      None
+                 */
+                bool operator==(const file_stamp& s) const noexcept
+                {
+                    return seconds == s.seconds && nanoseconds == s.nanoseconds && size == s.size;
+                }
+            };
+
+            /// One cached file.
+            struct entry final
+            {
+                file_stamp               stamp; ///< The version of the file which was parsed.
+                std::shared_ptr<const T> data;  ///< The parsed file.
+            };
+
+            loader_type                  m_loader;  ///< Parses a file.
+            std::mutex                   m_mutex;   ///< Guards the entries.
+            std::map<std::string, entry> m_entries; ///< The cached files, by path.
+        };
+    }
+
+    /// The parsed file caches, one for each kind of file.
+    struct evaluation_server::file_caches final
+    {
+        file_cache<box_list>           boxes {[](const std::string& f) { return load_results(f); }}; ///< Single object boxes.
+        file_cache<mot_sequence>       mot {load_mot};        ///< Multi-object results.
+        file_cache<mot_sequence>       mot_truth {load_mot_ground_truth}; ///< Multi-object ground truth.
+        file_cache<quadrilateral_list> regions {[](const std::string& f) { return load_regions(f); }}; ///< VOT regions.
+        file_cache<mask_list>          masks {[](const std::string& f) { return load_masks(f); }}; ///< VOT masks.
+    };
+
+    //-------------------------------------------------------
+    //                       evaluation_server class methods
+    //-------------------------------------------------------
+    evaluation_server::evaluation_server(server_options options)
+        : m_options(std::move(options)), m_caches(new file_caches)
+    {
+        if (m_options.data_directory.empty())
+            throw std::invalid_argument("the server needs a data directory");
+        const auto address = make_address(m_options.socket_path);
+        m_socket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (m_socket < 0)
+            throw std::runtime_error(system_error("create the server socket"));
+
+        // nothing can connect until listen(), so the mode is set before anyone can use the socket
+        unlink(m_options.socket_path.c_str());
+        if (bind(m_socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+            chmod(m_options.socket_path.c_str(), S_IRUSR | S_IWUSR) != 0 || listen(m_socket, SOMAXCONN) != 0)
+        {
+            const auto message = system_error("listen on " + m_options.socket_path);
+            close(m_socket);
+            throw std::runtime_error(message);
+        }
+
+        m_epoll = epoll_create1(EPOLL_CLOEXEC);
+        m_wake  = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        epoll_event listening {};
+        listening.events  = EPOLLIN;
+        listening.data.fd = m_socket;
+        epoll_event waking {};
+        waking.events  = EPOLLIN;
+        waking.data.fd = m_wake;
+        if (m_epoll < 0 || m_wake < 0 || epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_socket, &listening) != 0 ||
+            epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wake, &waking) != 0)
+        {
+            const auto message = system_error("wait for connections on " + m_options.socket_path);
+            for (const auto descriptor : {m_epoll, m_wake, m_socket})
+            {
+                if (descriptor >= 0)
+                    close(descriptor);
+            }
+            unlink(m_options.socket_path.c_str());
+            throw std::runtime_error(message);
+        }
+
+        auto threads = m_options.thread_count;
+        if (threads == 0)
+            threads = std::max(std::thread::hardware_concurrency(), 1u);
+        try
+        {
+            for (unsigned t = 0; t < threads; ++t)
+                m_workers.emplace_back(&evaluation_server::work, this);
+        }
+        catch (std::system_error&)
+        {
+            // serve with the workers which did start, unless there are none
+            if (m_workers.empty())
+            {
+                close(m_wake);
+                close(m_epoll);
+                close(m_socket);
+                unlink(m_options.socket_path.c_str());
+                throw std::runtime_error("could not start a server worker");
+            }
+        }
+    }
+
+    evaluation_server::~evaluation_server() noexcept
+    {
+        stop();
+        for (auto& w : m_workers)
+            w.join();
+        m_workers.clear();
+        for (const auto client : m_clients)
+            close(client);
+        m_clients.clear();
+        m_queue.clear();
+        close(m_wake);
+        close(m_epoll);
+        close(m_socket);
+        unlink(m_options.socket_path.c_str());
+    }
+
+    void evaluation_server::run()
+    {
+        constexpr int capacity = 64;
+        epoll_event events[capacity];
+        while (!m_stopping)
+        {
+            const int count = epoll_wait(m_epoll, events, capacity, -1);
+            if (count < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                throw std::runtime_error(system_error("wait for requests"));
+            }
+
+            for (int e = 0; e < count && !m_stopping; ++e)
+            {
+                const int descriptor = events[e].data.fd;
+                if (descriptor == m_wake)
+                    continue;
+                if (descriptor != m_socket)
+                {
+                    // the client has a request, or has hung up; either way a worker reads it
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_queue.push_back(descriptor);
+                    m_ready.notify_one();
+                    continue;
+                }
+
+                const int client = accept4(m_socket, nullptr, nullptr, SOCK_CLOEXEC);
+                if (client < 0)
+                {
+                    if (errno == EINTR || errno == ECONNABORTED || errno == EAGAIN)
+                        continue;
+                    throw std::runtime_error(system_error("accept a connection"));
+                }
+
+                // one shot, so a connection is never queued twice; a worker arms it again
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_clients.insert(client);
+                epoll_event request {};
+                request.events  = EPOLLIN | EPOLLONESHOT;
+                request.data.fd = client;
+                if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, client, &request) != 0)
+                {
+                    m_clients.erase(client);
+                    close(client);
+                }
+            }
+        }
+    }
+
+    void evaluation_server::stop() noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        const std::uint64_t one = 1;
+        if (write(m_wake, &one, sizeof(one)) < 0)
+            shutdown(m_socket, SHUT_RDWR);
+        for (const auto client : m_clients)
+            shutdown(client, SHUT_RDWR);
+        m_ready.notify_all();
+    }
+
+    evaluation_response evaluation_server::evaluate(const evaluation_request& request)
+    {
+        const auto& data = m_options.data_directory;
+        const auto  root = m_options.results_root + "/";
+        const auto results_path = [&request, &root](const std::string& sequence, const char* extension) {
+            return root + (request.results_directory.empty() ? std::string() : request.results_directory + "/") +
+                   sequence + extension;
+        };
+
+        std::string directory_error;
+        try
+        {
+            check_request_path(request.results_directory, "the results directory", false);
+            check_request_path(request.output_directory, "the output directory", false);
+        }
+        catch (std::invalid_argument& e)
+        {
+            directory_error = e.what();
+        }
+
+        evaluation_response response(request.sequences.size());
+        for (std::size_t s = 0; s < request.sequences.size(); ++s)
+        {
+            const auto& sequence = request.sequences[s];
+            auto& result = response[s];
+            try
+            {
+                if (!directory_error.empty())
+                    throw std::invalid_argument(directory_error);
+                check_request_path(sequence, "a sequence", true);
+
+                iou_list ious;
+                switch (request.metric)
+                {
+                    case evaluation_metric::boxes:
+                    {
+                        const auto results = m_caches->boxes.get(results_path(sequence, ".boxes"));
+                        const auto truth = m_caches->boxes.get(data + "/struck_data/" + sequence + "/" + sequence + "_gt.txt");
+                        ious = calculate_ious(*results, *truth);
+                        break;
+                    }
+                    case evaluation_metric::mot:
+                    {
+                        const auto results = m_caches->mot.get(results_path(sequence, ".txt"));
+                        const auto truth = m_caches->mot_truth.get(data + "/mot_data/" + sequence + "/gt/gt.txt");
+                        ious = calculate_coverage(*results, *truth);
+                        break;
+                    }
+                    case evaluation_metric::vot:
+                    {
+                        const auto results = m_caches->regions.get(results_path(sequence, ".boxes"));
+                        const auto truth = m_caches->regions.get(data + "/vot_data/" + sequence + "/groundtruth.txt");
+                        ious.resize(std::min(results->size(), truth->size()));
+                        calculate_ious(results->data(), truth->data(), ious.size(), ious.data());
+                        break;
+                    }
+                    case evaluation_metric::vot_masks:
+                    {
+                        const auto results = m_caches->masks.get(results_path(sequence, ".boxes"));
+                        const auto truth = m_caches->masks.get(data + "/vot_data/" + sequence + "/groundtruth.txt");
+                        for (std::size_t m = 0; m < std::min(results->size(), truth->size()); ++m)
+                            ious.push_back(make_iou((*results)[m], (*truth)[m]));
+                        break;
+                    }
+                }
+
+                if (!request.output_directory.empty())
+                    write_ious(ious, root + request.output_directory + "/" + sequence + ".ious");
+                result.summary = summarize(ious);
+                result.ok      = true;
+            }
+            catch (std::exception& e)
+            {
+                result.error = e.what();
+            }
+        }
+        return response;
+    }
+
+    void evaluation_server::work() noexcept
+    {
+        while (true)
+        {
+            int client = -1;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_ready.wait(lock, [this]() { return m_stopping || !m_queue.empty(); });
+                if (m_stopping)
+                    return;
+                client = m_queue.front();
+                m_queue.pop_front();
+            }
+
+            if (!serve(client) || m_stopping)
+            {
+                disconnect(client);
+                continue;
+            }
+            epoll_event request {};
+            request.events  = EPOLLIN | EPOLLONESHOT;
+            request.data.fd = client;
+            if (epoll_ctl(m_epoll, EPOLL_CTL_MOD, client, &request) != 0)
+                disconnect(client);
+        }
+    }
+
+    bool evaluation_server::serve(const int client) noexcept
+    {
+        try
+        {
+            std::string message;
+            if (!read_message(client, message))
+                return false;
+            write_message(client, encode_response(evaluate(decode_request(message))));
+            return true;
+        }
+        catch (std::exception&)
+        {
+            // a broken or malformed connection only affects its own client
+            return false;
+        }
+    }
+
+    void evaluation_server::disconnect(const int client) noexcept
+    {
+        // under the lock, so stop() never shuts down a reused descriptor
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_clients.erase(client);
+        epoll_ctl(m_epoll, EPOLL_CTL_DEL, client, nullptr);
+        close(client);
+    }
+
+    //-------------------------------------------------------
+    //                       evaluation_client class methods
+    //-------------------------------------------------------
+    evaluation_client::evaluation_client(const std::string& socket_path)
+    {
+        const auto address = make_address(socket_path);
+        m_socket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (m_socket < 0)
+            throw std::runtime_error(system_error("create a client socket"));
+        if (connect(m_socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+        {
+            const auto message = system_error("connect to " + socket_path);
+            close(m_socket);
+            throw std::runtime_error(message);
+        }
+    }
+
+    evaluation_client::evaluation_client(evaluation_client&& client) noexcept : m_socket(client.m_socket)
+    {
+        client.m_socket = -1;
+    }
+
+    evaluation_client::~evaluation_client() noexcept
+    {
+        if (m_socket >= 0)
+            close(m_socket);
+    }
+
+    evaluation_client& evaluation_client::operator=(evaluation_client&& client) noexcept
+    {
+        std::swap(m_socket, client.m_socket);
+        return *this;
+    }
+
+    evaluation_response evaluation_client::evaluate(const evaluation_request& request)
+    {
+        write_message(m_socket, encode_request(request));
+        std::string message;
+        if (!read_message(m_socket, message))
+            throw std::runtime_error("the server closed the connection");
+        return decode_response(message);
+    }
+}
@@ -0,0 +1,197 @@
+#ifndef ANALYZE_SERVER_H
+#define ANALYZE_SERVER_H
+
+#include "protocol.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace analyze
+{
+    /// The settings for an evaluation_server.
+    struct server_options final
+    {
+        std::string socket_path  = "/tmp/analyze.sock"; ///< The Unix socket to listen on.
+        unsigned    thread_count = 0;                   ///< Workers; 0 uses one per core.
+        std::string data_directory;                     ///< The root of the ground truth. It is required.
+        std::string results_root = ".";                 ///< The root of request directories.
+    };
+
+    /**
+     * \brief       A long lived evaluation service on a Unix domain socket.
+     * \details     The server keeps every results and ground truth file it has parsed, so repeated
+     *              requests skip process start up and parsing. A cached file is parsed again only
+     *              if its modification time or size changes.
+     *
+     *              One thread, in run(), accepts connections and waits with epoll for any of them
+     *              to send a request. A connection with a request is handed to a pool of workers;
+     *              the worker answers that one request, and gives the connection back to run().
+     *              So idle connections hold no worker, and any number of clients can keep their
+     *              connections open, paying no set up cost per request. Requests and responses use
+     *              the messages in protocol.h.
+     *
+     *              Only the user running the server can connect to its socket. Even so, a request
+     *              cannot name files outside server_options::results_root; see evaluate().
+     */
+    class evaluation_server final
+    {
+    public:
+        /**
+         * \brief       Construct a server, start its workers, and listen on its socket.
+         * \param[in]   options The server settings.
+         * \throws      std::invalid_argument   This is thrown if \a options has no data directory.
+         * \throws      std::runtime_error      This is thrown if the socket or the epoll instance
+         *                                      cannot be created.
+         * \details     An existing file at the socket path is replaced. The socket is made
+         *              readable and writable by its owner only before the server listens.
+         */
+        explicit evaluation_server(server_options options);
+
+        /// A server owns a socket and threads, so it cannot be copied.
+        evaluation_server(const evaluation_server&) = delete;
+
+        /// A server owns a socket and threads, so it cannot be moved.
+        evaluation_server(evaluation_server&&) = delete;
+
+        /**
+         * \brief   Stop the server, wait for the workers, and remove the socket.
+         * \throws  None
+         */
+        ~evaluation_server() noexcept;
+
+        /// A server owns a socket and threads, so it cannot be copied.
+        evaluation_server& operator=(const evaluation_server&) = delete;
+
+        /// A server owns a socket and threads, so it cannot be moved.
+        evaluation_server& operator=(evaluation_server&&) = delete;
+
+        /**
+         * \brief   Accept connections, and queue those with requests, until stop() is called.
+         * \throws  std::runtime_error  This is thrown if waiting for, or accepting, a connection
+         *                              fails.
+         */
+        void run();
+
+        /**
+         * \brief   Stop accepting connections and close the open ones. This may be called from
+         *          any thread.
+         * \throws  None
+         */
+        void stop() noexcept;
+
+        /**
+         * \brief       Evaluate a request in this process, using the server's caches.
+         * \param[in]   request The evaluation to run.
+         * \return      One result for each sequence in \a request.
+         * \throws      std::bad_alloc  This is thrown if memory for the results cannot be
+         *                              allocated.
+         * \details     This is safe to call from several threads at once. A sequence which cannot
+         *              be evaluated has its error recorded in its result; it does not stop the
+         *              other sequences.
+         *
+         *              The request's directories are relative to server_options::results_root.
+         *              Every sequence fails if either is absolute or contains "..", and a sequence
+         *              fails if its name contains "/" or "..".
+         */
+        evaluation_response evaluate(const evaluation_request& request);
+
+    private:
+        /// The parsed file caches; see server.cpp.
+        struct file_caches;
+
+        /**
+         * \brief   Take connections from the queue and answer one request on each, until the
+         *          server stops.
+         * \throws  None
+         */
+        void work() noexcept;
+
+        /**
+         * \brief       Answer one request on a connection.
+         * \param[in]   client  The connected socket, which has a request to read.
+         * \retval      true    The request was answered, and the connection stays open.
+         * \retval      false   The client disconnected, or the connection is broken.
+         * \throws      None
+         */
+        bool serve(const int client) noexcept;
+
+        /**
+         * \brief       Close a connection, and forget it.
+         * \param[in]   client  The connected socket.
+         * \throws      None
+         */
+        void disconnect(const int client) noexcept;
+
+        server_options               m_options;      ///< The server settings.
+        std::unique_ptr<file_caches> m_caches;       ///< The parsed files.
+        int                          m_socket = -1;  ///< The listening socket.
+        int                          m_epoll  = -1;  ///< Waits for connections and requests.
+        int                          m_wake   = -1;  ///< An eventfd which wakes run() to stop.
+        std::atomic<bool>            m_stopping {false}; ///< True once stop() is called.
+        std::mutex                   m_mutex;        ///< Guards the queue and the open clients.
+        std::condition_variable      m_ready;        ///< Signals a queued client, or stopping.
+        std::deque<int>              m_queue;        ///< Clients with a request, waiting for a worker.
+        std::set<int>                m_clients;      ///< Every open client, to close on stop.
+        std::vector<std::thread>     m_workers;      ///< The worker pool.
+    };
+
+    /**
+     * \brief       A connection to an evaluation_server.
+     * \details     The connection is kept open between requests.
+     */
+    class evaluation_client final
+    {
+    public:
+        /**
+         * \brief       Connect to a server.
+         * \param[in]   socket_path The server's Unix socket.
+         * \throws      std::runtime_error  This is thrown if the server cannot be reached.
+         */
+        explicit evaluation_client(const std::string& socket_path);
+
+        /// A client owns a socket, so it cannot be copied.
+        evaluation_client(const evaluation_client&) = delete;
+
+        /**
+         * \brief   Move a client.
+         * \throws  None
+         */
+        evaluation_client(evaluation_client&& client) noexcept;
+
+        /**
+         * \brief   Disconnect from the server.
+         * \throws  None
+         */
+        ~evaluation_client() noexcept;
+
+        /// A client owns a socket, so it cannot be copied.
+        evaluation_client& operator=(const evaluation_client&) = delete;
+
+        /**
+         * \brief   Move a client.
+         * \return  A reference to this client.
+         * \throws  None
+         */
+        evaluation_client& operator=(evaluation_client&& client) noexcept;
+
+        /**
+         * \brief       Ask the server to run an evaluation, and wait for the answer.
+         * \param[in]   request The evaluation to run.
+         * \return      The server's response.
+         * \throws      std::runtime_error      This is thrown if the connection fails.
+         * \throws      std::invalid_argument   This is thrown if the response is malformed.
+         */
+        evaluation_response evaluate(const evaluation_request& request);
+
+    private:
+        int m_socket = -1; ///< The connected socket.
+    };
+}
+
+#endif
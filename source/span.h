@@ -0,0 +1,148 @@
+#ifndef ANALYZE_SPAN_H
+#define ANALYZE_SPAN_H
+
+#include <cstddef>
+#include <type_traits>
+
+namespace analyze
+{
+    /**
+     * \brief       A non-owning view of a contiguous sequence of objects.
+     * \tparam      T   The type of the viewed objects. Use a const type for a read only view.
+     * \details     This is a minimal stand in for C++20's std::span, so callers can pass their own
+     *              storage to the analysis functions without copying it into a std::vector.
+     */
+    template <class T>
+    class span final
+    {
+    public:
+        /// The type of the viewed objects.
+        using element_type = T;
+
+        /// The type of the viewed objects, without const or volatile qualifiers.
+        using value_type = typename std::remove_cv<T>::type;
+
+        /// The type used for sizes and indices.
+        using size_type = std::size_t;
+
+        /// The iterator type.
+        using iterator = T*;
+
+        /**
+         * \brief   Construct an empty span.
+         * \throws  None
+         */
+        constexpr span() noexcept = default;
+
+        /**
+         * \brief       Construct a span over a range of objects.
+         * \param[in]   data    The first object in the range.
+         * \param[in]   size    The number of objects in the range.
+         * \throws      None
+         */
+        constexpr span(T* data, const size_type size) noexcept : m_data(data), m_size(size) {}
+
+        /**
+         * \brief       Construct a span over a contiguous container, such as std::vector.
+         * \tparam      Container   The container type. It must have data() and size() members.
+         * \param[in]   c           The container to view.
+         * \throws      None
+         */
+        template <class Container,
+                  class = typename std::enable_if<
+                      std::is_convertible<decltype(std::declval<Container&>().data()), T*>::value>::type>
+        constexpr span(Container& c) noexcept : m_data(c.data()), m_size(c.size())
+        {
+        }
+
+        /**
+         * \brief       Construct a read only span over a contiguous container.
+         * \tparam      Container   The container type. It must have data() and size() members.
+         * \param[in]   c           The container to view. This may be a temporary, so a function
+         *                          result can be passed straight to a function taking a span; the
+         *                          span must not outlive it.
+         * \throws      None
+         */
+        template <class Container,
+                  class = typename std::enable_if<
+                      std::is_convertible<decltype(std::declval<const Container&>().data()), T*>::value>::type,
+                  class = void>
+        constexpr span(const Container& c) noexcept : m_data(c.data()), m_size(c.size())
+        {
+        }
+
+        /**
+         * \brief       Construct a read only span from a writable one.
+         * \tparam      U   The writable element type.
+         * \param[in]   s   The span to view.
+         * \throws      None
+         */
+        template <class U, class = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+        constexpr span(const span<U>& s) noexcept : m_data(s.data()), m_size(s.size())
+        {
+        }
+
+        /**
+         * \brief   Get the first viewed object.
+         * \return  A pointer to the first object, or null for a default span.
+         * \throws  None
+         */
+        constexpr T* data() const noexcept { return m_data; }
+
+        /**
+         * \brief   Query the number of viewed objects.
+         * \return  The number of objects in the span.
+         * \throws  None
+         */
+        constexpr size_type size() const noexcept { return m_size; }
+
+        /**
+         * \brief   Query if the span is empty.
+         * \retval  true    The span views no objects.
+         * \retval  false   The span views at least one object.
+         * \throws  None
+         */
+        constexpr bool empty() const noexcept { return m_size == 0; }
+
+        /**
+         * \brief       Access one viewed object.
+         * \param[in]   i   The index of the object. This must be less than size().
+         * \return      A reference to object \a i.
+         * \throws      None
+         */
+        constexpr T& operator[](const size_type i) const noexcept { return m_data[i]; }
+
+        /**
+         * \brief   Get an iterator to the first viewed object.
+         * \return  The start of the span.
+         * \throws  None
+         */
+        constexpr iterator begin() const noexcept { return m_data; }
+
+        /**
+         * \brief   Get an iterator past the last viewed object.
+         * \return  The end of the span.
+         * \throws  None
+         */
+        constexpr iterator end() const noexcept { return m_data + m_size; }
+
+        /**
+         * \brief       View part of this span.
+         * \param[in]   offset  The index of the first object in the sub-span. This must not be
+         *                      greater than size().
+         * \param[in]   count   The most objects to include in the sub-span.
+         * \return      A span over objects [offset, offset + count), clamped to this span.
+         * \throws      None
+         */
+        constexpr span subspan(const size_type offset, const size_type count) const noexcept
+        {
+            return span(m_data + offset, count < m_size - offset ? count : m_size - offset);
+        }
+
+    private:
+        T*        m_data = nullptr; ///< The first viewed object.
+        size_type m_size = 0;       ///< The number of viewed objects.
+    };
+}
+
+#endif
@@ -0,0 +1,235 @@
+#ifndef ANALYZE_SPATIAL_GRID_H
+#define ANALYZE_SPATIAL_GRID_H
+
+#include "bounding_box.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace analyze
+{
+    /**
+     * \brief       A uniform grid spatial index over a set of bounding boxes.
+     * \tparam      T   The data type of the bounding box coordinates.
+     * \details     The grid covers the extent of the indexed boxes with roughly one cell per box.
+     *              Each box is recorded in every cell it overlaps, and the cell contents are stored
+     *              in compressed sparse row layout. A query visits only the cells the query box
+     *              overlaps, and returns only boxes with a non-empty intersection().
+     *
+     *              A box which spans several cells is reported from just one of them: the cell
+     *              which contains the top left corner of its intersection with the query box. That
+     *              makes queries free of duplicates without any mutable state, so one grid can be
+     *              queried from many threads at once.
+     *
+     *              A box with a coordinate which is not finite overlaps nothing: it is not indexed,
+     *              and a query with one finds nothing.
+     *
+     *              The grid stores indices into the indexed array, but not the boxes themselves.
+     *              The array must outlive the grid, and must not be modified.
+     */
+    template <class T>
+    class spatial_grid final
+    {
+    public:
+        /// The data type representing the bounding box coordinates.
+        using value_type = T;
+
+        /// The type used for box indices and counts.
+        using size_type = std::size_t;
+
+        /**
+         * \brief   Construct an empty grid.
+         * \throws  None
+         */
+        spatial_grid() = default;
+
+        /**
+         * \brief       Construct a grid over a set of boxes.
+         * \param[in]   boxes   The first of \a count boxes to index.
+         * \param[in]   count   The number of boxes to index.
+         * \throws      std::bad_alloc  This is thrown if memory for the grid cannot be allocated.
+         */
+        spatial_grid(const bounding_box<T>* boxes, const size_type count) { build(boxes, count); }
+
+        /**
+         * \brief       Replace the indexed boxes.
+         * \param[in]   boxes   The first of \a count boxes to index.
+         * \param[in]   count   The number of boxes to index.
+         * \throws      std::bad_alloc  This is thrown if memory for the grid cannot be allocated.
+         * \details     The grid's memory is reused, so a grid can be rebuilt for each frame of a
+         *              sequence without reallocating.
+         */
+        void build(const bounding_box<T>* boxes, const size_type count)
+        {
+            m_boxes = boxes;
+            m_count = count;
+            m_cell_offsets.clear();
+            m_cell_items.clear();
+            if (count == 0)
+                return;
+
+            // fit the grid to the extent of the boxes which can overlap anything, with about one
+            // cell per box
+            const auto first = std::find_if(boxes, boxes + count, indexable);
+            if (first == boxes + count)
+                return;
+            double left = first->left(), right = first->right(), top = first->top(), bottom = first->bottom();
+            for (auto b = first + 1; b != boxes + count; ++b)
+            {
+                if (!indexable(*b))
+                    continue;
+                left   = std::min(left, static_cast<double>(b->left()));
+                right  = std::max(right, static_cast<double>(b->right()));
+                top    = std::min(top, static_cast<double>(b->top()));
+                bottom = std::max(bottom, static_cast<double>(b->bottom()));
+            }
+            const auto side = static_cast<size_type>(std::ceil(std::sqrt(static_cast<double>(count))));
+            m_columns     = side;
+            m_rows        = side;
+            m_left        = left;
+            m_top         = top;
+            m_cell_width  = std::max((right - left) / m_columns, 1.0e-9);
+            m_cell_height = std::max((bottom - top) / m_rows, 1.0e-9);
+
+            // count the entries in each cell, then convert the counts to offsets
+            m_cell_offsets.assign(m_columns * m_rows + 1, 0);
+            for_each_cell(count, [this](const size_type, const size_type cell) { ++m_cell_offsets[cell + 1]; });
+            for (size_type c = 1; c < m_cell_offsets.size(); ++c)
+                m_cell_offsets[c] += m_cell_offsets[c - 1];
+
+            // scatter the box indices into their cells
+            m_cell_items.resize(m_cell_offsets.back());
+            std::vector<size_type> next(m_cell_offsets.cbegin(), m_cell_offsets.cend() - 1);
+            for_each_cell(count, [this, &next](const size_type box, const size_type cell) {
+                m_cell_items[next[cell]++] = box;
+            });
+        }
+
+        /**
+         * \brief   Query the number of indexed boxes.
+         * \return  The number of boxes passed to build().
+         * \throws  None
+         */
+        size_type size() const noexcept { return m_count; }
+
+        /**
+         * \brief           Find the indexed boxes which overlap a query box.
+         * \param[in]       box         The query box.
+         * \param[in,out]   candidates  The indices of the overlapping boxes are appended to this
+         *                              list. Each index appears once, in no particular order.
+         * \throws          std::bad_alloc  This is thrown if \a candidates cannot grow.
+         * \details         A box overlaps the query box if the area of their intersection() is
+         *                  greater than 0. Boxes which only touch the query box are not reported.
+         */
+        void query(const bounding_box<T>& box, std::vector<size_type>& candidates) const
+        {
+            if (m_cell_offsets.empty() || !indexable(box))
+                return;
+
+            const auto first_column = column(box.left()), last_column = column(box.right());
+            const auto first_row = row(box.top()), last_row = row(box.bottom());
+            for (size_type r = first_row; r <= last_row; ++r)
+            {
+                for (size_type c = first_column; c <= last_column; ++c)
+                {
+                    const auto cell = r * m_columns + c;
+                    for (auto i = m_cell_offsets[cell]; i < m_cell_offsets[cell + 1]; ++i)
+                    {
+                        const auto index = m_cell_items[i];
+                        const auto overlap = intersection(box, m_boxes[index]);
+                        if (area(overlap) > 0 && column(overlap.left()) == c && row(overlap.top()) == r)
+                            candidates.push_back(index);
+                    }
+                }
+            }
+        }
+
+    private:
+        /**
+         * \brief       Check whether a box can overlap another.
+         * \param[in]   box     The box to check.
+         * \retval      true    Every coordinate is finite, and the box has an area.
+         * \retval      false   The box overlaps nothing.
+         * \throws      None
+         */
+        static bool indexable(const bounding_box<T>& box) noexcept
+        {
+            return std::isfinite(box.left()) && std::isfinite(box.right()) && std::isfinite(box.top()) &&
+                   std::isfinite(box.bottom()) && area(box) > 0;
+        }
+
+        /**
+         * \brief       Find the grid column containing a coordinate.
+         * \param[in]   x   The coordinate to locate.
+         * \return      The column index, clamped to the grid.
+         * \throws      None
+         */
+        size_type column(const value_type x) const noexcept
+        {
+            return clamp((static_cast<double>(x) - m_left) / m_cell_width, m_columns);
+        }
+
+        /**
+         * \brief       Find the grid row containing a coordinate.
+         * \param[in]   y   The coordinate to locate.
+         * \return      The row index, clamped to the grid.
+         * \throws      None
+         */
+        size_type row(const value_type y) const noexcept
+        {
+            return clamp((static_cast<double>(y) - m_top) / m_cell_height, m_rows);
+        }
+
+        /**
+         * \brief       Convert a fractional cell coordinate to a valid cell index.
+         * \param[in]   v       The fractional cell coordinate.
+         * \param[in]   cells   The number of cells along the axis.
+         * \return      \f$ \lfloor v \rfloor \f$ clamped to [0, \a cells - 1]. NaN gives 0.
+         * \throws      None
+         * \details     The value is clamped before it is converted, since converting a value which
+         *              does not fit is undefined.
+         */
+        static size_type clamp(const double v, const size_type cells) noexcept
+        {
+            if (!(v > 0.0))
+                return 0;
+            if (v >= static_cast<double>(cells - 1))
+                return cells - 1;
+            return static_cast<size_type>(v);
+        }
+
+        /**
+         * \brief       Visit every (box, cell) pair where an indexable box overlaps a cell.
+         * \tparam      Function    A callable taking a box index and a cell index.
+         * \param[in]   count       The number of boxes to visit.
+         * \param[in]   f           The function to call for each pair.
+         * \throws      None
+         */
+        template <class Function>
+        void for_each_cell(const size_type count, Function f) const
+        {
+            for (size_type i = 0; i < count; ++i)
+            {
+                const auto& b = m_boxes[i];
+                if (!indexable(b))
+                    continue;
+                for (size_type r = row(b.top()); r <= row(b.bottom()); ++r)
+                    for (size_type c = column(b.left()); c <= column(b.right()); ++c)
+                        f(i, r * m_columns + c);
+            }
+        }
+
+        const bounding_box<T>* m_boxes = nullptr; ///< The indexed boxes.
+        size_type m_count       = 0;              ///< The number of indexed boxes.
+        size_type m_columns     = 0;              ///< The number of grid columns.
+        size_type m_rows        = 0;              ///< The number of grid rows.
+        double    m_left        = 0.0;            ///< The left edge of the grid.
+        double    m_top         = 0.0;            ///< The top edge of the grid.
+        double    m_cell_width  = 1.0;            ///< The width of one grid cell.
+        double    m_cell_height = 1.0;            ///< The height of one grid cell.
+        std::vector<size_type> m_cell_offsets;    ///< The start of each cell's entries.
+        std::vector<size_type> m_cell_items;      ///< The box indices in each cell.
+    };
+}
+
+#endif
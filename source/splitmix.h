@@ -0,0 +1,28 @@
+#ifndef ANALYZE_SPLITMIX_H
+#define ANALYZE_SPLITMIX_H
+
+#include <cstdint>
+
+namespace analyze
+{
+    /// 2^64 over the golden ratio; SplitMix64 adds this to its state for each number it returns.
+    constexpr std::uint64_t golden_gamma = 0x9e3779b97f4a7c15ull;
+
+    /**
+     * \brief       Scramble a number; this is the SplitMix64 finalizer.
+     * \param[in]   x   The number to scramble.
+     * \return      The scrambled number.
+     * \throws      None
+     * \details     The n-th number of a SplitMix64 generator is the finalizer of
+     *              \f$ seed + n \cdot golden\_gamma \f$, so a stream can be drawn from a counter, and
+     *              one SplitMix64 step is <tt>splitmix_finalize(x + golden_gamma)</tt>.
+     */
+    inline std::uint64_t splitmix_finalize(std::uint64_t x) noexcept
+    {
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+}
+
+#endif
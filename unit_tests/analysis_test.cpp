@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <vector>
+#include <QtTest/QtTest>
+#include "analysis.h"
+#include "analyze_c.h"
+
+namespace analyze
+{
+    /// A set of unit tests for the analysis library interfaces.
+    class analysis_test final: public QObject
+    {
+        Q_OBJECT
+        public:
+            /**
+             * \brief   Construct a set of analysis unit tests.
+             * \throws  None
+             */
+            analysis_test() = default;
+
+            /**
+             * \brief   Copy a set of analysis unit tests.
+             * \throws  None
+             */
+            analysis_test(const analysis_test&) = default;
+
+            /**
+             * \brief   Move a set of analysis unit tests.
+             * \throws  None
+             */
+            analysis_test(analysis_test&&) = default;
+
+            /**
+             * \brief   Destroy an analysis test.
+             * \throws  None
+             */
+            ~analysis_test() noexcept = default;
+
+            /**
+             * \brief   Copy a set of analysis unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            analysis_test& operator=(const analysis_test&) = default;
+
+            /**
+             * \brief   Move a set of analysis unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            analysis_test& operator=(analysis_test&&) = default;
+
+        private slots:
+            /**
+             * \brief   Verify that IoUs are written to caller storage, with a stride and a limit.
+             * \throws  None
+             */
+            void test_calculate_ious() noexcept
+            {
+                const std::array<bounding_box<float>, 4> results {{{0, 2, 0, 2}, {0, 2, 0, 2}, {0, 2, 0, 2}, {0, 2, 0, 2}}};
+                const std::array<bounding_box<float>, 3> truth {{{0, 2, 0, 2}, {1, 3, 0, 2}, {4, 5, 4, 5}}};
+                std::array<iou, 4> ious;
+
+                QCOMPARE(calculate_ious(results, truth, ious), static_cast<std::size_t>(3));
+                QCOMPARE(ious[0].value(), 1.0f);
+                QCOMPARE(ious[1].value(), 1.0f / 3.0f);
+                QCOMPARE(ious[2].value(), 0.0f);
+
+                QCOMPARE(calculate_ious(results, truth, ious, 2), static_cast<std::size_t>(2));
+                QCOMPARE(ious[1].value(), 0.0f);
+
+                QCOMPARE(calculate_ious(results, truth, span<iou>(ious.data(), 1)), static_cast<std::size_t>(1));
+                QCOMPARE(calculate_ious(box_span(), truth, ious), static_cast<std::size_t>(0));
+
+                const box_list many(11, bounding_box<float>(0, 1, 0, 1));
+                QCOMPARE(calculate_ious(many, many).size(), static_cast<std::size_t>(3));
+            }
+
+            /**
+             * \brief   Verify the IoU summary statistics.
+             * \throws  None
+             */
+            void test_summarize() noexcept
+            {
+                const iou_list ious {iou(0.5f), iou(0.25f), iou(0.75f)};
+                const auto summary = summarize(ious);
+                QCOMPARE(summary.minimum, 0.25f);
+                QCOMPARE(summary.maximum, 0.75f);
+                QCOMPARE(summary.average, 0.5f);
+                QCOMPARE(summary.count, static_cast<std::size_t>(3));
+
+                const auto empty = summarize(iou_list());
+                QCOMPARE(empty.count, static_cast<std::size_t>(0));
+                QCOMPARE(empty.average, 0.0f);
+            }
+
+            /**
+             * \brief   Verify that IoUs and summaries are the same whatever the thread count, and
+             *          however the series is split up.
+             * \throws  None
+             */
+            void test_parallel() noexcept
+            {
+                box_list results, truth;
+                for (std::size_t b = 0; b < 1500000; ++b)
+                {
+                    const auto x = static_cast<float>(b % 977) * 0.37f;
+                    results.emplace_back(x, x + 20.0f + b % 13, 5.0f, 40.0f);
+                    truth.emplace_back(x + b % 7, x + 25.0f, 4.0f + b % 3, 41.0f);
+                }
+                // a box with no area gives NaN, which must not change the extremes
+                truth[500] = truth[1000] = bounding_box<float>(0, 0, 0, 0);
+                results[500] = results[1000] = truth[500];
+
+                iou_list expected(results.size() / 5);
+                QCOMPARE(calculate_ious(results, truth, expected, 5), static_cast<std::size_t>(300000));
+                const auto serial = summarize(expected, 1);
+                QVERIFY(serial.minimum == serial.minimum);
+                for (const unsigned threads : {0u, 2u, 3u, 8u, 64u})
+                {
+                    iou_list ious(expected.size());
+                    QCOMPARE(calculate_ious(results, truth, ious, 5, threads), static_cast<std::size_t>(300000));
+                    QVERIFY(std::memcmp(ious.data(), expected.data(), ious.size() * sizeof(iou)) == 0);
+
+                    const auto summary = summarize(ious, threads);
+                    QCOMPARE(summary.count, serial.count);
+                    QVERIFY(std::memcmp(&summary.minimum, &serial.minimum, sizeof(float)) == 0);
+                    QVERIFY(std::memcmp(&summary.maximum, &serial.maximum, sizeof(float)) == 0);
+                    QVERIFY(std::memcmp(&summary.average, &serial.average, sizeof(float)) == 0);
+                }
+
+                iou_accumulator pieces;
+                for (std::size_t i = 0; i < 300000; i += 777)
+                    pieces.add(span<const iou>(expected.data() + i, std::min<std::size_t>(777, 300000 - i)));
+                const auto streamed = pieces.summary();
+                QVERIFY(std::memcmp(&streamed.average, &serial.average, sizeof(float)) == 0);
+                QVERIFY(std::memcmp(&streamed.minimum, &serial.minimum, sizeof(float)) == 0);
+
+                // a NaN first value is the minimum and maximum, as std::min() gives
+                expected[0] = iou(std::numeric_limits<float>::quiet_NaN());
+                const auto first_nan = summarize(expected, 4);
+                QVERIFY(first_nan.minimum != first_nan.minimum);
+                QVERIFY(first_nan.maximum != first_nan.maximum);
+            }
+
+            /**
+             * \brief   Verify the order in which a pairwise sum adds.
+             * \throws  None
+             */
+            void test_pairwise_sum() noexcept
+            {
+                pairwise_sum empty;
+                QCOMPARE(empty.total(), 0.0f);
+
+                // ((1e8 + 1) + (-1e8 + 1)) + 1: each pair loses its 1 to rounding
+                pairwise_sum sum;
+                for (const auto v : {1e8f, 1.0f, -1e8f, 1.0f, 1.0f})
+                    sum.add(v);
+                QCOMPARE(sum.total(), 1.0f);
+
+                pairwise_sum counting;
+                for (int v = 1; v <= 1000; ++v)
+                    counting.add(static_cast<float>(v));
+                QCOMPARE(counting.total(), 500500.0f);
+            }
+
+            /**
+             * \brief   Verify that results are loaded as left, width, top, height.
+             * \throws  None
+             */
+            void test_load_results() noexcept
+            {
+                QTemporaryFile file;
+                QVERIFY(file.open());
+                {
+                    std::ofstream stream(file.fileName().toStdString());
+                    stream << "1,2,3,4\n"
+                           << "5.5,1,6,2\n";
+                }
+
+                const auto boxes = load_results(file.fileName().toStdString());
+                QCOMPARE(boxes.size(), static_cast<std::size_t>(2));
+                QCOMPARE(boxes[0].left(), 1.0f);
+                QCOMPARE(boxes[0].right(), 3.0f);
+                QCOMPARE(boxes[0].top(), 3.0f);
+                QCOMPARE(boxes[0].bottom(), 7.0f);
+                QCOMPARE(boxes[1].right(), 6.5f);
+
+                const std::string malformed("1,2,3,4\n5.5,1,6,2\n7 8\tx,1,2,3\n");
+                QVERIFY_EXCEPTION_THROWN(parse_results(malformed), std::runtime_error);
+                const auto parsed = parse_results(malformed, validation_policy::skip);
+                QCOMPARE(parsed.size(), static_cast<std::size_t>(2));
+                QCOMPARE(parsed[1].left(), boxes[1].left());
+                QCOMPARE(parsed[1].bottom(), boxes[1].bottom());
+            }
+
+            /**
+             * \brief   Verify that the C interface matches the C++ interface.
+             * \throws  None
+             */
+            void test_c_interface() noexcept
+            {
+                const analyze_box results[] = {{0, 2, 0, 2}, {0, 2, 0, 2}};
+                const analyze_box truth[]   = {{0, 2, 0, 2}, {1, 3, 0, 2}};
+                float ious[2] = {};
+
+                QCOMPARE(analyze_iou(&results[1], &truth[1]), 1.0f / 3.0f);
+                QCOMPARE(analyze_calculate_ious(results, truth, 2, ious), static_cast<std::size_t>(2));
+                QCOMPARE(ious[0], 1.0f);
+                QCOMPARE(ious[1], 1.0f / 3.0f);
+
+                // boxes from C may have their sides swapped
+                const analyze_box swapped[] = {{2, 0, 0, 2}, {2, 0, 2, 0}};
+                QCOMPARE(analyze_iou(&swapped[1], &truth[1]), 1.0f / 3.0f);
+                QCOMPARE(analyze_calculate_ious(swapped, truth, 2, ious), static_cast<std::size_t>(2));
+                QCOMPARE(ious[0], 1.0f);
+                QCOMPARE(ious[1], 1.0f / 3.0f);
+                const std::vector<analyze_box> many_swapped(600, analyze_box {2, 0, 2, 0});
+                const std::vector<analyze_box> many_truth(600, analyze_box {0, 2, 0, 2});
+                std::vector<float> many_ious(600);
+                QCOMPARE(analyze_calculate_ious(many_swapped.data(), many_truth.data(), 600, many_ious.data()),
+                         static_cast<std::size_t>(600));
+                QVERIFY(std::all_of(many_ious.begin(), many_ious.end(), [](const float v) { return v == 1.0f; }));
+
+                const auto summary = analyze_summarize(ious, 2);
+                QCOMPARE(summary.minimum, 1.0f / 3.0f);
+                QCOMPARE(summary.maximum, 1.0f);
+                QCOMPARE(summary.count, static_cast<std::size_t>(2));
+            }
+    };
+}
+
+QTEST_MAIN(analyze::analysis_test)
+#include "analysis_test.moc"
@@ -0,0 +1,161 @@
+#include <fstream>
+#include <stdexcept>
+#include <QtTest/QtTest>
+#include "archive.h"
+#include "test_helpers.h"
+
+namespace analyze
+{
+    /**
+     * \brief       Make a test sequence.
+     * \param[in]   name    The sequence name.
+     * \param[in]   count   The number of ground truth boxes.
+     * \return      The sequence, with results if \a count is odd.
+     * \throws      std::bad_alloc  This is thrown if memory for the boxes cannot be allocated.
+     */
+    packed_sequence make_sequence(const std::string& name, const std::size_t count)
+    {
+        packed_sequence sequence;
+        sequence.name = name;
+        for (std::size_t b = 0; b < count; ++b)
+            sequence.ground_truth.emplace_back(b, b + 10.5f, b * 2.0f, b * 2.0f + 3.25f);
+        sequence.has_results = count % 2 == 1;
+        if (sequence.has_results)
+            sequence.results.assign(count + 1, bounding_box<float>(1.0f, 2.0f, 3.0f, 4.0f));
+        return sequence;
+    }
+
+    /// A set of unit tests for dataset archives.
+    class archive_test final: public QObject
+    {
+        Q_OBJECT
+        public:
+            /**
+             * \brief   Construct a set of archive unit tests.
+             * \throws  None
+             */
+            archive_test() = default;
+
+            /**
+             * \brief   Copy a set of archive unit tests.
+             * \throws  None
+             */
+            archive_test(const archive_test&) = default;
+
+            /**
+             * \brief   Move a set of archive unit tests.
+             * \throws  None
+             */
+            archive_test(archive_test&&) = default;
+
+            /**
+             * \brief   Destroy an archive test.
+             * \throws  None
+             */
+            ~archive_test() noexcept = default;
+
+            /**
+             * \brief   Copy a set of archive unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            archive_test& operator=(const archive_test&) = default;
+
+            /**
+             * \brief   Move a set of archive unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            archive_test& operator=(archive_test&&) = default;
+
+        private slots:
+            /**
+             * \brief   Verify that packed sequences can be found and read back.
+             * \throws  None
+             */
+            void test_round_trip() noexcept
+            {
+                QTemporaryDir directory;
+                const auto file = directory.path().toStdString() + "/data.pack";
+                std::vector<packed_sequence> sequences;
+                for (std::size_t s = 0; s < 100; ++s)
+                    sequences.push_back(make_sequence("seq-" + std::to_string(s * 7 % 100), s));
+                sequences.push_back(make_sequence("\xc3\xa9t\xc3\xa9", 3));
+                write_archive(file, sequences);
+
+                dataset_archive moved(file);
+                const auto archive = std::move(moved);
+                QCOMPARE(moved.size(), static_cast<std::size_t>(0));
+                QCOMPARE(archive.size(), sequences.size());
+                for (std::size_t s = 1; s < archive.size(); ++s)
+                    QVERIFY(archive.at(s - 1).name < archive.at(s).name);
+
+                archived_sequence found;
+                for (const auto& expected : sequences)
+                {
+                    QVERIFY(archive.find(expected.name, found));
+                    QCOMPARE(found.name, expected.name);
+                    QVERIFY(same_boxes(found.ground_truth, expected.ground_truth));
+                    QCOMPARE(found.has_results, expected.has_results);
+                    QVERIFY(same_boxes(found.results, expected.results));
+                    QCOMPARE(reinterpret_cast<std::uintptr_t>(found.ground_truth.data()) % 64, std::uintptr_t(0));
+                }
+                for (const auto missing : {"", "seq", "seq-5x", "seq-99 ", "zzz", "\xff"})
+                    QVERIFY(!archive.find(missing, found));
+            }
+
+            /**
+             * \brief   Verify that damaged archives and duplicate names are rejected.
+             * \throws  None
+             */
+            void test_errors() noexcept
+            {
+                QTemporaryDir directory;
+                const auto file = directory.path().toStdString() + "/data.pack";
+
+                bool thrown = false;
+                try
+                {
+                    write_archive(file, {make_sequence("a", 1), make_sequence("a", 2)});
+                }
+                catch (std::invalid_argument&)
+                {
+                    thrown = true;
+                }
+                QVERIFY(thrown);
+
+                write_archive(file, {});
+                QCOMPARE(dataset_archive(file).size(), static_cast<std::size_t>(0));
+
+                write_archive(file, {make_sequence("a", 40), make_sequence("b", 41)});
+                std::string bytes;
+                {
+                    std::ifstream stream(file, std::ios::binary);
+                    bytes.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+                }
+                const auto damaged = [&file](const std::string& contents) {
+                    std::ofstream(file, std::ios::binary | std::ios::trunc) << contents;
+                    try
+                    {
+                        dataset_archive archive(file);
+                    }
+                    catch (std::runtime_error&)
+                    {
+                        return true;
+                    }
+                    return false;
+                };
+                QVERIFY(damaged(bytes.substr(0, bytes.size() - 64)));
+                QVERIFY(damaged(bytes.substr(0, 10)));
+                QVERIFY(damaged("XXXX" + bytes.substr(4)));
+                auto unsorted = bytes;
+                std::swap(unsorted[unsorted.find("ab")], unsorted[unsorted.find("ab") + 1]);
+                QVERIFY(damaged(unsorted));
+                QVERIFY(!damaged(bytes));
+                QVERIFY(damaged(""));
+            }
+    };
+}
+
+QTEST_MAIN(analyze::archive_test)
+#include "archive_test.moc"
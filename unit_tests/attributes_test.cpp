@@ -0,0 +1,162 @@
+#include <cmath>
+#include <fstream>
+#include <QtTest/QtTest>
+#include "attributes.h"
+
+namespace analyze
+{
+    /// A set of unit tests for attribute breakdowns.
+    class attributes_test final: public QObject
+    {
+        Q_OBJECT
+        public:
+            /**
+             * \brief   Construct a set of attribute unit tests.
+             * \throws  None
+             */
+            attributes_test() = default;
+
+            /**
+             * \brief   Copy a set of attribute unit tests.
+             * \throws  None
+             */
+            attributes_test(const attributes_test&) = default;
+
+            /**
+             * \brief   Move a set of attribute unit tests.
+             * \throws  None
+             */
+            attributes_test(attributes_test&&) = default;
+
+            /**
+             * \brief   Destroy an attribute test.
+             * \throws  None
+             */
+            ~attributes_test() noexcept = default;
+
+            /**
+             * \brief   Copy a set of attribute unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            attributes_test& operator=(const attributes_test&) = default;
+
+            /**
+             * \brief   Move a set of attribute unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            attributes_test& operator=(attributes_test&&) = default;
+
+        private slots:
+            /**
+             * \brief   Verify that one pass gives the same statistics as filtering each attribute.
+             * \throws  None
+             */
+            void test_summarize() noexcept
+            {
+                constexpr std::size_t stride = 5;
+                attribute_table table;
+                table.tag_sequence("IV");
+                std::vector<std::uint8_t> occluded(1000), out(700);
+                for (std::size_t f = 0; f < occluded.size(); ++f)
+                    occluded[f] = (f / 40) % 3 == 0;
+                for (std::size_t f = 0; f < out.size(); ++f)
+                    out[f] = f % 7 == 0;
+                table.tag_frames("full occlusion", occluded);
+                table.tag_frames("out of view", out);
+
+                iou_list ious;
+                for (std::size_t i = 0; i < 200; ++i)
+                    ious.emplace_back(i % 17 == 0 ? std::nanf("") : static_cast<float>((i * 13) % 100) / 100.0f);
+
+                const auto statistics = summarize_attributes(ious, stride, table);
+                QCOMPARE(statistics.size(), std::size_t(3));
+                for (std::size_t a = 0; a < statistics.size(); ++a)
+                {
+                    QCOMPARE(statistics[a].name, table.names()[a]);
+                    std::size_t frames = 0, successes = 0;
+                    double total = 0.0;
+                    for (std::size_t i = 0; i < ious.size(); ++i)
+                    {
+                        const auto v = ious[i].value();
+                        if (std::isnan(v) || ((table.mask(i * stride) >> a) & 1) == 0)
+                            continue;
+                        ++frames;
+                        total += v;
+                        successes += v > 0.5f;
+                    }
+                    QCOMPARE(statistics[a].frames, frames);
+                    QCOMPARE(statistics[a].successes, successes);
+                    QVERIFY(std::fabs(statistics[a].total - total) < 1e-9);
+                }
+                QCOMPARE(statistics[0].frames, std::size_t(200 - 12));
+
+                std::vector<attribute_statistics> pooled;
+                merge_attributes(pooled, statistics);
+                merge_attributes(pooled, std::vector<attribute_statistics>(statistics.rbegin(), statistics.rend()));
+                QCOMPARE(pooled.size(), std::size_t(3));
+                QCOMPARE(pooled[1].frames, 2 * statistics[1].frames);
+            }
+
+            /**
+             * \brief   Verify loading attribute files.
+             * \throws  None
+             */
+            void test_load() noexcept
+            {
+                QTemporaryDir directory;
+                const auto path = directory.path().toStdString();
+                QCOMPARE(load_attributes(path).names().size(), std::size_t(0));
+
+                std::ofstream(path + "/attributes.txt") << "IV,SV OCC\n";
+                std::ofstream(path + "/full_occlusion.txt") << "0,0,1,1,0";
+                std::ofstream(path + "/absence.label") << "0\n1\n0\n";
+                const auto table = load_attributes(path);
+                QCOMPARE(table.names().size(), std::size_t(5));
+                QCOMPARE(table.names()[3], std::string("full occlusion"));
+                QCOMPARE(table.mask(0), attribute_mask(7));
+                QCOMPARE(table.mask(1), attribute_mask(7 | 16));
+                QCOMPARE(table.mask(2), attribute_mask(7 | 8));
+                QCOMPARE(table.mask(100), attribute_mask(7));
+
+                std::ofstream(path + "/out_of_view.txt") << "0,x,1";
+                bool thrown = false;
+                try
+                {
+                    load_attributes(path);
+                }
+                catch (std::runtime_error&)
+                {
+                    thrown = true;
+                }
+                QVERIFY(thrown);
+            }
+
+            /**
+             * \brief   Verify the attribute limit.
+             * \throws  None
+             */
+            void test_limit() noexcept
+            {
+                attribute_table table;
+                for (std::size_t a = 0; a < max_attributes; ++a)
+                    table.tag_sequence(std::to_string(a));
+                table.tag_sequence("0");
+                QCOMPARE(table.mask(0), ~attribute_mask(0));
+                bool thrown = false;
+                try
+                {
+                    table.tag_sequence("one too many");
+                }
+                catch (std::length_error&)
+                {
+                    thrown = true;
+                }
+                QVERIFY(thrown);
+            }
+    };
+}
+
+QTEST_MAIN(analyze::attributes_test)
+#include "attributes_test.moc"
@@ -0,0 +1,123 @@
+#include <cerrno>
+#include <fstream>
+#include <QtTest/QtTest>
+#include "batch_reader.h"
+
+namespace analyze
+{
+    /**
+     * \brief       Make the contents of a test file.
+     * \param[in]   f   The file number.
+     * \return      The file's contents. Every tenth file is larger than one read.
+     * \throws      std::bad_alloc  This is thrown if memory for the contents cannot be allocated.
+     */
+    std::string file_contents(const std::size_t f)
+    {
+        const std::size_t size = f % 10 == 3 ? 150000 + f : f * 7;
+        std::string contents(size, '\0');
+        for (std::size_t c = 0; c < size; ++c)
+            contents[c] = static_cast<char>('a' + (c * 31 + f) % 26);
+        return contents;
+    }
+
+    /// A set of unit tests for batched file reading.
+    class batch_reader_test final: public QObject
+    {
+        Q_OBJECT
+        public:
+            /**
+             * \brief   Construct a set of batch reader unit tests.
+             * \throws  None
+             */
+            batch_reader_test() = default;
+
+            /**
+             * \brief   Copy a set of batch reader unit tests.
+             * \throws  None
+             */
+            batch_reader_test(const batch_reader_test&) = default;
+
+            /**
+             * \brief   Move a set of batch reader unit tests.
+             * \throws  None
+             */
+            batch_reader_test(batch_reader_test&&) = default;
+
+            /**
+             * \brief   Destroy a batch reader test.
+             * \throws  None
+             */
+            ~batch_reader_test() noexcept = default;
+
+            /**
+             * \brief   Copy a set of batch reader unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            batch_reader_test& operator=(const batch_reader_test&) = default;
+
+            /**
+             * \brief   Move a set of batch reader unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            batch_reader_test& operator=(batch_reader_test&&) = default;
+
+        private slots:
+            /**
+             * \brief   Verify that both methods read every file, and report missing files.
+             * \throws  None
+             */
+            void test_read() noexcept
+            {
+                QTemporaryDir directory;
+                const auto root = directory.path().toStdString();
+                std::vector<std::string> paths;
+                for (std::size_t f = 0; f < 300; ++f)
+                {
+                    paths.push_back(root + "/" + std::to_string(f) + ".txt");
+                    if (f != 17)
+                        std::ofstream(paths.back()) << file_contents(f);
+                }
+
+                for (const auto method : {read_method::automatic, read_method::threads})
+                {
+                    batch_reader reader(64, method);
+                    QVERIFY(method == read_method::automatic || reader.method() == read_method::threads);
+
+                    // an abandoned batch must not leak into the next one
+                    reader.start(paths);
+                    file_read read;
+                    QVERIFY(reader.next(read));
+                    reader.start(paths);
+
+                    std::vector<bool> seen(paths.size(), false);
+                    std::size_t count = 0;
+                    while (reader.next(read))
+                    {
+                        QVERIFY(read.index < paths.size());
+                        QVERIFY(!seen[read.index]);
+                        seen[read.index] = true;
+                        ++count;
+                        if (read.index == 17)
+                        {
+                            QCOMPARE(read.error, ENOENT);
+                            QVERIFY(read.bytes.empty());
+                        }
+                        else
+                        {
+                            QCOMPARE(read.error, 0);
+                            QVERIFY(read.bytes == file_contents(read.index));
+                        }
+                    }
+                    QCOMPARE(count, paths.size());
+
+                    reader.start(std::vector<std::string>());
+                    QVERIFY(!reader.next(read));
+                }
+            }
+    };
+}
+
+QTEST_MAIN(analyze::batch_reader_test)
+#include "batch_reader_test.moc"
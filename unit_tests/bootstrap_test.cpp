@@ -0,0 +1,189 @@
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+#include <QtTest/QtTest>
+#include "bootstrap.h"
+
+namespace analyze
+{
+    /**
+     * \brief       Make a list of pseudo random scores.
+     * \param[in]   count   The number of scores.
+     * \param[in]   offset  Added to every score.
+     * \return      The scores, spread over [offset, offset + 0.5).
+     * \throws      std::bad_alloc  This is thrown if memory for the scores cannot be allocated.
+     */
+    std::vector<double> make_scores(const std::size_t count, const double offset)
+    {
+        std::vector<double> scores;
+        for (std::size_t i = 0; i < count; ++i)
+            scores.push_back(offset + static_cast<double>((i * 7919) % 500) / 1000.0);
+        return scores;
+    }
+
+    /// A set of unit tests for the bootstrap.
+    class bootstrap_test final: public QObject
+    {
+        Q_OBJECT
+        public:
+            /**
+             * \brief   Construct a set of bootstrap unit tests.
+             * \throws  None
+             */
+            bootstrap_test() = default;
+
+            /**
+             * \brief   Copy a set of bootstrap unit tests.
+             * \throws  None
+             */
+            bootstrap_test(const bootstrap_test&) = default;
+
+            /**
+             * \brief   Move a set of bootstrap unit tests.
+             * \throws  None
+             */
+            bootstrap_test(bootstrap_test&&) = default;
+
+            /**
+             * \brief   Destroy a bootstrap test.
+             * \throws  None
+             */
+            ~bootstrap_test() noexcept = default;
+
+            /**
+             * \brief   Copy a set of bootstrap unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            bootstrap_test& operator=(const bootstrap_test&) = default;
+
+            /**
+             * \brief   Move a set of bootstrap unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            bootstrap_test& operator=(bootstrap_test&&) = default;
+
+        private slots:
+            /**
+             * \brief   Verify that the interval brackets the mean with roughly the normal width.
+             * \throws  None
+             */
+            void test_mean() noexcept
+            {
+                const auto scores = make_scores(100, 0.25);
+                bootstrap_options options;
+                options.resamples = 4000;
+                const auto interval = bootstrap_mean(scores, options);
+
+                double mean = 0.0, squares = 0.0;
+                for (const auto s : scores)
+                    mean += s / 100.0;
+                for (const auto s : scores)
+                    squares += (s - mean) * (s - mean);
+                const auto error = std::sqrt(squares / 99.0 / 100.0);
+
+                QVERIFY(std::fabs(interval.estimate - mean) < 1e-12);
+                QVERIFY(interval.lower < mean && mean < interval.upper);
+                QVERIFY(std::fabs(interval.standard_error - error) < 0.15 * error);
+                QVERIFY(std::fabs((interval.upper - interval.lower) - 2.0 * 1.96 * error) < 0.3 * error);
+
+                const std::vector<double> constant(10, 0.5);
+                const auto flat = bootstrap_mean(constant, options);
+                QCOMPARE(flat.lower, 0.5);
+                QCOMPARE(flat.upper, 0.5);
+            }
+
+            /**
+             * \brief   Verify that the thread count does not change the result, and the seed does.
+             * \throws  None
+             */
+            void test_reproducible() noexcept
+            {
+                const auto scores = make_scores(500, 0.0);
+                bootstrap_options options;
+                options.resamples    = 2000;
+                options.thread_count = 1;
+                const auto expected = bootstrap_mean(scores, options);
+                for (const unsigned threads : {2u, 3u, 7u, 64u})
+                {
+                    options.thread_count = threads;
+                    const auto interval  = bootstrap_mean(scores, options);
+                    QCOMPARE(interval.lower, expected.lower);
+                    QCOMPARE(interval.upper, expected.upper);
+                    QCOMPARE(interval.standard_error, expected.standard_error);
+                }
+                options.seed = 1;
+                QVERIFY(bootstrap_mean(scores, options).lower != expected.lower);
+            }
+
+            /**
+             * \brief   Verify the paired comparison finds a real difference and not a false one.
+             * \throws  None
+             * \details The sequences vary far more than the trackers differ, so only pairing can
+             *          find the difference.
+             */
+            void test_paired() noexcept
+            {
+                auto first  = make_scores(60, 0.0);
+                auto second = first;
+                for (std::size_t i = 0; i < second.size(); ++i)
+                    second[i] += i % 2 == 0 ? 0.015 : 0.005;
+
+                bootstrap_options options;
+                options.resamples = 5000;
+                const auto better = bootstrap_paired(second, first, options);
+                QVERIFY(std::fabs(better.difference.estimate - 0.01) < 1e-12);
+                QVERIFY(better.difference.lower > 0.0);
+                QVERIFY(better.p_value < 0.001);
+
+                const auto unpaired = bootstrap_mean(second, options);
+                QVERIFY(unpaired.lower < bootstrap_mean(first, options).estimate);
+
+                for (std::size_t i = 0; i < second.size(); ++i)
+                    second[i] = first[i] + (i % 2 == 0 ? 0.01 : -0.01);
+                const auto same = bootstrap_paired(second, first, options);
+                QVERIFY(same.difference.lower < 0.0 && same.difference.upper > 0.0);
+                QVERIFY(same.p_value > 0.5);
+            }
+
+            /**
+             * \brief   Verify that invalid input is rejected.
+             * \throws  None
+             */
+            void test_invalid() noexcept
+            {
+                const auto scores = make_scores(10, 0.0);
+                const auto shorter = make_scores(9, 0.0);
+                bootstrap_options options;
+                const auto rejected = [](const std::function<void()>& f) {
+                    try
+                    {
+                        f();
+                    }
+                    catch (std::invalid_argument&)
+                    {
+                        return true;
+                    }
+                    return false;
+                };
+                QVERIFY(rejected([&] { bootstrap_mean(span<const double>(), options); }));
+                QVERIFY(rejected([&] { bootstrap_paired(scores, shorter, options); }));
+                auto missing = scores;
+                missing[3] = std::nan("");
+                QVERIFY(rejected([&] { bootstrap_mean(missing, options); }));
+                QVERIFY(rejected([&] { bootstrap_paired(scores, missing, options); }));
+                missing[3] = HUGE_VAL;
+                QVERIFY(rejected([&] { bootstrap_mean(missing, options); }));
+                options.confidence = 1.0;
+                QVERIFY(rejected([&] { bootstrap_mean(scores, options); }));
+                options.confidence = 0.9;
+                options.resamples  = 0;
+                QVERIFY(rejected([&] { bootstrap_mean(scores, options); }));
+            }
+    };
+}
+
+QTEST_MAIN(analyze::bootstrap_test)
+#include "bootstrap_test.moc"
@@ -0,0 +1,274 @@
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <QtTest/QtTest>
+#include "analysis.h"
+
+namespace analyze
+{
+    /**
+     * \brief       Write boxes of a moving target in one dialect.
+     * \param[in]   count       The number of boxes.
+     * \param[in]   format      The dialect.
+     * \return      The text of the boxes.
+     * \throws      std::bad_alloc  This is thrown if memory for the text cannot be allocated.
+     * \details     Box \a b has its left edge at 3b mod 400 + 0.5, its top edge at 5b mod 300, and
+     *              a size near 40 by 30.
+     */
+    std::string write_boxes(const std::size_t count, const box_format& format)
+    {
+        const auto delimiter = format.delimiter == box_delimiter::comma ? "," : format.delimiter == box_delimiter::tab ? "\t" : " ";
+        std::ostringstream text;
+        for (std::size_t b = 0; b < count; ++b)
+        {
+            const auto x = static_cast<float>((3 * b) % 400) + 0.5f;
+            const auto y = static_cast<float>((5 * b) % 300);
+            const auto w = 40.0f + static_cast<float>(b % 3);
+            const auto h = 30.0f + static_cast<float>(b % 2);
+            switch (format.convention)
+            {
+                case box_convention::left_width_top_height:
+                    text << x << delimiter << w << delimiter << y << delimiter << h;
+                    break;
+                case box_convention::left_top_width_height:
+                    text << x << delimiter << y << delimiter << w << delimiter << h;
+                    break;
+                case box_convention::corners:
+                    text << x << delimiter << y << delimiter << x + w << delimiter << y + h;
+                    break;
+                case box_convention::polygon:
+                    text << x << delimiter << y << delimiter << x + w << delimiter << y << delimiter << x + w
+                         << delimiter << y + h << delimiter << x << delimiter << y + h;
+                    break;
+            }
+            text << (b % 2 == 0 ? "\n" : "\r\n");
+        }
+        return text.str();
+    }
+
+    /**
+     * \brief       Verify that boxes are those write_boxes() wrote.
+     * \param[in]   boxes   The parsed boxes.
+     * \param[in]   count   The number of boxes written.
+     * \retval      true    The boxes match.
+     * \retval      false   A box is wrong or missing.
+     * \throws      None
+     */
+    bool same_boxes(const box_list& boxes, const std::size_t count) noexcept
+    {
+        if (boxes.size() != count)
+            return false;
+        for (std::size_t b = 0; b < count; ++b)
+        {
+            const auto x = static_cast<float>((3 * b) % 400) + 0.5f;
+            const auto y = static_cast<float>((5 * b) % 300);
+            if (boxes[b].left() != x || boxes[b].top() != y || boxes[b].right() != x + 40.0f + static_cast<float>(b % 3)
+                || boxes[b].bottom() != y + 30.0f + static_cast<float>(b % 2))
+                return false;
+        }
+        return true;
+    }
+
+    /// A set of unit tests for bounding box dialects.
+    class box_format_test final: public QObject
+    {
+        Q_OBJECT
+        public:
+            /**
+             * \brief   Construct a set of box format unit tests.
+             * \throws  None
+             */
+            box_format_test() = default;
+
+            /**
+             * \brief   Copy a set of box format unit tests.
+             * \throws  None
+             */
+            box_format_test(const box_format_test&) = default;
+
+            /**
+             * \brief   Move a set of box format unit tests.
+             * \throws  None
+             */
+            box_format_test(box_format_test&&) = default;
+
+            /**
+             * \brief   Destroy a box format test.
+             * \throws  None
+             */
+            ~box_format_test() noexcept = default;
+
+            /**
+             * \brief   Copy a set of box format unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            box_format_test& operator=(const box_format_test&) = default;
+
+            /**
+             * \brief   Move a set of box format unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            box_format_test& operator=(box_format_test&&) = default;
+
+        private slots:
+            /**
+             * \brief   Verify that every dialect is detected and parsed in its convention.
+             * \throws  None
+             */
+            void test_dialects() noexcept
+            {
+                for (const auto delimiter : {box_delimiter::comma, box_delimiter::tab, box_delimiter::space})
+                {
+                    for (const auto convention : {box_convention::left_width_top_height, box_convention::left_top_width_height,
+                                                  box_convention::corners, box_convention::polygon})
+                    {
+                        const box_format format {delimiter, convention};
+                        const auto text = write_boxes(500, format);
+                        const auto detected = detect_box_format(text.c_str(), text.size(), convention);
+                        QVERIFY(detected.delimiter == delimiter);
+                        QVERIFY(detected.convention == convention);
+                        QVERIFY(same_boxes(parse_results(text, validation_policy::fail, convention), 500));
+                    }
+                }
+
+                // eight values are a polygon whatever the caller's convention
+                const auto polygon = write_boxes(10, box_format {box_delimiter::comma, box_convention::polygon});
+                QVERIFY(same_boxes(parse_results(polygon, validation_policy::fail, box_convention::left_top_width_height), 10));
+            }
+
+            /**
+             * \brief   Verify that the values of a file never change its convention.
+             * \throws  None
+             */
+            void test_convention() noexcept
+            {
+                const std::string empty;
+                QVERIFY(detect_box_format(empty.c_str(), 0).convention == box_convention::left_width_top_height);
+
+                // these values look like x, y, width, and height, but the convention is the caller's
+                const auto text = write_boxes(500, box_format {box_delimiter::comma, box_convention::left_top_width_height});
+                QVERIFY(detect_box_format(text.c_str(), text.size()).convention == box_convention::left_width_top_height);
+                QVERIFY(!same_boxes(parse_results(text), 500));
+
+                const std::string one("10,20,30,40\n");
+                QCOMPARE(parse_results(one).front().right(), 30.0f);
+                QCOMPARE(parse_results(one, validation_policy::fail, box_convention::left_top_width_height).front().right(), 40.0f);
+                QCOMPARE(parse_results(one, validation_policy::fail, box_convention::corners).front().right(), 30.0f);
+                QCOMPARE(parse_results(one, validation_policy::fail, box_convention::corners).front().bottom(), 40.0f);
+
+                QVERIFY(parse_box_convention("lwth") == box_convention::left_width_top_height);
+                QVERIFY(parse_box_convention("xywh") == box_convention::left_top_width_height);
+                QVERIFY(parse_box_convention("xyxy") == box_convention::corners);
+                QVERIFY_EXCEPTION_THROWN(parse_box_convention("ltrb"), std::invalid_argument);
+            }
+
+            /**
+             * \brief   Verify that files are parsed across chunks, and that a malformed line is found.
+             * \throws  None
+             */
+            void test_reader() noexcept
+            {
+                QTemporaryDir directory;
+                const auto file = directory.path().toStdString() + "/r.boxes";
+                const box_format format {box_delimiter::tab, box_convention::left_top_width_height};
+                const auto text = write_boxes(20000, format);
+                std::ofstream(file) << text << "\n\n1\t2\n3\t4\t5\t6\n";
+                QVERIFY(text.size() > 4 * (1 << 16));
+
+                // the blank lines count, so the short line is line 20003
+                try
+                {
+                    load_results(file, validation_policy::fail, format.convention);
+                    QFAIL("a line with two values was accepted");
+                }
+                catch (std::runtime_error& e)
+                {
+                    QVERIFY(std::string(e.what()).find("line 20003: expected 4 numbers") != std::string::npos);
+                }
+                QVERIFY(same_boxes(load_results(file, validation_policy::none, format.convention), 20000));
+
+                box_reader reader(file, validation_policy::skip, format.convention);
+                box_list boxes;
+                while (reader.read(boxes, 777) == 777)
+                    ;
+                QCOMPARE(boxes.size(), std::size_t(20001));
+                boxes.pop_back();
+                QVERIFY(same_boxes(boxes, 20000));
+                QCOMPARE(reader.status().line, std::size_t(20004));
+                QCOMPARE(reader.status().skipped, std::size_t(1));
+
+                // forcing the wrong dialect gives different boxes
+                box_reader forced(file, box_format {box_delimiter::tab, box_convention::corners}, validation_policy::none);
+                boxes.clear();
+                QCOMPARE(forced.read(boxes, 100), std::size_t(100));
+                QVERIFY(!same_boxes(boxes, 100));
+
+                // only the comma dialect accepts commas, so one in a space separated file is invalid
+                QCOMPARE(parse_results("1 2 3 4\n5,6 7 8\n", validation_policy::none).size(), std::size_t(1));
+                QVERIFY_EXCEPTION_THROWN(parse_results("1 2 3 4\n5,6 7 8\n"), std::runtime_error);
+            }
+
+            /**
+             * \brief   Verify what each policy does with each kind of invalid line.
+             * \throws  None
+             */
+            void test_validation() noexcept
+            {
+                const std::string bad_lines[] = {"1,2,3\n",          // too few values
+                                                 "1,2,3,4,5\n",      // too many values
+                                                 "1,2,3,4 x\n",      // trailing text
+                                                 "nan,2,3,4\n",      // not a number
+                                                 "1,inf,3,4\n",      // infinite
+                                                 "1,2,3,-4\n"};      // negative height
+                for (std::size_t b = 0; b < 6; ++b)
+                {
+                    const auto text = "10,20,30,40\n\n" + bad_lines[b] + "5,6,7,8\n";
+                    try
+                    {
+                        parse_results(text);
+                        QFAIL(bad_lines[b].c_str());
+                    }
+                    catch (std::runtime_error& e)
+                    {
+                        QVERIFY(std::string(e.what()).compare(0, 8, "line 3: ") == 0);
+                    }
+
+                    const auto skipped = parse_results(text, validation_policy::skip);
+                    QCOMPARE(skipped.size(), std::size_t(2));
+                    QCOMPARE(skipped[1].left(), 5.0f);
+
+                    // clamping repairs values, but cannot invent or drop them
+                    if (b < 3)
+                        QVERIFY_EXCEPTION_THROWN(parse_results(text, validation_policy::clamp), std::runtime_error);
+                    else
+                        QCOMPARE(parse_results(text, validation_policy::clamp).size(), std::size_t(3));
+                }
+
+                const auto clamped = parse_results("nan,2,3,-4\n", validation_policy::clamp);
+                QCOMPARE(clamped.front().left(), 0.0f);
+                QCOMPARE(clamped.front().right(), 2.0f);
+                QCOMPARE(clamped.front().top(), 3.0f);
+                QCOMPARE(clamped.front().bottom(), 3.0f);
+
+                // corners are invalid when the second corner is left of or above the first
+                const auto corners = select_box_parser(box_format {box_delimiter::comma, box_convention::corners},
+                                                       validation_policy::clamp);
+                const std::string inverted("10,20,5,30\n");
+                const char* p = inverted.c_str();
+                box_list boxes;
+                parse_status status;
+                status.policy = validation_policy::clamp;
+                QCOMPARE(corners(p, inverted.c_str() + inverted.size(), boxes, 10, status), std::size_t(1));
+                QCOMPARE(status.clamped, std::size_t(1));
+                QCOMPARE(boxes.front().right(), 10.0f);
+
+                QVERIFY(parse_validation_policy("skip") == validation_policy::skip);
+                QVERIFY_EXCEPTION_THROWN(parse_validation_policy("ignore"), std::invalid_argument);
+            }
+    };
+}
+
+QTEST_MAIN(analyze::box_format_test)
+#include "box_format_test.moc"
@@ -0,0 +1,181 @@
+#include <fstream>
+#include <QtTest/QtTest>
+#include "chunked.h"
+#include "test_helpers.h"
+
+namespace analyze
+{
+    /**
+     * \brief       Write a box file with pseudo random boxes.
+     * \param[in]   file_name   The file to write.
+     * \param[in]   count       The number of boxes.
+     * \param[in]   seed        Varies the boxes.
+     * \throws      None
+     * \details     The first box has no area, so its IoU is not a number.
+     */
+    void make_boxes(const std::string& file_name, const std::size_t count, const std::size_t seed)
+    {
+        std::ofstream file(file_name);
+        for (std::size_t b = 0; b < count; ++b)
+        {
+            const auto size = b == 0 ? 0 : 20 + (b * seed) % 37;
+            file << (b * 7 + seed) % 300 << '.' << b % 4 << ',' << size << ','
+                 << (b * 11 + seed) % 200 << ',' << size << '\n';
+        }
+    }
+
+    /// A set of unit tests for chunked evaluation.
+    class chunked_test final: public QObject
+    {
+        Q_OBJECT
+        public:
+            /**
+             * \brief   Construct a set of chunked evaluation unit tests.
+             * \throws  None
+             */
+            chunked_test() = default;
+
+            /**
+             * \brief   Copy a set of chunked evaluation unit tests.
+             * \throws  None
+             */
+            chunked_test(const chunked_test&) = default;
+
+            /**
+             * \brief   Move a set of chunked evaluation unit tests.
+             * \throws  None
+             */
+            chunked_test(chunked_test&&) = default;
+
+            /**
+             * \brief   Destroy a chunked evaluation test.
+             * \throws  None
+             */
+            ~chunked_test() noexcept = default;
+
+            /**
+             * \brief   Copy a set of chunked evaluation unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            chunked_test& operator=(const chunked_test&) = default;
+
+            /**
+             * \brief   Move a set of chunked evaluation unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            chunked_test& operator=(chunked_test&&) = default;
+
+        private slots:
+            /**
+             * \brief   Verify that every window size gives exactly the in-memory output.
+             * \throws  None
+             */
+            void test_matches_in_memory() noexcept
+            {
+                QTemporaryDir directory;
+                const auto path = directory.path().toStdString();
+                for (const auto& lengths : {std::make_pair(1003, 1003), std::make_pair(1003, 877), std::make_pair(12, 40),
+                                           std::make_pair(0, 5), std::make_pair(12000, 11003)})
+                {
+                    make_boxes(path + "/r.boxes", lengths.first, 3);
+                    make_boxes(path + "/t.boxes", lengths.second, 5);
+                    const auto ious = calculate_ious(load_results(path + "/r.boxes"), load_results(path + "/t.boxes"));
+                    write_ious(ious, path + "/expected.ious");
+                    const auto expected = summarize(ious);
+
+                    for (const std::size_t chunk : {0, 1, 4, 5, 7, 100, 1003, 100000})
+                    {
+                        const auto outcome = evaluate_chunked(path + "/r.boxes", path + "/t.boxes", path + "/chunked.ious", chunk);
+                        QCOMPARE(read_file(path + "/chunked.ious"), read_file(path + "/expected.ious"));
+                        QCOMPARE(outcome.summary.count, expected.count);
+                        QVERIFY(same_value(outcome.summary.minimum, expected.minimum));
+                        QVERIFY(same_value(outcome.summary.maximum, expected.maximum));
+                        QVERIFY(same_value(outcome.summary.average, expected.average));
+                        QCOMPARE(outcome.results_count, static_cast<std::size_t>(lengths.first));
+                        QCOMPARE(outcome.truth_count, static_cast<std::size_t>(lengths.second));
+                    }
+                }
+            }
+
+            /**
+             * \brief   Verify that invalid lines are handled as the validation policy says.
+             * \throws  None
+             */
+            void test_policy() noexcept
+            {
+                QTemporaryDir directory;
+                const auto path = directory.path().toStdString();
+                make_boxes(path + "/t.boxes", 40, 5);
+                make_boxes(path + "/r.boxes", 40, 3);
+                std::ofstream(path + "/r.boxes", std::ios::app) << "1,-4,2,4\n";
+                make_boxes(path + "/valid.boxes", 20, 7);
+                write_file(path + "/r.boxes", read_file(path + "/r.boxes") + read_file(path + "/valid.boxes"));
+
+                for (const auto policy : {validation_policy::skip, validation_policy::clamp})
+                {
+                    const auto ious = calculate_ious(load_results(path + "/r.boxes", policy), load_results(path + "/t.boxes"));
+                    write_ious(ious, path + "/expected.ious");
+                    for (const std::size_t chunk : {5, 7, 100})
+                    {
+                        const auto outcome = evaluate_chunked(path + "/r.boxes", path + "/t.boxes", path + "/chunked.ious", chunk,
+                                                              box_convention::left_width_top_height, policy);
+                        QCOMPARE(read_file(path + "/chunked.ious"), read_file(path + "/expected.ious"));
+                        QCOMPARE(outcome.results_count, policy == validation_policy::skip ? std::size_t(60) : std::size_t(61));
+                    }
+                }
+
+                bool thrown = false;
+                try
+                {
+                    evaluate_chunked(path + "/r.boxes", path + "/t.boxes", path + "/chunked.ious", 100);
+                }
+                catch (std::runtime_error&)
+                {
+                    thrown = true;
+                }
+                QVERIFY(thrown);
+            }
+
+            /**
+             * \brief   Verify that a box reader returns the same boxes a window at a time.
+             * \throws  None
+             */
+            void test_box_reader() noexcept
+            {
+                QTemporaryDir directory;
+                const auto file = directory.path().toStdString() + "/r.boxes";
+                make_boxes(file, 23, 9);
+                const auto expected = load_results(file);
+
+                box_reader reader(file);
+                box_list boxes;
+                QCOMPARE(reader.read(boxes, 10), static_cast<std::size_t>(10));
+                auto moved = std::move(reader);
+                QCOMPARE(moved.read(boxes, 10), static_cast<std::size_t>(10));
+                QCOMPARE(moved.read(boxes, 10), static_cast<std::size_t>(3));
+                QCOMPARE(moved.read(boxes, 10), static_cast<std::size_t>(0));
+                QCOMPARE(boxes.size(), expected.size());
+                for (std::size_t b = 0; b < boxes.size(); ++b)
+                {
+                    QCOMPARE(boxes[b].left(), expected[b].left());
+                    QCOMPARE(boxes[b].bottom(), expected[b].bottom());
+                }
+
+                bool thrown = false;
+                try
+                {
+                    box_reader missing(file + ".missing");
+                }
+                catch (std::runtime_error&)
+                {
+                    thrown = true;
+                }
+                QVERIFY(thrown);
+            }
+    };
+}
+
+QTEST_MAIN(analyze::chunked_test)
+#include "chunked_test.moc"
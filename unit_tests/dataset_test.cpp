@@ -0,0 +1,212 @@
+#include <atomic>
+#include <stdexcept>
+#include <QtTest/QtTest>
+#include "dataset.h"
+#include "test_helpers.h"
+
+namespace analyze
+{
+    /// A set of unit tests for dataset manifests and prefetching.
+    class dataset_test final: public QObject
+    {
+        Q_OBJECT
+        public:
+            /**
+             * \brief   Construct a set of dataset unit tests.
+             * \throws  None
+             */
+            dataset_test() = default;
+
+            /**
+             * \brief   Copy a set of dataset unit tests.
+             * \throws  None
+             */
+            dataset_test(const dataset_test&) = default;
+
+            /**
+             * \brief   Move a set of dataset unit tests.
+             * \throws  None
+             */
+            dataset_test(dataset_test&&) = default;
+
+            /**
+             * \brief   Destroy a dataset test.
+             * \throws  None
+             */
+            ~dataset_test() noexcept = default;
+
+            /**
+             * \brief   Copy a set of dataset unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            dataset_test& operator=(const dataset_test&) = default;
+
+            /**
+             * \brief   Move a set of dataset unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            dataset_test& operator=(dataset_test&&) = default;
+
+        private slots:
+            /**
+             * \brief   Verify the ground truth path of each layout.
+             * \throws  None
+             */
+            void test_paths() noexcept
+            {
+                QCOMPARE(ground_truth_path(parse_layout("struck"), "/d", "girl"), std::string("/d/girl/girl_gt.txt"));
+                QCOMPARE(ground_truth_path(parse_layout("otb"), "/d", "Basketball"),
+                         std::string("/d/Basketball/groundtruth_rect.txt"));
+                QCOMPARE(ground_truth_path(parse_layout("lasot"), "/d", "airplane-13"),
+                         std::string("/d/airplane/airplane-13/groundtruth.txt"));
+                QCOMPARE(ground_truth_path(parse_layout("got10k"), "/d", "GOT-10k_Val_000001"),
+                         std::string("/d/GOT-10k_Val_000001/groundtruth.txt"));
+                QCOMPARE(ground_truth_path(parse_layout("trackingnet"), "/d", "a1b2"), std::string("/d/anno/a1b2.txt"));
+
+                bool thrown = false;
+                try
+                {
+                    parse_layout("vot");
+                }
+                catch (std::invalid_argument&)
+                {
+                    thrown = true;
+                }
+                QVERIFY(thrown);
+
+                dataset_manifest manifest(dataset_layout::otb, "/d", "runs/a");
+                manifest.add("Car");
+                QCOMPARE(manifest.sequences()[0].results, std::string("runs/a/Car.boxes"));
+                QCOMPARE(manifest.sequences()[0].output, std::string("runs/a/Car.ious"));
+            }
+
+            /**
+             * \brief   Verify that sequences are discovered, and manifests are read.
+             * \throws  None
+             */
+            void test_manifest() noexcept
+            {
+                QTemporaryDir directory;
+                const auto root = directory.path().toStdString();
+                QVERIFY(make_file(root, "lasot/cat/cat-2/groundtruth.txt", ""));
+                QVERIFY(make_file(root, "lasot/cat/cat-1/groundtruth.txt", ""));
+                QVERIFY(make_file(root, "lasot/bird/bird-1/groundtruth.txt", ""));
+                QVERIFY(make_file(root, "lasot/bird/bird-9/readme.txt", ""));
+                QVERIFY(make_file(root, "tn/anno/b.txt", ""));
+                QVERIFY(make_file(root, "tn/anno/a.txt", ""));
+
+                dataset_manifest lasot(dataset_layout::lasot, root + "/lasot", "");
+                lasot.discover();
+                QCOMPARE(lasot.sequences().size(), static_cast<std::size_t>(3));
+                QCOMPARE(lasot.sequences()[0].name, std::string("bird-1"));
+                QCOMPARE(lasot.sequences()[2].name, std::string("cat-2"));
+                QVERIFY(lasot.sequences()[0].convention == box_convention::left_top_width_height);
+                QVERIFY(dataset_manifest(dataset_layout::struck, root, "").convention() == box_convention::left_width_top_height);
+
+                QVERIFY(make_file(root, "all.manifest", "# every sequence\nlayout trackingnet\nroot " + root + "/tn\n"));
+                const auto all = load_manifest(root + "/all.manifest");
+                QCOMPARE(all.sequences().size(), static_cast<std::size_t>(2));
+                QCOMPARE(all.sequences()[1].ground_truth, root + "/tn/anno/b.txt");
+
+                QVERIFY(make_file(root, "some.manifest", "layout lasot\nroot /x\nresults out\n\nsequence cat-2\n"));
+                const auto some = load_manifest(root + "/some.manifest");
+                QCOMPARE(some.sequences().size(), static_cast<std::size_t>(1));
+                QCOMPARE(some.sequences()[0].results, std::string("out/cat-2.boxes"));
+
+                QVERIFY(make_file(root, "packed.manifest", "layout got10k\nroot /x\nresults out\nextension .boxes.gz\nsequence v\n"));
+                const auto packed = load_manifest(root + "/packed.manifest");
+                QCOMPARE(packed.sequences()[0].results, std::string("out/v.boxes.gz"));
+                QCOMPARE(packed.sequences()[0].output, std::string("out/v.ious"));
+
+                QVERIFY(make_file(root, "native.manifest", "layout otb\nroot /x\nsequence v\nconvention lwth\n"));
+                QVERIFY(load_manifest(root + "/native.manifest").sequences()[0].convention == box_convention::left_width_top_height);
+
+                for (const auto& bad : {"layout lasot\n", "layout lasot\nroot /x\ncolour red\n", "layout vot\nroot /x\n",
+                                        "layout otb\nroot /x\nconvention ltrb\n"})
+                {
+                    QVERIFY(make_file(root, "bad.manifest", bad));
+                    bool thrown = false;
+                    try
+                    {
+                        load_manifest(root + "/bad.manifest");
+                    }
+                    catch (std::runtime_error&)
+                    {
+                        thrown = true;
+                    }
+                    QVERIFY(thrown);
+                }
+            }
+
+            /**
+             * \brief   Verify that prefetched sequences arrive in order, with their errors.
+             * \throws  None
+             */
+            void test_prefetcher() noexcept
+            {
+                QTemporaryDir directory;
+                const auto root = directory.path().toStdString();
+                dataset_manifest manifest(dataset_layout::struck, root, root);
+                for (std::size_t s = 0; s < 20; ++s)
+                {
+                    const auto name = "s" + std::to_string(s);
+                    manifest.add(name);
+                    if (s == 7)
+                        continue;
+                    std::string boxes;
+                    for (std::size_t b = 0; b <= s; ++b)
+                        boxes += "1,2,3,4\n";
+                    QVERIFY(make_file(root, name + ".boxes", boxes));
+                    QVERIFY(make_file(root, name + "/" + name + "_gt.txt", "1,2,3,4\n"));
+                }
+
+                for (const std::size_t depth : {1, 3, 64})
+                {
+                    const auto method = depth == 3 ? read_method::threads : read_method::automatic;
+                    sequence_prefetcher prefetcher(manifest.sequences(), depth, 3, method);
+                    loaded_sequence sequence;
+                    std::size_t count = 0;
+                    while (prefetcher.next(sequence))
+                    {
+                        QVERIFY(sequence.paths == &manifest.sequences()[count]);
+                        QCOMPARE(sequence.error.empty(), count != 7);
+                        QCOMPARE(sequence.results.size(), count == 7 ? 0 : count + 1);
+                        QCOMPARE(sequence.ground_truth.size(), static_cast<std::size_t>(count == 7 ? 0 : 1));
+                        ++count;
+                    }
+                    QCOMPARE(count, static_cast<std::size_t>(20));
+                }
+
+                // sequences the check accepts are hashed, but not parsed
+                std::atomic<std::size_t> checks(0);
+                const stored_check odd = [&checks](const sequence_paths& paths, const store_key& results, const store_key& truth) {
+                    ++checks;
+                    const auto hashes = make_store_key(results, truth, "");
+                    return (paths.name.back() - '0') % 2 == 1 && !(hashes == store_key());
+                };
+                {
+                    sequence_prefetcher checked(manifest.sequences(), 4, 2, read_method::threads, validation_policy::fail, odd);
+                    loaded_sequence sequence;
+                    for (std::size_t count = 0; checked.next(sequence); ++count)
+                    {
+                        QCOMPARE(sequence.error.empty(), count != 7);
+                        QCOMPARE(sequence.stored, count != 7 && count % 2 == 1);
+                        QCOMPARE(sequence.results.empty(), count == 7 || count % 2 == 1);
+                        if (count == 3)
+                            QVERIFY(sequence.results_hash == hash_file(root + "/s3.boxes"));
+                    }
+                }
+                QCOMPARE(checks.load(), static_cast<std::size_t>(19));
+
+                // stopping early must not wait for the rest of the sequences
+                sequence_prefetcher prefetcher(manifest.sequences(), 2, 2);
+                loaded_sequence sequence;
+                QVERIFY(prefetcher.next(sequence));
+            }
+    };
+}
+
+QTEST_MAIN(analyze::dataset_test)
+#include "dataset_test.moc"
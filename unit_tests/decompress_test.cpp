@@ -0,0 +1,204 @@
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <zlib.h>
+#include <QtTest/QtTest>
+#include "analysis.h"
+#include "decompress.h"
+#include "test_helpers.h"
+
+namespace analyze
+{
+    /**
+     * \brief       Compress data into one gzip member.
+     * \param[in]   text    The data to compress.
+     * \return      The gzip member.
+     * \throws      std::runtime_error  This is thrown if zlib fails.
+     */
+    std::string gzip(const std::string& text)
+    {
+        z_stream stream;
+        std::memset(&stream, 0, sizeof(stream));
+        if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+            throw std::runtime_error("deflateInit2 failed");
+        std::string compressed(deflateBound(&stream, static_cast<uLong>(text.size())), '\0');
+        stream.next_in   = reinterpret_cast<Bytef*>(const_cast<char*>(text.data()));
+        stream.avail_in  = static_cast<uInt>(text.size());
+        stream.next_out  = reinterpret_cast<Bytef*>(&compressed[0]);
+        stream.avail_out = static_cast<uInt>(compressed.size());
+        const int status = deflate(&stream, Z_FINISH);
+        compressed.resize(stream.total_out);
+        deflateEnd(&stream);
+        if (status != Z_STREAM_END)
+            throw std::runtime_error("deflate failed");
+        return compressed;
+    }
+
+    /**
+     * \brief       Make the text of a long box file.
+     * \param[in]   count   The number of boxes.
+     * \return      The text.
+     * \throws      std::bad_alloc  This is thrown if memory for the text cannot be allocated.
+     */
+    std::string box_text(const std::size_t count)
+    {
+        std::ostringstream text;
+        for (std::size_t b = 0; b < count; ++b)
+            text << b % 641 << ',' << b * 7 % 103 << '.' << b % 10 << ',' << b * 13 % 487 << ',' << 20 + b % 37 << '\n';
+        return text.str();
+    }
+
+    /**
+     * \brief       Read all the text from a decompressing buffer.
+     * \param[in]   buffer  The buffer.
+     * \return      The text.
+     * \throws      std::runtime_error  This is thrown if the data is corrupt or truncated.
+     */
+    std::string read_all(decompressing_buffer& buffer)
+    {
+        std::istream stream(&buffer);
+        stream.exceptions(std::ios::badbit);
+        std::ostringstream text;
+        text << stream.rdbuf();
+        return text.str();
+    }
+
+    /// A set of unit tests for decompressing box files.
+    class decompress_test final: public QObject
+    {
+        Q_OBJECT
+        public:
+            /**
+             * \brief   Construct a set of decompression unit tests.
+             * \throws  None
+             */
+            decompress_test() = default;
+
+            /**
+             * \brief   Copy a set of decompression unit tests.
+             * \throws  None
+             */
+            decompress_test(const decompress_test&) = default;
+
+            /**
+             * \brief   Move a set of decompression unit tests.
+             * \throws  None
+             */
+            decompress_test(decompress_test&&) = default;
+
+            /**
+             * \brief   Destroy a decompression test.
+             * \throws  None
+             */
+            ~decompress_test() noexcept = default;
+
+            /**
+             * \brief   Copy a set of decompression unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            decompress_test& operator=(const decompress_test&) = default;
+
+            /**
+             * \brief   Move a set of decompression unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            decompress_test& operator=(decompress_test&&) = default;
+
+        private slots:
+            /**
+             * \brief   Verify that formats are recognized by their magic numbers.
+             * \throws  None
+             */
+            void test_detect() noexcept
+            {
+                QCOMPARE(detect_compression("\x1f\x8b\x08\x00", 4), compression::gzip);
+                QCOMPARE(detect_compression("\x28\xb5\x2f\xfd", 4), compression::zstd);
+                QCOMPARE(detect_compression("\x28\xb5\x2f", 3), compression::none);
+                QCOMPARE(detect_compression("1,2,3,4", 7), compression::none);
+                QCOMPARE(detect_compression("\x1f", 1), compression::none);
+                QCOMPARE(detect_compression("", 0), compression::none);
+            }
+
+            /**
+             * \brief   Verify that gzip data decodes to the original text, from a stream and from
+             *          memory, across many chunks and concatenated members.
+             * \throws  None
+             */
+            void test_gzip() noexcept
+            {
+                const auto first  = box_text(200000);
+                const auto second = box_text(3);
+                const auto data   = gzip(first) + gzip(second);
+                QVERIFY(data.size() > 256 * 1024);
+
+                std::istringstream source(data);
+                decompressing_buffer streamed(source, compression::gzip);
+                QCOMPARE(read_all(streamed), first + second);
+
+                decompressing_buffer mapped(data.data(), data.size(), compression::gzip);
+                QCOMPARE(read_all(mapped), first + second);
+            }
+
+            /**
+             * \brief   Verify that compressed box files parse the same as plain ones.
+             * \throws  None
+             */
+            void test_load_results() noexcept
+            {
+                QTemporaryDir directory;
+                const auto plain      = directory.path().toStdString() + "/a.boxes";
+                const auto compressed = directory.path().toStdString() + "/a.boxes.gz";
+                const auto text       = box_text(50000);
+                std::ofstream(plain) << text;
+                std::ofstream(compressed, std::ios::binary) << gzip(text);
+
+                const auto expected = load_results(plain);
+                QCOMPARE(expected.size(), static_cast<std::size_t>(50000));
+                QVERIFY(same_boxes(load_results(compressed), expected));
+                QVERIFY(same_boxes(parse_results(gzip(text)), expected));
+            }
+
+            /**
+             * \brief   Verify that truncated and corrupt data is reported.
+             * \throws  None
+             */
+            void test_errors() noexcept
+            {
+                QTemporaryDir directory;
+                const auto file = directory.path().toStdString() + "/bad.boxes";
+                const auto data = gzip(box_text(1000));
+
+                std::ofstream(file, std::ios::binary) << data.substr(0, data.size() / 2);
+                bool thrown = false;
+                try
+                {
+                    load_results(file);
+                }
+                catch (std::runtime_error& e)
+                {
+                    thrown = std::string(e.what()).find(file) != std::string::npos;
+                }
+                QVERIFY(thrown);
+
+                auto corrupt = data;
+                for (std::size_t c = 20; c < 60; ++c)
+                    corrupt[c] = static_cast<char>(~corrupt[c]);
+                thrown = false;
+                try
+                {
+                    parse_results(corrupt);
+                }
+                catch (std::runtime_error&)
+                {
+                    thrown = true;
+                }
+                QVERIFY(thrown);
+            }
+    };
+}
+
+QTEST_MAIN(analyze::decompress_test)
+#include "decompress_test.moc"
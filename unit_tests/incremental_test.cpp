@@ -0,0 +1,170 @@
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <unistd.h>
+#include <QtTest/QtTest>
+#include "incremental.h"
+#include "test_helpers.h"
+
+namespace analyze
+{
+    /// A set of unit tests for incremental re-evaluation.
+    class incremental_test final: public QObject
+    {
+        Q_OBJECT
+        public:
+            /**
+             * \brief   Construct a set of incremental unit tests.
+             * \throws  None
+             */
+            incremental_test() = default;
+
+            /**
+             * \brief   Copy a set of incremental unit tests.
+             * \throws  None
+             */
+            incremental_test(const incremental_test&) = default;
+
+            /**
+             * \brief   Move a set of incremental unit tests.
+             * \throws  None
+             */
+            incremental_test(incremental_test&&) = default;
+
+            /**
+             * \brief   Destroy an incremental test.
+             * \throws  None
+             */
+            ~incremental_test() noexcept = default;
+
+            /**
+             * \brief   Copy a set of incremental unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            incremental_test& operator=(const incremental_test&) = default;
+
+            /**
+             * \brief   Move a set of incremental unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            incremental_test& operator=(incremental_test&&) = default;
+
+        private slots:
+            /**
+             * \brief   Verify that appends, partial lines, edits, and replacements are followed.
+             * \throws  None
+             */
+            void test_follower() noexcept
+            {
+                QTemporaryDir directory;
+                const auto file_name = directory.path().toStdString() + "/a.boxes";
+                box_follower follower(file_name);
+                QCOMPARE(follower.update(), box_follower::unchanged);
+
+                write_file(file_name, "1,2,3,4\n5,6,7,8\n9,1");
+                QCOMPARE(follower.update(), static_cast<std::size_t>(0));
+                QCOMPARE(follower.boxes().size(), static_cast<std::size_t>(2));
+                QCOMPARE(follower.update(), box_follower::unchanged);
+
+                // finish the partial line and append another
+                {
+                    std::ofstream file(file_name, std::ios::app);
+                    file << "0,1,1\n\n2,2,2,2\n";
+                }
+                QCOMPARE(follower.update(), static_cast<std::size_t>(2));
+                QVERIFY(same_boxes(follower.boxes(), load_results(file_name)));
+
+                // edit the second line in place
+                write_file(file_name, "1,2,3,4\n5,6,7,9\n90,10,1,1\n\n2,2,2,2\n3,3,3,3\n");
+                QCOMPARE(follower.update(), static_cast<std::size_t>(1));
+                QVERIFY(same_boxes(follower.boxes(), load_results(file_name)));
+
+                // replace the file, as an editor does
+                const auto replacement = file_name + ".new";
+                write_file(replacement, "1,2,3,4\n5,6,7,9\n");
+                QCOMPARE(std::rename(replacement.c_str(), file_name.c_str()), 0);
+                QCOMPARE(follower.update(), static_cast<std::size_t>(2));
+                QVERIFY(same_boxes(follower.boxes(), load_results(file_name)));
+
+                // rewrite an earlier line in place while the file grows and its last line stays
+                write_file(file_name, "9,2,3,4\n5,6,7,9\n7,7,7,7\n");
+                QCOMPARE(follower.update(), static_cast<std::size_t>(0));
+                QVERIFY(same_boxes(follower.boxes(), load_results(file_name)));
+                write_file(file_name, "1,2,3,4\n5,6,7,9\n");
+                QCOMPARE(follower.update(), static_cast<std::size_t>(0));
+                QVERIFY(same_boxes(follower.boxes(), load_results(file_name)));
+
+                // a malformed line ends the data until it is fixed
+                write_file(file_name, "1,2,3,4\nbad\n5,6,7,8\n");
+                QCOMPARE(follower.update(), static_cast<std::size_t>(1));
+                QCOMPARE(follower.boxes().size(), static_cast<std::size_t>(1));
+
+                std::remove(file_name.c_str());
+                QCOMPARE(follower.update(), static_cast<std::size_t>(0));
+                QVERIFY(follower.boxes().empty());
+            }
+
+            /**
+             * \brief   Verify that the series and file always match a full recalculation.
+             * \throws  None
+             */
+            void test_ious() noexcept
+            {
+                QTemporaryDir directory;
+                const auto file_name = directory.path().toStdString() + "/a.ious";
+                const auto reference = directory.path().toStdString() + "/b.ious";
+                incremental_ious ious(file_name, iou_stride);
+
+                std::mt19937 engine(5);
+                std::uniform_real_distribution<float> position(0.0f, 20.0f);
+                std::uniform_int_distribution<int> edit(0, 2);
+                const auto random_box = [&]() {
+                    const auto x = position(engine), y = position(engine);
+                    return bounding_box<float>(x, x + 10.0f, y, y + 10.0f);
+                };
+
+                box_list results, truth;
+                for (int step = 0; step < 60; ++step)
+                {
+                    std::size_t first = results.size();
+                    switch (edit(engine))
+                    {
+                        case 0: // append to both
+                            for (int b = 0; b < 7; ++b)
+                            {
+                                results.push_back(random_box());
+                                truth.push_back(random_box());
+                            }
+                            first = std::min(results.size(), truth.size()) - 7;
+                            break;
+                        case 1: // change one result
+                            if (!results.empty())
+                            {
+                                first = std::uniform_int_distribution<std::size_t>(0, results.size() - 1)(engine);
+                                results[first] = random_box();
+                            }
+                            break;
+                        default: // drop some ground truth
+                            first = truth.size() / 2;
+                            truth.resize(first);
+                            break;
+                    }
+
+                    ious.update(results, truth, first);
+                    const auto expected = calculate_ious(results, truth);
+                    write_ious(expected, reference);
+                    QCOMPARE(ious.ious().size(), expected.size());
+                    QVERIFY(read_file(file_name) == read_file(reference));
+                    QVERIFY(!std::ifstream(file_name + ".tmp." + std::to_string(getpid())));
+                    const auto summary = summarize(expected);
+                    QCOMPARE(ious.summary().count, summary.count);
+                    QVERIFY(ious.summary().average == summary.average);
+                }
+            }
+    };
+}
+
+QTEST_MAIN(analyze::incremental_test)
+#include "incremental_test.moc"
@@ -0,0 +1,157 @@
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <QtTest/QtTest>
+#include "analyze_c.h"
+#include "iou_file.h"
+#include "test_helpers.h"
+
+namespace analyze
+{
+    /**
+     * \brief       Make a test IoU series.
+     * \param[in]   count   The number of values.
+     * \return      The series.
+     * \throws      std::bad_alloc  This is thrown if memory for the values cannot be allocated.
+     */
+    iou_list make_ious(const std::size_t count)
+    {
+        iou_list ious(count);
+        for (std::size_t i = 0; i < count; ++i)
+            ious[i] = static_cast<float>(i % 7) / 7.0f + static_cast<float>(i) * 1e-7f;
+        return ious;
+    }
+
+    /// A set of unit tests for binary IoU files.
+    class iou_file_test final: public QObject
+    {
+        Q_OBJECT
+        public:
+            /**
+             * \brief   Construct a set of binary IoU file unit tests.
+             * \throws  None
+             */
+            iou_file_test() = default;
+
+            /**
+             * \brief   Copy a set of binary IoU file unit tests.
+             * \throws  None
+             */
+            iou_file_test(const iou_file_test&) = default;
+
+            /**
+             * \brief   Move a set of binary IoU file unit tests.
+             * \throws  None
+             */
+            iou_file_test(iou_file_test&&) = default;
+
+            /**
+             * \brief   Destroy a binary IoU file test.
+             * \throws  None
+             */
+            ~iou_file_test() noexcept = default;
+
+            /**
+             * \brief   Copy a set of binary IoU file unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            iou_file_test& operator=(const iou_file_test&) = default;
+
+            /**
+             * \brief   Move a set of binary IoU file unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            iou_file_test& operator=(iou_file_test&&) = default;
+
+        private slots:
+            /**
+             * \brief   Verify that values, statistics, and frames read back exactly.
+             * \throws  None
+             */
+            void test_round_trip() noexcept
+            {
+                QTemporaryDir directory;
+                const auto file_name = directory.path().toStdString() + "/a.ious";
+                const auto ious = make_ious(1001);
+                write_iou_file(ious, file_name, 5, 3);
+                QVERIFY(is_iou_file(file_name));
+                QCOMPARE(read_file(file_name).size(), sizeof(iou_file_header) + ious.size() * sizeof(float));
+
+                iou_file moved(file_name);
+                const auto file = std::move(moved);
+                QCOMPARE(file.ious().size(), ious.size());
+                for (std::size_t i = 0; i < ious.size(); ++i)
+                    QCOMPARE(file.ious()[i].value(), ious[i].value());
+                QCOMPARE(file.frame(0), std::uint64_t(3));
+                QCOMPARE(file.frame(10), std::uint64_t(53));
+
+                const auto expected = summarize(ious);
+                QCOMPARE(file.summary().minimum, expected.minimum);
+                QCOMPARE(file.summary().maximum, expected.maximum);
+                QCOMPARE(file.summary().average, expected.average);
+                QCOMPARE(file.summary().count, ious.size());
+
+                // the C interface reads the same mapping
+                auto* c_file = analyze_iou_file_open(file_name.c_str());
+                QVERIFY(c_file != nullptr);
+                std::size_t count = 0;
+                const float* values = analyze_iou_file_values(c_file, &count);
+                QCOMPARE(count, ious.size());
+                QCOMPARE(values[1], ious[1].value());
+                QCOMPARE(analyze_iou_file_summary(c_file).average, expected.average);
+                QCOMPARE(analyze_iou_file_frame(c_file, 2), std::uint64_t(13));
+                analyze_iou_file_close(c_file);
+
+                // frames without a ground truth box keep their NaN
+                write_iou_file(iou_list {iou(0.5f), iou(std::numeric_limits<float>::quiet_NaN())}, file_name, 1);
+                QVERIFY(std::isnan(iou_file(file_name).ious()[1].value()));
+
+                write_iou_file(iou_list(), file_name, 0);
+                const iou_file empty(file_name);
+                QVERIFY(empty.ious().empty());
+                QCOMPARE(empty.frame(4), std::uint64_t(4));
+            }
+
+            /**
+             * \brief   Verify that text files and damaged files are rejected.
+             * \throws  None
+             */
+            void test_errors() noexcept
+            {
+                QTemporaryDir directory;
+                const auto file_name = directory.path().toStdString() + "/a.ious";
+                write_ious(make_ious(20), file_name);
+                QVERIFY(!is_iou_file(file_name));
+                QVERIFY(!is_iou_file(file_name + ".missing"));
+                QVERIFY(analyze_iou_file_open(file_name.c_str()) == nullptr);
+
+                write_iou_file(make_ious(20), file_name, 5);
+                const auto bytes = read_file(file_name);
+                const auto damaged = [&file_name](const std::string& contents) {
+                    write_file(file_name, contents);
+                    try
+                    {
+                        iou_file file(file_name);
+                    }
+                    catch (std::runtime_error&)
+                    {
+                        return true;
+                    }
+                    return false;
+                };
+                QVERIFY(damaged(bytes.substr(0, bytes.size() - 1)));
+                QVERIFY(damaged(bytes.substr(0, 10)));
+                QVERIFY(damaged("XXXX" + bytes.substr(4)));
+                auto misaligned = bytes;
+                misaligned[offsetof(iou_file_header, values)] = 65;
+                QVERIFY(damaged(misaligned));
+                QVERIFY(!damaged(bytes));
+            }
+    };
+}
+
+QTEST_MAIN(analyze::iou_file_test)
+#include "iou_file_test.moc"
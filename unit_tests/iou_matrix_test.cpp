@@ -0,0 +1,110 @@
+#include <random>
+#include <QtTest/QtTest>
+#include "iou_matrix.h"
+
+namespace analyze
+{
+    /// A set of unit tests for the analyze::iou_matrix class and associated functions.
+    class iou_matrix_test final: public QObject
+    {
+        Q_OBJECT
+        public:
+            /**
+             * \brief   Construct a set of IoU matrix unit tests.
+             * \throws  None
+             */
+            iou_matrix_test() = default;
+
+            /**
+             * \brief   Copy a set of IoU matrix unit tests.
+             * \throws  None
+             */
+            iou_matrix_test(const iou_matrix_test&) = default;
+
+            /**
+             * \brief   Move a set of IoU matrix unit tests.
+             * \throws  None
+             */
+            iou_matrix_test(iou_matrix_test&&) = default;
+
+            /**
+             * \brief   Destroy an IoU matrix test.
+             * \throws  None
+             */
+            ~iou_matrix_test() noexcept = default;
+
+            /**
+             * \brief   Copy a set of IoU matrix unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            iou_matrix_test& operator=(const iou_matrix_test&) = default;
+
+            /**
+             * \brief   Move a set of IoU matrix unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            iou_matrix_test& operator=(iou_matrix_test&&) = default;
+
+        private slots:
+            /**
+             * \brief   Verify that an empty set of boxes produces an empty matrix.
+             * \throws  None
+             */
+            void test_empty() noexcept
+            {
+                const auto m = make_iou_matrix(box_list(), box_list(3));
+                QCOMPARE(m.rows(), static_cast<iou_matrix::size_type>(0));
+                QCOMPARE(m.columns(), static_cast<iou_matrix::size_type>(3));
+            }
+
+            /**
+             * \brief   Verify that boxes without area have an IoU of 0.
+             * \throws  None
+             */
+            void test_zero_area() noexcept
+            {
+                const auto m = make_iou_matrix(box_list(1), box_list(1));
+                QCOMPARE(m(0, 0), 0.0f);
+            }
+
+            /**
+             * \brief   Verify that the tiled matrix matches make_iou() across tile boundaries.
+             * \throws  None
+             */
+            void test_matches_make_iou() noexcept
+            {
+                std::mt19937 engine(42);
+                std::uniform_real_distribution<float> position(0.0f, 200.0f);
+                std::uniform_real_distribution<float> size(1.0f, 80.0f);
+                const auto random_boxes = [&](const std::size_t count)
+                {
+                    box_list boxes;
+                    for (std::size_t i = 0; i < count; ++i)
+                    {
+                        const auto x = position(engine), y = position(engine);
+                        boxes.emplace_back(x, x + size(engine), y, y + size(engine));
+                    }
+                    return boxes;
+                };
+
+                const auto results      = random_boxes(131);
+                const auto ground_truth = random_boxes(70);
+                const auto m = make_iou_matrix(results, ground_truth);
+                QCOMPARE(m.rows(), results.size());
+                QCOMPARE(m.columns(), ground_truth.size());
+                for (std::size_t r = 0; r < m.rows(); ++r)
+                {
+                    for (std::size_t c = 0; c < m.columns(); ++c)
+                    {
+                        const auto expected = make_iou(results[r], ground_truth[c]).value();
+                        QVERIFY(std::fabs(m(r, c) - expected) < 1.0e-6f);
+                    }
+                }
+            }
+    };
+}
+
+QTEST_MAIN(analyze::iou_matrix_test)
+#include "iou_matrix_test.moc"
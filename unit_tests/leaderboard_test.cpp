@@ -0,0 +1,174 @@
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <sys/stat.h>
+#include <QtTest/QtTest>
+#include "leaderboard.h"
+#include "test_helpers.h"
+
+namespace analyze
+{
+    /**
+     * \brief       Make random boxes, including some which miss, touch, or have no area.
+     * \param[in]   count       The number of boxes.
+     * \param[in]   generator   The random number source.
+     * \return      The boxes.
+     * \throws      std::bad_alloc  This is thrown if memory for the boxes cannot be allocated.
+     */
+    box_list make_boxes(const std::size_t count, std::mt19937& generator)
+    {
+        std::uniform_real_distribution<float> position(0.0f, 100.0f);
+        std::uniform_real_distribution<float> size(0.0f, 40.0f);
+        box_list boxes;
+        for (std::size_t b = 0; b < count; ++b)
+        {
+            const float left = position(generator), top = position(generator);
+            const float width = b % 17 == 0 ? 0.0f : size(generator);
+            boxes.emplace_back(left, left + width, top, top + size(generator));
+        }
+        return boxes;
+    }
+
+    /// A set of unit tests for evaluating several trackers together.
+    class leaderboard_test final: public QObject
+    {
+        Q_OBJECT
+        public:
+            /**
+             * \brief   Construct a set of leaderboard unit tests.
+             * \throws  None
+             */
+            leaderboard_test() = default;
+
+            /**
+             * \brief   Copy a set of leaderboard unit tests.
+             * \throws  None
+             */
+            leaderboard_test(const leaderboard_test&) = default;
+
+            /**
+             * \brief   Move a set of leaderboard unit tests.
+             * \throws  None
+             */
+            leaderboard_test(leaderboard_test&&) = default;
+
+            /**
+             * \brief   Destroy a leaderboard test.
+             * \throws  None
+             */
+            ~leaderboard_test() noexcept = default;
+
+            /**
+             * \brief   Copy a set of leaderboard unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            leaderboard_test& operator=(const leaderboard_test&) = default;
+
+            /**
+             * \brief   Move a set of leaderboard unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            leaderboard_test& operator=(leaderboard_test&&) = default;
+
+        private slots:
+            /**
+             * \brief   Verify that the shared ground truth gives the same IoUs as calculate_ious().
+             * \throws  None
+             */
+            void test_tracker_ious() noexcept
+            {
+                std::mt19937 generator(37);
+                const auto truth = make_boxes(1000, generator);
+                std::vector<box_list> trackers {make_boxes(1000, generator),
+                                                make_boxes(613, generator),
+                                                box_list(),
+                                                make_boxes(1500, generator)};
+                trackers[0][5] = truth[5];
+
+                const auto ious = calculate_tracker_ious(truth_columns(truth, iou_stride), trackers);
+                QCOMPARE(ious.size(), trackers.size());
+                for (std::size_t t = 0; t < trackers.size(); ++t)
+                    QVERIFY(same_ious(ious[t], calculate_ious(trackers[t], truth)));
+                QCOMPARE(ious[0][1].value(), 1.0f);
+
+                const truth_columns every(truth, 0);
+                QCOMPARE(every.size(), truth.size());
+                QCOMPARE(calculate_tracker_ious(every, trackers)[1].size(), static_cast<std::size_t>(613));
+            }
+
+            /**
+             * \brief   Verify that every tracker is evaluated on every sequence, and that missing
+             *          files only fail the results which need them.
+             * \throws  None
+             */
+            void test_leaderboard() noexcept
+            {
+                QTemporaryDir directory;
+                const auto root = directory.path().toStdString();
+                std::mt19937 generator(41);
+                leaderboard_options options;
+                options.trackers        = {root + "/a", root + "/b"};
+                options.sequences       = {"one", "two", "three", "missing"};
+                options.thread_count    = 3;
+                QVERIFY_EXCEPTION_THROWN(evaluate_leaderboard(options), std::invalid_argument);
+                options.truth_directory = root + "/truth";
+                mkdir(options.truth_directory.c_str(), 0755);
+                for (const auto& t : options.trackers)
+                    mkdir(t.c_str(), 0755);
+
+                std::vector<box_list> truth;
+                for (std::size_t s = 0; s < 3; ++s)
+                {
+                    const auto& sequence = options.sequences[s];
+                    truth.push_back(make_boxes(200 + 50 * s, generator));
+                    mkdir((options.truth_directory + "/" + sequence).c_str(), 0755);
+                    save_boxes(truth.back(), options.truth_directory + "/" + sequence + "/" + sequence + "_gt.txt");
+                    for (std::size_t t = 0; t < 2; ++t)
+                    {
+                        if (t == 1 && s == 2)
+                            continue;
+                        save_boxes(make_boxes(220, generator), options.trackers[t] + "/" + sequence + ".boxes");
+                    }
+                }
+
+                const auto board = evaluate_leaderboard(options);
+                QCOMPARE(board.size(), static_cast<std::size_t>(2));
+                for (std::size_t t = 0; t < 2; ++t)
+                {
+                    QCOMPARE(board[t].size(), static_cast<std::size_t>(4));
+                    QVERIFY(!board[t][3].ok);
+                    QVERIFY(!board[t][3].error.empty());
+                    for (std::size_t s = 0; s < 3; ++s)
+                    {
+                        const auto results_path = options.trackers[t] + "/" + options.sequences[s];
+                        if (t == 1 && s == 2)
+                        {
+                            QVERIFY(!board[t][s].ok);
+                            continue;
+                        }
+                        QVERIFY(board[t][s].ok);
+                        const auto expected = calculate_ious(load_results(results_path + ".boxes"),
+                                                             load_results(options.truth_directory + "/" + options.sequences[s] + "/" +
+                                                                          options.sequences[s] + "_gt.txt"));
+                        QCOMPARE(board[t][s].summary.count, expected.size());
+                        // frame 0 has no area in either file, so the average is NaN
+                        const auto average = summarize(expected).average;
+                        QVERIFY(std::memcmp(&board[t][s].summary.average, &average, sizeof(average)) == 0);
+
+                        write_ious(expected, root + "/expected.ious");
+                        std::ifstream written(results_path + ".ious"), reference(root + "/expected.ious");
+                        std::stringstream a, b;
+                        a << written.rdbuf();
+                        b << reference.rdbuf();
+                        QCOMPARE(a.str(), b.str());
+                    }
+                }
+            }
+    };
+}
+
+QTEST_MAIN(analyze::leaderboard_test)
+#include "leaderboard_test.moc"
@@ -0,0 +1,229 @@
+#include <stdexcept>
+#include <thread>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <QtTest/QtTest>
+#include "live_ring.h"
+
+namespace analyze
+{
+    /**
+     * \brief   Make a shared memory name which no other test run uses.
+     * \return  The name, including this process's ID.
+     * \throws  std::bad_alloc  This is thrown if memory for the name cannot be allocated.
+     */
+    std::string make_ring_name()
+    {
+        return "/analyze-live-ring-test-" + std::to_string(getpid());
+    }
+
+    /// A set of unit tests for the analyze::live_ring class.
+    class live_ring_test final: public QObject
+    {
+        Q_OBJECT
+        public:
+            /**
+             * \brief   Construct a set of live ring unit tests.
+             * \throws  None
+             */
+            live_ring_test() = default;
+
+            /**
+             * \brief   Copy a set of live ring unit tests.
+             * \throws  None
+             */
+            live_ring_test(const live_ring_test&) = default;
+
+            /**
+             * \brief   Move a set of live ring unit tests.
+             * \throws  None
+             */
+            live_ring_test(live_ring_test&&) = default;
+
+            /**
+             * \brief   Destroy a live ring test.
+             * \throws  None
+             */
+            ~live_ring_test() noexcept = default;
+
+            /**
+             * \brief   Copy a set of live ring unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            live_ring_test& operator=(const live_ring_test&) = default;
+
+            /**
+             * \brief   Move a set of live ring unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            live_ring_test& operator=(live_ring_test&&) = default;
+
+        private slots:
+            /**
+             * \brief   Verify that records pass between two mappings in order, and that a full ring
+             *          refuses records.
+             * \throws  None
+             */
+            void test_push_pop() noexcept
+            {
+                live_ring consumer(make_ring_name(), 3);
+                QCOMPARE(consumer.capacity(), static_cast<live_ring::size_type>(4));
+
+                live_ring producer(make_ring_name());
+                QCOMPARE(producer.capacity(), static_cast<live_ring::size_type>(4));
+
+                live_record record;
+                QVERIFY(!consumer.try_pop(record));
+                for (std::uint64_t f = 0; f < 4; ++f)
+                    QVERIFY(producer.try_push(live_record {f, bounding_box<float>(0, 1, 0, 1)}));
+                QVERIFY(!producer.try_push(live_record {4, bounding_box<float>()}));
+
+                QVERIFY(consumer.try_pop(record));
+                QCOMPARE(record.frame, static_cast<std::uint64_t>(0));
+                QCOMPARE(record.box.right(), 1.0f);
+                QVERIFY(producer.try_push(live_record {4, bounding_box<float>()}));
+                for (std::uint64_t f = 1; f < 5; ++f)
+                {
+                    QVERIFY(consumer.try_pop(record));
+                    QCOMPARE(record.frame, f);
+                }
+                QVERIFY(!consumer.try_pop(record));
+
+                QVERIFY(!consumer.closed());
+                producer.close();
+                QVERIFY(consumer.closed());
+            }
+
+            /**
+             * \brief   Verify that a missing ring cannot be opened, an existing ring is not replaced,
+             *          and a zero or huge capacity is refused.
+             * \throws  None
+             */
+            void test_errors() noexcept
+            {
+                {
+                    live_ring consumer(make_ring_name(), 4);
+                    try
+                    {
+                        live_ring ring(make_ring_name(), 4);
+                        QFAIL("an existing ring was replaced");
+                    }
+                    catch (std::runtime_error&)
+                    {
+                    }
+                    live_ring producer(make_ring_name());
+                    QVERIFY(producer.try_push(live_record {0, bounding_box<float>()}));
+                    live_record record;
+                    QVERIFY(consumer.try_pop(record));
+                }
+
+                try
+                {
+                    live_ring ring(make_ring_name() + "-missing");
+                    QFAIL("a missing ring was opened");
+                }
+                catch (std::runtime_error&)
+                {
+                }
+
+                try
+                {
+                    live_ring ring(make_ring_name(), 0);
+                    QFAIL("a ring with no capacity was created");
+                }
+                catch (std::invalid_argument&)
+                {
+                }
+
+                for (const auto capacity : {(live_ring::size_type(1) << 63) + 1, live_ring::size_type(1) << 62})
+                {
+                    try
+                    {
+                        live_ring ring(make_ring_name(), capacity);
+                        QFAIL("a ring too large to map was created");
+                    }
+                    catch (std::invalid_argument&)
+                    {
+                    }
+                }
+            }
+
+            /**
+             * \brief   Verify that the consumer can tell when the producer process exits.
+             * \throws  None
+             */
+            void test_producer_exit() noexcept
+            {
+                const auto name = make_ring_name();
+                live_ring consumer(name, 4);
+                QVERIFY(!consumer.attached());
+                QVERIFY(consumer.producer_alive());
+
+                const pid_t child = fork();
+                QVERIFY(child >= 0);
+                if (child == 0)
+                {
+                    live_ring producer(name);
+                    producer.try_push(live_record {7, bounding_box<float>()});
+                    _exit(0);
+                }
+                int status = 0;
+                QCOMPARE(waitpid(child, &status, 0), child);
+
+                QVERIFY(consumer.attached());
+                QVERIFY(!consumer.producer_alive());
+                QVERIFY(!consumer.closed());
+                live_record record;
+                QVERIFY(consumer.try_pop(record));
+                QCOMPARE(record.frame, static_cast<std::uint64_t>(7));
+            }
+
+            /**
+             * \brief   Verify that a producer thread and a consumer thread pass every record in
+             *          order through a small ring.
+             * \throws  None
+             */
+            void test_threads() noexcept
+            {
+                constexpr std::uint64_t count = 200000;
+                live_ring consumer(make_ring_name(), 64);
+                live_ring producer(make_ring_name());
+
+                std::thread tracker([&producer]() {
+                    for (std::uint64_t f = 0; f < count; ++f)
+                    {
+                        const live_record record {f, bounding_box<float>(0, static_cast<float>(f), 0, 1)};
+                        while (!producer.try_push(record))
+                            std::this_thread::yield();
+                    }
+                    producer.close();
+                });
+
+                std::uint64_t expected = 0;
+                bool in_order = true;
+                live_record record;
+                while (true)
+                {
+                    const bool finished = consumer.closed();
+                    if (!consumer.try_pop(record))
+                    {
+                        if (finished)
+                            break;
+                        continue;
+                    }
+                    in_order = in_order && record.frame == expected &&
+                               record.box.right() == static_cast<float>(expected);
+                    ++expected;
+                }
+                tracker.join();
+
+                QVERIFY(in_order);
+                QCOMPARE(expected, count);
+            }
+    };
+}
+
+QTEST_MAIN(analyze::live_ring_test)
+#include "live_ring_test.moc"
@@ -0,0 +1,287 @@
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <QtTest/QtTest>
+#include "mask.h"
+
+namespace analyze
+{
+    /**
+     * \brief       Generate a random blob shaped mask.
+     * \param[in]   engine  The random number generator.
+     * \return      A mask with a few hundred to a few thousand set pixels.
+     * \throws      std::bad_alloc  This is thrown if the mask cannot be allocated.
+     */
+    rle_mask make_blob(std::mt19937& engine)
+    {
+        std::uniform_int_distribution<int> position(0, 150), size(5, 60), jitter(-3, 3);
+        const int left = position(engine), top = position(engine);
+        const int width = size(engine), height = size(engine);
+        std::vector<mask_run> runs;
+        for (int row = top; row < top + height; ++row)
+        {
+            const int begin = left + jitter(engine);
+            const int split = begin + width / 2 + jitter(engine);
+            runs.push_back(mask_run {row, begin, split});
+            runs.push_back(mask_run {row, split + 2, begin + width});
+        }
+        return rle_mask(std::move(runs));
+    }
+
+    /**
+     * \brief       Calculate the IoU of two masks pixel by pixel.
+     * \param[in]   a,b     The masks to compare.
+     * \param[in]   frame   A region which contains both masks.
+     * \return      The IoU of \a a and \a b.
+     * \throws      std::bad_alloc  This is thrown if the decoded masks cannot be allocated.
+     */
+    float reference_iou(const rle_mask& a, const rle_mask& b, const integer_box& frame)
+    {
+        const auto bits_a = to_bit_mask(a, frame), bits_b = to_bit_mask(b, frame);
+        std::size_t overlap = 0, combined = 0;
+        for (int row = frame.top(); row < frame.bottom(); ++row)
+        {
+            for (int column = frame.left(); column < frame.right(); ++column)
+            {
+                overlap  += bits_a.test(column, row) && bits_b.test(column, row);
+                combined += bits_a.test(column, row) || bits_b.test(column, row);
+            }
+        }
+        return combined == 0 ? 0.0f : static_cast<float>(overlap) / combined;
+    }
+
+    /// A set of unit tests for segmentation masks.
+    class mask_test final: public QObject
+    {
+        Q_OBJECT
+        public:
+            /**
+             * \brief   Construct a set of mask unit tests.
+             * \throws  None
+             */
+            mask_test() = default;
+
+            /**
+             * \brief   Copy a set of mask unit tests.
+             * \throws  None
+             */
+            mask_test(const mask_test&) = default;
+
+            /**
+             * \brief   Move a set of mask unit tests.
+             * \throws  None
+             */
+            mask_test(mask_test&&) = default;
+
+            /**
+             * \brief   Destroy a mask test.
+             * \throws  None
+             */
+            ~mask_test() noexcept = default;
+
+            /**
+             * \brief   Copy a set of mask unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            mask_test& operator=(const mask_test&) = default;
+
+            /**
+             * \brief   Move a set of mask unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            mask_test& operator=(mask_test&&) = default;
+
+        private slots:
+            /**
+             * \brief   Verify the bounds and pixel count of a run-length encoded mask.
+             * \throws  None
+             */
+            void test_rle_mask() noexcept
+            {
+                const rle_mask m({{2, 5, 9}, {3, 4, 4}, {3, 6, 7}, {4, 70, 80}});
+                QCOMPARE(m.runs().size(), static_cast<std::size_t>(3));
+                QCOMPARE(m.pixel_count(), static_cast<std::size_t>(15));
+                QCOMPARE(m.bounds().left(), 5);
+                QCOMPARE(m.bounds().right(), 80);
+                QCOMPARE(m.bounds().top(), 2);
+                QCOMPARE(m.bounds().bottom(), 5);
+            }
+
+            /**
+             * \brief   Verify that decoding to bits keeps the pixels, bounds and count.
+             * \throws  None
+             */
+            void test_bit_mask() noexcept
+            {
+                const rle_mask m({{1, 60, 130}, {2, 0, 1}, {2, 63, 65}});
+                const auto bits = to_bit_mask(m, integer_box(0, 200, 0, 10));
+                QCOMPARE(bits.words_per_row(), static_cast<std::size_t>(4));
+                QCOMPARE(bits.pixel_count(), m.pixel_count());
+                QVERIFY(bits.test(60, 1));
+                QVERIFY(bits.test(129, 1));
+                QVERIFY(!bits.test(130, 1));
+                QVERIFY(bits.test(64, 2));
+                QVERIFY(!bits.test(62, 2));
+                QCOMPARE(bits.bounds().left(), 0);
+                QCOMPARE(bits.bounds().right(), 130);
+            }
+
+            /**
+             * \brief   Verify both IoU kernels against a pixel by pixel reference.
+             * \throws  None
+             */
+            void test_iou() noexcept
+            {
+                std::mt19937 engine(13);
+                const integer_box frame(-10, 230, -10, 230);
+                for (int trial = 0; trial < 100; ++trial)
+                {
+                    const auto a = make_blob(engine), b = make_blob(engine);
+                    const auto expected = reference_iou(a, b, frame);
+                    QVERIFY(std::fabs(make_iou(a, b).value() - expected) < 1.0e-6f);
+                    QVERIFY(std::fabs(make_iou(to_bit_mask(a, frame), to_bit_mask(b, frame)).value() - expected) < 1.0e-6f);
+                }
+
+                QCOMPARE(make_iou(rle_mask(), rle_mask()).value(), 0.0f);
+                try
+                {
+                    make_iou(bit_mask(integer_box(0, 10, 0, 10)), bit_mask(integer_box(0, 11, 0, 10)));
+                    QFAIL("masks with different frames were compared");
+                }
+                catch (std::invalid_argument&)
+                {
+                }
+            }
+
+            /**
+             * \brief   Verify that VOT masks and boxes are loaded.
+             * \throws  None
+             */
+            void test_load_masks() noexcept
+            {
+                QTemporaryFile file;
+                QVERIFY(file.open());
+                {
+                    std::ofstream stream(file.fileName().toStdString());
+                    stream << "m10,20,3,2,1,4,1\n"
+                           << "1,2,3,4\n";
+                }
+
+                const auto masks = load_masks(file.fileName().toStdString());
+                QCOMPARE(masks.size(), static_cast<std::size_t>(2));
+
+                // 0 1 1
+                // 1 1 0
+                QCOMPARE(masks[0].pixel_count(), static_cast<std::size_t>(4));
+                QCOMPARE(masks[0].runs().size(), static_cast<std::size_t>(2));
+                QCOMPARE(masks[0].runs()[0].row, 20);
+                QCOMPARE(masks[0].runs()[0].begin, 11);
+                QCOMPARE(masks[0].runs()[1].begin, 10);
+                QCOMPARE(masks[0].runs()[1].end, 12);
+
+                QCOMPARE(masks[1].pixel_count(), static_cast<std::size_t>(12));
+                QCOMPARE(masks[1].bounds().bottom(), 6);
+            }
+
+            /**
+             * \brief   Verify that VOT results statuses and polygons are loaded, and bad lines rejected.
+             * \throws  None
+             */
+            void test_load_results() noexcept
+            {
+                QTemporaryFile file;
+                QVERIFY(file.open());
+                const auto file_name = file.fileName().toStdString();
+                {
+                    std::ofstream stream(file_name);
+                    stream << "1\n"
+                           << "m10,20,3,2,1,4,1\n"
+                           << "1,2,4,2,4,6,1,6\n"
+                           << "2\n"
+                           << "0\n"
+                           << "1,2,3,4\n"
+                           << "  \n";
+                }
+
+                std::vector<region_status> statuses;
+                const auto masks = load_masks(file_name, &statuses);
+                QCOMPARE(masks.size(), static_cast<std::size_t>(6));
+                QCOMPARE(statuses.size(), masks.size());
+                QVERIFY(statuses[0] == region_status::initialized);
+                QVERIFY(statuses[1] == region_status::tracked);
+                QVERIFY(statuses[3] == region_status::failed);
+                QVERIFY(statuses[4] == region_status::skipped);
+                QCOMPARE(masks[0].pixel_count(), static_cast<std::size_t>(0));
+                QCOMPARE(masks[2].pixel_count(), static_cast<std::size_t>(12));
+                QCOMPARE(make_iou(masks[2], masks[5]).value(), 1.0f);
+
+                // a diamond covers the pixels whose centres are inside it
+                {
+                    std::ofstream stream(file_name);
+                    stream << "2,0,4,2,2,4,0,2\n";
+                }
+                QCOMPARE(load_masks(file_name)[0].pixel_count(), static_cast<std::size_t>(8));
+
+                const auto rejected = [&file_name](const std::string& line, const bool invalid) {
+                    {
+                        std::ofstream stream(file_name);
+                        stream << "1,2,3,4\n" << line << "\n";
+                    }
+                    try
+                    {
+                        load_masks(file_name);
+                    }
+                    catch (std::invalid_argument&)
+                    {
+                        return invalid;
+                    }
+                    catch (std::runtime_error&)
+                    {
+                        return !invalid;
+                    }
+                    return false;
+                };
+                QVERIFY(rejected("1,2,3", false));
+                QVERIFY(rejected("1,2,3,4,5,6", false));
+                QVERIFY(rejected("3", false));
+                QVERIFY(rejected("1,2,3,4 x", false));
+                QVERIFY(rejected("0,0,10,1e9", true));
+                QVERIFY(rejected("0,0,1e300,1", true));
+                QVERIFY(rejected("0,0,-1,1", true));
+                QVERIFY(rejected("0,0,3e9,0,3e9,1,0,1", true));
+                QVERIFY(rejected("m10,20,0,2,1", true));
+            }
+
+            /**
+             * \brief   Verify that malformed VOT masks are rejected.
+             * \throws  None
+             */
+            void test_parse_errors() noexcept
+            {
+                const auto rejected = [](const std::string& region) {
+                    try
+                    {
+                        parse_vot_mask(region);
+                    }
+                    catch (std::invalid_argument&)
+                    {
+                        return true;
+                    }
+                    return false;
+                };
+                QVERIFY(rejected("10,20,3,2,1,4,1"));
+                QVERIFY(rejected("m10,20,0,2,1"));
+                QVERIFY(rejected("m10,20,3,2,1,-4,1"));
+                QVERIFY(rejected("m10,20,3,2,-1,4"));
+                QVERIFY(rejected("m2147483647,20,3,2,1,4,1"));
+                QVERIFY(rejected("m10,20,3,9999999999,1,4,1"));
+                QVERIFY(!rejected("m-10,20,3,2,1,4,1"));
+            }
+    };
+}
+
+QTEST_MAIN(analyze::mask_test)
+#include "mask_test.moc"
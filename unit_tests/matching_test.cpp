@@ -0,0 +1,233 @@
+#include <random>
+#include <QtTest/QtTest>
+#include "matching.h"
+
+namespace analyze
+{
+    /**
+     * \brief       Generate a random cluster of boxes.
+     * \param[in]   count   The number of boxes to generate.
+     * \param[in]   engine  The random number generator.
+     * \return      \a count boxes which overlap each other heavily.
+     * \throws      std::bad_alloc  This is thrown if the box list cannot be allocated.
+     */
+    box_list make_cluster(const std::size_t count, std::mt19937& engine)
+    {
+        std::uniform_real_distribution<float> position(0.0f, 30.0f), size(10.0f, 30.0f);
+        box_list boxes;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const auto x = position(engine), y = position(engine);
+            boxes.emplace_back(x, x + size(engine), y, y + size(engine));
+        }
+        return boxes;
+    }
+
+    /**
+     * \brief       Find the largest total IoU of any matching, by trying every matching.
+     * \param[in]   results,ground_truth    The boxes to match.
+     * \param[in]   threshold               The minimum IoU for a match.
+     * \param[in]   r                       The first result still to be considered.
+     * \param[in]   used                    Flags for ground truth which is already matched.
+     * \return      The largest total IoU of matches among results \a r and later.
+     * \throws      None
+     */
+    double best_total(const box_list& results,
+                      const box_list& ground_truth,
+                      const float threshold,
+                      const std::size_t r,
+                      std::vector<char>& used)
+    {
+        if (r == results.size())
+            return 0.0;
+
+        auto best = best_total(results, ground_truth, threshold, r + 1, used);
+        for (std::size_t t = 0; t < ground_truth.size(); ++t)
+        {
+            const auto value = make_iou(results[r], ground_truth[t]).value();
+            if (used[t] || value < threshold)
+                continue;
+            used[t] = 1;
+            best = std::max(best, value + best_total(results, ground_truth, threshold, r + 1, used));
+            used[t] = 0;
+        }
+        return best;
+    }
+
+    /**
+     * \brief       Add up the IoU of a list of matches.
+     * \param[in]   matches The matches to add.
+     * \return      The total IoU of \a matches.
+     * \throws      None
+     */
+    double total(const match_list& matches) noexcept
+    {
+        double sum = 0.0;
+        for (const auto& m : matches)
+            sum += m.value;
+        return sum;
+    }
+
+    /// A set of unit tests for the assignment of results to ground truth.
+    class matching_test final: public QObject
+    {
+        Q_OBJECT
+        public:
+            /**
+             * \brief   Construct a set of matching unit tests.
+             * \throws  None
+             */
+            matching_test() = default;
+
+            /**
+             * \brief   Copy a set of matching unit tests.
+             * \throws  None
+             */
+            matching_test(const matching_test&) = default;
+
+            /**
+             * \brief   Move a set of matching unit tests.
+             * \throws  None
+             */
+            matching_test(matching_test&&) = default;
+
+            /**
+             * \brief   Destroy a matching test.
+             * \throws  None
+             */
+            ~matching_test() noexcept = default;
+
+            /**
+             * \brief   Copy a set of matching unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            matching_test& operator=(const matching_test&) = default;
+
+            /**
+             * \brief   Move a set of matching unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            matching_test& operator=(matching_test&&) = default;
+
+        private slots:
+            /**
+             * \brief   Verify that pairs below the threshold are never matched.
+             * \throws  None
+             */
+            void test_threshold() noexcept
+            {
+                const box_list results {bounding_box<float>(0, 10, 0, 10),
+                                        bounding_box<float>(100, 110, 0, 10)};
+                const box_list truth {bounding_box<float>(0, 10, 0, 10),
+                                      bounding_box<float>(104, 114, 0, 10)};
+                const auto matches = match_boxes(results.data(), results.size(),
+                                                 truth.data(), truth.size(),
+                                                 0.5f, match_method::hungarian);
+                QCOMPARE(matches.size(), static_cast<std::size_t>(1));
+                QCOMPARE(matches[0].result, static_cast<std::size_t>(0));
+                QCOMPARE(matches[0].truth, static_cast<std::size_t>(0));
+                QCOMPARE(matches[0].value, 1.0f);
+            }
+
+            /**
+             * \brief   Verify that the Hungarian method finds the largest total IoU, and greedy
+             *          matching never beats it.
+             * \throws  None
+             */
+            void test_optimal() noexcept
+            {
+                std::mt19937 engine(7);
+                bool greedy_was_worse = false;
+                for (int trial = 0; trial < 200; ++trial)
+                {
+                    const auto results = make_cluster(5, engine);
+                    const auto truth   = make_cluster(4, engine);
+                    const auto optimal = match_boxes(results.data(), results.size(),
+                                                     truth.data(), truth.size(),
+                                                     0.1f, match_method::hungarian);
+                    const auto greedy = match_boxes(results.data(), results.size(),
+                                                    truth.data(), truth.size(),
+                                                    0.1f, match_method::greedy);
+
+                    std::vector<char> used(truth.size(), 0);
+                    const auto expected = best_total(results, truth, 0.1f, 0, used);
+                    QVERIFY(std::fabs(total(optimal) - expected) < 1.0e-5);
+                    QVERIFY(total(greedy) <= total(optimal) + 1.0e-5);
+                    greedy_was_worse = greedy_was_worse || total(greedy) < total(optimal) - 1.0e-5;
+                }
+                QVERIFY(greedy_was_worse);
+            }
+
+            /**
+             * \brief   Verify that sequence matching does not depend on the number of threads.
+             * \throws  None
+             */
+            void test_thread_count() noexcept
+            {
+                std::mt19937 engine(11);
+                std::vector<mot_sequence::size_type> frames;
+                std::vector<int> ids;
+                box_list boxes;
+                for (mot_sequence::size_type f = 0; f < 50; ++f)
+                {
+                    for (const auto& b : make_cluster(6, engine))
+                    {
+                        frames.push_back(f);
+                        ids.push_back(static_cast<int>(ids.size()));
+                        boxes.push_back(b);
+                    }
+                }
+                const std::vector<float> scores(boxes.size(), 1.0f);
+                const mot_sequence results(frames, ids, boxes, scores);
+                std::shuffle(boxes.begin(), boxes.end(), engine);
+                const mot_sequence truth(frames, ids, boxes, scores);
+
+                const auto one  = match_sequence(results, truth, 0.3f, match_method::hungarian, 1);
+                const auto many = match_sequence(results, truth, 0.3f, match_method::hungarian, 4);
+                QCOMPARE(one.size(), many.size());
+                for (std::size_t f = 0; f < one.size(); ++f)
+                {
+                    QCOMPARE(one[f].size(), many[f].size());
+                    for (std::size_t m = 0; m < one[f].size(); ++m)
+                    {
+                        QCOMPARE(one[f][m].result, many[f][m].result);
+                        QCOMPARE(one[f][m].truth, many[f][m].truth);
+                    }
+                }
+            }
+
+            /**
+             * \brief   Verify the CLEAR MOT counts, including identity switches.
+             * \throws  None
+             */
+            void test_clear_mot() noexcept
+            {
+                const bounding_box<float> a(0, 10, 0, 10), b(50, 60, 0, 10);
+
+                // the result identity following ground truth object 1 changes from 5 to 6
+                const mot_sequence results({0, 1, 2, 2},
+                                           {5, 6, 6, 7},
+                                           {a, a, a, b},
+                                           {1.0f, 1.0f, 1.0f, 1.0f});
+                const mot_sequence truth({0, 1, 2, 2},
+                                         {1, 1, 1, 2},
+                                         {a, a, a, bounding_box<float>(200, 210, 0, 10)},
+                                         {1.0f, 1.0f, 1.0f, 1.0f});
+
+                const auto matches = match_sequence(results, truth, 0.5f, match_method::greedy, 2);
+                const auto metrics = calculate_clear_mot(results, truth, matches);
+                QCOMPARE(metrics.ground_truth, static_cast<std::size_t>(4));
+                QCOMPARE(metrics.matches, static_cast<std::size_t>(3));
+                QCOMPARE(metrics.misses, static_cast<std::size_t>(1));
+                QCOMPARE(metrics.false_positives, static_cast<std::size_t>(1));
+                QCOMPARE(metrics.id_switches, static_cast<std::size_t>(1));
+                QCOMPARE(metrics.accuracy(), 0.25);
+                QCOMPARE(metrics.precision(), 1.0);
+            }
+    };
+}
+
+QTEST_MAIN(analyze::matching_test)
+#include "matching_test.moc"
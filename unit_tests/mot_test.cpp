@@ -0,0 +1,224 @@
+#include <fstream>
+#include <QtTest/QtTest>
+#include "mot.h"
+
+namespace analyze
+{
+    /// A set of unit tests for the analyze::mot_sequence class and associated functions.
+    class mot_test final: public QObject
+    {
+        Q_OBJECT
+        public:
+            /**
+             * \brief   Construct a set of multi-object unit tests.
+             * \throws  None
+             */
+            mot_test() = default;
+
+            /**
+             * \brief   Copy a set of multi-object unit tests.
+             * \throws  None
+             */
+            mot_test(const mot_test&) = default;
+
+            /**
+             * \brief   Move a set of multi-object unit tests.
+             * \throws  None
+             */
+            mot_test(mot_test&&) = default;
+
+            /**
+             * \brief   Destroy a multi-object test.
+             * \throws  None
+             */
+            ~mot_test() noexcept = default;
+
+            /**
+             * \brief   Copy a set of multi-object unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            mot_test& operator=(const mot_test&) = default;
+
+            /**
+             * \brief   Move a set of multi-object unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            mot_test& operator=(mot_test&&) = default;
+
+        private slots:
+            /**
+             * \brief   Verify that a default sequence is empty.
+             * \throws  None
+             */
+            void test_default_construction() noexcept
+            {
+                const mot_sequence s;
+                QCOMPARE(s.frame_count(), static_cast<mot_sequence::size_type>(0));
+                QCOMPARE(s.object_count(), static_cast<mot_sequence::size_type>(0));
+                QCOMPARE(s.frame(0).size, static_cast<std::size_t>(0));
+            }
+
+            /**
+             * \brief   Verify that unordered objects are grouped by frame, in stable order.
+             * \throws  None
+             */
+            void test_grouping() noexcept
+            {
+                const mot_sequence s({3, 1, 3, 1},
+                                     {7, 8, 9, 10},
+                                     {bounding_box<float>(0, 1, 0, 1),
+                                      bounding_box<float>(0, 2, 0, 2),
+                                      bounding_box<float>(0, 3, 0, 3),
+                                      bounding_box<float>(0, 4, 0, 4)},
+                                     {0.1f, 0.2f, 0.3f, 0.4f});
+                QCOMPARE(s.frame_count(), static_cast<mot_sequence::size_type>(4));
+                QCOMPARE(s.object_count(), static_cast<mot_sequence::size_type>(4));
+                QCOMPARE(s.frame(0).size, static_cast<std::size_t>(0));
+                QCOMPARE(s.frame(2).size, static_cast<std::size_t>(0));
+                QCOMPARE(s.frame(4).size, static_cast<std::size_t>(0));
+
+                const auto one = s.frame(1);
+                QCOMPARE(one.size, static_cast<std::size_t>(2));
+                QCOMPARE(one.ids[0], 8);
+                QCOMPARE(one.ids[1], 10);
+                QCOMPARE(one.boxes[1].right(), 4.0f);
+
+                const auto three = s.frame(3);
+                QCOMPARE(three.size, static_cast<std::size_t>(2));
+                QCOMPARE(three.ids[0], 7);
+                QCOMPARE(three.ids[1], 9);
+                QCOMPARE(three.scores[1], 0.3f);
+            }
+
+            /**
+             * \brief   Verify that mismatched input lists are rejected.
+             * \throws  None
+             */
+            void test_mismatched_lists() noexcept
+            {
+                try
+                {
+                    const mot_sequence s({1, 2}, {1}, box_list(2), {1.0f, 1.0f});
+                    QFAIL("mismatched lists were accepted");
+                }
+                catch (std::invalid_argument&)
+                {
+                }
+            }
+
+            /**
+             * \brief   Verify that MOTChallenge files are loaded as described.
+             * \throws  None
+             */
+            void test_load_mot() noexcept
+            {
+                QTemporaryFile file;
+                QVERIFY(file.open());
+                {
+                    std::ofstream stream(file.fileName().toStdString());
+                    stream << "2,1,10,20,30,40,0.5,-1,-1,-1\n"
+                           << "1,2,1.5,2.5,3,4\n"
+                           << "bad line\n"
+                           << "2, 3, 0, 0, 5, 5, 0.25\n";
+                }
+
+                const auto s = load_mot(file.fileName().toStdString());
+                QCOMPARE(s.object_count(), static_cast<mot_sequence::size_type>(3));
+
+                const auto one = s.frame(1);
+                QCOMPARE(one.size, static_cast<std::size_t>(1));
+                QCOMPARE(one.ids[0], 2);
+                QCOMPARE(one.scores[0], 1.0f);
+                QCOMPARE(one.boxes[0].left(), 1.5f);
+                QCOMPARE(one.boxes[0].right(), 4.5f);
+                QCOMPARE(one.boxes[0].bottom(), 6.5f);
+
+                const auto two = s.frame(2);
+                QCOMPARE(two.size, static_cast<std::size_t>(2));
+                QCOMPARE(two.boxes[0].right(), 40.0f);
+                QCOMPARE(two.boxes[0].bottom(), 60.0f);
+                QCOMPARE(two.scores[0], 0.5f);
+                QCOMPARE(two.ids[1], 3);
+                QCOMPARE(two.scores[1], 0.25f);
+            }
+
+            /**
+             * \brief   Verify that a missing file is reported.
+             * \throws  None
+             */
+            void test_load_missing_file() noexcept
+            {
+                try
+                {
+                    load_mot("/this/file/does/not/exist.txt");
+                    QFAIL("a missing file was not reported");
+                }
+                catch (std::runtime_error&)
+                {
+                }
+            }
+
+            /**
+             * \brief   Verify that frame numbers and identities out of range are reported, instead of
+             *          sizing the sequence or being converted.
+             * \throws  None
+             */
+            void test_load_out_of_range() noexcept
+            {
+                QTemporaryFile file;
+                QVERIFY(file.open());
+                const auto rejected = [&file](const char* line) {
+                    std::ofstream(file.fileName().toStdString(), std::ios::trunc) << "1,1,0,0,5,5\n" << line << '\n';
+                    try
+                    {
+                        load_mot(file.fileName().toStdString());
+                    }
+                    catch (std::runtime_error&)
+                    {
+                        return true;
+                    }
+                    return false;
+                };
+                QVERIFY(rejected("1e15,1,0,0,5,5"));
+                QVERIFY(rejected("nan,1,0,0,5,5"));
+                QVERIFY(rejected("inf,1,0,0,5,5"));
+                QVERIFY(rejected("-1,1,0,0,5,5"));
+                QVERIFY(rejected("2,1e10,0,0,5,5"));
+                QVERIFY(rejected("2,nan,0,0,5,5"));
+                QVERIFY(!rejected("10000000,1,0,0,5,5"));
+            }
+
+            /**
+             * \brief   Verify that ground truth objects which are not to be considered are left out.
+             * \throws  None
+             */
+            void test_load_ground_truth() noexcept
+            {
+                QTemporaryFile file;
+                QVERIFY(file.open());
+                {
+                    std::ofstream stream(file.fileName().toStdString());
+                    stream << "1,1,10,20,30,40,1,1,1\n"
+                           << "1,2,10,20,30,40,0,1,1\n"
+                           << "2,3,0,0,5,5\n";
+                }
+
+                const auto truth = load_mot_ground_truth(file.fileName().toStdString());
+                QCOMPARE(truth.object_count(), static_cast<mot_sequence::size_type>(2));
+                QCOMPARE(truth.frame(1).size, static_cast<std::size_t>(1));
+                QCOMPARE(truth.frame(1).ids[0], 1);
+                QCOMPARE(truth.frame(1).scores[0], 1.0f);
+                QCOMPARE(truth.frame(2).ids[0], 3);
+
+                // as results, the same column is a confidence score
+                const auto results = load_mot(file.fileName().toStdString());
+                QCOMPARE(results.object_count(), static_cast<mot_sequence::size_type>(3));
+                QCOMPARE(results.frame(1).scores[1], 0.0f);
+            }
+    };
+}
+
+QTEST_MAIN(analyze::mot_test)
+#include "mot_test.moc"
@@ -0,0 +1,210 @@
+#include <random>
+#include <QtTest/QtTest>
+#include "nms.h"
+
+Q_DECLARE_METATYPE(analyze::nms_method)
+
+namespace analyze
+{
+    /**
+     * \brief       Generate random detections, with several near duplicates of each object.
+     * \param[in]   count   The number of detections to generate.
+     * \param[out]  scores  Receives a random score for each detection.
+     * \return      The detection boxes.
+     * \throws      std::bad_alloc  This is thrown if the lists cannot be allocated.
+     */
+    box_list make_detections(const std::size_t count, std::vector<float>& scores)
+    {
+        std::mt19937 engine(5);
+        std::uniform_real_distribution<float> position(0.0f, 600.0f), jitter(-4.0f, 4.0f),
+            score(0.0f, 1.0f);
+        box_list boxes;
+        scores.clear();
+        while (boxes.size() < count)
+        {
+            const auto x = position(engine), y = position(engine);
+            for (int d = 0; d < 4 && boxes.size() < count; ++d)
+            {
+                const auto left = x + jitter(engine), top = y + jitter(engine);
+                boxes.emplace_back(left, left + 30.0f, top, top + 60.0f);
+                scores.push_back(score(engine));
+            }
+        }
+        return boxes;
+    }
+
+    /// A set of unit tests for non-maximum suppression.
+    class nms_test final: public QObject
+    {
+        Q_OBJECT
+        public:
+            /**
+             * \brief   Construct a set of non-maximum suppression unit tests.
+             * \throws  None
+             */
+            nms_test() = default;
+
+            /**
+             * \brief   Copy a set of non-maximum suppression unit tests.
+             * \throws  None
+             */
+            nms_test(const nms_test&) = default;
+
+            /**
+             * \brief   Move a set of non-maximum suppression unit tests.
+             * \throws  None
+             */
+            nms_test(nms_test&&) = default;
+
+            /**
+             * \brief   Destroy a non-maximum suppression test.
+             * \throws  None
+             */
+            ~nms_test() noexcept = default;
+
+            /**
+             * \brief   Copy a set of non-maximum suppression unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            nms_test& operator=(const nms_test&) = default;
+
+            /**
+             * \brief   Move a set of non-maximum suppression unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            nms_test& operator=(nms_test&&) = default;
+
+        private slots:
+            /**
+             * \brief   Verify that hard suppression keeps the best of each overlapping group.
+             * \throws  None
+             */
+            void test_hard() noexcept
+            {
+                const box_list boxes {bounding_box<float>(0, 10, 0, 10),
+                                      bounding_box<float>(1, 11, 0, 10),
+                                      bounding_box<float>(50, 60, 0, 10),
+                                      bounding_box<float>(5, 15, 0, 10)};
+                std::vector<float> scores {0.5f, 0.9f, 0.3f, 0.4f};
+                const auto kept = non_maximum_suppression(boxes, scores, nms_options());
+                QCOMPARE(kept, (std::vector<std::size_t> {1, 3, 2}));
+                QCOMPARE(scores[0], 0.5f);
+            }
+
+            /**
+             * \brief   Verify that linear soft suppression decays overlapping scores.
+             * \throws  None
+             */
+            void test_linear() noexcept
+            {
+                const box_list boxes {bounding_box<float>(0, 10, 0, 10),
+                                      bounding_box<float>(0, 10, 0, 8)};
+                std::vector<float> scores {0.9f, 0.8f};
+                nms_options options;
+                options.method = nms_method::linear;
+                const auto kept = non_maximum_suppression(boxes, scores, options);
+                QCOMPARE(kept, (std::vector<std::size_t> {0, 1}));
+                QCOMPARE(scores[0], 0.9f);
+                QCOMPARE(scores[1], 0.8f * 0.2f);
+            }
+
+            /**
+             * \brief   Verify that suppression only happens within a class.
+             * \throws  None
+             */
+            void test_class_aware() noexcept
+            {
+                const box_list boxes {bounding_box<float>(0, 10, 0, 10),
+                                      bounding_box<float>(0, 10, 0, 10),
+                                      bounding_box<float>(0, 10, 0, 10)};
+                std::vector<float> scores {0.5f, 0.9f, 0.7f};
+                const auto kept = non_maximum_suppression(boxes, scores, {1, 1, 2}, nms_options());
+                QCOMPARE(kept, (std::vector<std::size_t> {1, 2}));
+            }
+
+            /**
+             * \brief   Generate the methods to compare with and without the spatial grid.
+             * \throws  None
+             */
+            void test_grid_data() noexcept
+            {
+                QTest::addColumn<nms_method>("method");
+
+                QTest::newRow("hard")     << nms_method::hard;
+                QTest::newRow("linear")   << nms_method::linear;
+                QTest::newRow("gaussian") << nms_method::gaussian;
+            }
+
+            /**
+             * \brief   Verify that the spatial grid does not change the outcome.
+             * \throws  None
+             */
+            void test_grid() noexcept
+            {
+                QFETCH(nms_method, method);
+                std::vector<float> scores;
+                const auto boxes = make_detections(400, scores);
+                auto grid_scores = scores;
+
+                nms_options options;
+                options.method = method;
+                const auto dense = non_maximum_suppression(boxes, scores, options);
+                options.use_grid = true;
+                const auto sparse = non_maximum_suppression(boxes, grid_scores, options);
+                QCOMPARE(dense, sparse);
+                QVERIFY(dense.size() < boxes.size() || method != nms_method::hard);
+                for (std::size_t i = 0; i < scores.size(); ++i)
+                    QVERIFY(std::fabs(scores[i] - grid_scores[i]) < 1.0e-6f);
+            }
+
+            /**
+             * \brief   Verify that suppression is applied to each frame of a sequence.
+             * \throws  None
+             */
+            void test_sequence() noexcept
+            {
+                const bounding_box<float> a(0, 10, 0, 10);
+                const mot_sequence detections({1, 1, 2}, {1, 2, 3}, {a, a, a}, {0.2f, 0.6f, 0.1f});
+                const auto kept = non_maximum_suppression(detections, nms_options());
+                QCOMPARE(kept.object_count(), static_cast<mot_sequence::size_type>(2));
+                QCOMPARE(kept.frame(1).size, static_cast<std::size_t>(1));
+                QCOMPARE(kept.frame(1).ids[0], 2);
+                QCOMPARE(kept.frame(2).ids[0], 3);
+            }
+
+            /**
+             * \brief   Measure hard suppression over a crowded frame, comparing every pair.
+             * \throws  None
+             */
+            void benchmark_dense() noexcept
+            {
+                std::vector<float> scores;
+                const auto boxes = make_detections(4000, scores);
+                QBENCHMARK
+                {
+                    non_maximum_suppression(boxes, scores, nms_options());
+                }
+            }
+
+            /**
+             * \brief   Measure hard suppression over a crowded frame, with the spatial grid.
+             * \throws  None
+             */
+            void benchmark_grid() noexcept
+            {
+                std::vector<float> scores;
+                const auto boxes = make_detections(4000, scores);
+                nms_options options;
+                options.use_grid = true;
+                QBENCHMARK
+                {
+                    non_maximum_suppression(boxes, scores, options);
+                }
+            }
+    };
+}
+
+QTEST_MAIN(analyze::nms_test)
+#include "nms_test.moc"
@@ -0,0 +1,189 @@
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include <QtTest/QtTest>
+#include "polygon.h"
+
+namespace analyze
+{
+    /// A set of unit tests for the analyze::quadrilateral class and associated functions.
+    class polygon_test final: public QObject
+    {
+        Q_OBJECT
+        public:
+            /**
+             * \brief   Construct a set of polygon unit tests.
+             * \throws  None
+             */
+            polygon_test() = default;
+
+            /**
+             * \brief   Copy a set of polygon unit tests.
+             * \throws  None
+             */
+            polygon_test(const polygon_test&) = default;
+
+            /**
+             * \brief   Move a set of polygon unit tests.
+             * \throws  None
+             */
+            polygon_test(polygon_test&&) = default;
+
+            /**
+             * \brief   Destroy a polygon test.
+             * \throws  None
+             */
+            ~polygon_test() noexcept = default;
+
+            /**
+             * \brief   Copy a set of polygon unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            polygon_test& operator=(const polygon_test&) = default;
+
+            /**
+             * \brief   Move a set of polygon unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            polygon_test& operator=(polygon_test&&) = default;
+
+        private slots:
+            /**
+             * \brief   Verify the area and hull of a rotated box, in either winding order.
+             * \throws  None
+             */
+            void test_geometry() noexcept
+            {
+                const quadrilateral diamond({{{0, -1}, {1, 0}, {0, 1}, {-1, 0}}});
+                const quadrilateral reversed({{{0, -1}, {-1, 0}, {0, 1}, {1, 0}}});
+                QCOMPARE(area(diamond), 2.0f);
+                QCOMPARE(area(reversed), 2.0f);
+
+                const auto hull = bounding_hull(diamond);
+                QCOMPARE(hull.left(), -1.0f);
+                QCOMPARE(hull.right(), 1.0f);
+                QCOMPARE(hull.top(), -1.0f);
+                QCOMPARE(hull.bottom(), 1.0f);
+            }
+
+            /**
+             * \brief   Verify that axis aligned quadrilaterals match the bounding box IoU.
+             * \throws  None
+             */
+            void test_axis_aligned() noexcept
+            {
+                std::mt19937 engine(3);
+                std::uniform_real_distribution<float> position(0.0f, 50.0f), size(1.0f, 40.0f);
+                for (int trial = 0; trial < 500; ++trial)
+                {
+                    const auto x1 = position(engine), y1 = position(engine);
+                    const auto x2 = position(engine), y2 = position(engine);
+                    const bounding_box<float> a(x1, x1 + size(engine), y1, y1 + size(engine));
+                    const bounding_box<float> b(x2, x2 + size(engine), y2, y2 + size(engine));
+                    const auto expected = area(intersection(a, b)) > 0.0f ? make_iou(a, b).value() : 0.0f;
+                    const auto actual = make_iou(quadrilateral(a), quadrilateral(b)).value();
+                    QVERIFY(std::fabs(actual - expected) < 1.0e-5f);
+                }
+            }
+
+            /**
+             * \brief   Verify the IoU of rotated boxes.
+             * \throws  None
+             */
+            void test_rotated() noexcept
+            {
+                const auto square  = make_rotated_box(point {10.0f, 10.0f}, 2.0f, 2.0f, 0.0f);
+                const auto diamond = make_rotated_box(point {10.0f, 10.0f}, 2.0f, 2.0f, 0.785398163f);
+                QVERIFY(std::fabs(make_iou(diamond, diamond).value() - 1.0f) < 1.0e-5f);
+
+                // the overlap of a square and the same square turned 45 degrees is a regular
+                // octagon with area 8(sqrt(2) - 1)
+                const auto overlap  = 8.0f * (std::sqrt(2.0f) - 1.0f);
+                const auto expected = overlap / (8.0f - overlap);
+                QVERIFY(std::fabs(make_iou(square, diamond).value() - expected) < 1.0e-5f);
+                QVERIFY(std::fabs(make_iou(diamond, square).value() - expected) < 1.0e-5f);
+
+                // the hulls overlap, but the regions do not
+                const quadrilateral a({{{0, 0}, {10, 10}, {9, 11}, {-1, 1}}});
+                const quadrilateral b({{{10, 0}, {11, 1}, {1, 11}, {0, 10}}});
+                const quadrilateral c({{{20, 0}, {21, 1}, {11, 11}, {10, 10}}});
+                QVERIFY(make_iou(a, b).value() > 0.0f);
+                QCOMPARE(make_iou(a, c).value(), 0.0f);
+
+                QCOMPARE(make_iou(quadrilateral(), quadrilateral()).value(), 0.0f);
+            }
+
+            /**
+             * \brief   Verify that both VOT region forms and the status lines are loaded, that blank
+             *          lines are skipped, and that anything else is rejected.
+             * \throws  None
+             */
+            void test_load_regions() noexcept
+            {
+                QTemporaryFile file;
+                QVERIFY(file.open());
+                const auto write = [&file](const char* text) {
+                    std::ofstream(file.fileName().toStdString()) << text;
+                };
+                write("0,0,4,0,4,2,0,2\n1\n1,2,3,4\n \t\n2\n0\n0\n1\n1,2,3,4\r\n\n");
+
+                std::vector<region_status> statuses;
+                const auto regions = load_regions(file.fileName().toStdString(), &statuses);
+                QCOMPARE(regions.size(), static_cast<std::size_t>(8));
+                QCOMPARE(area(regions[0]), 8.0f);
+                const auto hull = bounding_hull(regions[2]);
+                QCOMPARE(hull.left(), 1.0f);
+                QCOMPARE(hull.right(), 4.0f);
+                QCOMPARE(hull.top(), 2.0f);
+                QCOMPARE(hull.bottom(), 6.0f);
+                QCOMPARE(area(regions[1]), 0.0f);
+                QVERIFY(statuses == std::vector<region_status>({region_status::tracked, region_status::initialized,
+                                                                 region_status::tracked, region_status::failed,
+                                                                 region_status::skipped, region_status::skipped,
+                                                                 region_status::initialized, region_status::tracked}));
+
+                iou_list ious(regions.size(), iou(0.5f));
+                ious[3] = iou(0.0f);
+                apply_region_statuses(ious, statuses);
+                QCOMPARE(ious[0].value(), 0.5f);
+                QVERIFY(std::isnan(ious[1].value()));
+                QCOMPARE(ious[3].value(), 0.0f);
+                QVERIFY(std::isnan(ious[4].value()));
+                QCOMPARE(ious[7].value(), 0.5f);
+
+                for (const auto bad : {"1,2,3,4\nbad\n", "1,2,3\n", "3\n", "1,2,3,4x\n", "1,2,3,4\n1,2,3,4,5\n"})
+                {
+                    write(bad);
+                    QVERIFY_EXCEPTION_THROWN(load_regions(file.fileName().toStdString()), std::runtime_error);
+                }
+            }
+
+            /**
+             * \brief   Measure the batch IoU over overlapping rotated boxes.
+             * \throws  None
+             */
+            void benchmark_batch() noexcept
+            {
+                std::mt19937 engine(9);
+                std::uniform_real_distribution<float> jitter(-5.0f, 5.0f), angle(0.0f, 3.14f);
+                quadrilateral_list results, truth;
+                for (int i = 0; i < 100000; ++i)
+                {
+                    results.push_back(make_rotated_box(point {50.0f + jitter(engine), 50.0f}, 40.0f, 20.0f, angle(engine)));
+                    truth.push_back(make_rotated_box(point {50.0f, 50.0f + jitter(engine)}, 40.0f, 20.0f, angle(engine)));
+                }
+                std::vector<iou> ious(results.size());
+                QBENCHMARK
+                {
+                    calculate_ious(results.data(), truth.data(), results.size(), ious.data());
+                }
+            }
+    };
+}
+
+QTEST_MAIN(analyze::polygon_test)
+#include "polygon_test.moc"
@@ -0,0 +1,152 @@
+#include <stdexcept>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <QtTest/QtTest>
+#include "protocol.h"
+
+namespace analyze
+{
+    /// A set of unit tests for the evaluation protocol.
+    class protocol_test final: public QObject
+    {
+        Q_OBJECT
+        public:
+            /**
+             * \brief   Construct a set of protocol unit tests.
+             * \throws  None
+             */
+            protocol_test() = default;
+
+            /**
+             * \brief   Copy a set of protocol unit tests.
+             * \throws  None
+             */
+            protocol_test(const protocol_test&) = default;
+
+            /**
+             * \brief   Move a set of protocol unit tests.
+             * \throws  None
+             */
+            protocol_test(protocol_test&&) = default;
+
+            /**
+             * \brief   Destroy a protocol test.
+             * \throws  None
+             */
+            ~protocol_test() noexcept = default;
+
+            /**
+             * \brief   Copy a set of protocol unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            protocol_test& operator=(const protocol_test&) = default;
+
+            /**
+             * \brief   Move a set of protocol unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            protocol_test& operator=(protocol_test&&) = default;
+
+        private slots:
+            /**
+             * \brief   Verify that a request survives encoding and decoding.
+             * \throws  None
+             */
+            void test_request() noexcept
+            {
+                evaluation_request request;
+                request.metric            = evaluation_metric::vot_masks;
+                request.results_directory = "/results";
+                request.output_directory  = "";
+                request.sequences         = {"ball", "", "car"};
+
+                const auto decoded = decode_request(encode_request(request));
+                QVERIFY(decoded.metric == evaluation_metric::vot_masks);
+                QCOMPARE(decoded.results_directory, request.results_directory);
+                QCOMPARE(decoded.output_directory, request.output_directory);
+                QVERIFY(decoded.sequences == request.sequences);
+            }
+
+            /**
+             * \brief   Verify that a response survives encoding and decoding.
+             * \throws  None
+             */
+            void test_response() noexcept
+            {
+                evaluation_response response(2);
+                response[0].ok              = true;
+                response[0].summary.count   = 7;
+                response[0].summary.minimum = 0.25f;
+                response[0].summary.maximum = 0.75f;
+                response[0].summary.average = 0.5f;
+                response[1].error           = "could not open ball.boxes";
+
+                const auto decoded = decode_response(encode_response(response));
+                QCOMPARE(decoded.size(), static_cast<std::size_t>(2));
+                QVERIFY(decoded[0].ok);
+                QCOMPARE(decoded[0].summary.count, static_cast<std::size_t>(7));
+                QCOMPARE(decoded[0].summary.minimum, 0.25f);
+                QCOMPARE(decoded[0].summary.maximum, 0.75f);
+                QCOMPARE(decoded[0].summary.average, 0.5f);
+                QVERIFY(!decoded[1].ok);
+                QCOMPARE(decoded[1].error, response[1].error);
+            }
+
+            /**
+             * \brief   Verify that truncated, padded, and mislabeled messages are rejected.
+             * \throws  None
+             */
+            void test_malformed() noexcept
+            {
+                evaluation_request request;
+                request.sequences = {"ball"};
+                const auto message = encode_request(request);
+
+                const auto rejected = [](const std::string& m) {
+                    try
+                    {
+                        decode_request(m);
+                        return false;
+                    }
+                    catch (std::invalid_argument&)
+                    {
+                        return true;
+                    }
+                };
+                for (std::size_t length = 0; length < message.size(); ++length)
+                    QVERIFY(rejected(message.substr(0, length)));
+                QVERIFY(rejected(message + "x"));
+                QVERIFY(rejected(encode_response(evaluation_response(1))));
+            }
+
+            /**
+             * \brief   Verify that messages are framed over a socket.
+             * \throws  None
+             */
+            void test_socket() noexcept
+            {
+                int sockets[2];
+                QVERIFY(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0);
+                const std::string big(50000, 'a');
+                write_message(sockets[0], "first");
+                write_message(sockets[0], "");
+                write_message(sockets[0], big);
+                close(sockets[0]);
+
+                std::string message;
+                QVERIFY(read_message(sockets[1], message));
+                QCOMPARE(message, std::string("first"));
+                QVERIFY(read_message(sockets[1], message));
+                QVERIFY(message.empty());
+                QVERIFY(read_message(sockets[1], message));
+                QVERIFY(message == big);
+                QVERIFY(!read_message(sockets[1], message));
+                close(sockets[1]);
+            }
+    };
+}
+
+QTEST_MAIN(analyze::protocol_test)
+#include "protocol_test.moc"
@@ -0,0 +1,231 @@
+#include <fstream>
+#include <utime.h>
+#include <QtTest/QtTest>
+#include "result_store.h"
+
+namespace analyze
+{
+    /**
+     * \brief       Make a result with a simple IoU series.
+     * \param[in]   count   The number of IoUs.
+     * \param[in]   value   The value of every IoU.
+     * \return      The result.
+     * \throws      std::bad_alloc  This is thrown if memory for the result cannot be allocated.
+     */
+    stored_result make_result(const std::size_t count, const float value)
+    {
+        stored_result result;
+        result.ious.assign(count, iou(value));
+        result.summary = summarize(result.ious);
+        return result;
+    }
+
+    /// A set of unit tests for the content hashed result store.
+    class result_store_test final: public QObject
+    {
+        Q_OBJECT
+        public:
+            /**
+             * \brief   Construct a set of result store unit tests.
+             * \throws  None
+             */
+            result_store_test() = default;
+
+            /**
+             * \brief   Copy a set of result store unit tests.
+             * \throws  None
+             */
+            result_store_test(const result_store_test&) = default;
+
+            /**
+             * \brief   Move a set of result store unit tests.
+             * \throws  None
+             */
+            result_store_test(result_store_test&&) = default;
+
+            /**
+             * \brief   Destroy a result store test.
+             * \throws  None
+             */
+            ~result_store_test() noexcept = default;
+
+            /**
+             * \brief   Copy a set of result store unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            result_store_test& operator=(const result_store_test&) = default;
+
+            /**
+             * \brief   Move a set of result store unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            result_store_test& operator=(result_store_test&&) = default;
+
+        private slots:
+            /**
+             * \brief   Verify that the hash depends on the bytes, not how they are split.
+             * \throws  None
+             */
+            void test_hash() noexcept
+            {
+                const std::string text("the quick brown fox jumps over the lazy dog, twice over");
+                content_hash whole;
+                whole.update(text.data(), text.size());
+                for (std::size_t split = 0; split <= text.size(); ++split)
+                {
+                    content_hash parts;
+                    parts.update(text.data(), split);
+                    parts.update(text.data() + split, text.size() - split);
+                    QVERIFY(parts.finish() == whole.finish());
+                }
+
+                content_hash changed;
+                std::string other(text);
+                other[20] ^= 1;
+                changed.update(other.data(), other.size());
+                QVERIFY(!(changed.finish() == whole.finish()));
+
+                content_hash shorter;
+                shorter.update(text.data(), text.size() - 1);
+                QVERIFY(!(shorter.finish() == whole.finish()));
+                QCOMPARE(whole.finish().hex().size(), static_cast<std::size_t>(32));
+            }
+
+            /**
+             * \brief   Verify that keys follow file contents and configuration.
+             * \throws  None
+             */
+            void test_key() noexcept
+            {
+                QTemporaryDir directory;
+                const auto results = directory.path().toStdString() + "/a.boxes";
+                const auto truth   = directory.path().toStdString() + "/a_gt.txt";
+                std::ofstream(results) << "1,2,3,4\n";
+                std::ofstream(truth) << "1,2,3,4\n";
+
+                const auto key = make_store_key(results, truth, "boxes");
+                QVERIFY(make_store_key(results, truth, "boxes") == key);
+                QVERIFY(!(make_store_key(results, truth, "mot") == key));
+                QVERIFY(make_store_key(hash_file(results), hash_file(truth), "boxes") == key);
+                std::ofstream(results) << "1,2,3,5\n";
+                QVERIFY(!(make_store_key(results, truth, "boxes") == key));
+            }
+
+            /**
+             * \brief   Verify that results are stored, persist, and merge between stores.
+             * \throws  None
+             */
+            void test_store() noexcept
+            {
+                QTemporaryDir directory;
+                const auto path = directory.path().toStdString();
+                const store_key a {1, 2}, b {3, 4}, c {0, 9};
+                {
+                    result_store store(path);
+                    stored_result found;
+                    QVERIFY(!store.find(a, found));
+                    store.insert(a, make_result(10, 0.5f));
+                    QVERIFY(store.find(a, found));
+                    QCOMPARE(found.ious.size(), static_cast<std::size_t>(10));
+                    QCOMPARE(found.summary.average, 0.5f);
+
+                    // a second process adds a result before this one flushes
+                    result_store other(path);
+                    other.insert(b, make_result(3, 0.25f));
+                }
+
+                result_store store(path);
+                QCOMPARE(store.size(), static_cast<std::size_t>(2));
+                stored_result found;
+                QVERIFY(store.find(b, found));
+                QCOMPARE(found.ious[2].value(), 0.25f);
+                QVERIFY(!store.find(c, found));
+
+                // a damaged result is a miss, and is dropped from the index
+                std::ofstream(path + "/objects/" + a.hex()) << "junk";
+                QVERIFY(!store.find(a, found));
+                QCOMPARE(store.size(), static_cast<std::size_t>(1));
+
+                // so is one whose count is too large to allocate
+                {
+                    std::fstream file(path + "/objects/" + b.hex(), std::ios::in | std::ios::out | std::ios::binary);
+                    const std::uint64_t count = std::uint64_t(1) << 62;
+                    file.seekp(8);
+                    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+                }
+                QVERIFY(!store.find(b, found));
+                QCOMPARE(store.size(), static_cast<std::size_t>(0));
+            }
+
+            /**
+             * \brief   Verify that garbage collection keeps the store within a size budget and
+             *          removes orphans.
+             * \throws  None
+             */
+            void test_garbage() noexcept
+            {
+                QTemporaryDir directory;
+                const auto path = directory.path().toStdString();
+                result_store store(path);
+                for (std::uint64_t k = 0; k < 5; ++k)
+                    store.insert(store_key {k, k}, make_result(100, 0.5f));
+                store.flush();
+
+                const auto orphan = path + "/objects/orphan";
+                std::ofstream(orphan) << "x";
+                const utimbuf old {1000, 1000};
+                utime(orphan.c_str(), &old);
+
+                auto report = store.collect_garbage(0, 0);
+                QCOMPARE(report.removed_entries, static_cast<std::size_t>(1));
+                QCOMPARE(report.kept_entries, static_cast<std::size_t>(5));
+                QVERIFY(!std::ifstream(orphan).good());
+
+                const auto one = report.kept_bytes / 5;
+                report = store.collect_garbage(0, 2 * one);
+                QCOMPARE(report.removed_entries, static_cast<std::size_t>(3));
+                QCOMPARE(report.kept_entries, static_cast<std::size_t>(2));
+                QCOMPARE(result_store(path).size(), static_cast<std::size_t>(2));
+            }
+
+            /**
+             * \brief   Verify that a flush does not bring back results which another process
+             *          removed after this one opened the store.
+             * \throws  None
+             */
+            void test_concurrent_removal() noexcept
+            {
+                QTemporaryDir directory;
+                const auto path = directory.path().toStdString();
+                const store_key a {1, 2}, b {3, 4}, c {5, 6};
+                {
+                    result_store store(path);
+                    store.insert(a, make_result(10, 0.5f));
+                    store.insert(b, make_result(10, 0.5f));
+                }
+
+                result_store store(path);
+                stored_result found;
+                QVERIFY(store.find(b, found));
+                {
+                    result_store other(path);
+                    QCOMPARE(other.collect_garbage(0, 1).kept_entries, static_cast<std::size_t>(0));
+                }
+                store.insert(c, make_result(3, 0.25f));
+                store.flush();
+
+                // using a result does not bring it back either
+                result_store reopened(path);
+                QCOMPARE(reopened.size(), static_cast<std::size_t>(1));
+                QVERIFY(!reopened.contains(a));
+                QVERIFY(!reopened.contains(b));
+                QVERIFY(reopened.find(c, found));
+                QCOMPARE(found.summary.average, 0.25f);
+            }
+    };
+}
+
+QTEST_MAIN(analyze::result_store_test)
+#include "result_store_test.moc"
@@ -0,0 +1,180 @@
+#include <cmath>
+#include <QtTest/QtTest>
+#include "robustness.h"
+
+namespace analyze
+{
+    /**
+     * \brief       Make an IoU series from values.
+     * \param[in]   values  The IoU values.
+     * \return      The series.
+     * \throws      std::bad_alloc  This is thrown if memory for the series cannot be allocated.
+     */
+    iou_list make_ious(const std::vector<float>& values)
+    {
+        return iou_list(values.begin(), values.end());
+    }
+
+    /**
+     * \brief       Find the expected overlap curve directly, for comparison.
+     * \param[in]   sequences   The IoU series of each sequence.
+     * \param[in]   options     The protocol settings.
+     * \return      The expected overlap of each length.
+     * \throws      std::bad_alloc  This is thrown if memory for the curve cannot be allocated.
+     */
+    std::vector<double> quadratic_curve(const std::vector<iou_list>& sequences, const vot_options& options)
+    {
+        std::vector<std::pair<const iou_list*, vot_segment>> segments;
+        std::size_t longest = 0;
+        for (const auto& ious : sequences)
+        {
+            for (const auto& s : evaluate_robustness(ious, options).segments)
+            {
+                segments.emplace_back(&ious, s);
+                longest = std::max(longest, s.length);
+            }
+        }
+
+        std::vector<double> curve(longest, 0.0);
+        for (std::size_t n = 1; n <= longest; ++n)
+        {
+            double total = 0.0;
+            std::size_t count = 0;
+            for (const auto& s : segments)
+            {
+                if (!s.second.failed && s.second.length < n)
+                    continue;
+                double sum = 0.0;
+                for (std::size_t i = 0; i < std::min(n, s.second.length); ++i)
+                {
+                    const auto v = (*s.first)[s.second.begin + i].value();
+                    sum += std::isnan(v) ? 0.0 : v;
+                }
+                total += sum / static_cast<double>(n);
+                ++count;
+            }
+            if (count > 0)
+                curve[n - 1] = total / static_cast<double>(count);
+        }
+        return curve;
+    }
+
+    /// A set of unit tests for VOT robustness metrics.
+    class robustness_test final: public QObject
+    {
+        Q_OBJECT
+        public:
+            /**
+             * \brief   Construct a set of robustness unit tests.
+             * \throws  None
+             */
+            robustness_test() = default;
+
+            /**
+             * \brief   Copy a set of robustness unit tests.
+             * \throws  None
+             */
+            robustness_test(const robustness_test&) = default;
+
+            /**
+             * \brief   Move a set of robustness unit tests.
+             * \throws  None
+             */
+            robustness_test(robustness_test&&) = default;
+
+            /**
+             * \brief   Destroy a robustness test.
+             * \throws  None
+             */
+            ~robustness_test() noexcept = default;
+
+            /**
+             * \brief   Copy a set of robustness unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            robustness_test& operator=(const robustness_test&) = default;
+
+            /**
+             * \brief   Move a set of robustness unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            robustness_test& operator=(robustness_test&&) = default;
+
+        private slots:
+            /**
+             * \brief   Verify failures, re-initialization, and accuracy on a small sequence.
+             * \throws  None
+             */
+            void test_failures() noexcept
+            {
+                vot_options options;
+                options.reinit_gap = 2;
+                options.burn_in    = 1;
+                const auto nan = std::nanf("");
+                const auto ious = make_ious({1.0f, 0.5f, nan, 0.0f, 0.0f, 0.0f, 1.0f, 0.75f, 0.0f, 0.3f, 0.6f, 0.0f, 0.2f});
+                const auto summary = evaluate_robustness(ious, options);
+
+                // segments start at 0, 3 + 1 + 2 = 6, and 8 + 1 + 2 = 11, which fails at once
+                QCOMPARE(summary.failures, std::size_t(3));
+                QCOMPARE(summary.segments.size(), std::size_t(3));
+                QCOMPARE(summary.segments[0].begin, std::size_t(0));
+                QCOMPARE(summary.segments[0].length, std::size_t(4));
+                QCOMPARE(summary.segments[1].begin, std::size_t(6));
+                QCOMPARE(summary.segments[1].length, std::size_t(3));
+                QCOMPARE(summary.segments[2].begin, std::size_t(11));
+                QVERIFY(summary.segments[2].failed);
+
+                // frames 1 and 7; the NaN, burn in, and failure frames are left out
+                QCOMPARE(summary.accuracy_frames, std::size_t(2));
+                QVERIFY(std::fabs(summary.accuracy - 0.625) < 1e-12);
+
+                const auto clean = evaluate_robustness(make_ious({0.5f, 0.5f, 0.5f}), options);
+                QCOMPARE(clean.failures, std::size_t(0));
+                QCOMPARE(clean.segments.size(), std::size_t(1));
+                QVERIFY(!clean.segments[0].failed);
+                QCOMPARE(evaluate_robustness(iou_list(), options).segments.size(), std::size_t(0));
+            }
+
+            /**
+             * \brief   Verify the linear expected overlap curve against the direct one.
+             * \throws  None
+             */
+            void test_expected_overlap() noexcept
+            {
+                vot_options options;
+                std::vector<iou_list> sequences;
+                for (std::size_t s = 0; s < 6; ++s)
+                {
+                    std::vector<float> values;
+                    for (std::size_t f = 0; f < 150 + 70 * s; ++f)
+                    {
+                        const auto hash = (f * 2654435761u + s * 97) % 1000;
+                        values.push_back(hash < 8 ? 0.0f : hash < 12 ? std::nanf("") : static_cast<float>(hash) / 1000.0f);
+                    }
+                    sequences.push_back(make_ious(values));
+                }
+
+                eao_accumulator eao;
+                for (const auto& ious : sequences)
+                    eao.add(ious, evaluate_robustness(ious, options).segments);
+                const auto curve    = eao.curve();
+                const auto expected = quadratic_curve(sequences, options);
+                QCOMPARE(curve.size(), expected.size());
+                double total = 0.0;
+                for (std::size_t n = 0; n < curve.size(); ++n)
+                {
+                    QVERIFY(std::fabs(curve[n] - expected[n]) < 1e-9);
+                    if (n >= 9 && n < 100)
+                        total += expected[n];
+                }
+                QVERIFY(std::fabs(eao.average(10, 100) - total / 91.0) < 1e-9);
+                QVERIFY(std::fabs(eao.average() - eao.average(0, 100000)) < 1e-12);
+                QCOMPARE(eao_accumulator().average(), 0.0);
+            }
+    };
+}
+
+QTEST_MAIN(analyze::robustness_test)
+#include "robustness_test.moc"
@@ -0,0 +1,236 @@
+#include <cmath>
+#include <QtTest/QtTest>
+#include "sampling.h"
+
+namespace analyze
+{
+    /**
+     * \brief       Make a pair of box lists with a known IoU series.
+     * \param[in]   count       The number of frames.
+     * \param[in]   results     The tracker results to fill.
+     * \param[in]   truth       The ground truth to fill.
+     * \throws      std::bad_alloc  This is thrown if the lists cannot grow.
+     * \details     The ground truth is always a 100 by 100 box. The results shift it by an amount
+     *              which cycles through 0 to 99, and every 500 frames there is a run of 50 frames
+     *              which miss the target completely.
+     */
+    void make_sequence(const std::size_t count, box_list& results, box_list& truth)
+    {
+        results.clear();
+        truth.clear();
+        for (std::size_t f = 0; f < count; ++f)
+        {
+            const auto shift = f % 500 < 50 ? 1000.0f : static_cast<float>((f * 37) % 100);
+            truth.emplace_back(0.0f, 100.0f, 0.0f, 100.0f);
+            results.emplace_back(shift, 100.0f, 0.0f, 100.0f);
+        }
+    }
+
+    /**
+     * \brief       Find the exact mean IoU and success rate of a sequence.
+     * \param[in]   results     The tracker results.
+     * \param[in]   truth       The ground truth.
+     * \param[out]  mean        The mean IoU.
+     * \param[out]  success     The fraction of frames with IoU over 0.5.
+     * \throws      None
+     */
+    void exact_statistics(const box_list& results, const box_list& truth, double& mean, double& success) noexcept
+    {
+        double total = 0.0;
+        std::size_t successes = 0;
+        for (std::size_t f = 0; f < results.size(); ++f)
+        {
+            const auto v = make_iou(results[f], truth[f]).value();
+            total += v;
+            if (v > 0.5f)
+                ++successes;
+        }
+        mean    = total / static_cast<double>(results.size());
+        success = static_cast<double>(successes) / static_cast<double>(results.size());
+    }
+
+    /// A set of unit tests for sampled evaluation.
+    class sampling_test final: public QObject
+    {
+        Q_OBJECT
+        public:
+            /**
+             * \brief   Construct a set of sampling unit tests.
+             * \throws  None
+             */
+            sampling_test() = default;
+
+            /**
+             * \brief   Copy a set of sampling unit tests.
+             * \throws  None
+             */
+            sampling_test(const sampling_test&) = default;
+
+            /**
+             * \brief   Move a set of sampling unit tests.
+             * \throws  None
+             */
+            sampling_test(sampling_test&&) = default;
+
+            /**
+             * \brief   Destroy a sampling test.
+             * \throws  None
+             */
+            ~sampling_test() noexcept = default;
+
+            /**
+             * \brief   Copy a set of sampling unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            sampling_test& operator=(const sampling_test&) = default;
+
+            /**
+             * \brief   Move a set of sampling unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            sampling_test& operator=(sampling_test&&) = default;
+
+        private slots:
+            /**
+             * \brief   Verify the normal critical values.
+             * \throws  None
+             */
+            void test_critical_value() noexcept
+            {
+                QVERIFY(std::fabs(normal_critical_value(0.95) - 1.959964) < 1e-5);
+                QVERIFY(std::fabs(normal_critical_value(0.99) - 2.575829) < 1e-5);
+                for (const auto confidence : {0.0, 1.0, -0.5, std::nan("")})
+                {
+                    bool thrown = false;
+                    try
+                    {
+                        normal_critical_value(confidence);
+                    }
+                    catch (std::invalid_argument&)
+                    {
+                        thrown = true;
+                    }
+                    QVERIFY(thrown);
+                }
+            }
+
+            /**
+             * \brief   Verify that both orders visit every frame once.
+             * \throws  None
+             * \details A tolerance too small to reach forces every frame to be compared, so the
+             *          estimates must be the exact statistics.
+             */
+            void test_every_frame() noexcept
+            {
+                box_list results, truth;
+                for (const std::size_t count : {1, 2, 31, 64, 1000, 1025})
+                {
+                    make_sequence(count, results, truth);
+                    double mean = 0.0, success = 0.0;
+                    exact_statistics(results, truth, mean, success);
+                    for (const auto order : {sampling_order::stratified, sampling_order::random})
+                    {
+                        sampling_options options;
+                        options.order     = order;
+                        options.tolerance = 1e-12;
+                        options.seed      = count;
+                        const auto estimate = estimate_ious(results, truth, options);
+                        QCOMPARE(estimate.frames_evaluated, count);
+                        QCOMPARE(estimate.frames_total, count);
+                        QVERIFY(estimate.converged);
+                        QVERIFY(std::fabs(estimate.mean - mean) < 1e-9);
+                        QVERIFY(std::fabs(estimate.success_rate - success) < 1e-12);
+                        QCOMPARE(estimate.mean_margin, 0.0);
+                    }
+                }
+            }
+
+            /**
+             * \brief   Verify that a long sequence converges on a small sample near the exact values.
+             * \throws  None
+             */
+            void test_converges() noexcept
+            {
+                box_list results, truth;
+                make_sequence(200000, results, truth);
+                double mean = 0.0, success = 0.0;
+                exact_statistics(results, truth, mean, success);
+                for (const auto order : {sampling_order::stratified, sampling_order::random})
+                {
+                    sampling_options options;
+                    options.order     = order;
+                    options.tolerance = 0.02;
+                    const auto estimate = estimate_ious(results, truth, options);
+                    QVERIFY(estimate.converged);
+                    QVERIFY(estimate.frames_evaluated < results.size() / 10);
+                    QVERIFY(estimate.mean_margin <= options.tolerance);
+                    QVERIFY(estimate.success_margin <= options.tolerance);
+                    QVERIFY(std::fabs(estimate.mean - mean) < 2.0 * options.tolerance);
+                    QVERIFY(std::fabs(estimate.success_rate - success) < 2.0 * options.tolerance);
+                }
+            }
+
+            /**
+             * \brief   Verify the frame limit, and that undefined frames are counted, not averaged.
+             * \throws  None
+             */
+            void test_limit_and_undefined() noexcept
+            {
+                box_list results, truth;
+                make_sequence(10000, results, truth);
+                sampling_options options;
+                options.tolerance      = 1e-6;
+                options.maximum_frames = 100;
+                auto estimate = estimate_ious(results, truth, options);
+                QCOMPARE(estimate.frames_evaluated, std::size_t(100));
+                QVERIFY(!estimate.converged);
+                QVERIFY(estimate.mean_margin > options.tolerance);
+
+                // boxes with no area have no union, so their IoU is not a number
+                for (std::size_t f = 0; f < results.size(); f += 2)
+                    results[f] = truth[f] = bounding_box<float>(0.0f, 0.0f, 0.0f, 0.0f);
+                options.maximum_frames = 0;
+                estimate = estimate_ious(results, truth, options);
+                QCOMPARE(estimate.frames_evaluated, results.size());
+                QCOMPARE(estimate.frames_undefined, results.size() / 2);
+                QVERIFY(!std::isnan(estimate.mean));
+
+                bool thrown = false;
+                try
+                {
+                    options.tolerance = 0.0;
+                    estimate_ious(results, truth, options);
+                }
+                catch (std::invalid_argument&)
+                {
+                    thrown = true;
+                }
+                QVERIFY(thrown);
+            }
+
+            /**
+             * \brief   Verify parsing sampling order names.
+             * \throws  None
+             */
+            void test_parse_order() noexcept
+            {
+                QVERIFY(parse_sampling_order("stratified") == sampling_order::stratified);
+                QVERIFY(parse_sampling_order("random") == sampling_order::random);
+                bool thrown = false;
+                try
+                {
+                    parse_sampling_order("sequential");
+                }
+                catch (std::invalid_argument&)
+                {
+                    thrown = true;
+                }
+                QVERIFY(thrown);
+            }
+    };
+}
+
+QTEST_MAIN(analyze::sampling_test)
+#include "sampling_test.moc"
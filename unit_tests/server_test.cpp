@@ -0,0 +1,147 @@
+#include <fstream>
+#include <thread>
+#include <sys/stat.h>
+#include <QtTest/QtTest>
+#include "server.h"
+#include "test_helpers.h"
+
+namespace analyze
+{
+    /// A set of unit tests for the evaluation server and client.
+    class server_test final: public QObject
+    {
+        Q_OBJECT
+        public:
+            /**
+             * \brief   Construct a set of server unit tests.
+             * \throws  None
+             */
+            server_test() = default;
+
+            /**
+             * \brief   Copy a set of server unit tests.
+             * \throws  None
+             */
+            server_test(const server_test&) = default;
+
+            /**
+             * \brief   Move a set of server unit tests.
+             * \throws  None
+             */
+            server_test(server_test&&) = default;
+
+            /**
+             * \brief   Destroy a server test.
+             * \throws  None
+             */
+            ~server_test() noexcept = default;
+
+            /**
+             * \brief   Copy a set of server unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            server_test& operator=(const server_test&) = default;
+
+            /**
+             * \brief   Move a set of server unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            server_test& operator=(server_test&&) = default;
+
+        private slots:
+            /**
+             * \brief   Verify evaluations over the socket, from several clients, and that changed
+             *          files are parsed again.
+             * \throws  None
+             */
+            void test_evaluate() noexcept
+            {
+                QTemporaryDir directory;
+                QVERIFY(directory.isValid());
+                const auto root = directory.path().toStdString();
+                mkdir((root + "/struck_data").c_str(), 0700);
+                mkdir((root + "/struck_data/ball").c_str(), 0700);
+                save_boxes(box_list(10, bounding_box<float>(0, 10, 0, 10)), root + "/struck_data/ball/ball_gt.txt");
+                save_boxes(box_list(10, bounding_box<float>(0, 10, 0, 10)), root + "/ball.boxes");
+
+                server_options options;
+                options.socket_path    = root + "/analyze.sock";
+                options.thread_count   = 2;
+                QVERIFY_EXCEPTION_THROWN(evaluation_server {options}, std::invalid_argument);
+                options.data_directory = root;
+                options.results_root   = root;
+                evaluation_server server(options);
+                struct stat status;
+                QVERIFY(stat(options.socket_path.c_str(), &status) == 0);
+                QCOMPARE(status.st_mode & 0777, static_cast<mode_t>(0600));
+                std::thread acceptor([&server]() { server.run(); });
+
+                evaluation_request request;
+                request.output_directory  = ".";
+                request.sequences         = {"ball", "missing"};
+
+                std::vector<evaluation_response> responses(4);
+                std::vector<std::thread> clients;
+                for (auto& r : responses)
+                {
+                    clients.emplace_back([&options, &request, &r]() {
+                        evaluation_client client(options.socket_path);
+                        client.evaluate(request);
+                        r = client.evaluate(request);
+                    });
+                }
+                for (auto& c : clients)
+                    c.join();
+
+                for (const auto& r : responses)
+                {
+                    QCOMPARE(r.size(), static_cast<std::size_t>(2));
+                    QVERIFY(r[0].ok);
+                    QCOMPARE(r[0].summary.count, static_cast<std::size_t>(2));
+                    QCOMPARE(r[0].summary.average, 1.0f);
+                    QVERIFY(!r[1].ok);
+                    QVERIFY(!r[1].error.empty());
+                }
+                QVERIFY(std::ifstream(root + "/ball.ious").good());
+
+                // idle connections hold no worker, so more of them than workers do not block others
+                std::vector<evaluation_client> idle;
+                for (int c = 0; c < 3; ++c)
+                    idle.emplace_back(options.socket_path);
+                QVERIFY(evaluation_client(options.socket_path).evaluate(request)[0].ok);
+                QVERIFY(idle[1].evaluate(request)[0].ok);
+
+                // a different size, so the change is seen even within one timestamp tick
+                save_boxes(box_list(12, bounding_box<float>(5, 15, 0, 10)), root + "/ball.boxes");
+                evaluation_client client(options.socket_path);
+                const auto changed = client.evaluate(request);
+                QVERIFY(changed[0].ok);
+                QCOMPARE(changed[0].summary.average, 1.0f / 3.0f);
+
+                // requests cannot name files outside the results root
+                auto escaping = request;
+                escaping.sequences = {"../ball", "struck_data/ball/ball_gt", "ball"};
+                const auto names = client.evaluate(escaping);
+                QVERIFY(!names[0].ok);
+                QVERIFY(!names[1].ok);
+                QVERIFY(names[2].ok);
+                for (const auto& directory : {root, std::string("struck_data/../..")})
+                {
+                    escaping = request;
+                    escaping.results_directory = directory;
+                    QVERIFY(!client.evaluate(escaping)[0].ok);
+                    escaping = request;
+                    escaping.output_directory = directory;
+                    QVERIFY(!client.evaluate(escaping)[0].ok);
+                }
+
+                server.stop();
+                acceptor.join();
+            }
+    };
+}
+
+QTEST_MAIN(analyze::server_test)
+#include "server_test.moc"
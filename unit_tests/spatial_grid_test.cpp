@@ -0,0 +1,243 @@
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <QtTest/QtTest>
+#include "spatial_grid.h"
+
+namespace analyze
+{
+    /**
+     * \brief       Generate a random scene of boxes.
+     * \param[in]   count   The number of boxes to generate.
+     * \param[in]   seed    The seed for the random number generator.
+     * \return      \a count boxes in a 1920x1080 frame, sized like pedestrians in a crowd.
+     * \throws      std::bad_alloc  This is thrown if the box list cannot be allocated.
+     */
+    box_list make_scene(const std::size_t count, const unsigned seed)
+    {
+        std::mt19937 engine(seed);
+        std::uniform_real_distribution<float> x(0.0f, 1880.0f), y(0.0f, 1000.0f);
+        std::uniform_real_distribution<float> width(10.0f, 40.0f), height(30.0f, 80.0f);
+        box_list boxes;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const auto left = x(engine), top = y(engine);
+            boxes.emplace_back(left, left + width(engine), top, top + height(engine));
+        }
+        return boxes;
+    }
+
+    /**
+     * \brief       Find overlapping boxes by comparing every pair.
+     * \param[in]   box     The query box.
+     * \param[in]   boxes   The boxes to search.
+     * \return      The sorted indices of the boxes in \a boxes which overlap \a box.
+     * \throws      std::bad_alloc  This is thrown if the index list cannot be allocated.
+     */
+    std::vector<std::size_t> brute_force(const bounding_box<float>& box, const box_list& boxes)
+    {
+        std::vector<std::size_t> indices;
+        for (std::size_t i = 0; i < boxes.size(); ++i)
+        {
+            if (area(intersection(box, boxes[i])) > 0)
+                indices.push_back(i);
+        }
+        return indices;
+    }
+
+    /**
+     * \brief   Generate the scene densities for the candidate search benchmarks.
+     * \throws  None
+     */
+    void make_density_table()
+    {
+        QTest::addColumn<int>("count");
+
+        QTest::newRow("100 boxes")  <<  100;
+        QTest::newRow("400 boxes")  <<  400;
+        QTest::newRow("1600 boxes") << 1600;
+        QTest::newRow("6400 boxes") << 6400;
+    }
+
+    /// A set of unit tests for the analyze::spatial_grid class.
+    class spatial_grid_test final: public QObject
+    {
+        Q_OBJECT
+        public:
+            /**
+             * \brief   Construct a set of spatial grid unit tests.
+             * \throws  None
+             */
+            spatial_grid_test() = default;
+
+            /**
+             * \brief   Copy a set of spatial grid unit tests.
+             * \throws  None
+             */
+            spatial_grid_test(const spatial_grid_test&) = default;
+
+            /**
+             * \brief   Move a set of spatial grid unit tests.
+             * \throws  None
+             */
+            spatial_grid_test(spatial_grid_test&&) = default;
+
+            /**
+             * \brief   Destroy a spatial grid test.
+             * \throws  None
+             */
+            ~spatial_grid_test() noexcept = default;
+
+            /**
+             * \brief   Copy a set of spatial grid unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            spatial_grid_test& operator=(const spatial_grid_test&) = default;
+
+            /**
+             * \brief   Move a set of spatial grid unit tests.
+             * \return  A reference to this set of unit tests.
+             * \throws  None
+             */
+            spatial_grid_test& operator=(spatial_grid_test&&) = default;
+
+        private slots:
+            /**
+             * \brief   Verify that an empty grid finds nothing.
+             * \throws  None
+             */
+            void test_empty() noexcept
+            {
+                const spatial_grid<float> grid;
+                std::vector<std::size_t> candidates;
+                grid.query(bounding_box<float>(0, 10, 0, 10), candidates);
+                QVERIFY(candidates.empty());
+            }
+
+            /**
+             * \brief   Verify that touching boxes and boxes without area are not candidates.
+             * \throws  None
+             */
+            void test_touching() noexcept
+            {
+                const std::vector<integer_box> boxes {integer_box(0, 10, 0, 10),
+                                                      integer_box(10, 20, 0, 10),
+                                                      integer_box(5, 5, 5, 5),
+                                                      integer_box(5, 15, 5, 15)};
+                const spatial_grid<int> grid(boxes.data(), boxes.size());
+                std::vector<std::size_t> candidates;
+                grid.query(integer_box(0, 10, 0, 10), candidates);
+                std::sort(candidates.begin(), candidates.end());
+                QCOMPARE(candidates, (std::vector<std::size_t> {0, 3}));
+            }
+
+            /**
+             * \brief   Verify that boxes with coordinates which are not finite match nothing, and
+             *          do not disturb the other boxes.
+             * \throws  None
+             */
+            void test_not_finite() noexcept
+            {
+                const auto nan = std::numeric_limits<float>::quiet_NaN();
+                const auto infinity = std::numeric_limits<float>::infinity();
+                const std::vector<bounding_box<float>> boxes {bounding_box<float>(nan, 10, 0, 10),
+                                                              bounding_box<float>(0, 10, 0, 10),
+                                                              bounding_box<float>(-infinity, infinity, 0, 10),
+                                                              bounding_box<float>(5, 15, 5, nan)};
+                const spatial_grid<float> grid(boxes.data(), boxes.size());
+                std::vector<std::size_t> candidates;
+                grid.query(bounding_box<float>(0, 20, 0, 20), candidates);
+                QCOMPARE(candidates, (std::vector<std::size_t> {1}));
+
+                candidates.clear();
+                grid.query(bounding_box<float>(nan, 20, 0, 20), candidates);
+                grid.query(bounding_box<float>(0, infinity, 0, 20), candidates);
+                grid.query(bounding_box<float>(-3.0e38f, 3.0e38f, -3.0e38f, 3.0e38f), candidates);
+                QCOMPARE(candidates, (std::vector<std::size_t> {1}));
+
+                const spatial_grid<float> unusable(boxes.data(), 1);
+                candidates.clear();
+                unusable.query(bounding_box<float>(0, 20, 0, 20), candidates);
+                QVERIFY(candidates.empty());
+            }
+
+            /**
+             * \brief   Verify that grid queries match a brute force search, without duplicates.
+             * \throws  None
+             */
+            void test_matches_brute_force() noexcept
+            {
+                const auto boxes   = make_scene(500, 1);
+                const auto queries = make_scene(200, 2);
+                const spatial_grid<float> grid(boxes.data(), boxes.size());
+                std::vector<std::size_t> candidates;
+                for (const auto& q : queries)
+                {
+                    candidates.clear();
+                    grid.query(q, candidates);
+                    std::sort(candidates.begin(), candidates.end());
+                    QCOMPARE(candidates, brute_force(q, boxes));
+                }
+
+                // a query larger than the grid extent must still find everything
+                candidates.clear();
+                grid.query(bounding_box<float>(-1.0e6f, 1.0e6f, -1.0e6f, 1.0e6f), candidates);
+                QCOMPARE(candidates.size(), boxes.size());
+            }
+
+            /**
+             * \brief   Measure an all-pairs candidate search by brute force.
+             * \throws  None
+             */
+            void benchmark_brute_force() noexcept
+            {
+                QFETCH(int, count);
+                const auto results      = make_scene(count, 3);
+                const auto ground_truth = make_scene(count, 4);
+                std::size_t found = 0;
+                QBENCHMARK
+                {
+                    for (const auto& r : results)
+                        found += brute_force(r, ground_truth).size();
+                }
+                QVERIFY(found > 0);
+            }
+
+            /// \copydoc make_density_table()
+            void benchmark_brute_force_data() noexcept { make_density_table(); }
+
+            /**
+             * \brief   Measure an all-pairs candidate search with a spatial grid.
+             * \details The measurement includes building the grid, as it would be built for each
+             *          frame.
+             * \throws  None
+             */
+            void benchmark_grid() noexcept
+            {
+                QFETCH(int, count);
+                const auto results      = make_scene(count, 3);
+                const auto ground_truth = make_scene(count, 4);
+                std::size_t found = 0;
+                std::vector<std::size_t> candidates;
+                spatial_grid<float> grid;
+                QBENCHMARK
+                {
+                    grid.build(ground_truth.data(), ground_truth.size());
+                    for (const auto& r : results)
+                    {
+                        candidates.clear();
+                        grid.query(r, candidates);
+                        found += candidates.size();
+                    }
+                }
+                QVERIFY(found > 0);
+            }
+
+            /// \copydoc make_density_table()
+            void benchmark_grid_data() noexcept { make_density_table(); }
+    };
+}
+
+QTEST_MAIN(analyze::spatial_grid_test)
+#include "spatial_grid_test.moc"
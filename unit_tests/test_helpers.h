@@ -0,0 +1,117 @@
+#ifndef ANALYZE_TEST_HELPERS_H
+#define ANALYZE_TEST_HELPERS_H
+
+#include "analysis.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <sys/stat.h>
+
+namespace analyze
+{
+    /**
+     * \brief       Read a whole file.
+     * \param[in]   file_name   The file to read.
+     * \return      The file's bytes. A missing file reads as empty.
+     * \throws      std::bad_alloc  This is thrown if memory for the bytes cannot be allocated.
+     */
+    inline std::string read_file(const std::string& file_name)
+    {
+        std::ifstream file(file_name, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    /**
+     * \brief       Replace a file's contents, keeping its inode if it exists.
+     * \param[in]   file_name   The file to write.
+     * \param[in]   contents    The new contents.
+     * \retval      true        The file was written.
+     * \retval      false       The file could not be opened or written.
+     * \throws      None
+     */
+    inline bool write_file(const std::string& file_name, const std::string& contents)
+    {
+        std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+        file << contents;
+        return static_cast<bool>(file.flush());
+    }
+
+    /**
+     * \brief       Create a file, and the directories which hold it.
+     * \param[in]   root        An existing directory.
+     * \param[in]   path        The file's path under \a root.
+     * \param[in]   contents    The file's contents.
+     * \retval      true        The file was written.
+     * \retval      false       A directory could not be created, or the file could not be written.
+     * \throws      None
+     */
+    inline bool make_file(const std::string& root, const std::string& path, const std::string& contents)
+    {
+        for (auto slash = path.find('/'); slash != std::string::npos; slash = path.find('/', slash + 1))
+        {
+            if (mkdir((root + "/" + path.substr(0, slash)).c_str(), 0755) != 0 && errno != EEXIST)
+                return false;
+        }
+        return write_file(root + "/" + path, contents);
+    }
+
+    /**
+     * \brief       Write boxes in the format read by load_results().
+     * \param[in]   boxes       The boxes to write.
+     * \param[in]   file_name   The file to write.
+     * \throws      None
+     */
+    inline void save_boxes(const box_span boxes, const std::string& file_name)
+    {
+        std::ofstream file(file_name);
+        for (const auto& b : boxes)
+            file << b.left() << ',' << b.right() - b.left() << ',' << b.top() << ',' << b.bottom() - b.top() << '\n';
+    }
+
+    /**
+     * \brief       Verify that two box lists have the same coordinates.
+     * \param[in]   a,b     The lists to compare.
+     * \retval      true    The lists are the same.
+     * \retval      false   The lists differ.
+     * \throws      None
+     */
+    inline bool same_boxes(const box_span a, const box_span b) noexcept
+    {
+        return a.size() == b.size() &&
+               std::equal(a.begin(), a.end(), b.begin(), [](const bounding_box<float>& x, const bounding_box<float>& y) {
+                   return x.left() == y.left() && x.right() == y.right() && x.top() == y.top() &&
+                          x.bottom() == y.bottom();
+               });
+    }
+
+    /**
+     * \brief       Verify that two IoU values have the same bits.
+     * \param[in]   a,b     The values.
+     * \retval      true    The values are identical, including NaN.
+     * \retval      false   The values differ.
+     * \throws      None
+     */
+    inline bool same_value(const iou::value_type a, const iou::value_type b) noexcept
+    {
+        return std::memcmp(&a, &b, sizeof(a)) == 0;
+    }
+
+    /**
+     * \brief       Verify that two IoU lists are the same, bit for bit.
+     * \param[in]   a,b     The lists to compare.
+     * \retval      true    The lists are the same.
+     * \retval      false   The lists differ.
+     * \throws      None
+     */
+    inline bool same_ious(const iou_list& a, const iou_list& b) noexcept
+    {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](const iou x, const iou y) {
+                   return same_value(x.value(), y.value());
+               });
+    }
+}
+
+#endif